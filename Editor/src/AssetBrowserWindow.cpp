@@ -97,7 +97,8 @@ void AssetBrowserWindow::importButton() noexcept
 			FileDialog::FileExtension extensions[]
 			{
 				{ "Wavefront OBJ", "*.obj" },
-				{ "glTF", "*.gltf" }
+				{ "glTF", "*.gltf" },
+				{ "Material", "*.json" }
 			};
 
 			FileDialog::FileDialogParams dialogParams{};
@@ -124,6 +125,8 @@ void AssetBrowserWindow::importButton() noexcept
 					m_importAssetTask.m_importOptions.m_fileType = AssetImporter::FileType::WAVEFRONT_OBJ; break;
 				case 1:
 					m_importAssetTask.m_importOptions.m_fileType = AssetImporter::FileType::GLTF; break;
+				case 2:
+					m_importAssetTask.m_importOptions.m_fileType = AssetImporter::FileType::MATERIAL_JSON; break;
 				default:
 					assert(false);
 					break;
@@ -123,6 +123,15 @@ void Editor::update(float deltaTime) noexcept
 			}
 			ImGui::EndMenu();
 		}
+		if (ImGui::BeginMenu("Assets"))
+		{
+			// the registry index is only checked for changes made outside the editor on startup
+			if (ImGui::MenuItem("Rebuild Asset Registry"))
+			{
+				AssetMetaDataRegistry::get()->rebuildIndex();
+			}
+			ImGui::EndMenu();
+		}
 		ImGui::EndMainMenuBar();
 	}
 
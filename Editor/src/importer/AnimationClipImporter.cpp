@@ -1,12 +1,14 @@
 #include "AnimationClipImporter.h"
 #include <asset/AssetManager.h>
 #include <asset/AnimationClipAsset.h>
+#include <animation/AnimationClipCompressor.h>
 #include <filesystem/VirtualFileSystem.h>
 #include <Log.h>
+#include "DerivedDataCache.h"
 #include "loader/LoadedModel.h"
 #include <EASTL/string.h>
 
-bool AnimationClipImporter::importAnimationClips(size_t count, const LoadedAnimationClip *anims, const char *baseDstPath, const char *sourcePath) noexcept
+bool AnimationClipImporter::importAnimationClips(size_t count, const LoadedAnimationClip *anims, const char *baseDstPath, const char *sourcePath, eastl::vector<ImportedAsset> *importedAssets) noexcept
 {
 	auto *assetMgr = AssetManager::get();
 	auto &vfs = VirtualFileSystem::get();
@@ -39,107 +41,50 @@ bool AnimationClipImporter::importAnimationClips(size_t count, const LoadedAnima
 
 		assetMgr->createAsset(AnimationClipAsset::k_assetType, dstPath.c_str(), sourcePath);
 
-		if (FileHandle fh = vfs.open(dstPath.c_str(), FileMode::WRITE, true))
+		// compress the clip
+		AnimationClipLayout layout{};
+		eastl::vector<char> clipData;
 		{
-			AnimationClipAsset::FileHeader header{};
-			header.m_fileSize = sizeof(header);
-			header.m_jointCount = (uint32_t)animClip.m_jointAnimations.size();
-			header.m_duration = animClip.m_duration;
-
-			// compute file size
+			eastl::vector<AnimationClipSourceJoint> sourceJoints(animClip.m_jointAnimations.size());
+			for (size_t j = 0; j < sourceJoints.size(); ++j)
 			{
-				header.m_fileSize += header.m_jointCount * sizeof(uint32_t) * 6; // per joint info
-				for (const auto &jointClip : animClip.m_jointAnimations)
-				{
-					header.m_fileSize += (uint32_t)jointClip.m_translationChannel.m_timeKeys.size() * sizeof(uint32_t);
-					header.m_fileSize += (uint32_t)jointClip.m_rotationChannel.m_timeKeys.size() * sizeof(uint32_t);
-					header.m_fileSize += (uint32_t)jointClip.m_scaleChannel.m_timeKeys.size() * sizeof(uint32_t);
-					header.m_fileSize += (uint32_t)jointClip.m_translationChannel.m_translations.size() * sizeof(glm::vec3);
-					header.m_fileSize += (uint32_t)jointClip.m_rotationChannel.m_rotations.size() * sizeof(glm::quat);
-					header.m_fileSize += (uint32_t)jointClip.m_scaleChannel.m_scales.size() * sizeof(float);
-				}
+				const auto &jointClip = animClip.m_jointAnimations[j];
+				auto &sourceJoint = sourceJoints[j];
+
+				sourceJoint.m_translationKeyCount = (uint32_t)jointClip.m_translationChannel.m_timeKeys.size();
+				sourceJoint.m_rotationKeyCount = (uint32_t)jointClip.m_rotationChannel.m_timeKeys.size();
+				sourceJoint.m_scaleKeyCount = (uint32_t)jointClip.m_scaleChannel.m_timeKeys.size();
+				sourceJoint.m_translationTimeKeys = jointClip.m_translationChannel.m_timeKeys.data();
+				sourceJoint.m_rotationTimeKeys = jointClip.m_rotationChannel.m_timeKeys.data();
+				sourceJoint.m_scaleTimeKeys = jointClip.m_scaleChannel.m_timeKeys.data();
+				sourceJoint.m_translations = jointClip.m_translationChannel.m_translations.empty() ? nullptr : &jointClip.m_translationChannel.m_translations[0].x;
+				sourceJoint.m_rotations = jointClip.m_rotationChannel.m_rotations.empty() ? nullptr : &jointClip.m_rotationChannel.m_rotations[0].x;
+				sourceJoint.m_scales = jointClip.m_scaleChannel.m_scales.data();
 			}
 
-			vfs.write(fh, sizeof(header), &header);
-
-			uint32_t curTranslationArrayOffset = 0;
-			uint32_t curRotationArrayOffset = 0;
-			uint32_t curScaleArrayOffset = 0;
-
-			// write joint clip info
-			for (const auto &jointClip : animClip.m_jointAnimations)
-			{
-				uint32_t translationCount = (uint32_t)jointClip.m_translationChannel.m_timeKeys.size();
-				uint32_t rotationCount = (uint32_t)jointClip.m_rotationChannel.m_timeKeys.size();
-				uint32_t scaleCount = (uint32_t)jointClip.m_scaleChannel.m_timeKeys.size();
-
-				vfs.write(fh, 4, &translationCount);
-				vfs.write(fh, 4, &rotationCount);
-				vfs.write(fh, 4, &scaleCount);
-				vfs.write(fh, 4, &curTranslationArrayOffset);
-				vfs.write(fh, 4, &curRotationArrayOffset);
-				vfs.write(fh, 4, &curScaleArrayOffset);
-
-				curTranslationArrayOffset += (uint32_t)jointClip.m_translationChannel.m_timeKeys.size();
-				curRotationArrayOffset += (uint32_t)jointClip.m_rotationChannel.m_timeKeys.size();
-				curScaleArrayOffset += (uint32_t)jointClip.m_scaleChannel.m_timeKeys.size();
-			}
-
-			// write translation timekeys
-			for (const auto &jointClip : animClip.m_jointAnimations)
-			{
-				for (auto t : jointClip.m_translationChannel.m_timeKeys)
-				{
-					vfs.write(fh, 4, &t);
-				}
-			}
-
-			// write rotation timekeys
-			for (const auto &jointClip : animClip.m_jointAnimations)
-			{
-				for (auto t : jointClip.m_rotationChannel.m_timeKeys)
-				{
-					vfs.write(fh, 4, &t);
-				}
-			}
+			AnimationClipCompressor::compress(sourceJoints.size(), sourceJoints.data(), animClip.m_duration, AnimationClipCompressionSettings{}, &layout, &clipData);
+		}
 
-			// write scale timekeys
-			for (const auto &jointClip : animClip.m_jointAnimations)
-			{
-				for (auto t : jointClip.m_scaleChannel.m_timeKeys)
-				{
-					vfs.write(fh, 4, &t);
-				}
-			}
+		if (FileHandle fh = vfs.open(dstPath.c_str(), FileMode::WRITE, true))
+		{
+			AnimationClipAsset::FileHeader header{};
+			header.m_fileSize = (uint32_t)(sizeof(header) + clipData.size());
+			header.m_jointCount = layout.m_jointCount;
+			header.m_duration = animClip.m_duration;
+			header.m_constantDataCount = layout.m_constantDataCount;
+			header.m_translationKeyCount = layout.m_translationKeyCount;
+			header.m_rotationKeyCount = layout.m_rotationKeyCount;
+			header.m_scaleKeyCount = layout.m_scaleKeyCount;
 
-			// write translations
-			for (const auto &jointClip : animClip.m_jointAnimations)
-			{
-				for (const auto &t : jointClip.m_translationChannel.m_translations)
-				{
-					vfs.write(fh, sizeof(float) * 3, &t.x);
-				}
-			}
+			vfs.write(fh, sizeof(header), &header);
+			vfs.write(fh, clipData.size(), clipData.data());
 
-			// write rotations
-			for (const auto &jointClip : animClip.m_jointAnimations)
-			{
-				for (const auto &r : jointClip.m_rotationChannel.m_rotations)
-				{
-					vfs.write(fh, sizeof(float) * 4, &r.x);
-				}
-			}
+			vfs.close(fh);
 
-			// write scales
-			for (const auto &jointClip : animClip.m_jointAnimations)
+			if (importedAssets)
 			{
-				for (const auto &s : jointClip.m_scaleChannel.m_scales)
-				{
-					vfs.write(fh, sizeof(float), &s);
-				}
+				importedAssets->push_back({ AnimationClipAsset::k_assetType, dstPath.c_str() });
 			}
-
-			vfs.close(fh);
 		}
 		else
 		{
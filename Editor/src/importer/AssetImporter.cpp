@@ -6,17 +6,101 @@
 #include "AnimationClipImporter.h"
 #include "MeshImporter.h"
 #include "MaterialImporter.h"
+#include "DerivedDataCache.h"
 #include <asset/Asset.h>
+#include <utility/StringID.h>
+#include <string.h>
 
 struct LoadedModel;
 
 namespace
 {
+	// increment when the output of the loaders changes to invalidate the DerivedDataCache
+	constexpr uint32_t k_loaderVersion = 1;
+
 	typedef bool (*LoaderFuncPtr)(const char *filepath, bool mergeByMaterial, bool invertTexcoordY, bool importMeshes, bool importSkeletons, bool importAnimations, float scale, LoadedModel &model);
 }
 
+static bool computeCacheKey(const AssetImporter::ImportOptions &importOptions, Physics *physics, const char *nativeSrcPath, const char *dstPath, uint64_t *key) noexcept
+{
+	uint64_t hash = k_fnvOffsetBasis;
+
+	// the files loaded in addition to the source file are found the same way the loaders find them
+	eastl::vector<eastl::string> referencedFiles;
+	switch (importOptions.m_fileType)
+	{
+	case AssetImporter::FileType::WAVEFRONT_OBJ:
+		WavefrontOBJLoader::getReferencedFiles(nativeSrcPath, &referencedFiles);
+		break;
+	case AssetImporter::FileType::GLTF:
+		GLTFLoader::getReferencedFiles(nativeSrcPath, &referencedFiles);
+		break;
+	default:
+		break;
+	}
+
+	if (!DerivedDataCache::hashSourceFiles(nativeSrcPath, referencedFiles.size(), referencedFiles.data(), &hash))
+	{
+		return false;
+	}
+
+	const uint32_t versions[] = { k_loaderVersion, SkeletonImporter::k_version, AnimationClipImporter::k_version, MaterialImporter::k_version, MeshImporter::k_version };
+	hash = DerivedDataCache::hash(versions, sizeof(versions), hash);
+
+	// ImportOptions has padding, so the members are hashed individually. physics meshes are only cooked if there is a Physics instance
+	const uint8_t options[] =
+	{
+		static_cast<uint8_t>(importOptions.m_fileType),
+		importOptions.m_mergeByMaterial,
+		importOptions.m_invertTexCoordY,
+		importOptions.m_importMeshes,
+		importOptions.m_importSkeletons,
+		importOptions.m_importAnimations,
+		importOptions.m_cookConvexPhysicsMesh,
+		importOptions.m_cookTrianglePhysicsMesh,
+		physics != nullptr,
+	};
+	hash = DerivedDataCache::hash(options, sizeof(options), hash);
+	hash = DerivedDataCache::hash(&importOptions.m_meshScale, sizeof(importOptions.m_meshScale), hash);
+
+	// imported meshes refer to their materials by asset ID, which is derived from the destination path
+	hash = DerivedDataCache::hash(dstPath, strlen(dstPath), hash);
+
+	*key = hash;
+	return true;
+}
+
 bool AssetImporter::importAsset(const ImportOptions &importOptions, Physics *physics, const char *nativeSrcPath, const char *dstPath) noexcept
 {
+	uint64_t cacheKey = 0;
+	const bool cacheable = computeCacheKey(importOptions, physics, nativeSrcPath, dstPath, &cacheKey);
+
+	if (cacheable && DerivedDataCache::restore(cacheKey, nativeSrcPath))
+	{
+		Log::info("Restored asset \"%s\" from the DerivedDataCache.", nativeSrcPath);
+		return true;
+	}
+
+	// materials are edited as JSON and imported on their own
+	if (importOptions.m_fileType == FileType::MATERIAL_JSON)
+	{
+		LoadedMaterial material;
+		if (!MaterialImporter::loadMaterialJSON(nativeSrcPath, &material))
+		{
+			Log::err("Import of asset \"%s\" failed!", nativeSrcPath);
+			return false;
+		}
+
+		AssetID materialAssetID;
+		eastl::vector<ImportedAsset> importedAssets;
+		if (MaterialImporter::importMaterials(1, &material, dstPath, nativeSrcPath, &materialAssetID, &importedAssets) && cacheable)
+		{
+			DerivedDataCache::store(cacheKey, importedAssets.size(), importedAssets.data());
+		}
+
+		return true;
+	}
+
 	// select correct loader function pointer
 	LoaderFuncPtr loader = WavefrontOBJLoader::loadModel;
 	switch (importOptions.m_fileType)
@@ -40,21 +124,30 @@ bool AssetImporter::importAsset(const ImportOptions &importOptions, Physics *phy
 		return false;
 	}
 
+	eastl::vector<ImportedAsset> importedAssets;
+	bool success = true;
+
 	if (importOptions.m_importSkeletons && !model.m_skeletons.empty())
 	{
-		bool res = SkeletonImporter::importSkeletons(model.m_skeletons.size(), model.m_skeletons.data(), dstPath, nativeSrcPath);
+		success = SkeletonImporter::importSkeletons(model.m_skeletons.size(), model.m_skeletons.data(), dstPath, nativeSrcPath, &importedAssets) && success;
 	}
 
 	if (importOptions.m_importAnimations && !model.m_animationClips.empty())
 	{
-		bool res = AnimationClipImporter::importAnimationClips(model.m_animationClips.size(), model.m_animationClips.data(), dstPath, nativeSrcPath);
+		success = AnimationClipImporter::importAnimationClips(model.m_animationClips.size(), model.m_animationClips.data(), dstPath, nativeSrcPath, &importedAssets) && success;
 	}
 
 	if (importOptions.m_importMeshes && !model.m_meshes.empty())
 	{
 		eastl::vector<AssetID> materialAssetIDs(model.m_materials.size());
-		bool matRes = MaterialImporter::importMaterials(model.m_materials.size(), model.m_materials.data(), dstPath, nativeSrcPath, materialAssetIDs.data());
-		bool res = MeshImporter::importMeshes(1, &model, dstPath, nativeSrcPath, physics, materialAssetIDs.data(), importOptions.m_cookConvexPhysicsMesh, importOptions.m_cookTrianglePhysicsMesh);
+		success = MaterialImporter::importMaterials(model.m_materials.size(), model.m_materials.data(), dstPath, nativeSrcPath, materialAssetIDs.data(), &importedAssets) && success;
+		success = MeshImporter::importMeshes(1, &model, dstPath, nativeSrcPath, physics, materialAssetIDs.data(), importOptions.m_cookConvexPhysicsMesh, importOptions.m_cookTrianglePhysicsMesh, &importedAssets) && success;
+	}
+
+	// incomplete imports are not cached, so they are retried the next time
+	if (cacheable && success)
+	{
+		DerivedDataCache::store(cacheKey, importedAssets.size(), importedAssets.data());
 	}
 
 	return true;
@@ -8,6 +8,7 @@ namespace AssetImporter
 	{
 		WAVEFRONT_OBJ,
 		GLTF,
+		MATERIAL_JSON,
 	};
 
 	struct ImportOptions
@@ -0,0 +1,250 @@
+#include "DerivedDataCache.h"
+#include <asset/AssetManager.h>
+#include <filesystem/VirtualFileSystem.h>
+#include <filesystem/RawFileSystem.h>
+#include <filesystem/Path.h>
+#include <utility/StringID.h>
+#include <Log.h>
+#include <EASTL/vector.h>
+#include <stdio.h>
+
+namespace
+{
+	struct FileHeader
+	{
+		char m_magicNumber[8] = { 'V', 'E', 'D', 'D', 'C', ' ', ' ', ' ' };
+		uint32_t m_version = 1;
+		uint32_t m_assetCount;
+		uint64_t m_key;
+		uint64_t m_fileSize;
+	};
+
+	// followed by the path (without null terminator) and the data of the asset
+	struct AssetHeader
+	{
+		AssetType m_assetType;
+		uint32_t m_pathLength;
+		uint32_t m_padding;
+		uint64_t m_dataSize;
+	};
+
+	struct CachedAsset
+	{
+		AssetType m_assetType;
+		eastl::string m_path;
+		const char *m_data;
+		uint64_t m_dataSize;
+	};
+}
+
+static void getEntryPath(uint64_t key, char *path) noexcept
+{
+	char currentPath[IFileSystem::k_maxPathLength] = {};
+	RawFileSystem::get().getCurrentPath(currentPath);
+	snprintf(path, IFileSystem::k_maxPathLength, "%s/ddc/%016llx.ddc", currentPath, (unsigned long long)key);
+}
+
+static bool isUpToDate(const char *path, const char *data, uint64_t dataSize) noexcept
+{
+	auto &vfs = VirtualFileSystem::get();
+
+	char metaFilePath[IFileSystem::k_maxPathLength] = "\0";
+	strcat_s(metaFilePath, path);
+	strcat_s(metaFilePath, ".meta");
+
+	if (!vfs.exists(path) || !vfs.exists(metaFilePath) || vfs.size(path) != dataSize)
+	{
+		return false;
+	}
+
+	ScopedFileMapping fileMapping(vfs, path);
+	return fileMapping.isValid() && memcmp(fileMapping.getData(), data, dataSize) == 0;
+}
+
+uint64_t DerivedDataCache::hash(const void *data, size_t size, uint64_t hash) noexcept
+{
+	const uint8_t *bytes = reinterpret_cast<const uint8_t *>(data);
+
+	// FNV-1a on 8 byte words, which is fast enough for large source files. the shift also mixes the high bits of a word into the low bits
+	size_t i = 0;
+	for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+	{
+		uint64_t word;
+		memcpy(&word, bytes + i, sizeof(word));
+		hash = (hash ^ word) * k_fnvPrime;
+		hash ^= hash >> 32;
+	}
+
+	for (; i < size; ++i)
+	{
+		hash = (hash ^ bytes[i]) * k_fnvPrime;
+	}
+
+	return hash;
+}
+
+bool DerivedDataCache::hashSourceFiles(const char *nativeSrcPath, size_t referencedFileCount, const eastl::string *referencedFiles, uint64_t *hash) noexcept
+{
+	auto &rawFs = RawFileSystem::get();
+
+	{
+		ScopedFileMapping fileMapping(rawFs, nativeSrcPath);
+		if (!fileMapping.isValid())
+		{
+			return false;
+		}
+
+		*hash = DerivedDataCache::hash(fileMapping.getData(), fileMapping.getSize(), *hash);
+	}
+
+	for (size_t i = 0; i < referencedFileCount; ++i)
+	{
+		const auto &path = referencedFiles[i];
+		*hash = DerivedDataCache::hash(path.c_str(), path.length(), *hash);
+
+		const uint8_t exists = rawFs.exists(path.c_str()) ? 1 : 0;
+		*hash = DerivedDataCache::hash(&exists, sizeof(exists), *hash);
+		if (!exists)
+		{
+			continue;
+		}
+
+		ScopedFileMapping fileMapping(rawFs, path.c_str());
+		if (!fileMapping.isValid())
+		{
+			return false;
+		}
+
+		*hash = DerivedDataCache::hash(fileMapping.getData(), fileMapping.getSize(), *hash);
+	}
+
+	return true;
+}
+
+bool DerivedDataCache::restore(uint64_t key, const char *sourcePath) noexcept
+{
+	char entryPath[IFileSystem::k_maxPathLength];
+	getEntryPath(key, entryPath);
+
+	auto &rawFs = RawFileSystem::get();
+	if (!rawFs.exists(entryPath))
+	{
+		return false;
+	}
+
+	ScopedFileMapping fileMapping(rawFs, entryPath);
+	const uint64_t fileSize = fileMapping.getSize();
+
+	if (!fileMapping.isValid() || fileSize < sizeof(FileHeader))
+	{
+		return false;
+	}
+
+	const char *data = fileMapping.getData();
+	const auto &header = *reinterpret_cast<const FileHeader *>(data);
+
+	FileHeader defaultHeader{};
+	if (memcmp(header.m_magicNumber, defaultHeader.m_magicNumber, sizeof(defaultHeader.m_magicNumber)) != 0 || header.m_version != defaultHeader.m_version || header.m_key != key || header.m_fileSize != fileSize)
+	{
+		Log::warn("DerivedDataCache: Entry \"%s\" is corrupted or has a wrong version!", entryPath);
+		return false;
+	}
+
+	// validate all assets before writing any files. the sizes are compared against the remaining size one after the other,
+	// so that corrupted sizes can not wrap around
+	eastl::vector<CachedAsset> cachedAssets;
+	cachedAssets.reserve(eastl::min<uint64_t>(header.m_assetCount, (fileSize - sizeof(FileHeader)) / sizeof(AssetHeader)));
+	uint64_t offset = sizeof(FileHeader);
+	for (size_t i = 0; i < header.m_assetCount; ++i)
+	{
+		if (fileSize - offset < sizeof(AssetHeader))
+		{
+			break;
+		}
+
+		const auto &assetHeader = *reinterpret_cast<const AssetHeader *>(data + offset);
+		offset += sizeof(AssetHeader);
+
+		if (fileSize - offset < assetHeader.m_pathLength || fileSize - offset - assetHeader.m_pathLength < assetHeader.m_dataSize)
+		{
+			break;
+		}
+
+		cachedAssets.push_back({ assetHeader.m_assetType, eastl::string(data + offset, assetHeader.m_pathLength), data + offset + assetHeader.m_pathLength, assetHeader.m_dataSize });
+		offset += assetHeader.m_pathLength + assetHeader.m_dataSize;
+	}
+
+	if (cachedAssets.size() != header.m_assetCount || offset != fileSize)
+	{
+		Log::warn("DerivedDataCache: Entry \"%s\" is corrupted!", entryPath);
+		return false;
+	}
+
+	auto *assetMgr = AssetManager::get();
+	auto &vfs = VirtualFileSystem::get();
+
+	for (const auto &cachedAsset : cachedAssets)
+	{
+		// rewriting unchanged files would only trigger hot reloads
+		if (isUpToDate(cachedAsset.m_path.c_str(), cachedAsset.m_data, cachedAsset.m_dataSize))
+		{
+			continue;
+		}
+
+		assetMgr->createAsset(cachedAsset.m_assetType, cachedAsset.m_path.c_str(), sourcePath);
+
+		if (!vfs.writeFile(cachedAsset.m_path.c_str(), static_cast<size_t>(cachedAsset.m_dataSize), cachedAsset.m_data, true))
+		{
+			Log::err("Could not open file \"%s\" for writing imported asset data!", cachedAsset.m_path.c_str());
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void DerivedDataCache::store(uint64_t key, size_t count, const ImportedAsset *importedAssets) noexcept
+{
+	auto &vfs = VirtualFileSystem::get();
+
+	eastl::vector<char> entryData(sizeof(FileHeader));
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const auto &importedAsset = importedAssets[i];
+
+		ScopedFileMapping fileMapping(vfs, importedAsset.m_path.c_str());
+		if (!fileMapping.isValid())
+		{
+			Log::warn("DerivedDataCache: Could not read imported asset \"%s\"!", importedAsset.m_path.c_str());
+			return;
+		}
+
+		AssetHeader assetHeader{ importedAsset.m_assetType, static_cast<uint32_t>(importedAsset.m_path.length()), 0, fileMapping.getSize() };
+		const char *assetHeaderData = reinterpret_cast<const char *>(&assetHeader);
+
+		entryData.insert(entryData.end(), assetHeaderData, assetHeaderData + sizeof(assetHeader));
+		entryData.insert(entryData.end(), importedAsset.m_path.begin(), importedAsset.m_path.end());
+		entryData.insert(entryData.end(), fileMapping.getData(), fileMapping.getData() + fileMapping.getSize());
+	}
+
+	FileHeader header{};
+	header.m_assetCount = static_cast<uint32_t>(count);
+	header.m_key = key;
+	header.m_fileSize = entryData.size();
+	memcpy(entryData.data(), &header, sizeof(header));
+
+	char entryPath[IFileSystem::k_maxPathLength];
+	getEntryPath(key, entryPath);
+
+	auto &rawFs = RawFileSystem::get();
+
+	char directoryPath[IFileSystem::k_maxPathLength] = {};
+	memcpy(directoryPath, entryPath, Path::getParentPath(entryPath));
+	rawFs.createDirectoryHierarchy(directoryPath);
+
+	if (!rawFs.writeFile(entryPath, entryData.size(), entryData.data(), true))
+	{
+		Log::warn("DerivedDataCache: Could not write entry \"%s\"!", entryPath);
+	}
+}
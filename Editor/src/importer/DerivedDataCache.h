@@ -0,0 +1,58 @@
+#pragma once
+#include <stdint.h>
+#include <EASTL/string.h>
+#include <UUID.h>
+
+typedef TUUID AssetType;
+
+/// <summary>
+/// An asset file written by one of the importers.
+/// </summary>
+struct ImportedAsset
+{
+	AssetType m_assetType;
+	eastl::string m_path; // VFS path of the asset data file
+};
+
+/// <summary>
+/// Local cache for the outputs of the asset importers. An entry stores the data files of all assets created by a single import
+/// and is addressed by a key, which is a hash of everything the import depends on: the source files, the import options,
+/// the destination path and the versions of the importers. Re-importing an unchanged source then only copies the cached data
+/// files (and skips files that are already up to date) instead of running the loaders and importers again.
+/// </summary>
+namespace DerivedDataCache
+{
+	/// <summary>
+	/// Hashes a block of memory and combines the result with the given hash.
+	/// </summary>
+	uint64_t hash(const void *data, size_t size, uint64_t hash) noexcept;
+
+	/// <summary>
+	/// Hashes the contents of a native source file and of the files it references (like the buffers of a .gltf file)
+	/// and combines the result with the given hash. Referenced files that do not exist are hashed by their path only,
+	/// so the hash changes once they are created.
+	/// </summary>
+	/// <param name="nativeSrcPath">The native path of the source file.</param>
+	/// <param name="referencedFileCount">The number of referenced files.</param>
+	/// <param name="referencedFiles">The native paths of the referenced files, as resolved by the loader of the source file.</param>
+	/// <param name="hash">[In/Out] The hash to combine with.</param>
+	/// <returns>False if the source file or an existing referenced file could not be read.</returns>
+	bool hashSourceFiles(const char *nativeSrcPath, size_t referencedFileCount, const eastl::string *referencedFiles, uint64_t *hash) noexcept;
+
+	/// <summary>
+	/// Restores the assets of a cache entry by creating their meta files and writing their data files.
+	/// Data files that already hold the cached data are not written again.
+	/// </summary>
+	/// <param name="key">The key of the cache entry.</param>
+	/// <param name="sourcePath">The source path to store in the meta files of the restored assets.</param>
+	/// <returns>True if the entry was found and all of its assets were restored.</returns>
+	bool restore(uint64_t key, const char *sourcePath) noexcept;
+
+	/// <summary>
+	/// Reads the data files of the given imported assets and stores them in a new cache entry.
+	/// </summary>
+	/// <param name="key">The key of the cache entry.</param>
+	/// <param name="count">The number of imported assets.</param>
+	/// <param name="importedAssets">The imported assets.</param>
+	void store(uint64_t key, size_t count, const ImportedAsset *importedAssets) noexcept;
+}
@@ -4,12 +4,16 @@
 #include <asset/AssetManager.h>
 #include <asset/MaterialAsset.h>
 #include <filesystem/VirtualFileSystem.h>
-#include <iomanip>
-#include <sstream>
+#include <filesystem/RawFileSystem.h>
+#include <graphics/Material.h>
+#include <glm/packing.hpp>
+#include <algorithm>
+#include <string>
 #include "loader/LoadedModel.h"
 #include <Log.h>
+#include "DerivedDataCache.h"
 
-bool MaterialImporter::importMaterials(size_t count, LoadedMaterial *materials, const char *baseDstPath, const char *sourcePath, AssetID *resultAssetIDs) noexcept
+bool MaterialImporter::importMaterials(size_t count, LoadedMaterial *materials, const char *baseDstPath, const char *sourcePath, AssetID *resultAssetIDs, eastl::vector<ImportedAsset> *importedAssets) noexcept
 {
 	auto *assetMgr = AssetManager::get();
 	auto &vfs = VirtualFileSystem::get();
@@ -18,22 +22,6 @@ bool MaterialImporter::importMaterials(size_t count, LoadedMaterial *materials,
 	{
 		const auto &mat = materials[i];
 
-		nlohmann::json j;
-		j["name"] = mat.m_name.c_str();
-		j["alphaMode"] = (int)mat.m_alpha;
-		j["albedo"] = { mat.m_albedoFactor[0], mat.m_albedoFactor[1], mat.m_albedoFactor[2] };
-		j["metalness"] = mat.m_metalnessFactor;
-		j["roughness"] = mat.m_roughnessFactor;
-		j["emissive"] = { mat.m_emissiveFactor[0], mat.m_emissiveFactor[1], mat.m_emissiveFactor[2] };
-		j["opacity"] = mat.m_opacity;
-		j["albedoTexture"] = mat.m_albedoTexture.c_str();
-		j["normalTexture"] = mat.m_normalTexture.c_str();
-		j["metalnessTexture"] = mat.m_metalnessTexture.c_str();
-		j["roughnessTexture"] = mat.m_roughnessTexture.c_str();
-		j["occlusionTexture"] = mat.m_occlusionTexture.c_str();
-		j["emissiveTexture"] = mat.m_emissiveTexture.c_str();
-		j["displacementTexture"] = mat.m_displacementTexture.c_str();
-
 		std::string cleanedName = mat.m_name.c_str();
 		cleanedName.erase(std::remove_if(cleanedName.begin(), cleanedName.end(), [](auto c)
 			{
@@ -56,17 +44,47 @@ bool MaterialImporter::importMaterials(size_t count, LoadedMaterial *materials,
 
 		std::string dstPath = count > 1 ? (std::string(baseDstPath) + "_" + cleanedName + ".mat") : std::string(baseDstPath) + ".mat";
 	
-		std::stringstream fileData;
-		fileData << std::setw(4) << j << std::endl;
-		auto fileDataStr = fileData.str();
+		// the asset IDs of the textures are stored in the string table after the header
+		MaterialAsset::FileHeader header{};
+		eastl::string stringTable;
+
+		const eastl::string *textures[] = { &mat.m_albedoTexture, &mat.m_normalTexture, &mat.m_metalnessTexture, &mat.m_roughnessTexture, &mat.m_occlusionTexture, &mat.m_emissiveTexture, &mat.m_displacementTexture };
+		static_assert(eastl::size(textures) == MaterialAsset::k_textureCount);
+
+		for (size_t j = 0; j < MaterialAsset::k_textureCount; ++j)
+		{
+			header.m_textureAssetIDOffsets[j] = MaterialAsset::k_noTexture;
+
+			if (!textures[j]->empty())
+			{
+				header.m_textureAssetIDOffsets[j] = static_cast<uint32_t>(stringTable.size());
+				stringTable.append(textures[j]->c_str(), textures[j]->size() + 1); // include the null terminator
+			}
+		}
+
+		header.m_alphaMode = static_cast<uint32_t>(mat.m_alpha == LoadedMaterial::Alpha::OPAQUE ? MaterialAlphaMode::Opaque : mat.m_alpha == LoadedMaterial::Alpha::MASKED ? MaterialAlphaMode::Mask : MaterialAlphaMode::Blended);
+		header.m_albedoFactor = glm::packUnorm4x8(glm::vec4(mat.m_albedoFactor, 1.0f));
+		header.m_metalnessFactor = mat.m_metalnessFactor;
+		header.m_roughnessFactor = mat.m_roughnessFactor;
+		header.m_emissiveFactor[0] = mat.m_emissiveFactor[0];
+		header.m_emissiveFactor[1] = mat.m_emissiveFactor[1];
+		header.m_emissiveFactor[2] = mat.m_emissiveFactor[2];
+		header.m_stringTableSize = static_cast<uint32_t>(stringTable.size());
+		header.m_fileSize = static_cast<uint32_t>(sizeof(header) + stringTable.size());
 
 		auto assetID = assetMgr->createAsset(MaterialAsset::k_assetType, dstPath.c_str(), sourcePath);
 		resultAssetIDs[i] = assetID;
 
 		if (FileHandle fh = vfs.open(dstPath.c_str(), FileMode::WRITE, true))
 		{
-			vfs.write(fh, fileDataStr.length(), fileDataStr.c_str());
+			vfs.write(fh, sizeof(header), &header);
+			vfs.write(fh, stringTable.size(), stringTable.data());
 			vfs.close(fh);
+
+			if (importedAssets)
+			{
+				importedAssets->push_back({ MaterialAsset::k_assetType, dstPath.c_str() });
+			}
 		}
 		else
 		{
@@ -76,3 +94,63 @@ bool MaterialImporter::importMaterials(size_t count, LoadedMaterial *materials,
 	}
 	return true;
 }
+
+bool MaterialImporter::loadMaterialJSON(const char *nativeSrcPath, LoadedMaterial *material) noexcept
+{
+	ScopedFileMapping fileMapping(RawFileSystem::get(), nativeSrcPath);
+	if (!fileMapping.isValid())
+	{
+		Log::err("MaterialImporter: Could not open material file \"%s\"!", nativeSrcPath);
+		return false;
+	}
+
+	nlohmann::json j = nlohmann::json::parse(fileMapping.getData(), fileMapping.getData() + fileMapping.getSize(), nullptr, false);
+	if (!j.is_object())
+	{
+		Log::err("MaterialImporter: Material file \"%s\" is not a valid JSON object!", nativeSrcPath);
+		return false;
+	}
+
+	// missing or malformed values are replaced by defaults
+	auto getFloat = [&](const char *key, float defaultValue)
+	{
+		auto it = j.find(key);
+		return it != j.end() && it->is_number() ? it->get<float>() : defaultValue;
+	};
+
+	auto getVec3 = [&](const char *key, const glm::vec3 &defaultValue)
+	{
+		auto it = j.find(key);
+		if (it == j.end() || !it->is_array() || it->size() != 3 || !(*it)[0].is_number() || !(*it)[1].is_number() || !(*it)[2].is_number())
+		{
+			return defaultValue;
+		}
+		return glm::vec3((*it)[0].get<float>(), (*it)[1].get<float>(), (*it)[2].get<float>());
+	};
+
+	auto getString = [&](const char *key)
+	{
+		auto it = j.find(key);
+		return it != j.end() && it->is_string() ? eastl::string(it->get_ref<const std::string &>().c_str()) : eastl::string();
+	};
+
+	auto alphaIt = j.find("alphaMode");
+	const int alphaMode = alphaIt != j.end() && alphaIt->is_number_integer() ? alphaIt->get<int>() : 0;
+
+	material->m_name = getString("name");
+	material->m_alpha = alphaMode == 1 ? LoadedMaterial::Alpha::MASKED : alphaMode == 2 ? LoadedMaterial::Alpha::BLENDED : LoadedMaterial::Alpha::OPAQUE;
+	material->m_albedoFactor = getVec3("albedo", glm::vec3(1.0f));
+	material->m_metalnessFactor = getFloat("metalness", 0.0f);
+	material->m_roughnessFactor = getFloat("roughness", 1.0f);
+	material->m_emissiveFactor = getVec3("emissive", glm::vec3(0.0f));
+	material->m_opacity = getFloat("opacity", 1.0f);
+	material->m_albedoTexture = getString("albedoTexture");
+	material->m_normalTexture = getString("normalTexture");
+	material->m_metalnessTexture = getString("metalnessTexture");
+	material->m_roughnessTexture = getString("roughnessTexture");
+	material->m_occlusionTexture = getString("occlusionTexture");
+	material->m_emissiveTexture = getString("emissiveTexture");
+	material->m_displacementTexture = getString("displacementTexture");
+
+	return true;
+}
@@ -1,10 +1,26 @@
 #pragma once
+#include <stdint.h>
+#include <EASTL/vector.h>
 
+struct ImportedAsset;
 struct LoadedMaterial;
 struct StringID;
 typedef StringID AssetID;
 
 namespace MaterialImporter
 {
-	bool importMaterials(size_t count, LoadedMaterial *materials, const char *baseDstPath, const char *sourcePath, AssetID *resultAssetIDs) noexcept;
+	// increment when the output of the importer changes to invalidate the DerivedDataCache
+	constexpr uint32_t k_version = 2;
+
+	/// <summary>
+	/// Writes the materials as binary material assets.
+	/// </summary>
+	bool importMaterials(size_t count, LoadedMaterial *materials, const char *baseDstPath, const char *sourcePath, AssetID *resultAssetIDs, eastl::vector<ImportedAsset> *importedAssets = nullptr) noexcept;
+
+	/// <summary>
+	/// Reads a material from a JSON file, the editable source format of materials. The keys are "name", "alphaMode" (0 = opaque,
+	/// 1 = masked, 2 = blended), "albedo", "metalness", "roughness", "emissive", "opacity" and the asset IDs of the textures
+	/// "albedoTexture", "normalTexture", "metalnessTexture", "roughnessTexture", "occlusionTexture", "emissiveTexture" and "displacementTexture".
+	/// </summary>
+	bool loadMaterialJSON(const char *nativeSrcPath, LoadedMaterial *material) noexcept;
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <asset/MeshAsset.h>
 #include <filesystem/VirtualFileSystem.h>
 #include <Log.h>
+#include "DerivedDataCache.h"
 #include "loader/LoadedModel.h"
 #include "meshoptimizer/meshoptimizer.h"
 #include "mikktspace.h"
@@ -273,7 +274,7 @@ static bool cookPhysicsMeshes(
 	return true;
 }
 
-bool MeshImporter::importMeshes(size_t count, LoadedModel *models, const char *baseDstPath, const char *sourcePath, Physics *physics, const AssetID *materialAssetIDs, bool cookConvexPhysicsMesh, bool cookTrianglePhysicsMesh) noexcept
+bool MeshImporter::importMeshes(size_t count, LoadedModel *models, const char *baseDstPath, const char *sourcePath, Physics *physics, const AssetID *materialAssetIDs, bool cookConvexPhysicsMesh, bool cookTrianglePhysicsMesh, eastl::vector<ImportedAsset> *importedAssets) noexcept
 {
 	SMikkTSpaceInterface mikkTSpaceInterface = {};
 	mikkTSpaceInterface.m_getNumFaces = mikktGetNumFaces;
@@ -585,6 +586,11 @@ bool MeshImporter::importMeshes(size_t count, LoadedModel *models, const char *b
 			vfs.write(fh, dataSegment.size(), dataSegment.data());
 
 			vfs.close(fh);
+
+			if (importedAssets)
+			{
+				importedAssets->push_back({ MeshAsset::k_assetType, dstPath.c_str() });
+			}
 		}
 		else
 		{
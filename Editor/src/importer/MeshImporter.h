@@ -1,5 +1,8 @@
 #pragma once
+#include <stdint.h>
+#include <EASTL/vector.h>
 
+struct ImportedAsset;
 struct LoadedModel;
 struct StringID;
 typedef StringID AssetID;
@@ -7,5 +10,8 @@ class Physics;
 
 namespace MeshImporter
 {
-	bool importMeshes(size_t count, LoadedModel *models, const char *baseDstPath, const char *sourcePath, Physics *physics, const AssetID *materialAssetIDs, bool cookConvexPhysicsMesh, bool cookTrianglePhysicsMesh) noexcept;
+	// increment when the output of the importer changes to invalidate the DerivedDataCache
+	constexpr uint32_t k_version = 1;
+
+	bool importMeshes(size_t count, LoadedModel *models, const char *baseDstPath, const char *sourcePath, Physics *physics, const AssetID *materialAssetIDs, bool cookConvexPhysicsMesh, bool cookTrianglePhysicsMesh, eastl::vector<ImportedAsset> *importedAssets = nullptr) noexcept;
 }
\ No newline at end of file
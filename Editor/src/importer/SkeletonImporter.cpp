@@ -3,10 +3,11 @@
 #include <asset/SkeletonAsset.h>
 #include <filesystem/VirtualFileSystem.h>
 #include <Log.h>
+#include "DerivedDataCache.h"
 #include <EASTL/string.h>
 #include "loader/LoadedModel.h"
 
-bool SkeletonImporter::importSkeletons(size_t count, const LoadedSkeleton *skeletons, const char *baseDstPath, const char *sourcePath) noexcept
+bool SkeletonImporter::importSkeletons(size_t count, const LoadedSkeleton *skeletons, const char *baseDstPath, const char *sourcePath, eastl::vector<ImportedAsset> *importedAssets) noexcept
 {
 	auto *assetMgr = AssetManager::get();
 	auto &vfs = VirtualFileSystem::get();
@@ -61,6 +62,11 @@ bool SkeletonImporter::importSkeletons(size_t count, const LoadedSkeleton *skele
 			}
 
 			vfs.close(fh);
+
+			if (importedAssets)
+			{
+				importedAssets->push_back({ SkeletonAsset::k_assetType, dstPath.c_str() });
+			}
 		}
 		else
 		{
@@ -1,8 +1,14 @@
 #pragma once
+#include <stdint.h>
+#include <EASTL/vector.h>
 
+struct ImportedAsset;
 struct LoadedSkeleton;
 
 namespace SkeletonImporter
 {
-	bool importSkeletons(size_t count, const LoadedSkeleton *skeletons, const char *baseDstPath, const char *sourcePath) noexcept;
+	// increment when the output of the importer changes to invalidate the DerivedDataCache
+	constexpr uint32_t k_version = 1;
+
+	bool importSkeletons(size_t count, const LoadedSkeleton *skeletons, const char *baseDstPath, const char *sourcePath, eastl::vector<ImportedAsset> *importedAssets = nullptr) noexcept;
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "GLTFLoader.h"
 #include <nlohmann/json.hpp>
+#include <filesystem/RawFileSystem.h>
 #include <Log.h>
 #include <glm/mat4x4.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -955,3 +956,34 @@ bool GLTFLoader::loadModel(const char *filepath, bool mergeByMaterial, bool inve
 
 	return true;
 }
+
+void GLTFLoader::getReferencedFiles(const char *filepath, eastl::vector<eastl::string> *paths)
+{
+	ScopedFileMapping fileMapping(RawFileSystem::get(), filepath);
+	if (!fileMapping.isValid())
+	{
+		return;
+	}
+
+	nlohmann::json j = nlohmann::json::parse(fileMapping.getData(), fileMapping.getData() + fileMapping.getSize(), nullptr, false);
+	if (!j.is_object() || !j.contains("buffers") || !j["buffers"].is_array())
+	{
+		return;
+	}
+
+	// resolve the URIs like tinygltf does for external buffers. external images are not loaded
+	const std::string baseDir = tinygltf::GetBaseDir(filepath);
+	for (const auto &buffer : j["buffers"])
+	{
+		if (!buffer.is_object() || !buffer.contains("uri") || !buffer["uri"].is_string())
+		{
+			continue;
+		}
+
+		const std::string &uri = buffer["uri"].get_ref<const std::string &>();
+		if (!tinygltf::IsDataURI(uri))
+		{
+			paths->push_back(tinygltf::JoinPath(baseDir, tinygltf::dlib::urldecode(uri)).c_str());
+		}
+	}
+}
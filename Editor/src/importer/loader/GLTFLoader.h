@@ -4,4 +4,7 @@
 namespace GLTFLoader
 {
 	bool loadModel(const char *filepath, bool mergeByMaterial, bool invertTexcoordY, bool importMeshes, bool importSkeletons, bool importAnimations, float scale, LoadedModel &model);
+
+	// gets the native paths of the external buffers loaded by loadModel()
+	void getReferencedFiles(const char *filepath, eastl::vector<eastl::string> *paths);
 };
\ No newline at end of file
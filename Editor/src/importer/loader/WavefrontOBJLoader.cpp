@@ -7,6 +7,7 @@
 #include <EASTL/hash_set.h>
 #include <glm/geometric.hpp>
 #include <filesystem>
+#include <filesystem/RawFileSystem.h>
 #include <Log.h>
 
 //namespace
@@ -248,4 +249,58 @@ bool WavefrontOBJLoader::loadModel(const char *filepath, bool mergeByMaterial, b
 	}
 
 	return true;
-}
\ No newline at end of file
+}
+
+void WavefrontOBJLoader::getReferencedFiles(const char *filepath, eastl::vector<eastl::string> *paths)
+{
+	ScopedFileMapping fileMapping(RawFileSystem::get(), filepath);
+	if (!fileMapping.isValid())
+	{
+		return;
+	}
+
+	std::filesystem::path baseDir(filepath);
+	baseDir.remove_filename();
+	const std::string baseDirString = baseDir.u8string();
+
+	const char *data = fileMapping.getData();
+	const size_t size = static_cast<size_t>(fileMapping.getSize());
+
+	for (size_t lineStart = 0; lineStart < size;)
+	{
+		size_t lineEnd = lineStart;
+		while (lineEnd < size && data[lineEnd] != '\n' && data[lineEnd] != '\r')
+		{
+			++lineEnd;
+		}
+
+		const std::string line(data + lineStart, lineEnd - lineStart);
+		lineStart = lineEnd + 1;
+
+		// parse mtllib lines like tinyobj, which loads the first of the listed files that can be opened
+		const size_t tokenStart = line.find_first_not_of(" \t");
+		if (tokenStart == std::string::npos || line.compare(tokenStart, 6, "mtllib") != 0 || line.length() <= tokenStart + 6 || (line[tokenStart + 6] != ' ' && line[tokenStart + 6] != '\t'))
+		{
+			continue;
+		}
+
+		size_t nameStart = tokenStart + 7;
+		while (nameStart < line.length())
+		{
+			size_t nameEnd = line.find(' ', nameStart);
+			nameEnd = nameEnd == std::string::npos ? line.length() : nameEnd;
+
+			if (nameEnd > nameStart)
+			{
+				const std::string path = baseDirString + line.substr(nameStart, nameEnd - nameStart);
+				paths->push_back(path.c_str());
+				if (RawFileSystem::get().exists(path.c_str()))
+				{
+					break;
+				}
+			}
+
+			nameStart = nameEnd + 1;
+		}
+	}
+}
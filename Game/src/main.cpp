@@ -34,6 +34,7 @@
 #include <filesystem/Path.h>
 #include <profiling/Profiling.h>
 #include <TransformHierarchy.h>
+#include <WorldPartition.h>
 
 //static AnimationGraph *setupAnimationGraph()
 //{
@@ -227,6 +228,7 @@ public:
 		}
 
 		// ground plane
+		EntityID groundPlaneEntity = {};
 		{
 			TransformComponent transC{};
 
@@ -235,7 +237,14 @@ public:
 			physicsC.m_physicsShapeType = PhysicsShapeType::PLANE;
 			//physicsC.m_materialHandle = m_physicsMaterial;
 
-			auto entity = m_engine->getECS()->createEntity<EntityMetaComponent, TransformComponent, PhysicsComponent>(EntityMetaComponent("Ground Plane"), transC, physicsC);
+			groundPlaneEntity = m_engine->getECS()->createEntity<EntityMetaComponent, TransformComponent, PhysicsComponent>(EntityMetaComponent("Ground Plane"), transC, physicsC);
+		}
+
+		// the level is streamed in from cell files, which are written from the entities created below on the first start
+		m_worldPartition = new WorldPartition(m_engine->getECS());
+		if (WorldPartition::exists(k_levelPath) && m_worldPartition->open(k_levelPath))
+		{
+			return;
 		}
 
 		// sponza
@@ -463,6 +472,35 @@ public:
 			auto entity = m_engine->getECS()->createEntity<EntityMetaComponent, TransformComponent, IrradianceVolumeComponent>(EntityMetaComponent("Irradiance Volume"), transC, volumeC);
 			TransformHierarchy::attach(m_engine->getECS(), entity, sponzaEntity, true);
 		}
+
+		// write the level into cells and replace its entities with the streamed ones
+		{
+			auto *ecs = m_engine->getECS();
+			const EntityID excludedEntities[] = { m_cameraEntity, m_playerEntity, groundPlaneEntity };
+
+			if (WorldPartition::build(ecs, k_levelPath, k_levelCellSize, eastl::size(excludedEntities), excludedEntities))
+			{
+				eastl::vector<EntityID> levelEntities;
+				ecs->iterateTypeless(0, nullptr, [&](size_t count, const EntityID *entities, void **)
+					{
+						for (size_t i = 0; i < count; ++i)
+						{
+							if (eastl::find(eastl::begin(excludedEntities), eastl::end(excludedEntities), entities[i]) == eastl::end(excludedEntities))
+							{
+								levelEntities.push_back(entities[i]);
+							}
+						}
+					});
+
+				for (EntityID entity : levelEntities)
+				{
+					TransformHierarchy::detach(ecs, entity, true);
+					ecs->destroyEntity(entity);
+				}
+
+				m_worldPartition->open(k_levelPath);
+			}
+		}
 	}
 
 	void setPlaying(bool playing) noexcept override
@@ -474,6 +512,14 @@ public:
 	{
 		PROFILING_ZONE_SCOPED;
 
+		// the level is streamed around the player while playing and around the editor camera otherwise
+		const EntityID streamingCenterEntity = m_playing ? m_playerEntity : m_engine->getCameraEntity();
+		auto *ecs = m_engine->getECS();
+		if (const auto *streamingCenterTc = ecs->isValid(streamingCenterEntity) ? ecs->getComponent<TransformComponent>(streamingCenterEntity) : nullptr)
+		{
+			m_worldPartition->update(streamingCenterTc->m_globalTransform.m_translation);
+		}
+
 		if (m_playing)
 		{
 			m_engine->setCameraEntity(m_cameraEntity);
@@ -518,6 +564,9 @@ public:
 		//	m_engine->getECS()->destroyEntity(n->m_entity);
 		//}
 
+		delete m_worldPartition;
+		m_worldPartition = nullptr;
+
 		m_engine->getECS()->clear();
 
 		delete m_fpsCameraController;
@@ -532,7 +581,11 @@ public:
 	}
 
 private:
+	static constexpr const char *k_levelPath = "/levels/sponza";
+	static constexpr float k_levelCellSize = 16.0f;
+
 	Engine *m_engine = nullptr;
+	WorldPartition *m_worldPartition = nullptr;
 	FPSCameraController *m_fpsCameraController = nullptr;
 	ThirdPersonCameraController *m_thirdPersonCameraController = nullptr;
 	Asset<MeshAsset> m_meshAsset;
@@ -10,6 +10,9 @@
 #include "graphics/imgui/ImGuizmo.h"
 #include "input/ImGuiInputAdapter.h"
 #include "asset/AssetManager.h"
+#include "asset/TextureAsset.h"
+#include "asset/MeshAsset.h"
+#include "asset/AnimationClipAsset.h"
 #include "utility/Utility.h"
 #include "IGameLogic.h"
 #include "ecs/ECS.h"
@@ -22,8 +25,12 @@
 #include "CharacterMovementSystem.h"
 #include "filesystem/RawFileSystem.h"
 #include "filesystem/VirtualFileSystem.h"
+#include "filesystem/PackFile.h"
 #include "profiling/Profiling.h"
 #include "utility/allocator/DefaultAllocator.h"
+#include "utility/allocator/ScratchAllocator.h"
+#include "utility/allocator/AllocatorRegistry.h"
+#include "utility/allocator/AllocationTrace.h"
 #include "script/ScriptSystem.h"
 #include "job/JobSystem.h"
 
@@ -34,12 +41,12 @@ extern bool g_sharpenEnabled;
 
 void *__cdecl operator new[](size_t size, const char *name, int flags, unsigned debugFlags, const char *file, int line)
 {
-	return new uint8_t[size];
+	return DefaultAllocator::get()->allocate(size, flags);
 }
 
 void *__cdecl operator new[](size_t size, size_t alignment, size_t alignmentOffset, const char *pName, int flags, unsigned debugFlags, const char *file, int line)
 {
-	return new uint8_t[size];
+	return DefaultAllocator::get()->allocate(size, alignment, alignmentOffset, flags);
 }
 
 namespace EA
@@ -59,20 +66,43 @@ int Engine::start(int argc, char *argv[], IGameLogic *gameLogic) noexcept
 
 	FileDialog::initializeCOM();
 
-	// set VFS mount points
+	// set VFS mount points. pack files are mounted first, so that loose files take precedence over packed ones
 	{
 		char currentPath[IFileSystem::k_maxPathLength] = {};
 
+		RawFileSystem::get().getCurrentPath(currentPath);
+		strcat_s(currentPath, "/assets.vpak");
+		if (RawFileSystem::get().exists(currentPath))
+		{
+			VirtualFileSystem::get().mountPackFile(currentPath, "assets");
+		}
+
+		RawFileSystem::get().getCurrentPath(currentPath);
+		strcat_s(currentPath, "/levels.vpak");
+		const bool levelsPacked = RawFileSystem::get().exists(currentPath);
+		if (levelsPacked)
+		{
+			VirtualFileSystem::get().mountPackFile(currentPath, "levels");
+		}
+
+		// missing directories are not mounted
 		RawFileSystem::get().getCurrentPath(currentPath);
 		strcat_s(currentPath, "/assets");
 		VirtualFileSystem::get().mount(currentPath, "assets");
 
+		// without packed levels, levels are built into the loose directory, so it is created if needed
 		RawFileSystem::get().getCurrentPath(currentPath);
 		strcat_s(currentPath, "/levels");
+		if (!levelsPacked && !RawFileSystem::get().exists(currentPath))
+		{
+			RawFileSystem::get().createDirectoryHierarchy(currentPath);
+		}
 		VirtualFileSystem::get().mount(currentPath, "levels");
 	}
 
 	job::init();
+	// scratch memory is committed on demand, so the capacities only cost address space
+	scratch::init(64 * 1024 * 1024, 256 * 1024 * 1024);
 
 	m_gameLogic = gameLogic;
 	Window window(1600, 900, Window::WindowMode::WINDOWED, "VEngine 2");
@@ -121,6 +151,11 @@ int Engine::start(int argc, char *argv[], IGameLogic *gameLogic) noexcept
 
 	AssetHandlerRegistration::createAndRegisterHandlers(m_renderer, m_physics);
 
+	// keep recently released assets loaded, so that respawned entities do not need to load them again
+	AssetManager::get()->setCacheBudget(TextureAsset::k_assetType, 512ull * 1024 * 1024);
+	AssetManager::get()->setCacheBudget(MeshAsset::k_assetType, 256ull * 1024 * 1024);
+	AssetManager::get()->setCacheBudget(AnimationClipAsset::k_assetType, 64ull * 1024 * 1024);
+
 	ImGuiInputAdapter imguiInputAdapter(ImGui::GetCurrentContext(), *m_userInput, *m_window);
 	imguiInputAdapter.resize(m_window->getWidth(), m_window->getHeight(), m_window->getWindowWidth(), m_window->getWindowHeight());
 
@@ -139,9 +174,17 @@ int Engine::start(int argc, char *argv[], IGameLogic *gameLogic) noexcept
 	{
 		PROFILING_FRAME_MARK;
 
+		scratch::beginFrame();
+
 		timer.update();
 		float timeDelta = fminf(0.5f, static_cast<float>(timer.getTimeDelta()));
 
+		AllocatorRegistry::update(static_cast<float>(timer.getTimeDelta()));
+		AllocationTraceRecorder::markFrame();
+
+		// reload assets whose files changed
+		AssetManager::get()->update();
+
 		accumulator += timeDelta;
 		while (accumulator >= k_stepSize)
 		{
@@ -174,6 +217,80 @@ int Engine::start(int argc, char *argv[], IGameLogic *gameLogic) noexcept
 			{
 				ImGui::Checkbox("TAA", &g_taaEnabled);
 				ImGui::Checkbox("Sharpen", &g_sharpenEnabled);
+
+				if (ImGui::CollapsingHeader("Memory"))
+				{
+					constexpr size_t k_maxSnapshots = 256;
+					AllocatorStatsSnapshot snapshots[k_maxSnapshots];
+					size_t snapshotCount = AllocatorRegistry::getSnapshots(k_maxSnapshots, snapshots);
+					snapshotCount = snapshotCount < k_maxSnapshots ? snapshotCount : k_maxSnapshots;
+
+					// traces can be replayed with the allocator benchmark
+					if (!AllocationTraceRecorder::isRecording())
+					{
+						if (ImGui::Button("Record Allocation Trace"))
+						{
+							AllocationTraceRecorder::begin();
+						}
+					}
+					else if (ImGui::Button("Save Allocation Trace"))
+					{
+						AllocationTraceRecorder::end("allocation_trace.vat");
+					}
+
+					if (ImGui::BeginTable("##Allocators", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable))
+					{
+						ImGui::TableSetupColumn("Allocator");
+						ImGui::TableSetupColumn("Subsystem");
+						ImGui::TableSetupColumn("Live KiB");
+						ImGui::TableSetupColumn("Peak KiB");
+						ImGui::TableSetupColumn("Live Allocations");
+						ImGui::TableSetupColumn("Allocations/s");
+						ImGui::TableHeadersRow();
+
+						for (size_t i = 0; i < snapshotCount; ++i)
+						{
+							const auto &s = snapshots[i];
+							ImGui::TableNextRow();
+							ImGui::TableNextColumn();
+							ImGui::TextUnformatted(s.m_name ? s.m_name : "<unnamed>");
+							ImGui::TableNextColumn();
+							ImGui::TextUnformatted(s.m_subsystem ? s.m_subsystem : "");
+							ImGui::TableNextColumn();
+							ImGui::Text("%.1f", s.m_liveBytes / 1024.0);
+							ImGui::TableNextColumn();
+							ImGui::Text("%.1f", s.m_peakBytes / 1024.0);
+							ImGui::TableNextColumn();
+							ImGui::Text("%llu", (unsigned long long)s.m_liveAllocationCount);
+							ImGui::TableNextColumn();
+							ImGui::Text("%.0f", s.m_allocationsPerSecond);
+						}
+
+						ImGui::EndTable();
+					}
+				}
+
+				if (ImGui::CollapsingHeader("Pack Files"))
+				{
+					// the packs are picked up on the next start
+					if (ImGui::Button("Build Pack Files"))
+					{
+						char sourcePath[IFileSystem::k_maxPathLength] = {};
+						char packPath[IFileSystem::k_maxPathLength] = {};
+						const char *directories[] = { "assets", "levels" };
+
+						for (const char *dir : directories)
+						{
+							RawFileSystem::get().getCurrentPath(sourcePath);
+							strcat_s(sourcePath, "/");
+							strcat_s(sourcePath, dir);
+							strcpy_s(packPath, sourcePath);
+							strcat_s(packPath, ".vpak");
+							PackFile::write(sourcePath, packPath, true);
+						}
+					}
+				}
+
 				//if (ImGui::Button("Save"))
 				//{
 				//	Log::info("Saving level...");
@@ -245,6 +362,7 @@ int Engine::start(int argc, char *argv[], IGameLogic *gameLogic) noexcept
 	delete m_ecs;
 	m_window = nullptr;
 
+	scratch::shutdown();
 	job::shutdown();
 
 	return 0;
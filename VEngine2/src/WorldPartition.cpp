@@ -0,0 +1,843 @@
+#include "WorldPartition.h"
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+#include <chrono>
+#include <EASTL/sort.h>
+#include <EASTL/fixed_vector.h>
+#include "ecs/ECS.h"
+#include "ecs/ECSComponentInfoTable.h"
+#include "component/TransformComponent.h"
+#include "TransformHierarchy.h"
+#include "filesystem/VirtualFileSystem.h"
+#include "job/JobSystem.h"
+#include "utility/Serialization.h"
+#include "utility/Thread.h"
+#include "profiling/Profiling.h"
+#include "Log.h"
+
+namespace
+{
+	// followed by m_cellCount CellInfo
+	struct LevelFileHeader
+	{
+		char m_magicNumber[8] = { 'V', 'E', 'L', 'E', 'V', 'E', 'L', ' ' };
+		uint32_t m_version = 2;
+		uint32_t m_cellCount;
+		uint64_t m_fileSize;
+		float m_cellSize;
+		uint32_t m_padding;
+	};
+
+	struct CellInfo
+	{
+		int32_t m_x;
+		int32_t m_z;
+		uint32_t m_entityCount;
+		uint32_t m_global;
+	};
+
+	// followed by the entities. each entity starts with the index of the cell of its parent, the index of its parent within that cell
+	// (UINT32_MAX for roots) and its component count, followed by the name (with null terminator) and the serialized data of each component,
+	// both prefixed with their size. parents in the same cell always come before their children. entities whose parent is in a different
+	// cell are stored with their global transform.
+	struct CellFileHeader
+	{
+		char m_magicNumber[8] = { 'V', 'E', 'C', 'E', 'L', 'L', ' ', ' ' };
+		uint32_t m_version = 2;
+		uint32_t m_entityCount;
+		uint64_t m_fileSize;
+	};
+
+	struct BuildCell
+	{
+		uint32_t m_index = 0;
+		CellInfo m_info = {};
+		SerializationWriteStream m_stream;
+	};
+
+	struct BuildContext
+	{
+		ECS *m_ecs;
+		float m_cellSize;
+		size_t m_excludedEntityCount;
+		const EntityID *m_excludedEntities;
+		BuildCell m_globalCell;
+		eastl::hash_map<uint64_t, BuildCell> m_cells;
+		uint32_t m_cellCount = 1; // the global cell is always the first cell
+	};
+}
+
+static constexpr uint32_t k_noParentIndex = UINT32_MAX;
+
+static uint64_t getTimestamp() noexcept
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+static bool serializeEntity(ECS *ecs, EntityID entity, uint32_t parentCellIndex, uint32_t parentIndex, SerializationWriteStream &stream) noexcept
+{
+	eastl::fixed_vector<ComponentID, k_ecsMaxComponentTypes> componentIDs;
+	forEachComponentType(ecs->getComponentMask(entity), [&](size_t, ComponentID componentID)
+		{
+			const auto &info = ECSComponentInfoTable::getComponentInfo(componentID);
+			if (info.m_onSerialize && info.m_name)
+			{
+				componentIDs.push_back(componentID);
+			}
+		});
+
+	uint32_t componentCount = static_cast<uint32_t>(componentIDs.size());
+	serializeUInt32(stream, parentCellIndex);
+	serializeUInt32(stream, parentIndex);
+	serializeUInt32(stream, componentCount);
+
+	for (ComponentID componentID : componentIDs)
+	{
+		const auto &info = ECSComponentInfoTable::getComponentInfo(componentID);
+
+		SerializationWriteStream componentStream;
+		if (!info.m_onSerialize(ecs, entity, ecs->getComponentTypeless(entity, componentID), componentStream))
+		{
+			Log::warn("WorldPartition: Failed to serialize component \"%s\" of entity %llu!", info.m_name, (unsigned long long)entity);
+			return false;
+		}
+
+		uint32_t nameLength = static_cast<uint32_t>(strlen(info.m_name) + 1);
+		uint32_t dataSize = static_cast<uint32_t>(componentStream.getData().size());
+		serializeUInt32(stream, nameLength);
+		serializeBytes(stream, nameLength, info.m_name);
+		serializeUInt32(stream, dataSize);
+		serializeBytes(stream, dataSize, componentStream.getData().data());
+	}
+
+	return true;
+}
+
+static bool isExcluded(EntityID entity, size_t excludedEntityCount, const EntityID *excludedEntities) noexcept
+{
+	return eastl::find(excludedEntities, excludedEntities + excludedEntityCount, entity) != excludedEntities + excludedEntityCount;
+}
+
+// entities without a TransformComponent go into the global cell
+static BuildCell &getBuildCell(BuildContext &context, const TransformComponent *tc) noexcept
+{
+	if (!tc)
+	{
+		return context.m_globalCell;
+	}
+
+	const int32_t x = static_cast<int32_t>(floorf(tc->m_globalTransform.m_translation.x / context.m_cellSize));
+	const int32_t z = static_cast<int32_t>(floorf(tc->m_globalTransform.m_translation.z / context.m_cellSize));
+	const uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(z);
+
+	auto it = context.m_cells.find(key);
+	if (it == context.m_cells.end())
+	{
+		it = context.m_cells.insert(key).first;
+		it->second.m_index = context.m_cellCount++;
+		it->second.m_info.m_x = x;
+		it->second.m_info.m_z = z;
+	}
+
+	return it->second;
+}
+
+// writes the entity into the cell containing its global translation and all its children depth first
+static bool serializeHierarchy(BuildContext &context, EntityID entity, const BuildCell *parentCell, uint32_t parentIndex) noexcept
+{
+	ECS *ecs = context.m_ecs;
+	auto *tc = ecs->getComponent<TransformComponent>(entity);
+	BuildCell &cell = getBuildCell(context, tc);
+
+	const uint32_t entityIndex = cell.m_info.m_entityCount++;
+	const uint32_t parentCellIndex = parentCell ? parentCell->m_index : cell.m_index;
+
+	bool serialized = false;
+	if (parentCell && parentCell != &cell)
+	{
+		// the entity is created as a root until the cell of its parent is loaded, so it is stored with its global transform
+		const Transform localTransform = tc->m_transform;
+		tc->m_transform = tc->m_globalTransform;
+		serialized = serializeEntity(ecs, entity, parentCellIndex, parentIndex, cell.m_stream);
+		tc->m_transform = localTransform;
+	}
+	else
+	{
+		serialized = serializeEntity(ecs, entity, parentCellIndex, parentIndex, cell.m_stream);
+	}
+
+	if (!serialized)
+	{
+		return false;
+	}
+
+	if (tc)
+	{
+		for (auto childEntity = tc->m_childEntity; childEntity != k_nullEntity; childEntity = TransformHierarchy::getNextSibling(ecs, childEntity))
+		{
+			if (!isExcluded(childEntity, context.m_excludedEntityCount, context.m_excludedEntities) && !serializeHierarchy(context, childEntity, &cell, entityIndex))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool WorldPartition::build(ECS *ecs, const char *levelPath, float cellSize, size_t excludedEntityCount, const EntityID *excludedEntities) noexcept
+{
+	PROFILING_ZONE_SCOPED;
+
+	eastl::vector<EntityID> rootEntities;
+	ecs->iterateTypeless(0, nullptr, [&](size_t count, const EntityID *entities, void **)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const auto *tc = ecs->getComponent<TransformComponent>(entities[i]);
+				if ((!tc || tc->m_parentEntity == k_nullEntity) && !isExcluded(entities[i], excludedEntityCount, excludedEntities))
+				{
+					rootEntities.push_back(entities[i]);
+				}
+			}
+		});
+
+	BuildContext context;
+	context.m_ecs = ecs;
+	context.m_cellSize = cellSize;
+	context.m_excludedEntityCount = excludedEntityCount;
+	context.m_excludedEntities = excludedEntities;
+	context.m_globalCell.m_info.m_global = 1;
+
+	for (EntityID entity : rootEntities)
+	{
+		if (!serializeHierarchy(context, entity, nullptr, k_noParentIndex))
+		{
+			return false;
+		}
+	}
+
+	// parents in other cells are referenced by cell index, so the cells are written in the order they were created in
+	eastl::vector<const BuildCell *> buildCells(context.m_cellCount);
+	buildCells[0] = &context.m_globalCell;
+	for (const auto &p : context.m_cells)
+	{
+		buildCells[p.second.m_index] = &p.second;
+	}
+
+	size_t entityCount = 0;
+	for (const BuildCell *buildCell : buildCells)
+	{
+		entityCount += buildCell->m_info.m_entityCount;
+	}
+
+	auto &vfs = VirtualFileSystem::get();
+	vfs.createDirectoryHierarchy(levelPath);
+
+	// write cell files
+	eastl::string cellPath;
+	eastl::vector<char> fileData;
+	for (const BuildCell *buildCell : buildCells)
+	{
+		Cell cell;
+		cell.m_x = buildCell->m_info.m_x;
+		cell.m_z = buildCell->m_info.m_z;
+		cell.m_global = buildCell->m_info.m_global != 0;
+		getCellPath(levelPath, cell, cellPath);
+
+		const auto &streamData = buildCell->m_stream.getData();
+
+		CellFileHeader header{};
+		header.m_entityCount = buildCell->m_info.m_entityCount;
+		header.m_fileSize = sizeof(header) + streamData.size();
+
+		fileData.resize(static_cast<size_t>(header.m_fileSize));
+		memcpy(fileData.data(), &header, sizeof(header));
+		if (!streamData.empty())
+		{
+			memcpy(fileData.data() + sizeof(header), streamData.data(), streamData.size());
+		}
+
+		if (!vfs.writeFile(cellPath.c_str(), fileData.size(), fileData.data(), true))
+		{
+			Log::err("WorldPartition: Could not write cell file \"%s\"!", cellPath.c_str());
+			return false;
+		}
+	}
+
+	// write level index
+	{
+		LevelFileHeader header{};
+		header.m_cellCount = static_cast<uint32_t>(buildCells.size());
+		header.m_fileSize = sizeof(header) + sizeof(CellInfo) * buildCells.size();
+		header.m_cellSize = cellSize;
+		header.m_padding = 0;
+
+		fileData.resize(static_cast<size_t>(header.m_fileSize));
+		memcpy(fileData.data(), &header, sizeof(header));
+		for (size_t i = 0; i < buildCells.size(); ++i)
+		{
+			memcpy(fileData.data() + sizeof(header) + sizeof(CellInfo) * i, &buildCells[i]->m_info, sizeof(CellInfo));
+		}
+
+		eastl::string indexPath = levelPath;
+		indexPath += "/level.idx";
+
+		if (!vfs.writeFile(indexPath.c_str(), fileData.size(), fileData.data(), true))
+		{
+			Log::err("WorldPartition: Could not write level index \"%s\"!", indexPath.c_str());
+			return false;
+		}
+	}
+
+	Log::info("WorldPartition: Wrote %u entities into %u cells of level \"%s\".", (unsigned)entityCount, (unsigned)buildCells.size(), levelPath);
+
+	return true;
+}
+
+bool WorldPartition::exists(const char *levelPath) noexcept
+{
+	eastl::string indexPath = levelPath;
+	indexPath += "/level.idx";
+	return VirtualFileSystem::get().exists(indexPath.c_str());
+}
+
+WorldPartition::WorldPartition(ECS *ecs) noexcept
+	:m_ecs(ecs)
+{
+}
+
+WorldPartition::~WorldPartition() noexcept
+{
+	close();
+}
+
+bool WorldPartition::open(const char *levelPath) noexcept
+{
+	close();
+
+	auto &vfs = VirtualFileSystem::get();
+
+	eastl::string indexPath = levelPath;
+	indexPath += "/level.idx";
+
+	if (!vfs.exists(indexPath.c_str()))
+	{
+		Log::err("WorldPartition: Level index \"%s\" does not exist!", indexPath.c_str());
+		return false;
+	}
+
+	const uint64_t fileSize = vfs.size(indexPath.c_str());
+	eastl::vector<char> fileData(static_cast<size_t>(fileSize));
+
+	if (fileSize < sizeof(LevelFileHeader) || !vfs.readFile(indexPath.c_str(), fileData.size(), fileData.data(), true))
+	{
+		Log::err("WorldPartition: Failed to read level index \"%s\"!", indexPath.c_str());
+		return false;
+	}
+
+	LevelFileHeader header;
+	memcpy(&header, fileData.data(), sizeof(header));
+
+	LevelFileHeader defaultHeader{};
+	if (memcmp(header.m_magicNumber, defaultHeader.m_magicNumber, sizeof(defaultHeader.m_magicNumber)) != 0
+		|| header.m_version != defaultHeader.m_version
+		|| header.m_fileSize != fileSize
+		|| fileSize != sizeof(LevelFileHeader) + sizeof(CellInfo) * static_cast<uint64_t>(header.m_cellCount)
+		|| !(header.m_cellSize > 0.0f))
+	{
+		Log::err("WorldPartition: Level index \"%s\" is corrupted or has a wrong version!", indexPath.c_str());
+		return false;
+	}
+
+	m_levelPath = levelPath;
+	m_cellSize = header.m_cellSize;
+
+	m_cells.resize(header.m_cellCount);
+	for (size_t i = 0; i < m_cells.size(); ++i)
+	{
+		CellInfo cellInfo;
+		memcpy(&cellInfo, fileData.data() + sizeof(LevelFileHeader) + sizeof(CellInfo) * i, sizeof(cellInfo));
+
+		auto &cell = m_cells[i];
+		cell.m_x = cellInfo.m_x;
+		cell.m_z = cellInfo.m_z;
+		cell.m_entityCount = cellInfo.m_entityCount;
+		cell.m_global = cellInfo.m_global != 0;
+	}
+
+	// components are stored by name, so the files do not depend on the registration order of the component types
+	m_componentIDs.clear();
+	for (int64_t i = 0; i <= ECSComponentInfoTable::getHighestRegisteredComponentIDValue(); ++i)
+	{
+		const auto &info = ECSComponentInfoTable::getComponentInfo(static_cast<ComponentID>(i));
+		if (info.m_onDeserialize && info.m_name)
+		{
+			m_componentIDs[StringID::hashOnly(info.m_name)] = static_cast<ComponentID>(i);
+		}
+	}
+
+	return true;
+}
+
+void WorldPartition::close() noexcept
+{
+	waitForPendingLoads();
+
+	for (LoadRequest *request : m_finishedRequests)
+	{
+		delete request;
+	}
+	m_finishedRequests.clear();
+
+	for (auto &cell : m_cells)
+	{
+		unloadCell(cell);
+	}
+
+	m_cells.clear();
+	m_levelPath.clear();
+}
+
+void WorldPartition::update(const glm::vec3 &streamingCenter) noexcept
+{
+	PROFILING_ZONE_SCOPED;
+
+	const uint64_t startTime = getTimestamp();
+
+	// hand finished loads over to their cells
+	{
+		eastl::vector<LoadRequest *> finishedRequests;
+		{
+			LOCK_HOLDER(m_finishedRequestsMutex);
+			finishedRequests.swap(m_finishedRequests);
+		}
+
+		for (LoadRequest *request : finishedRequests)
+		{
+			auto &cell = m_cells[request->m_cellIndex];
+			assert(cell.m_state == CellState::LOADING);
+
+			// the level index may be outdated
+			if (request->m_success && request->m_entityCount != cell.m_entityCount)
+			{
+				Log::warn("WorldPartition: Cell \"%s\" does not match the level index!", request->m_path.c_str());
+				request->m_success = false;
+			}
+
+			if (!request->m_success)
+			{
+				Log::warn("WorldPartition: Failed to load cell \"%s\"!", request->m_path.c_str());
+				cell.m_failed = true;
+			}
+
+			// the cell may have left the unload radius while it was loading
+			if (!request->m_success || !cell.m_wanted)
+			{
+				cell.m_state = CellState::UNLOADED;
+				delete request;
+				continue;
+			}
+
+			if (cell.m_entityCount == 0)
+			{
+				cell.m_state = CellState::LOADED;
+				delete request;
+				continue;
+			}
+
+			cell.m_state = CellState::CREATING;
+			cell.m_request = request;
+			cell.m_readOffset = sizeof(CellFileHeader);
+			cell.m_entities.reserve(cell.m_entityCount);
+		}
+	}
+
+	// update which cells should be loaded
+	m_sortedCells.clear();
+	for (size_t i = 0; i < m_cells.size(); ++i)
+	{
+		auto &cell = m_cells[i];
+		const float distance = getDistance(cell, streamingCenter);
+
+		if (cell.m_global || distance <= m_loadRadius)
+		{
+			cell.m_wanted = true;
+		}
+		else if (distance > m_unloadRadius)
+		{
+			cell.m_wanted = false;
+		}
+
+		if (!cell.m_wanted && (cell.m_state == CellState::CREATING || cell.m_state == CellState::LOADED))
+		{
+			unloadCell(cell);
+		}
+
+		if (cell.m_wanted && cell.m_state != CellState::LOADING && cell.m_state != CellState::LOADED && !cell.m_failed)
+		{
+			m_sortedCells.push_back(static_cast<uint32_t>(i));
+		}
+	}
+
+	// closest cells first. the global cell has a distance of zero
+	eastl::sort(m_sortedCells.begin(), m_sortedCells.end(), [&](uint32_t lhs, uint32_t rhs)
+		{
+			return getDistance(m_cells[lhs], streamingCenter) < getDistance(m_cells[rhs], streamingCenter);
+		});
+
+	// issue load jobs
+	{
+		eastl::fixed_vector<job::Job, k_maxPendingLoads> jobs;
+		for (uint32_t cellIndex : m_sortedCells)
+		{
+			auto &cell = m_cells[cellIndex];
+			if (cell.m_state != CellState::UNLOADED)
+			{
+				continue;
+			}
+
+			if (m_pendingLoadCount.load() >= k_maxPendingLoads)
+			{
+				break;
+			}
+
+			LoadRequest *request = new LoadRequest();
+			request->m_worldPartition = this;
+			request->m_cellIndex = cellIndex;
+			request->m_entityCount = 0;
+			request->m_success = false;
+			getCellPath(m_levelPath.c_str(), cell, request->m_path);
+
+			cell.m_state = CellState::LOADING;
+
+			++m_pendingLoadCount;
+			jobs.push_back(job::Job(loadJob, request));
+		}
+
+		if (!jobs.empty())
+		{
+			job::run(jobs.size(), jobs.data(), nullptr, job::Priority::LOW);
+		}
+	}
+
+	// create entities of loaded cells until the frame budget is used up, but at least one, so that large cells still finish
+	bool createdEntity = false;
+	for (uint32_t cellIndex : m_sortedCells)
+	{
+		auto &cell = m_cells[cellIndex];
+		while (cell.m_state == CellState::CREATING)
+		{
+			if (createdEntity && (getTimestamp() - startTime) >= m_frameBudget)
+			{
+				return;
+			}
+
+			if (!createNextEntity(cell))
+			{
+				cell.m_state = CellState::LOADED;
+				delete cell.m_request;
+				cell.m_request = nullptr;
+				attachCrossCellChildren(cellIndex);
+			}
+			createdEntity = true;
+		}
+	}
+}
+
+void WorldPartition::setRadii(float loadRadius, float unloadRadius) noexcept
+{
+	m_loadRadius = loadRadius;
+	m_unloadRadius = eastl::max(loadRadius, unloadRadius);
+}
+
+void WorldPartition::setFrameBudget(uint64_t budgetMilliseconds) noexcept
+{
+	m_frameBudget = budgetMilliseconds * 1000000;
+}
+
+size_t WorldPartition::getLoadedCellCount() const noexcept
+{
+	size_t count = 0;
+	for (const auto &cell : m_cells)
+	{
+		count += cell.m_state == CellState::LOADED ? 1 : 0;
+	}
+	return count;
+}
+
+void WorldPartition::waitForPendingLoads() noexcept
+{
+	// load jobs still reference this object
+	while (m_pendingLoadCount.load() != 0)
+	{
+		Thread::yield();
+	}
+}
+
+void WorldPartition::unloadCell(Cell &cell) noexcept
+{
+	detachCrossCellChildren(static_cast<uint32_t>(&cell - m_cells.data()));
+
+	// children were created after their parents, so they are destroyed first
+	for (auto it = cell.m_entities.rbegin(); it != cell.m_entities.rend(); ++it)
+	{
+		// gameplay code may have destroyed the entity already
+		if (m_ecs->isValid(*it))
+		{
+			TransformHierarchy::detach(m_ecs, *it, true);
+			m_ecs->destroyEntity(*it);
+		}
+	}
+
+	cell.m_entities.clear();
+	cell.m_crossCellParents.clear();
+	cell.m_readOffset = 0;
+
+	delete cell.m_request;
+	cell.m_request = nullptr;
+	cell.m_state = CellState::UNLOADED;
+}
+
+void WorldPartition::attachCrossCellChildren(uint32_t parentCellIndex) noexcept
+{
+	for (const auto &cell : m_cells)
+	{
+		for (const auto &crossCellParent : cell.m_crossCellParents)
+		{
+			if (crossCellParent.m_parentCellIndex == parentCellIndex)
+			{
+				attachCrossCellChild(cell, crossCellParent);
+			}
+		}
+	}
+}
+
+void WorldPartition::detachCrossCellChildren(uint32_t parentCellIndex) noexcept
+{
+	const auto &parentCell = m_cells[parentCellIndex];
+
+	for (const auto &cell : m_cells)
+	{
+		for (const auto &crossCellParent : cell.m_crossCellParents)
+		{
+			if (crossCellParent.m_parentCellIndex != parentCellIndex
+				|| crossCellParent.m_entityIndex >= cell.m_entities.size()
+				|| crossCellParent.m_parentIndex >= parentCell.m_entities.size())
+			{
+				continue;
+			}
+
+			const EntityID entity = cell.m_entities[crossCellParent.m_entityIndex];
+			auto *tc = m_ecs->isValid(entity) ? m_ecs->getComponent<TransformComponent>(entity) : nullptr;
+
+			// the child stays loaded as a root at its current global transform
+			if (tc && tc->m_parentEntity == parentCell.m_entities[crossCellParent.m_parentIndex])
+			{
+				TransformHierarchy::attach(m_ecs, entity, k_nullEntity, false, tc);
+			}
+		}
+	}
+}
+
+bool WorldPartition::attachCrossCellChild(const Cell &cell, const CrossCellParent &crossCellParent) noexcept
+{
+	const auto &parentCell = m_cells[crossCellParent.m_parentCellIndex];
+	if (crossCellParent.m_entityIndex >= cell.m_entities.size() || crossCellParent.m_parentIndex >= parentCell.m_entities.size())
+	{
+		return false;
+	}
+
+	const EntityID entity = cell.m_entities[crossCellParent.m_entityIndex];
+	const EntityID parentEntity = parentCell.m_entities[crossCellParent.m_parentIndex];
+	if (!m_ecs->isValid(entity) || !m_ecs->isValid(parentEntity))
+	{
+		return false;
+	}
+
+	// gameplay code may have attached the entity to a different parent
+	auto *tc = m_ecs->getComponent<TransformComponent>(entity);
+	if (!tc || tc->m_parentEntity != k_nullEntity)
+	{
+		return false;
+	}
+
+	// the entity was created with its global transform, which is kept
+	return TransformHierarchy::attach(m_ecs, entity, parentEntity, false, tc);
+}
+
+bool WorldPartition::createNextEntity(Cell &cell) noexcept
+{
+	const auto &data = cell.m_request->m_data;
+	SerializationReadStream stream(data.size() - cell.m_readOffset, data.data() + cell.m_readOffset);
+
+	if (!deserializeEntity(cell, stream))
+	{
+		Log::warn("WorldPartition: Cell \"%s\" is corrupted! Only %u of %u entities were created.", cell.m_request->m_path.c_str(), (unsigned)cell.m_entities.size(), (unsigned)cell.m_entityCount);
+		return false;
+	}
+
+	cell.m_readOffset += stream.getReadOffset();
+
+	return cell.m_entities.size() < cell.m_entityCount;
+}
+
+bool WorldPartition::deserializeEntity(Cell &cell, SerializationReadStream &stream) noexcept
+{
+	uint32_t parentCellIndex = 0;
+	uint32_t parentIndex = 0;
+	uint32_t componentCount = 0;
+	serializeUInt32(stream, parentCellIndex);
+	serializeUInt32(stream, parentIndex);
+	serializeUInt32(stream, componentCount);
+
+	if (componentCount > k_ecsMaxComponentTypes || parentCellIndex >= m_cells.size())
+	{
+		return false;
+	}
+
+	const uint32_t cellIndex = static_cast<uint32_t>(&cell - m_cells.data());
+	const bool crossCellParent = parentIndex != k_noParentIndex && parentCellIndex != cellIndex;
+	if (parentIndex != k_noParentIndex && parentIndex >= (crossCellParent ? m_cells[parentCellIndex].m_entityCount : cell.m_entities.size()))
+	{
+		return false;
+	}
+
+	ComponentID componentIDs[k_ecsMaxComponentTypes];
+	const char *componentData[k_ecsMaxComponentTypes];
+	uint32_t componentDataSizes[k_ecsMaxComponentTypes];
+	size_t knownComponentCount = 0;
+
+	for (uint32_t i = 0; i < componentCount; ++i)
+	{
+		uint32_t nameLength = 0;
+		const char *name = nullptr;
+		uint32_t dataSize = 0;
+		const char *data = nullptr;
+		serializeUInt32(stream, nameLength);
+		serializeBytesView(stream, nameLength, name);
+		serializeUInt32(stream, dataSize);
+		serializeBytesView(stream, dataSize, data);
+
+		if (nameLength == 0 || name[nameLength - 1] != '\0')
+		{
+			return false;
+		}
+
+		auto it = m_componentIDs.find(StringID::hashOnly(name));
+		if (it == m_componentIDs.end())
+		{
+			Log::warn("WorldPartition: Skipping unknown component \"%s\"!", name);
+			continue;
+		}
+
+		componentIDs[knownComponentCount] = it->second;
+		componentData[knownComponentCount] = data;
+		componentDataSizes[knownComponentCount] = dataSize;
+		++knownComponentCount;
+	}
+
+	const EntityID entity = m_ecs->createEntityTypeless(knownComponentCount, componentIDs);
+	cell.m_entities.push_back(entity);
+
+	for (size_t i = 0; i < knownComponentCount; ++i)
+	{
+		const auto &info = ECSComponentInfoTable::getComponentInfo(componentIDs[i]);
+		SerializationReadStream componentStream(componentDataSizes[i], componentData[i]);
+		if (!info.m_onDeserialize(m_ecs, entity, m_ecs->getComponentTypeless(entity, componentIDs[i]), componentStream))
+		{
+			Log::warn("WorldPartition: Failed to deserialize component \"%s\"!", info.m_name);
+		}
+	}
+
+	// only the local transform is serialized
+	if (auto *tc = m_ecs->getComponent<TransformComponent>(entity))
+	{
+		if (parentIndex != k_noParentIndex && !crossCellParent)
+		{
+			TransformHierarchy::attach(m_ecs, entity, cell.m_entities[parentIndex], true, tc);
+		}
+		else
+		{
+			tc->m_globalTransform = tc->m_transform;
+		}
+
+		tc->m_prevGlobalTransform = tc->m_globalTransform;
+		tc->m_curRenderTransform = tc->m_globalTransform;
+		tc->m_prevRenderTransform = tc->m_globalTransform;
+
+		// the parent is attached now if its cell is loaded already, otherwise when its cell finishes loading
+		if (crossCellParent)
+		{
+			cell.m_crossCellParents.push_back({ static_cast<uint32_t>(cell.m_entities.size() - 1), parentCellIndex, parentIndex });
+			attachCrossCellChild(cell, cell.m_crossCellParents.back());
+		}
+	}
+
+	return true;
+}
+
+float WorldPartition::getDistance(const Cell &cell, const glm::vec3 &position) const noexcept
+{
+	if (cell.m_global)
+	{
+		return 0.0f;
+	}
+
+	// distance to the closest point of the cell on the XZ plane
+	const float minX = cell.m_x * m_cellSize;
+	const float minZ = cell.m_z * m_cellSize;
+	const float dx = eastl::max(eastl::max(minX - position.x, position.x - (minX + m_cellSize)), 0.0f);
+	const float dz = eastl::max(eastl::max(minZ - position.z, position.z - (minZ + m_cellSize)), 0.0f);
+
+	return sqrtf(dx * dx + dz * dz);
+}
+
+void WorldPartition::getCellPath(const char *levelPath, const Cell &cell, eastl::string &path) noexcept
+{
+	path = levelPath;
+	if (cell.m_global)
+	{
+		path += "/global.cell";
+	}
+	else
+	{
+		path.append_sprintf("/cell_%d_%d.cell", (int)cell.m_x, (int)cell.m_z);
+	}
+}
+
+void WorldPartition::loadJob(void *param) noexcept
+{
+	LoadRequest *request = reinterpret_cast<LoadRequest *>(param);
+	WorldPartition *worldPartition = request->m_worldPartition;
+
+	{
+		auto &vfs = VirtualFileSystem::get();
+		const char *path = request->m_path.c_str();
+		const uint64_t fileSize = vfs.exists(path) ? vfs.size(path) : 0;
+
+		if (fileSize >= sizeof(CellFileHeader))
+		{
+			request->m_data.resize(static_cast<size_t>(fileSize));
+			if (vfs.readFile(path, request->m_data.size(), request->m_data.data(), true))
+			{
+				CellFileHeader header;
+				memcpy(&header, request->m_data.data(), sizeof(header));
+
+				CellFileHeader defaultHeader{};
+				request->m_success = memcmp(header.m_magicNumber, defaultHeader.m_magicNumber, sizeof(defaultHeader.m_magicNumber)) == 0
+					&& header.m_version == defaultHeader.m_version
+					&& header.m_fileSize == fileSize;
+				request->m_entityCount = header.m_entityCount;
+			}
+		}
+	}
+
+	{
+		LOCK_HOLDER(worldPartition->m_finishedRequestsMutex);
+		worldPartition->m_finishedRequests.push_back(request);
+	}
+
+	--worldPartition->m_pendingLoadCount;
+}
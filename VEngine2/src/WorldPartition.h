@@ -0,0 +1,159 @@
+#pragma once
+#include <stdint.h>
+#include <EASTL/vector.h>
+#include <EASTL/string.h>
+#include <EASTL/atomic.h>
+#include <EASTL/hash_map.h>
+#include <glm/vec3.hpp>
+#include "ecs/ECSCommon.h"
+#include "utility/StringID.h"
+#include "utility/SpinLock.h"
+#include "utility/DeletedCopyMove.h"
+
+class ECS;
+class SerializationReadStream;
+
+/// <summary>
+/// Divides the entities of a level into square cells on the XZ plane, which are stored as separate binary files and
+/// streamed in and out of the ECS around a streaming center, like the player. Entities are assigned to the cell containing
+/// their global translation and entities without a TransformComponent are kept in a global cell, which is always loaded.
+/// Children in a different cell than their parent are attached to the parent while both cells are loaded and keep their
+/// global transform otherwise. Cell files are read and validated in background jobs, while creating the
+/// entities of a loaded cell happens in update() and is spread over multiple frames to stay within a time budget.
+/// Assets referenced by the components of a cell are requested asynchronously while the cell is created.
+/// </summary>
+class WorldPartition
+{
+public:
+	static constexpr float k_defaultLoadRadius = 64.0f;
+	static constexpr float k_defaultUnloadRadius = 80.0f;
+	static constexpr uint64_t k_defaultFrameBudget = 2; // milliseconds
+
+	/// <summary>
+	/// Writes all entities of the ECS into cell files and a level index file.
+	/// </summary>
+	/// <param name="ecs">The ECS holding the entities to write.</param>
+	/// <param name="levelPath">The virtual path of the directory to write the files to.</param>
+	/// <param name="cellSize">The edge length of a cell.</param>
+	/// <param name="excludedEntityCount">The number of entities to not write, like the player and the camera.</param>
+	/// <param name="excludedEntities">The entities to not write. Their children are not written either.</param>
+	/// <returns>True if all files were written successfully.</returns>
+	static bool build(ECS *ecs, const char *levelPath, float cellSize, size_t excludedEntityCount = 0, const EntityID *excludedEntities = nullptr) noexcept;
+
+	/// <summary>
+	/// Checks if there is a level index file in the given directory.
+	/// </summary>
+	static bool exists(const char *levelPath) noexcept;
+
+	explicit WorldPartition(ECS *ecs) noexcept;
+	DELETED_COPY_MOVE(WorldPartition);
+	~WorldPartition() noexcept;
+
+	/// <summary>
+	/// Reads the level index file of a level written by build(). Unloads the cells of the previously opened level.
+	/// </summary>
+	/// <param name="levelPath">The virtual path of the level directory.</param>
+	/// <returns>True if the level index was read successfully.</returns>
+	bool open(const char *levelPath) noexcept;
+
+	/// <summary>
+	/// Destroys the entities of all loaded cells and closes the level.
+	/// </summary>
+	void close() noexcept;
+
+	/// <summary>
+	/// Issues load jobs for cells within the load radius of the streaming center (closest first), unloads cells outside
+	/// of the unload radius and creates entities of finished cells until the frame budget is used up.
+	/// This should be called once per frame from the main thread.
+	/// </summary>
+	/// <param name="streamingCenter">The position around which to keep cells loaded.</param>
+	void update(const glm::vec3 &streamingCenter) noexcept;
+
+	/// <summary>
+	/// Sets the distances on the XZ plane between the streaming center and a cell at which the cell is loaded and unloaded.
+	/// The unload radius should be larger than the load radius, so cells do not bounce in and out at the border.
+	/// </summary>
+	void setRadii(float loadRadius, float unloadRadius) noexcept;
+
+	/// <summary>
+	/// Sets the time in milliseconds that update() may spend creating entities each frame.
+	/// At least one entity is created per frame, so large cells still finish loading.
+	/// </summary>
+	void setFrameBudget(uint64_t budgetMilliseconds) noexcept;
+
+	/// <summary>
+	/// Gets the number of cells whose entities are completely created.
+	/// </summary>
+	size_t getLoadedCellCount() const noexcept;
+
+private:
+	static constexpr uint32_t k_maxPendingLoads = 4;
+
+	enum class CellState
+	{
+		UNLOADED,
+		LOADING, // a load job is reading the cell file
+		CREATING, // the file was read and the entities are being created
+		LOADED,
+	};
+
+	struct LoadRequest;
+
+	// an entity of a cell whose parent is in a different cell
+	struct CrossCellParent
+	{
+		uint32_t m_entityIndex;
+		uint32_t m_parentCellIndex;
+		uint32_t m_parentIndex;
+	};
+
+	struct Cell
+	{
+		int32_t m_x = 0;
+		int32_t m_z = 0;
+		uint32_t m_entityCount = 0;
+		bool m_global = false;
+		CellState m_state = CellState::UNLOADED;
+		bool m_wanted = false; // within the load radius or not yet outside of the unload radius
+		bool m_failed = false; // the cell file could not be read, so it is not requested again
+		LoadRequest *m_request = nullptr; // the finished load request while CREATING
+		size_t m_readOffset = 0; // offset of the next entity in the cell data while CREATING
+		eastl::vector<EntityID> m_entities;
+		eastl::vector<CrossCellParent> m_crossCellParents;
+	};
+
+	struct LoadRequest
+	{
+		WorldPartition *m_worldPartition;
+		uint32_t m_cellIndex;
+		eastl::string m_path;
+		eastl::vector<char> m_data;
+		uint32_t m_entityCount;
+		bool m_success;
+	};
+
+	ECS *m_ecs = nullptr;
+	eastl::string m_levelPath;
+	float m_cellSize = 1.0f;
+	float m_loadRadius = k_defaultLoadRadius;
+	float m_unloadRadius = k_defaultUnloadRadius;
+	uint64_t m_frameBudget = k_defaultFrameBudget * 1000000; // nanoseconds
+	eastl::vector<Cell> m_cells;
+	eastl::vector<uint32_t> m_sortedCells;
+	eastl::hash_map<StringID, ComponentID, StringIDHash> m_componentIDs; // by component name
+	SpinLock m_finishedRequestsMutex;
+	eastl::vector<LoadRequest *> m_finishedRequests; // guarded by m_finishedRequestsMutex
+	eastl::atomic<uint32_t> m_pendingLoadCount = 0;
+
+	void waitForPendingLoads() noexcept;
+	void unloadCell(Cell &cell) noexcept;
+	void attachCrossCellChildren(uint32_t parentCellIndex) noexcept;
+	void detachCrossCellChildren(uint32_t parentCellIndex) noexcept;
+	bool attachCrossCellChild(const Cell &cell, const CrossCellParent &crossCellParent) noexcept;
+	// returns false once all entities of the cell were created
+	bool createNextEntity(Cell &cell) noexcept;
+	bool deserializeEntity(Cell &cell, SerializationReadStream &stream) noexcept;
+	float getDistance(const Cell &cell, const glm::vec3 &position) const noexcept;
+	static void getCellPath(const char *levelPath, const Cell &cell, eastl::string &path) noexcept;
+	static void loadJob(void *request) noexcept;
+};
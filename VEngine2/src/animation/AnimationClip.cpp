@@ -3,44 +3,183 @@
 #include <string.h>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtc/type_ptr.hpp>
-#include "utility/Utility.h"
+#include <xmmintrin.h>
+#include <EASTL/algorithm.h>
+#include "AnimationClipQuantization.h"
 
+namespace
+{
+	// the decoded keys to interpolate between for one track of one joint
+	struct KeySample
+	{
+		float m_value0[4];
+		float m_value1[4];
+		float m_alpha;
+	};
+}
 
-static void sampleData(uint32_t componentCount, float time, uint32_t frameCount, bool loop, const float *timeKeys, const float *data, float *result) noexcept
+// linear search is used for at most this many keys before falling back to binary search
+static constexpr uint32_t k_maxCursorSteps = 4;
+
+static constexpr uint32_t k_trackComponentCounts[] = { 3, 4, 1 };
+static constexpr float k_defaultTrackValues[][4] = { { 0.0f, 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f, 1.0f }, { 1.0f, 0.0f, 0.0f, 0.0f } };
+
+// same results as util::findPieceWiseLinearCurveIndicesAndAlpha() on the dequantized keys. time is in the range of the
+// quantized keys. if cursor is not null, the search starts at the key found by the previous call, which is the same or
+// one of the next keys during playback
+static void findKeys(uint32_t count, const uint16_t *keys, float time, bool loop, uint32_t *cursor, uint32_t *index0, uint32_t *index1, float *alpha) noexcept
 {
-	float alpha = 0.0f;
-	size_t index0 = 0;
-	size_t index1 = 0;
-	util::findPieceWiseLinearCurveIndicesAndAlpha(frameCount, timeKeys, time, loop, &index0, &index1, &alpha);
+	assert(count > 0);
 
-	auto lerp = [](auto x, auto y, auto alpha)
+	*index0 = 0;
+	*index1 = 0;
+	*alpha = 0.0f;
+
+	if (count == 1)
 	{
-		return x * (1.0f - alpha) + y * alpha;
-	};
+		return;
+	}
 
-	if (index0 == index1)
+	const float firstKey = keys[0];
+	const float lastKey = keys[count - 1];
+
+	if (time < firstKey || time >= lastKey)
 	{
-		for (size_t i = 0; i < componentCount; ++i)
+		if (loop)
+		{
+			*index0 = count - 1;
+			*index1 = 0;
+			*alpha = firstKey > 0.0f ? (time < firstKey ? time : time - lastKey) / firstKey : 0.0f;
+		}
+		else
 		{
-			result[i] = data[index0 * componentCount + i];
+			*index0 = time < firstKey ? 0 : count - 1;
+			*index1 = *index0;
 		}
+		return;
 	}
-	else
+
+	// find the last key that is less-equal to time. since time is less than the last key, this is never the last key
+	uint32_t keyIdx = (cursor && *cursor < (count - 1)) ? *cursor : 0;
+	uint32_t steps = 0;
+	if (keys[keyIdx] <= time)
 	{
-		for (size_t i = 0; i < componentCount; ++i)
+		while (time >= keys[keyIdx + 1] && steps < k_maxCursorSteps)
 		{
-			result[i] = lerp(data[index0 * componentCount + i], data[index1 * componentCount + i], alpha);
+			++keyIdx;
+			++steps;
 		}
 	}
 
+	// time jumped backwards, like when the clip looped, or too far forward
+	if (keys[keyIdx] > time || time >= keys[keyIdx + 1])
+	{
+		keyIdx = static_cast<uint32_t>(eastl::upper_bound(keys, keys + count, time, [](float lhs, uint16_t rhs) { return lhs < rhs; }) - keys) - 1;
+	}
+
+	assert(keys[keyIdx] <= time && time < keys[keyIdx + 1]);
+
+	if (cursor)
+	{
+		*cursor = keyIdx;
+	}
 
+	*index0 = keyIdx;
+	*index1 = keyIdx + 1;
+	*alpha = (time - keys[keyIdx]) / static_cast<float>(keys[keyIdx + 1] - keys[keyIdx]);
+}
+
+// gathers component c of the keys of four joints into SIMD registers and interpolates them linearly
+static __m128 lerpKeySamples(const KeySample *samples, uint32_t c) noexcept
+{
+	const __m128 x0 = _mm_setr_ps(samples[0].m_value0[c], samples[1].m_value0[c], samples[2].m_value0[c], samples[3].m_value0[c]);
+	const __m128 x1 = _mm_setr_ps(samples[0].m_value1[c], samples[1].m_value1[c], samples[2].m_value1[c], samples[3].m_value1[c]);
+	const __m128 alpha = _mm_setr_ps(samples[0].m_alpha, samples[1].m_alpha, samples[2].m_alpha, samples[3].m_alpha);
+	return _mm_add_ps(x0, _mm_mul_ps(_mm_sub_ps(x1, x0), alpha));
+}
+
+size_t AnimationClipLayout::getMemorySize() const noexcept
+{
+	size_t memorySize = 0;
+	memorySize += m_jointCount * sizeof(AnimationClipJointInfo); // per joint info
+	memorySize += m_constantDataCount * sizeof(float); // constant tracks
+	memorySize += (static_cast<size_t>(m_translationKeyCount) + static_cast<size_t>(m_rotationKeyCount) + static_cast<size_t>(m_scaleKeyCount)) * sizeof(uint16_t); // time keys
+	memorySize += m_translationKeyCount * sizeof(uint16_t) * 3; // translation data
+	memorySize += m_rotationKeyCount * sizeof(uint16_t) * 3; // rotation data
+	memorySize += m_scaleKeyCount * sizeof(uint16_t) * 1; // scale data
+	return memorySize;
+}
+
+bool AnimationClipLayout::isValid(const char *memory) const noexcept
+{
+	const uint32_t keyCounts[] = { m_translationKeyCount, m_rotationKeyCount, m_scaleKeyCount };
+	const uint32_t constantFlags[] = { ANIMATION_CLIP_TRACK_FLAG_CONSTANT_TRANSLATION, ANIMATION_CLIP_TRACK_FLAG_CONSTANT_ROTATION, ANIMATION_CLIP_TRACK_FLAG_CONSTANT_SCALE };
+
+	for (uint32_t i = 0; i < m_jointCount; ++i)
+	{
+		AnimationClipJointInfo info;
+		memcpy(&info, memory + i * sizeof(AnimationClipJointInfo), sizeof(info));
+
+		const uint32_t frameCounts[] = { info.m_translationFrameCount, info.m_rotationFrameCount, info.m_scaleFrameCount };
+		const uint32_t arrayOffsets[] = { info.m_translationArrayOffset, info.m_rotationArrayOffset, info.m_scaleArrayOffset };
+
+		for (size_t track = 0; track < 3; ++track)
+		{
+			if ((info.m_flags & constantFlags[track]) != 0)
+			{
+				if (frameCounts[track] != 1 || uint64_t(arrayOffsets[track]) + k_trackComponentCounts[track] > m_constantDataCount)
+				{
+					return false;
+				}
+			}
+			else if (uint64_t(arrayOffsets[track]) + frameCounts[track] > keyCounts[track])
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void AnimationClipCreateInfo::setArrays(const AnimationClipLayout &layout, const char *memory) noexcept
+{
+	size_t curMemOffset = 0;
+
+	m_perJointInfo = reinterpret_cast<const AnimationClipJointInfo *>(memory + curMemOffset);
+	curMemOffset += layout.m_jointCount * sizeof(AnimationClipJointInfo);
+
+	m_constantData = reinterpret_cast<const float *>(memory + curMemOffset);
+	curMemOffset += layout.m_constantDataCount * sizeof(float);
+
+	m_translationTimeKeys = reinterpret_cast<const uint16_t *>(memory + curMemOffset);
+	curMemOffset += layout.m_translationKeyCount * sizeof(uint16_t);
+
+	m_rotationTimeKeys = reinterpret_cast<const uint16_t *>(memory + curMemOffset);
+	curMemOffset += layout.m_rotationKeyCount * sizeof(uint16_t);
+
+	m_scaleTimeKeys = reinterpret_cast<const uint16_t *>(memory + curMemOffset);
+	curMemOffset += layout.m_scaleKeyCount * sizeof(uint16_t);
+
+	m_translationData = reinterpret_cast<const uint16_t *>(memory + curMemOffset);
+	curMemOffset += layout.m_translationKeyCount * sizeof(uint16_t) * 3;
+
+	m_rotationData = reinterpret_cast<const uint16_t *>(memory + curMemOffset);
+	curMemOffset += layout.m_rotationKeyCount * sizeof(uint16_t) * 3;
+
+	m_scaleData = reinterpret_cast<const uint16_t *>(memory + curMemOffset);
+	curMemOffset += layout.m_scaleKeyCount * sizeof(uint16_t) * 1;
+
+	assert(curMemOffset == layout.getMemorySize());
 }
 
 AnimationClip::AnimationClip(const AnimationClipCreateInfo &createInfo) noexcept
 	:m_jointCount(createInfo.m_jointCount),
 	m_duration(createInfo.m_duration),
 	m_memory(createInfo.m_memory),
+	m_timeKeyScale(createInfo.m_duration > 0.0f ? AnimationClipQuantization::k_maxValue / createInfo.m_duration : 0.0f),
 	m_perJointInfo(createInfo.m_perJointInfo),
+	m_constantData(createInfo.m_constantData),
 	m_translationTimeKeys(createInfo.m_translationTimeKeys),
 	m_rotationTimeKeys(createInfo.m_rotationTimeKeys),
 	m_scaleTimeKeys(createInfo.m_scaleTimeKeys),
@@ -54,7 +193,9 @@ AnimationClip::AnimationClip(AnimationClip &&other) noexcept
 	:m_jointCount(other.m_jointCount),
 	m_duration(other.m_duration),
 	m_memory(other.m_memory),
+	m_timeKeyScale(other.m_timeKeyScale),
 	m_perJointInfo(other.m_perJointInfo),
+	m_constantData(other.m_constantData),
 	m_translationTimeKeys(other.m_translationTimeKeys),
 	m_rotationTimeKeys(other.m_rotationTimeKeys),
 	m_scaleTimeKeys(other.m_scaleTimeKeys),
@@ -65,7 +206,9 @@ AnimationClip::AnimationClip(AnimationClip &&other) noexcept
 	other.m_jointCount = 0;
 	other.m_duration = 0.0f;
 	other.m_memory = nullptr;
+	other.m_timeKeyScale = 0.0f;
 	other.m_perJointInfo = nullptr;
+	other.m_constantData = nullptr;
 	other.m_translationTimeKeys = nullptr;
 	other.m_rotationTimeKeys = nullptr;
 	other.m_scaleTimeKeys = nullptr;
@@ -86,7 +229,9 @@ AnimationClip &AnimationClip::operator=(AnimationClip &&other) noexcept
 		m_jointCount = other.m_jointCount;
 		m_duration = other.m_duration;
 		m_memory = other.m_memory;
+		m_timeKeyScale = other.m_timeKeyScale;
 		m_perJointInfo = other.m_perJointInfo;
+		m_constantData = other.m_constantData;
 		m_translationTimeKeys = other.m_translationTimeKeys;
 		m_rotationTimeKeys = other.m_rotationTimeKeys;
 		m_scaleTimeKeys = other.m_scaleTimeKeys;
@@ -97,7 +242,9 @@ AnimationClip &AnimationClip::operator=(AnimationClip &&other) noexcept
 		other.m_jointCount = 0;
 		other.m_duration = 0.0f;
 		other.m_memory = nullptr;
+		other.m_timeKeyScale = 0.0f;
 		other.m_perJointInfo = nullptr;
+		other.m_constantData = nullptr;
 		other.m_translationTimeKeys = nullptr;
 		other.m_rotationTimeKeys = nullptr;
 		other.m_scaleTimeKeys = nullptr;
@@ -128,82 +275,219 @@ JointPose AnimationClip::getJointPose(size_t jointIdx, float time, bool loop, bo
 {
 	assert(jointIdx < m_jointCount);
 
+	auto lerp = [](auto x, auto y, auto alpha)
+	{
+		return x * (1.0f - alpha) + y * alpha;
+	};
+
 	JointPose jointPose{};
-	jointPose.m_rot[3] = 1.0f;
-	jointPose.m_scale = 1.0f;
+	float value0[4];
+	float value1[4];
+	float alpha = 0.0f;
 
 	// translation
 	{
-		uint32_t frameCount = m_perJointInfo[jointIdx].m_translationFrameCount;
-		size_t arrayOffset = m_perJointInfo[jointIdx].m_translationArrayOffset;
+		const bool rootMotion = jointIdx == 0 && extractRootMotion;
+		findTrackKeys(jointIdx, TRANSLATION, rootMotion ? 0.0f : time, rootMotion ? false : loop, nullptr, value0, value1, &alpha);
+		for (size_t i = 0; i < 3; ++i)
+		{
+			jointPose.m_trans[i] = lerp(value0[i], value1[i], alpha);
+		}
+	}
+
+	// rotation
+	{
+		findTrackKeys(jointIdx, ROTATION, time, loop, nullptr, value0, value1, &alpha);
 
-		if (frameCount)
+		glm::quat resultQ = glm::make_quat(value0);
+		if (alpha != 0.0f)
 		{
-			const float *timeKeys = m_translationTimeKeys + arrayOffset;
-			const float *data = m_translationData + (arrayOffset * 3);
+			resultQ = glm::normalize(glm::slerp(resultQ, glm::make_quat(value1), alpha));
+		}
+
+		memcpy(jointPose.m_rot, &resultQ[0], sizeof(jointPose.m_rot));
+	}
+
+	// scale
+	{
+		findTrackKeys(jointIdx, SCALE, time, loop, nullptr, value0, value1, &alpha);
+		jointPose.m_scale = lerp(value0[0], value1[0], alpha);
+	}
+
+	return jointPose;
+}
+
+void AnimationClip::sampleAllJoints(float time, bool loop, bool extractRootMotion, AnimationClipCursor *cursor, JointPoses *poses) const noexcept
+{
+	const size_t jointCount = eastl::min<size_t>(m_jointCount, poses->m_jointCount);
+
+	if (cursor->m_keyIndices.size() != m_jointCount * 3)
+	{
+		cursor->m_keyIndices.clear();
+		cursor->m_keyIndices.resize(m_jointCount * 3, 0);
+	}
 
-			float adjustedTime = time;
-			bool adjustedLoop = loop;
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+
+	for (size_t blockStart = 0; blockStart < jointCount; blockStart += JointPoses::k_simdWidth)
+	{
+		KeySample translationSamples[JointPoses::k_simdWidth];
+		KeySample rotationSamples[JointPoses::k_simdWidth];
+		KeySample scaleSamples[JointPoses::k_simdWidth];
 
-			if (jointIdx == 0 && extractRootMotion)
+		// decode the keys of each joint. lanes past the last joint use the default values
+		for (size_t lane = 0; lane < JointPoses::k_simdWidth; ++lane)
+		{
+			KeySample *samples[] = { &translationSamples[lane], &rotationSamples[lane], &scaleSamples[lane] };
+
+			const size_t jointIdx = blockStart + lane;
+			if (jointIdx >= jointCount)
 			{
-				adjustedTime = 0.0f;
-				adjustedLoop = false;
+				for (size_t track = 0; track < 3; ++track)
+				{
+					memcpy(samples[track]->m_value0, k_defaultTrackValues[track], sizeof(samples[track]->m_value0));
+					memcpy(samples[track]->m_value1, k_defaultTrackValues[track], sizeof(samples[track]->m_value1));
+					samples[track]->m_alpha = 0.0f;
+				}
+				continue;
 			}
-			sampleData(3, adjustedTime, frameCount, adjustedLoop, timeKeys, data, jointPose.m_trans);
 
+			uint32_t *keyIndices = &cursor->m_keyIndices[jointIdx * 3];
+
+			const bool rootMotion = jointIdx == 0 && extractRootMotion;
+			findTrackKeys(jointIdx, TRANSLATION, rootMotion ? 0.0f : time, rootMotion ? false : loop, &keyIndices[0], translationSamples[lane].m_value0, translationSamples[lane].m_value1, &translationSamples[lane].m_alpha);
+			findTrackKeys(jointIdx, ROTATION, time, loop, &keyIndices[1], rotationSamples[lane].m_value0, rotationSamples[lane].m_value1, &rotationSamples[lane].m_alpha);
+			findTrackKeys(jointIdx, SCALE, time, loop, &keyIndices[2], scaleSamples[lane].m_value0, scaleSamples[lane].m_value1, &scaleSamples[lane].m_alpha);
 		}
-	}
 
-	// rotation
-	{
-		uint32_t frameCount = m_perJointInfo[jointIdx].m_rotationFrameCount;
-		size_t arrayOffset = m_perJointInfo[jointIdx].m_rotationArrayOffset;
+		// translation and scale
+		__m128 trans[3];
+		for (uint32_t c = 0; c < 3; ++c)
+		{
+			trans[c] = lerpKeySamples(translationSamples, c);
+		}
+		const __m128 scale = lerpKeySamples(scaleSamples, 0);
 
-		if (frameCount)
+		// rotation. decoded keys may be on opposite hemispheres, so the sign is fixed up like in slerp
+		__m128 q0[4];
+		__m128 q1[4];
+		for (uint32_t c = 0; c < 4; ++c)
 		{
-			const float *timeKeys = m_rotationTimeKeys + arrayOffset;
-			const float *data = m_rotationData + (arrayOffset * 4);
+			q0[c] = _mm_setr_ps(rotationSamples[0].m_value0[c], rotationSamples[1].m_value0[c], rotationSamples[2].m_value0[c], rotationSamples[3].m_value0[c]);
+			q1[c] = _mm_setr_ps(rotationSamples[0].m_value1[c], rotationSamples[1].m_value1[c], rotationSamples[2].m_value1[c], rotationSamples[3].m_value1[c]);
+		}
 
-#if 0
-			sampleData(4, time, frameCount, timeKeys, data, jointPose.m_rot);
-#else
-			float alpha = 0.0f;
-			size_t index0 = 0;
-			size_t index1 = 0;
-			util::findPieceWiseLinearCurveIndicesAndAlpha(frameCount, timeKeys, time, loop, &index0, &index1, &alpha);
+		__m128 dot = _mm_mul_ps(q0[0], q1[0]);
+		dot = _mm_add_ps(dot, _mm_mul_ps(q0[1], q1[1]));
+		dot = _mm_add_ps(dot, _mm_mul_ps(q0[2], q1[2]));
+		dot = _mm_add_ps(dot, _mm_mul_ps(q0[3], q1[3]));
+		const __m128 sign = _mm_and_ps(dot, signMask);
 
-			glm::quat resultQ = glm::identity<glm::quat>();
+		const __m128 alpha = _mm_setr_ps(rotationSamples[0].m_alpha, rotationSamples[1].m_alpha, rotationSamples[2].m_alpha, rotationSamples[3].m_alpha);
+		__m128 rot[4];
+		__m128 lengthSq = _mm_setzero_ps();
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			rot[c] = _mm_add_ps(q0[c], _mm_mul_ps(_mm_sub_ps(_mm_xor_ps(q1[c], sign), q0[c]), alpha));
+			lengthSq = _mm_add_ps(lengthSq, _mm_mul_ps(rot[c], rot[c]));
+		}
+		const __m128 length = _mm_sqrt_ps(lengthSq);
 
-			if (index0 == index1)
-			{
-				resultQ = glm::make_quat(&data[index0 * 4]);
-			}
-			else
-			{
-				glm::quat q0 = glm::make_quat(&data[index0 * 4]);
-				glm::quat q1 = glm::make_quat(&data[index1 * 4]);
-				resultQ = glm::normalize(glm::slerp(q0, q1, alpha));
-			}
+		// write the results. the last block may contain joints that are not part of the clip, which must be left unchanged
+		float results[JointPoses::COMPONENT_COUNT][JointPoses::k_simdWidth];
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			_mm_storeu_ps(results[JointPoses::ROT_X + c], _mm_div_ps(rot[c], length));
+		}
+		for (uint32_t c = 0; c < 3; ++c)
+		{
+			_mm_storeu_ps(results[JointPoses::TRANS_X + c], trans[c]);
+		}
+		_mm_storeu_ps(results[JointPoses::SCALE], scale);
 
-			memcpy(jointPose.m_rot, &resultQ[0], sizeof(jointPose.m_rot));
-#endif
+		const size_t laneCount = eastl::min<size_t>(JointPoses::k_simdWidth, jointCount - blockStart);
+		for (size_t c = 0; c < JointPoses::COMPONENT_COUNT; ++c)
+		{
+			memcpy(poses->getComponent(static_cast<JointPoses::Component>(c)) + blockStart, results[c], sizeof(float) * laneCount);
 		}
 	}
+}
 
-	// scale
+void AnimationClip::findTrackKeys(size_t jointIdx, Track track, float time, bool loop, uint32_t *cursor, float *value0, float *value1, float *alpha) const noexcept
+{
+	const auto &info = m_perJointInfo[jointIdx];
+	const uint32_t componentCount = k_trackComponentCounts[track];
+
+	uint32_t frameCount = 0;
+	uint32_t arrayOffset = 0;
+	uint32_t constantFlag = 0;
+	const uint16_t *timeKeys = nullptr;
+	const uint16_t *data = nullptr;
+
+	switch (track)
 	{
-		uint32_t frameCount = m_perJointInfo[jointIdx].m_scaleFrameCount;
-		size_t arrayOffset = m_perJointInfo[jointIdx].m_scaleArrayOffset;
+	case TRANSLATION:
+		frameCount = info.m_translationFrameCount;
+		arrayOffset = info.m_translationArrayOffset;
+		constantFlag = ANIMATION_CLIP_TRACK_FLAG_CONSTANT_TRANSLATION;
+		timeKeys = m_translationTimeKeys;
+		data = m_translationData;
+		break;
+	case ROTATION:
+		frameCount = info.m_rotationFrameCount;
+		arrayOffset = info.m_rotationArrayOffset;
+		constantFlag = ANIMATION_CLIP_TRACK_FLAG_CONSTANT_ROTATION;
+		timeKeys = m_rotationTimeKeys;
+		data = m_rotationData;
+		break;
+	case SCALE:
+		frameCount = info.m_scaleFrameCount;
+		arrayOffset = info.m_scaleArrayOffset;
+		constantFlag = ANIMATION_CLIP_TRACK_FLAG_CONSTANT_SCALE;
+		timeKeys = m_scaleTimeKeys;
+		data = m_scaleData;
+		break;
+	default:
+		assert(false);
+		break;
+	}
 
-		if (frameCount)
-		{
-			const float *timeKeys = m_scaleTimeKeys + arrayOffset;
-			const float *data = m_scaleData + arrayOffset;
+	*alpha = 0.0f;
 
-			sampleData(1, time, frameCount, loop, timeKeys, data, &jointPose.m_scale);
-		}
+	// joints without keys have the identity pose and constant tracks have a single full precision value
+	if (frameCount == 0 || (info.m_flags & constantFlag) != 0)
+	{
+		const float *value = frameCount == 0 ? k_defaultTrackValues[track] : m_constantData + arrayOffset;
+		memcpy(value0, value, sizeof(float) * componentCount);
+		memcpy(value1, value, sizeof(float) * componentCount);
+		return;
 	}
 
-	return jointPose;
+	uint32_t index0 = 0;
+	uint32_t index1 = 0;
+	findKeys(frameCount, timeKeys + arrayOffset, time * m_timeKeyScale, loop, cursor, &index0, &index1, alpha);
+
+	const uint32_t indices[] = { arrayOffset + index0, arrayOffset + index1 };
+	float *values[] = { value0, value1 };
+	for (size_t i = 0; i < 2; ++i)
+	{
+		switch (track)
+		{
+		case TRANSLATION:
+			for (size_t c = 0; c < 3; ++c)
+			{
+				values[i][c] = AnimationClipQuantization::dequantize(data[indices[i] * 3 + c], info.m_translationMin[c], info.m_translationExtent[c]);
+			}
+			break;
+		case ROTATION:
+			AnimationClipQuantization::decodeRotation(data + indices[i] * 3, values[i]);
+			break;
+		case SCALE:
+			values[i][0] = AnimationClipQuantization::dequantize(data[indices[i]], info.m_scaleMin, info.m_scaleExtent);
+			break;
+		default:
+			assert(false);
+			break;
+		}
+	}
 }
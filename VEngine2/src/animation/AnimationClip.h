@@ -1,33 +1,86 @@
 #pragma once
 #include <stdint.h>
+#include <EASTL/vector.h>
 #include "utility/DeletedCopyMove.h"
 #include "JointPose.h"
 
+enum AnimationClipTrackFlags : uint32_t
+{
+	ANIMATION_CLIP_TRACK_FLAG_CONSTANT_TRANSLATION = 1u << 0,
+	ANIMATION_CLIP_TRACK_FLAG_CONSTANT_ROTATION = 1u << 1,
+	ANIMATION_CLIP_TRACK_FLAG_CONSTANT_SCALE = 1u << 2,
+};
+
+/// <summary>
+/// Describes the compressed tracks of a joint. Animated tracks have time keys quantized to 16 bit over the duration of the clip
+/// and 16 bit values: translations and scales are quantized to the range of their track and rotations are stored as the
+/// smallest three components of the quaternion with 15 bit each, using the remaining bits for the index of the largest component.
+/// Constant tracks have a single full precision value in the constant data and no time keys.
+/// </summary>
 struct AnimationClipJointInfo
 {
-	uint32_t m_translationFrameCount;
+	uint32_t m_translationFrameCount; // 0 if the joint has no translation track, 1 for constant tracks
 	uint32_t m_rotationFrameCount;
 	uint32_t m_scaleFrameCount;
-	uint32_t m_translationArrayOffset;
+	uint32_t m_translationArrayOffset; // index of the first key of the track or offset into the constant data for constant tracks
 	uint32_t m_rotationArrayOffset;
 	uint32_t m_scaleArrayOffset;
+	uint32_t m_flags; // AnimationClipTrackFlags
+	float m_translationMin[3];
+	float m_translationExtent[3];
+	float m_scaleMin;
+	float m_scaleExtent;
 };
 
-static_assert(sizeof(AnimationClipJointInfo) == (6 * sizeof(uint32_t)));
+static_assert(sizeof(AnimationClipJointInfo) == (15 * sizeof(uint32_t)));
 static_assert(alignof(AnimationClipJointInfo) == alignof(uint32_t));
 
+/// <summary>
+/// The array sizes of a compressed clip. All arrays are stored in a single allocation in the order of the members of
+/// AnimationClipCreateInfo, which is also the layout of the data in animation clip asset files.
+/// </summary>
+struct AnimationClipLayout
+{
+	uint32_t m_jointCount;
+	uint32_t m_constantDataCount; // number of floats
+	uint32_t m_translationKeyCount;
+	uint32_t m_rotationKeyCount;
+	uint32_t m_scaleKeyCount;
+
+	size_t getMemorySize() const noexcept;
+	bool isValid(const char *memory) const noexcept;
+};
+
 struct AnimationClipCreateInfo
 {
 	uint32_t m_jointCount;
 	float m_duration;
 	const char *m_memory;
 	const AnimationClipJointInfo *m_perJointInfo;
-	const float *m_translationTimeKeys = nullptr;
-	const float *m_rotationTimeKeys = nullptr;
-	const float *m_scaleTimeKeys = nullptr;
-	const float *m_translationData = nullptr; // 3 floats per entry
-	const float *m_rotationData = nullptr; // 4 floats (quaternion xyzw) per entry
-	const float *m_scaleData = nullptr; // 1 float per entry (uniform scale)
+	const float *m_constantData = nullptr; // 3 floats for translations, 4 floats (quaternion xyzw) for rotations and 1 float for scales
+	const uint16_t *m_translationTimeKeys = nullptr;
+	const uint16_t *m_rotationTimeKeys = nullptr;
+	const uint16_t *m_scaleTimeKeys = nullptr;
+	const uint16_t *m_translationData = nullptr; // 3 values per entry
+	const uint16_t *m_rotationData = nullptr; // 3 values (smallest three) per entry
+	const uint16_t *m_scaleData = nullptr; // 1 value per entry (uniform scale)
+
+	/// <summary>
+	/// Sets up the pointers to the arrays of a compressed clip.
+	/// </summary>
+	/// <param name="layout">The array sizes.</param>
+	/// <param name="memory">A pointer to the arrays. Must be at least layout.getMemorySize() bytes large.</param>
+	void setArrays(const AnimationClipLayout &layout, const char *memory) noexcept;
+};
+
+/// <summary>
+/// The key indices found by the last call to AnimationClip::sampleAllJoints(). When the clip is sampled at increasing times,
+/// like during playback, only the following keys need to be checked instead of searching all keys of every joint.
+/// Each instance playing a clip needs its own cursor.
+/// </summary>
+struct AnimationClipCursor
+{
+	eastl::vector<uint32_t> m_keyIndices; // translation, rotation and scale key index of each joint
 };
 
 class AnimationClip
@@ -43,15 +96,38 @@ public:
 	uint32_t getJointCount() const noexcept;
 	JointPose getJointPose(size_t jointIdx, float time, bool loop, bool extractRootMotion) const noexcept;
 
+	/// <summary>
+	/// Samples all joints at the given time and writes the results to poses. Joints of poses that are not part of the clip
+	/// are left unchanged. Rotations are interpolated with nlerp.
+	/// </summary>
+	/// <param name="time">The time to sample the clip at.</param>
+	/// <param name="loop">Whether to interpolate between the last and the first key when sampling outside of the keys.</param>
+	/// <param name="extractRootMotion">Whether to sample the translation of the root joint at the start of the clip.</param>
+	/// <param name="cursor">The cursor of the instance playing this clip. It is resized if necessary.</param>
+	/// <param name="poses">The JointPoses to write to.</param>
+	void sampleAllJoints(float time, bool loop, bool extractRootMotion, AnimationClipCursor *cursor, JointPoses *poses) const noexcept;
+
 private:
+	enum Track
+	{
+		TRANSLATION,
+		ROTATION,
+		SCALE,
+	};
+
 	uint32_t m_jointCount = 0;
 	float m_duration = 0.0f;
 	const char *m_memory = nullptr;
+	float m_timeKeyScale = 0.0f; // converts time into the range of the quantized time keys
 	const AnimationClipJointInfo *m_perJointInfo = nullptr;
-	const float *m_translationTimeKeys = nullptr;
-	const float *m_rotationTimeKeys = nullptr;
-	const float *m_scaleTimeKeys = nullptr;
-	const float *m_translationData = nullptr; // 3 floats per entry
-	const float *m_rotationData = nullptr; // 4 floats (quaternion xyzw) per entry
-	const float *m_scaleData = nullptr; // 1 float per entry (uniform scale)
+	const float *m_constantData = nullptr;
+	const uint16_t *m_translationTimeKeys = nullptr;
+	const uint16_t *m_rotationTimeKeys = nullptr;
+	const uint16_t *m_scaleTimeKeys = nullptr;
+	const uint16_t *m_translationData = nullptr;
+	const uint16_t *m_rotationData = nullptr;
+	const uint16_t *m_scaleData = nullptr;
+
+	// decodes the two keys of a track to interpolate between at the given time. cursor may be null
+	void findTrackKeys(size_t jointIdx, Track track, float time, bool loop, uint32_t *cursor, float *value0, float *value1, float *alpha) const noexcept;
 };
\ No newline at end of file
@@ -0,0 +1,275 @@
+#include "AnimationClipCompressor.h"
+#include <assert.h>
+#include <string.h>
+#include <math.h>
+#include "AnimationClipQuantization.h"
+
+namespace
+{
+	enum class TrackType
+	{
+		TRANSLATION,
+		ROTATION,
+		SCALE,
+	};
+
+	struct SourceTrack
+	{
+		TrackType m_type;
+		uint32_t m_componentCount;
+		uint32_t m_keyCount;
+		const float *m_timeKeys;
+		const float *m_values;
+		float m_tolerance;
+	};
+
+	struct CompressedTracks
+	{
+		eastl::vector<float> m_constantData;
+		eastl::vector<uint16_t> m_timeKeys[3];
+		eastl::vector<uint16_t> m_data[3];
+	};
+}
+
+static float getError(TrackType type, const float *value, const float *reference) noexcept
+{
+	switch (type)
+	{
+	case TrackType::TRANSLATION:
+	{
+		const float dx = value[0] - reference[0];
+		const float dy = value[1] - reference[1];
+		const float dz = value[2] - reference[2];
+		return sqrtf(dx * dx + dy * dy + dz * dz);
+	}
+	case TrackType::ROTATION:
+	{
+		// angle between the rotations. the inputs need not be normalized
+		float dot = 0.0f;
+		float lengthSqValue = 0.0f;
+		float lengthSqReference = 0.0f;
+		for (size_t i = 0; i < 4; ++i)
+		{
+			dot += value[i] * reference[i];
+			lengthSqValue += value[i] * value[i];
+			lengthSqReference += reference[i] * reference[i];
+		}
+		const float cosHalfAngle = fabsf(dot) / sqrtf(lengthSqValue * lengthSqReference);
+		return 2.0f * acosf(cosHalfAngle < 1.0f ? cosHalfAngle : 1.0f);
+	}
+	case TrackType::SCALE:
+		return fabsf(value[0] - reference[0]);
+	default:
+		assert(false);
+		return 0.0f;
+	}
+}
+
+// interpolates like AnimationClip::sampleAllJoints(), which uses nlerp for rotations
+static void interpolate(TrackType type, uint32_t componentCount, const float *x, const float *y, float alpha, float *result) noexcept
+{
+	float sign = 1.0f;
+	if (type == TrackType::ROTATION)
+	{
+		const float dot = x[0] * y[0] + x[1] * y[1] + x[2] * y[2] + x[3] * y[3];
+		sign = dot < 0.0f ? -1.0f : 1.0f;
+	}
+
+	for (uint32_t c = 0; c < componentCount; ++c)
+	{
+		result[c] = x[c] + (y[c] * sign - x[c]) * alpha;
+	}
+}
+
+static void compressTrack(const SourceTrack &track, float duration, CompressedTracks *tracks, AnimationClipJointInfo *jointInfo) noexcept
+{
+	const uint32_t trackIdx = static_cast<uint32_t>(track.m_type);
+	const uint32_t componentCount = track.m_componentCount;
+	const uint32_t quantizedComponentCount = track.m_type == TrackType::ROTATION ? 3 : componentCount;
+	const uint32_t constantFlags[] = { ANIMATION_CLIP_TRACK_FLAG_CONSTANT_TRANSLATION, ANIMATION_CLIP_TRACK_FLAG_CONSTANT_ROTATION, ANIMATION_CLIP_TRACK_FLAG_CONSTANT_SCALE };
+
+	uint32_t *frameCount = nullptr;
+	uint32_t *arrayOffset = nullptr;
+	float *min = nullptr;
+	float *extent = nullptr;
+	switch (track.m_type)
+	{
+	case TrackType::TRANSLATION:
+		frameCount = &jointInfo->m_translationFrameCount;
+		arrayOffset = &jointInfo->m_translationArrayOffset;
+		min = jointInfo->m_translationMin;
+		extent = jointInfo->m_translationExtent;
+		break;
+	case TrackType::ROTATION:
+		frameCount = &jointInfo->m_rotationFrameCount;
+		arrayOffset = &jointInfo->m_rotationArrayOffset;
+		break;
+	case TrackType::SCALE:
+		frameCount = &jointInfo->m_scaleFrameCount;
+		arrayOffset = &jointInfo->m_scaleArrayOffset;
+		min = &jointInfo->m_scaleMin;
+		extent = &jointInfo->m_scaleExtent;
+		break;
+	default:
+		assert(false);
+		break;
+	}
+
+	*frameCount = 0;
+	*arrayOffset = 0;
+
+	if (track.m_keyCount == 0)
+	{
+		return;
+	}
+
+	const float *values = track.m_values;
+
+	// constant track
+	bool constant = duration <= 0.0f;
+	if (!constant)
+	{
+		constant = true;
+		for (uint32_t i = 1; i < track.m_keyCount && constant; ++i)
+		{
+			constant = getError(track.m_type, values + i * componentCount, values) <= track.m_tolerance;
+		}
+	}
+
+	if (constant)
+	{
+		*frameCount = 1;
+		*arrayOffset = static_cast<uint32_t>(tracks->m_constantData.size());
+		jointInfo->m_flags |= constantFlags[trackIdx];
+		tracks->m_constantData.insert(tracks->m_constantData.end(), values, values + componentCount);
+		return;
+	}
+
+	// range reduction
+	if (min)
+	{
+		for (uint32_t c = 0; c < componentCount; ++c)
+		{
+			float maxValue = values[c];
+			min[c] = values[c];
+			for (uint32_t i = 1; i < track.m_keyCount; ++i)
+			{
+				min[c] = fminf(min[c], values[i * componentCount + c]);
+				maxValue = fmaxf(maxValue, values[i * componentCount + c]);
+			}
+			extent[c] = maxValue - min[c];
+		}
+	}
+
+	// quantize all keys
+	eastl::vector<uint16_t> quantizedTimeKeys(track.m_keyCount);
+	eastl::vector<uint16_t> quantizedValues(track.m_keyCount * quantizedComponentCount);
+	eastl::vector<float> decodedValues(track.m_keyCount * componentCount);
+	for (uint32_t i = 0; i < track.m_keyCount; ++i)
+	{
+		quantizedTimeKeys[i] = AnimationClipQuantization::quantize(track.m_timeKeys[i], 0.0f, duration);
+
+		uint16_t *quantized = &quantizedValues[i * quantizedComponentCount];
+		float *decoded = &decodedValues[i * componentCount];
+		if (track.m_type == TrackType::ROTATION)
+		{
+			AnimationClipQuantization::encodeRotation(values + i * 4, quantized);
+			AnimationClipQuantization::decodeRotation(quantized, decoded);
+		}
+		else
+		{
+			for (uint32_t c = 0; c < componentCount; ++c)
+			{
+				quantized[c] = AnimationClipQuantization::quantize(values[i * componentCount + c], min[c], extent[c]);
+				decoded[c] = AnimationClipQuantization::dequantize(quantized[c], min[c], extent[c]);
+			}
+		}
+	}
+
+	// checks if all keys between keyIdx0 and keyIdx1 can be reconstructed by interpolating between them
+	auto canRemoveKeysBetween = [&](uint32_t keyIdx0, uint32_t keyIdx1)
+	{
+		const float timeDiff = static_cast<float>(quantizedTimeKeys[keyIdx1] - quantizedTimeKeys[keyIdx0]);
+		for (uint32_t i = keyIdx0 + 1; i < keyIdx1; ++i)
+		{
+			const float alpha = timeDiff > 0.0f ? (quantizedTimeKeys[i] - quantizedTimeKeys[keyIdx0]) / timeDiff : 0.0f;
+
+			float interpolated[4];
+			interpolate(track.m_type, componentCount, &decodedValues[keyIdx0 * componentCount], &decodedValues[keyIdx1 * componentCount], alpha, interpolated);
+			if (getError(track.m_type, interpolated, values + i * componentCount) > track.m_tolerance)
+			{
+				return false;
+			}
+		}
+		return true;
+	};
+
+	// keyframe reduction. the first and the last key are always kept, so that looping clips interpolate between the same keys
+	eastl::vector<uint32_t> keptKeys;
+	keptKeys.push_back(0);
+	for (uint32_t i = 2; i < track.m_keyCount; ++i)
+	{
+		if (!canRemoveKeysBetween(keptKeys.back(), i))
+		{
+			keptKeys.push_back(i - 1);
+		}
+	}
+	if (track.m_keyCount > 1)
+	{
+		keptKeys.push_back(track.m_keyCount - 1);
+	}
+
+	*frameCount = static_cast<uint32_t>(keptKeys.size());
+	*arrayOffset = static_cast<uint32_t>(tracks->m_timeKeys[trackIdx].size());
+	for (uint32_t keyIdx : keptKeys)
+	{
+		tracks->m_timeKeys[trackIdx].push_back(quantizedTimeKeys[keyIdx]);
+		tracks->m_data[trackIdx].insert(tracks->m_data[trackIdx].end(), &quantizedValues[keyIdx * quantizedComponentCount], &quantizedValues[keyIdx * quantizedComponentCount] + quantizedComponentCount);
+	}
+}
+
+void AnimationClipCompressor::compress(size_t jointCount, const AnimationClipSourceJoint *joints, float duration, const AnimationClipCompressionSettings &settings, AnimationClipLayout *layout, eastl::vector<char> *memory) noexcept
+{
+	eastl::vector<AnimationClipJointInfo> jointInfos(jointCount);
+	CompressedTracks tracks;
+
+	for (size_t i = 0; i < jointCount; ++i)
+	{
+		const auto &joint = joints[i];
+		auto &jointInfo = jointInfos[i];
+		memset(&jointInfo, 0, sizeof(jointInfo));
+
+		compressTrack({ TrackType::TRANSLATION, 3, joint.m_translationKeyCount, joint.m_translationTimeKeys, joint.m_translations, settings.m_translationTolerance }, duration, &tracks, &jointInfo);
+		compressTrack({ TrackType::ROTATION, 4, joint.m_rotationKeyCount, joint.m_rotationTimeKeys, joint.m_rotations, settings.m_rotationTolerance }, duration, &tracks, &jointInfo);
+		compressTrack({ TrackType::SCALE, 1, joint.m_scaleKeyCount, joint.m_scaleTimeKeys, joint.m_scales, settings.m_scaleTolerance }, duration, &tracks, &jointInfo);
+	}
+
+	layout->m_jointCount = static_cast<uint32_t>(jointCount);
+	layout->m_constantDataCount = static_cast<uint32_t>(tracks.m_constantData.size());
+	layout->m_translationKeyCount = static_cast<uint32_t>(tracks.m_timeKeys[0].size());
+	layout->m_rotationKeyCount = static_cast<uint32_t>(tracks.m_timeKeys[1].size());
+	layout->m_scaleKeyCount = static_cast<uint32_t>(tracks.m_timeKeys[2].size());
+
+	// copy the arrays in the order expected by AnimationClipCreateInfo::setArrays()
+	memory->clear();
+	memory->reserve(layout->getMemorySize());
+
+	auto append = [&](const auto &vec)
+	{
+		const char *data = reinterpret_cast<const char *>(vec.data());
+		memory->insert(memory->end(), data, data + vec.size() * sizeof(vec[0]));
+	};
+
+	append(jointInfos);
+	append(tracks.m_constantData);
+	for (const auto &timeKeys : tracks.m_timeKeys)
+	{
+		append(timeKeys);
+	}
+	for (const auto &data : tracks.m_data)
+	{
+		append(data);
+	}
+
+	assert(memory->size() == layout->getMemorySize());
+}
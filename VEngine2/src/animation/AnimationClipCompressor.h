@@ -0,0 +1,47 @@
+#pragma once
+#include <stdint.h>
+#include <EASTL/vector.h>
+#include "AnimationClip.h"
+
+/// <summary>
+/// The uncompressed keys of the tracks of a joint. Time keys must be sorted in ascending order.
+/// </summary>
+struct AnimationClipSourceJoint
+{
+	uint32_t m_translationKeyCount = 0;
+	uint32_t m_rotationKeyCount = 0;
+	uint32_t m_scaleKeyCount = 0;
+	const float *m_translationTimeKeys = nullptr;
+	const float *m_rotationTimeKeys = nullptr;
+	const float *m_scaleTimeKeys = nullptr;
+	const float *m_translations = nullptr; // 3 floats per key
+	const float *m_rotations = nullptr; // 4 floats (quaternion xyzw) per key
+	const float *m_scales = nullptr; // 1 float per key (uniform scale)
+};
+
+/// <summary>
+/// The maximum error between the source keys and the compressed clip.
+/// </summary>
+struct AnimationClipCompressionSettings
+{
+	float m_translationTolerance = 1e-4f; // distance
+	float m_rotationTolerance = 1e-4f; // angle in radians
+	float m_scaleTolerance = 1e-4f;
+};
+
+namespace AnimationClipCompressor
+{
+	/// <summary>
+	/// Compresses the tracks of all joints into the format read by AnimationClip. Tracks whose keys are all within the
+	/// tolerance of the first key become constant tracks. Keys of animated tracks that can be reconstructed from their
+	/// neighbors within the tolerance are removed. The error is measured after quantization, so it also covers the quantization
+	/// error as long as that is below the tolerance on its own.
+	/// </summary>
+	/// <param name="jointCount">The number of joints.</param>
+	/// <param name="joints">The keys of each joint.</param>
+	/// <param name="duration">The duration of the clip, which is used to quantize the time keys.</param>
+	/// <param name="settings">The tolerances.</param>
+	/// <param name="layout">The array sizes of the compressed clip.</param>
+	/// <param name="memory">The arrays of the compressed clip, which can be passed to AnimationClipCreateInfo::setArrays().</param>
+	void compress(size_t jointCount, const AnimationClipSourceJoint *joints, float duration, const AnimationClipCompressionSettings &settings, AnimationClipLayout *layout, eastl::vector<char> *memory) noexcept;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <stdint.h>
+#include <math.h>
+
+/// <summary>
+/// Encoding of the values of compressed animation clips. See AnimationClipJointInfo for the format.
+/// </summary>
+namespace AnimationClipQuantization
+{
+	constexpr float k_maxValue = 65535.0f;
+	constexpr float k_maxRotationComponent = 32767.0f;
+	// components that are not the largest one are within [-1/sqrt(2), 1/sqrt(2)]
+	constexpr float k_rotationComponentRange = 0.70710678f;
+
+	inline uint16_t quantize(float value, float min, float extent) noexcept
+	{
+		const float normalized = extent > 0.0f ? (value - min) / extent : 0.0f;
+		const float clamped = normalized < 0.0f ? 0.0f : normalized > 1.0f ? 1.0f : normalized;
+		return static_cast<uint16_t>(clamped * k_maxValue + 0.5f);
+	}
+
+	inline float dequantize(uint16_t value, float min, float extent) noexcept
+	{
+		return min + value * (extent * (1.0f / k_maxValue));
+	}
+
+	inline void encodeRotation(const float *quat, uint16_t *result) noexcept
+	{
+		uint32_t largestIdx = 0;
+		for (uint32_t i = 1; i < 4; ++i)
+		{
+			largestIdx = fabsf(quat[i]) > fabsf(quat[largestIdx]) ? i : largestIdx;
+		}
+
+		// q and -q are the same rotation, so the largest component can always be made positive
+		const float sign = quat[largestIdx] < 0.0f ? -1.0f : 1.0f;
+
+		uint32_t resultIdx = 0;
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			if (i != largestIdx)
+			{
+				const float normalized = (quat[i] * sign / k_rotationComponentRange) * 0.5f + 0.5f;
+				const float clamped = normalized < 0.0f ? 0.0f : normalized > 1.0f ? 1.0f : normalized;
+				result[resultIdx++] = static_cast<uint16_t>(clamped * k_maxRotationComponent + 0.5f);
+			}
+		}
+
+		// the index of the largest component is stored in the upper bits of the first two values
+		result[0] |= static_cast<uint16_t>((largestIdx & 1) << 15);
+		result[1] |= static_cast<uint16_t>((largestIdx >> 1) << 15);
+	}
+
+	inline void decodeRotation(const uint16_t *data, float *result) noexcept
+	{
+		const uint32_t largestIdx = (data[0] >> 15) | ((data[1] >> 15) << 1);
+
+		float sumSq = 0.0f;
+		uint32_t dataIdx = 0;
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			if (i != largestIdx)
+			{
+				const float value = ((data[dataIdx++] & 0x7FFF) * (1.0f / k_maxRotationComponent) * 2.0f - 1.0f) * k_rotationComponentRange;
+				result[i] = value;
+				sumSq += value * value;
+			}
+		}
+
+		result[largestIdx] = sqrtf(1.0f - sumSq > 0.0f ? 1.0f - sumSq : 0.0f);
+	}
+}
@@ -231,6 +231,27 @@ JointPose AnimationGraphInstance::evaluate(size_t jointIdx) const noexcept
 	return m_graphAsset.isLoaded() && m_graphAsset->getAnimationGraph()->isValid() ? evaluate(jointIdx, m_nodes[m_rootNodeIndex]) : JointPose{};
 }
 
+void AnimationGraphInstance::evaluate(size_t jointCount, JointPoses *poses) noexcept
+{
+	poses->reset(jointCount);
+
+	if (!m_graphAsset.isLoaded() || !m_graphAsset->getAnimationGraph()->isValid())
+	{
+		return;
+	}
+
+	m_clipCursors.resize(m_animationClipCount);
+
+	// a blend node at depth d uses m_scratchPoses[d] for the result of its second input, so the scratch poses must not be
+	// reallocated during evaluation. Lerp2D nodes use two levels, so the depth is bounded by twice the node count
+	if (m_scratchPoses.size() < m_nodeCount * 2)
+	{
+		m_scratchPoses.resize(m_nodeCount * 2);
+	}
+
+	evaluate(m_nodes[m_rootNodeIndex], 0, poses);
+}
+
 void AnimationGraphInstance::updatePhase(float deltaTime) noexcept
 {
 	const float duration = evaluateDuration(m_nodes[m_rootNodeIndex]);
@@ -425,6 +446,76 @@ JointPose AnimationGraphInstance::evaluate(size_t jointIdx, const AnimationGraph
 	return JointPose();
 }
 
+void AnimationGraphInstance::evaluate(const AnimationGraphNode &node, size_t depth, JointPoses *poses) noexcept
+{
+	switch (node.m_nodeType)
+	{
+	case AnimationGraphNodeType::AnimClip:
+	{
+		const auto nodeData = node.m_nodeData.m_clipNodeData;
+		const auto *animClip = m_animationClipAssets[nodeData.m_animClip]->getAnimationClip();
+		const float clipDuration = animClip->getDuration();
+		animClip->sampleAllJoints(m_phase * clipDuration, getBoolParam(nodeData.m_loop), false, &m_clipCursors[nodeData.m_animClip], poses);
+		break;
+	}
+	case AnimationGraphNodeType::Lerp:
+	{
+		const auto nodeData = node.m_nodeData.m_lerpNodeData;
+		lerp(m_nodes[nodeData.m_inputA], m_nodes[nodeData.m_inputB], getFloatParam(nodeData.m_alpha), depth, poses);
+		break;
+	}
+	case AnimationGraphNodeType::Lerp1DArray:
+	{
+		const auto nodeData = node.m_nodeData.m_lerp1DArrayNodeData;
+
+		assert(nodeData.m_inputCount <= AnimationGraphNodeData::Lerp1DArrayNodeData::k_maxInputs);
+
+		size_t index0;
+		size_t index1;
+		float alpha;
+		util::findPieceWiseLinearCurveIndicesAndAlpha(nodeData.m_inputCount, nodeData.m_inputKeys, getFloatParam(nodeData.m_alpha), false, &index0, &index1, &alpha);
+
+		if (index0 == index1)
+		{
+			evaluate(m_nodes[nodeData.m_inputs[index0]], depth, poses);
+		}
+		else
+		{
+			lerp(m_nodes[nodeData.m_inputs[index0]], m_nodes[nodeData.m_inputs[index1]], alpha, depth, poses);
+		}
+		break;
+	}
+	case AnimationGraphNodeType::Lerp2D:
+	{
+		const auto nodeData = node.m_nodeData.m_lerp2DNodeData;
+
+		const float alphaX = getFloatParam(nodeData.m_alphaX);
+		const float alphaY = getFloatParam(nodeData.m_alphaY);
+
+		if (alphaY == 0.0f)
+		{
+			lerp(m_nodes[nodeData.m_inputTL], m_nodes[nodeData.m_inputTR], alphaX, depth, poses);
+		}
+		else if (alphaY == 1.0f)
+		{
+			lerp(m_nodes[nodeData.m_inputBL], m_nodes[nodeData.m_inputBR], alphaX, depth, poses);
+		}
+		else
+		{
+			auto &bottomPoses = m_scratchPoses[depth];
+			bottomPoses.reset(poses->m_jointCount);
+			lerp(m_nodes[nodeData.m_inputTL], m_nodes[nodeData.m_inputTR], alphaX, depth + 1, poses);
+			lerp(m_nodes[nodeData.m_inputBL], m_nodes[nodeData.m_inputBR], alphaX, depth + 1, &bottomPoses);
+			JointPoses::lerp(*poses, bottomPoses, alphaY, poses);
+		}
+		break;
+	}
+	default:
+		assert(false);
+		break;
+	}
+}
+
 float AnimationGraphInstance::evaluateDuration(const AnimationGraphNode &node) const noexcept
 {
 	switch (node.m_nodeType)
@@ -503,6 +594,22 @@ JointPose AnimationGraphInstance::lerp(size_t jointIdx, const AnimationGraphNode
 	}
 }
 
+void AnimationGraphInstance::lerp(const AnimationGraphNode &x, const AnimationGraphNode &y, float alpha, size_t depth, JointPoses *poses) noexcept
+{
+	if (alpha == 0.0f || alpha == 1.0f)
+	{
+		evaluate((alpha == 0.0f) ? x : y, depth, poses);
+	}
+	else
+	{
+		auto &yPoses = m_scratchPoses[depth];
+		yPoses.reset(poses->m_jointCount);
+		evaluate(x, depth + 1, poses);
+		evaluate(y, depth + 1, &yPoses);
+		JointPoses::lerp(*poses, yPoses, alpha, poses);
+	}
+}
+
 float AnimationGraphInstance::lerpDuration(const AnimationGraphNode &x, const AnimationGraphNode &y, float alpha) const noexcept
 {
 	if (alpha == 0.0f || alpha == 1.0f)
@@ -569,7 +676,7 @@ void AnimationGraphInstance::reloadScript() noexcept
 		L = nullptr;
 	}
 
-	L = luaL_newstate();
+	L = LuaUtil::newState();
 	luaL_openlibs(L);
 	ECSLua::open(L);
 	AnimationGraphInstanceLua::open(L);
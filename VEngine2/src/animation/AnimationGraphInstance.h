@@ -2,6 +2,7 @@
 #include "ecs/ECSCommon.h"
 #include "utility/StringID.h"
 #include "JointPose.h"
+#include "AnimationClip.h"
 #include "asset/AnimationGraphAsset.h"
 #include <EASTL/vector.h>
 
@@ -22,6 +23,8 @@ public:
 	Asset<AnimationGraphAsset> getGraphAsset() const noexcept;
 	void preEvaluate(ECS *ecs, EntityID entity, float deltaTime) noexcept;
 	JointPose evaluate(size_t jointIdx) const noexcept;
+	// evaluates all joints at once, which is much faster than calling evaluate() for each joint
+	void evaluate(size_t jointCount, JointPoses *poses) noexcept;
 	void updatePhase(float deltaTime) noexcept;
 	void setPhase(float phase) noexcept;
 	bool setFloatParam(const StringID &paramName, float value) noexcept;
@@ -43,10 +46,14 @@ private:
 	Asset<ScriptAsset> m_controllerScript = nullptr;
 	lua_State *m_scriptLuaState = nullptr;
 	float m_phase = 0.0f;
+	eastl::vector<AnimationClipCursor> m_clipCursors; // one per animation clip of the graph
+	eastl::vector<JointPoses> m_scratchPoses; // intermediate results of blend nodes, indexed by the depth in the graph
 
 	JointPose evaluate(size_t jointIdx, const AnimationGraphNode &node) const noexcept;
+	void evaluate(const AnimationGraphNode &node, size_t depth, JointPoses *poses) noexcept;
 	float evaluateDuration(const AnimationGraphNode &node) const noexcept;
 	JointPose lerp(size_t jointIdx, const AnimationGraphNode &x, const AnimationGraphNode &y, float alpha) const noexcept;
+	void lerp(const AnimationGraphNode &x, const AnimationGraphNode &y, float alpha, size_t depth, JointPoses *poses) noexcept;
 	float lerpDuration(const AnimationGraphNode &x, const AnimationGraphNode &y, float alpha) const noexcept;
 	float getFloatParam(AnimationGraphNodeData::ParameterIndex idx) const noexcept;
 	int32_t getIntParam(AnimationGraphNodeData::ParameterIndex idx) const noexcept;
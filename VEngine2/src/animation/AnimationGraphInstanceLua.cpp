@@ -18,7 +18,7 @@ static int luaAnimationGraphInstanceSetFloatParam(lua_State *L) noexcept
 	const char *name = luaL_checkstring(L, 2);
 	float value = (float)luaL_checknumber(L, 3);
 
-	graphInstance->setFloatParam(StringID(name), value);
+	graphInstance->setFloatParam(StringID::hashOnly(name), value);
 
 	return 0;
 }
@@ -29,7 +29,7 @@ static int luaAnimationGraphInstanceSetIntParam(lua_State *L) noexcept
 	const char *name = luaL_checkstring(L, 2);
 	int32_t value = (int32_t)luaL_checkinteger(L, 3);
 
-	graphInstance->setIntParam(StringID(name), value);
+	graphInstance->setIntParam(StringID::hashOnly(name), value);
 
 	return 0;
 }
@@ -40,7 +40,7 @@ static int luaAnimationGraphInstanceSetBoolParam(lua_State *L) noexcept
 	const char *name = luaL_checkstring(L, 2);
 	bool value = (bool)luaL_checkinteger(L, 3);
 
-	graphInstance->setBoolParam(StringID(name), value);
+	graphInstance->setBoolParam(StringID::hashOnly(name), value);
 
 	return 0;
 }
@@ -51,7 +51,7 @@ static int luaAnimationGraphInstanceGetFloatParam(lua_State *L) noexcept
 	const char *name = luaL_checkstring(L, 2);
 	float value = 0.0f;
 
-	bool result = graphInstance->getFloatParam(StringID(name), &value);
+	bool result = graphInstance->getFloatParam(StringID::hashOnly(name), &value);
 
 	lua_pushnumber(L, (lua_Number)value);
 	lua_pushboolean(L, result);
@@ -65,7 +65,7 @@ static int luaAnimationGraphInstanceGetIntParam(lua_State *L) noexcept
 	const char *name = luaL_checkstring(L, 2);
 	int32_t value = 0;
 
-	bool result = graphInstance->getIntParam(StringID(name), &value);
+	bool result = graphInstance->getIntParam(StringID::hashOnly(name), &value);
 
 	lua_pushinteger(L, (lua_Integer)value);
 	lua_pushboolean(L, result);
@@ -79,7 +79,7 @@ static int luaAnimationGraphInstanceGetBoolParam(lua_State *L) noexcept
 	const char *name = luaL_checkstring(L, 2);
 	bool value = false;
 
-	bool result = graphInstance->getBoolParam(StringID(name), &value);
+	bool result = graphInstance->getBoolParam(StringID::hashOnly(name), &value);
 
 	lua_pushboolean(L, value);
 	lua_pushboolean(L, result);
@@ -31,14 +31,23 @@ void AnimationSystem::update(float deltaTime) noexcept
 			{
 				PROFILING_ZONE_SCOPED_N("Animate Entities");
 
+				// reused for all entities of this range
+				JointPoses poses;
+
 				for (size_t entityIdx = startIdx; entityIdx != endIdx; ++entityIdx)
 				{
 					PROFILING_ZONE_SCOPED_N("Animate Entity");
 
-					PROFILING_ZONE_BEGIN_N(profilingZoneAnimatePrepare, "Animate Prepare");
-
 					auto &smc = skinnedMeshC[entityIdx];
 
+					// skeletons are loaded asynchronously
+					if (!smc.m_skeleton.isLoaded())
+					{
+						continue;
+					}
+
+					PROFILING_ZONE_BEGIN_N(profilingZoneAnimatePrepare, "Animate Prepare");
+
 					// compute matrix palette for this frame
 					{
 						const Skeleton *skel = smc.m_skeleton->getSkeleton();
@@ -81,13 +90,19 @@ void AnimationSystem::update(float deltaTime) noexcept
 
 						PROFILING_ZONE_END(profilingZoneAnimatePrepare);
 
+						// sample all joints at once
+						{
+							PROFILING_ZONE_SCOPED_N("Evaluate Graph");
+							graphInstance->evaluate(jointCount, &poses);
+						}
+
 						// compute local poses (can be done in parallel)
 						auto computeLocalPoses = [&](size_t startIdx, size_t endIdx)
 						{
 							PROFILING_ZONE_SCOPED_N("Compute Local Poses");
 							for (size_t j = startIdx; j < endIdx; ++j)
 							{
-								JointPose pose = graphInstance->evaluate(j);
+								JointPose pose = poses.getJointPose(j);
 
 								glm::mat4 localPose =
 									glm::translate(glm::make_vec3(pose.m_trans))
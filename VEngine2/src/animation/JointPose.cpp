@@ -1,6 +1,8 @@
 #include "JointPose.h"
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <assert.h>
+#include <xmmintrin.h>
 #include "utility/Utility.h"
 
 JointPose JointPose::lerp(const JointPose &x, const JointPose &y, float alpha) noexcept
@@ -42,3 +44,100 @@ JointPose JointPose::lerp2D(const JointPose &tl, const JointPose &tr, const Join
 {
 	return lerp(lerp(tl, tr, horizontalAlpha), lerp(bl, br, horizontalAlpha), verticalAlpha);
 }
+
+void JointPoses::reset(size_t jointCount) noexcept
+{
+	m_jointCount = jointCount;
+	m_paddedJointCount = (jointCount + k_simdWidth - 1) / k_simdWidth * k_simdWidth;
+	m_data.resize(m_paddedJointCount * COMPONENT_COUNT);
+
+	const float identity[COMPONENT_COUNT] = { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+	for (size_t c = 0; c < COMPONENT_COUNT; ++c)
+	{
+		float *component = getComponent(static_cast<Component>(c));
+		for (size_t i = 0; i < m_paddedJointCount; ++i)
+		{
+			component[i] = identity[c];
+		}
+	}
+}
+
+JointPose JointPoses::getJointPose(size_t jointIdx) const noexcept
+{
+	assert(jointIdx < m_jointCount);
+
+	JointPose pose;
+	pose.m_rot[0] = getComponent(ROT_X)[jointIdx];
+	pose.m_rot[1] = getComponent(ROT_Y)[jointIdx];
+	pose.m_rot[2] = getComponent(ROT_Z)[jointIdx];
+	pose.m_rot[3] = getComponent(ROT_W)[jointIdx];
+	pose.m_trans[0] = getComponent(TRANS_X)[jointIdx];
+	pose.m_trans[1] = getComponent(TRANS_Y)[jointIdx];
+	pose.m_trans[2] = getComponent(TRANS_Z)[jointIdx];
+	pose.m_scale = getComponent(SCALE)[jointIdx];
+	return pose;
+}
+
+void JointPoses::setJointPose(size_t jointIdx, const JointPose &pose) noexcept
+{
+	assert(jointIdx < m_jointCount);
+
+	getComponent(ROT_X)[jointIdx] = pose.m_rot[0];
+	getComponent(ROT_Y)[jointIdx] = pose.m_rot[1];
+	getComponent(ROT_Z)[jointIdx] = pose.m_rot[2];
+	getComponent(ROT_W)[jointIdx] = pose.m_rot[3];
+	getComponent(TRANS_X)[jointIdx] = pose.m_trans[0];
+	getComponent(TRANS_Y)[jointIdx] = pose.m_trans[1];
+	getComponent(TRANS_Z)[jointIdx] = pose.m_trans[2];
+	getComponent(SCALE)[jointIdx] = pose.m_scale;
+}
+
+void JointPoses::lerp(const JointPoses &x, const JointPoses &y, float alpha, JointPoses *result) noexcept
+{
+	assert(x.m_jointCount == y.m_jointCount && x.m_jointCount == result->m_jointCount);
+
+	const __m128 a = _mm_set1_ps(alpha);
+	const __m128 oneMinusA = _mm_set1_ps(1.0f - alpha);
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+
+	for (size_t i = 0; i < x.m_paddedJointCount; i += k_simdWidth)
+	{
+		// translation and scale
+		for (size_t c = TRANS_X; c < COMPONENT_COUNT; ++c)
+		{
+			const __m128 x0 = _mm_loadu_ps(x.getComponent(static_cast<Component>(c)) + i);
+			const __m128 y0 = _mm_loadu_ps(y.getComponent(static_cast<Component>(c)) + i);
+			_mm_storeu_ps(result->getComponent(static_cast<Component>(c)) + i, _mm_add_ps(_mm_mul_ps(x0, oneMinusA), _mm_mul_ps(y0, a)));
+		}
+
+		// rotation
+		__m128 qx[4];
+		__m128 qy[4];
+		for (size_t c = 0; c < 4; ++c)
+		{
+			qx[c] = _mm_loadu_ps(x.getComponent(static_cast<Component>(ROT_X + c)) + i);
+			qy[c] = _mm_loadu_ps(y.getComponent(static_cast<Component>(ROT_X + c)) + i);
+		}
+
+		// take the shortest path by flipping the sign of y where the dot product is negative
+		__m128 dot = _mm_mul_ps(qx[0], qy[0]);
+		dot = _mm_add_ps(dot, _mm_mul_ps(qx[1], qy[1]));
+		dot = _mm_add_ps(dot, _mm_mul_ps(qx[2], qy[2]));
+		dot = _mm_add_ps(dot, _mm_mul_ps(qx[3], qy[3]));
+		const __m128 sign = _mm_and_ps(dot, signMask);
+
+		__m128 q[4];
+		__m128 lengthSq = _mm_setzero_ps();
+		for (size_t c = 0; c < 4; ++c)
+		{
+			q[c] = _mm_add_ps(_mm_mul_ps(qx[c], oneMinusA), _mm_mul_ps(_mm_xor_ps(qy[c], sign), a));
+			lengthSq = _mm_add_ps(lengthSq, _mm_mul_ps(q[c], q[c]));
+		}
+
+		const __m128 length = _mm_sqrt_ps(lengthSq);
+		for (size_t c = 0; c < 4; ++c)
+		{
+			_mm_storeu_ps(result->getComponent(static_cast<Component>(ROT_X + c)) + i, _mm_div_ps(q[c], length));
+		}
+	}
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <EASTL/vector.h>
 
 struct JointPose
 {
@@ -42,4 +43,45 @@ struct JointPose
 	/// <param name="verticalAlpha">The alpha value for interpolating between "top" and "bottom" inputs.</param>
 	/// <returns>The intepolated JointPose.</returns>
 	static JointPose lerp2D(const JointPose &tl, const JointPose &tr, const JointPose &bl, const JointPose &br, float horizontalAlpha, float verticalAlpha) noexcept;
+};
+
+/// <summary>
+/// The JointPoses of all joints of a skeleton in SoA layout, with one array per component, so that four joints can be
+/// processed at once with SIMD instructions. The arrays are padded to a multiple of four joints.
+/// </summary>
+struct JointPoses
+{
+	static constexpr size_t k_simdWidth = 4;
+
+	enum Component
+	{
+		ROT_X, ROT_Y, ROT_Z, ROT_W,
+		TRANS_X, TRANS_Y, TRANS_Z,
+		SCALE,
+		COMPONENT_COUNT
+	};
+
+	eastl::vector<float> m_data; // COMPONENT_COUNT arrays of m_paddedJointCount floats
+	size_t m_jointCount = 0;
+	size_t m_paddedJointCount = 0;
+
+	/// <summary>
+	/// Resizes the arrays and sets all joints to the identity pose.
+	/// </summary>
+	/// <param name="jointCount">The number of joints.</param>
+	void reset(size_t jointCount) noexcept;
+	float *getComponent(Component component) noexcept { return m_data.data() + component * m_paddedJointCount; }
+	const float *getComponent(Component component) const noexcept { return m_data.data() + component * m_paddedJointCount; }
+	JointPose getJointPose(size_t jointIdx) const noexcept;
+	void setJointPose(size_t jointIdx, const JointPose &pose) noexcept;
+
+	/// <summary>
+	/// Performs linear interpolation of the translations and scales and normalized linear interpolation of the rotations
+	/// of all joints. x, y and result must have the same joint count. result may alias x or y.
+	/// </summary>
+	/// <param name="x">The first JointPoses to interpolate.</param>
+	/// <param name="y">The second JointPoses to interpolate.</param>
+	/// <param name="alpha">The alpha value to interpolate between x and y.</param>
+	/// <param name="result">The interpolated JointPoses.</param>
+	static void lerp(const JointPoses &x, const JointPoses &y, float alpha, JointPoses *result) noexcept;
 };
\ No newline at end of file
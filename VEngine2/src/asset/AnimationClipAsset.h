@@ -14,16 +14,23 @@ public:
 	enum class Version : uint32_t
 	{
 		V_1_0 = 0,
-		LATEST = V_1_0,
+		V_2_0 = 1, // compressed tracks
+		LATEST = V_2_0,
 	};
 
 	struct FileHeader
 	{
 		char m_magicNumber[8] = { 'V', 'E', 'A', 'N', 'I', 'M', ' ', ' ' };
-		Version m_version = Version::V_1_0;
+		Version m_version = Version::LATEST;
 		uint32_t m_fileSize;
 		uint32_t m_jointCount;
 		float m_duration;
+		uint32_t m_constantDataCount;
+		uint32_t m_translationKeyCount;
+		uint32_t m_rotationKeyCount;
+		uint32_t m_scaleKeyCount;
+
+		AnimationClipLayout getLayout() const noexcept { return { m_jointCount, m_constantDataCount, m_translationKeyCount, m_rotationKeyCount, m_scaleKeyCount }; }
 	};
 
 	explicit AnimationClipAsset(const AssetID &assetID) noexcept : AssetData(assetID, k_assetType) {}
@@ -52,6 +52,12 @@ void AssetData::setAssetStatus(AssetStatus status) noexcept
 	m_assetStatus = static_cast<uint32_t>(status);
 }
 
+bool AssetData::trySetAssetStatus(AssetStatus expectedStatus, AssetStatus status) noexcept
+{
+	uint32_t expected = static_cast<uint32_t>(expectedStatus);
+	return m_assetStatus.compare_exchange_strong(expected, static_cast<uint32_t>(status));
+}
+
 void AssetData::setIsReloadedAssetAvailable(bool reloadedAssetAvailable) noexcept
 {
 	if (reloadedAssetAvailable)
@@ -63,3 +69,18 @@ void AssetData::setIsReloadedAssetAvailable(bool reloadedAssetAvailable) noexcep
 		m_reloadedAssetAvailable.clear();
 	}
 }
+
+bool AssetData::waitUntilLoaded() noexcept
+{
+	return AssetManager::get()->waitForAssetData(this);
+}
+
+uint64_t AssetData::getMemorySize() const noexcept
+{
+	return m_memorySize;
+}
+
+void AssetData::setMemorySize(uint64_t memorySize) noexcept
+{
+	m_memorySize = memorySize;
+}
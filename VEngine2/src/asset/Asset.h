@@ -1,5 +1,6 @@
 #pragma once
 #include <EASTL/atomic.h>
+#include <EASTL/vector.h>
 #include "UUID.h"
 #include <assert.h>
 #include "utility/StringID.h"
@@ -33,14 +34,35 @@ public:
 	const AssetType &getAssetType() const noexcept;
 	bool isReloadedAssetAvailable() const noexcept;
 	void setAssetStatus(AssetStatus status) noexcept;
+	bool trySetAssetStatus(AssetStatus expectedStatus, AssetStatus status) noexcept;
 	void setIsReloadedAssetAvailable(bool reloadedAssetAvailable) noexcept;
+	bool waitUntilLoaded() noexcept;
+	uint64_t getMemorySize() const noexcept;
+	// set by the asset handler. used to keep the asset caches of the AssetManager within budget
+	void setMemorySize(uint64_t memorySize) noexcept;
 
 private:
+	friend class AssetManager;
+
 	eastl::atomic<int32_t> m_referenceCount = 0;
 	eastl::atomic<uint32_t> m_assetStatus = static_cast<uint32_t>(AssetStatus::UNLOADED);
 	eastl::atomic_flag m_reloadedAssetAvailable = false;
 	AssetID m_assetID;
 	AssetType m_assetType;
+	uint64_t m_memorySize = 0;
+
+	// unreferenced assets kept loaded by the AssetManager are linked in an LRU list, guarded by the AssetManager
+	AssetData *m_cachePrev = nullptr;
+	AssetData *m_cacheNext = nullptr;
+	bool m_cached = false;
+
+	// state of an in-flight load, guarded by the AssetManager
+	eastl::atomic<uint32_t> m_pendingDependencyCount = 0;
+	eastl::atomic<uint32_t> m_finishState = 0; // AssetManager::FinishState, claimed by the thread that calls the handler
+	eastl::vector<AssetData *> m_loadDependencies; // referenced until this asset finished loading
+	eastl::vector<AssetData *> m_loadDependents; // assets waiting for this asset to finish loading
+	uint64_t m_loadQueueTime = 0; // AssetLoadTelemetry timestamp of when the asset was queued for loading
+	eastl::vector<AssetID> m_dependencyIDs; // reported by the handler when loading the asset, used to reload the assets depending on it
 };
 
 template<typename T>
@@ -55,6 +77,7 @@ public:
 	~Asset() noexcept;
 	bool release() noexcept;
 	bool isLoaded() const noexcept;
+	bool waitUntilLoaded() const noexcept;
 	T *get() const noexcept;
 	T &operator*() const noexcept;
 	T *operator->() const noexcept;
@@ -163,6 +186,12 @@ inline bool Asset<T>::isLoaded() const noexcept
 	return m_assetData && m_assetData->getAssetStatus() == AssetStatus::READY;
 }
 
+template<typename T>
+inline bool Asset<T>::waitUntilLoaded() const noexcept
+{
+	return m_assetData && m_assetData->waitUntilLoaded();
+}
+
 template<typename T>
 inline T *Asset<T>::get() const noexcept
 {
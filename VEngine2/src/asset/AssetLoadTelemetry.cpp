@@ -0,0 +1,247 @@
+#include "AssetLoadTelemetry.h"
+#include "filesystem/VirtualFileSystem.h"
+#include <EASTL/string.h>
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <stdio.h>
+
+static thread_local AssetLoadRecord *s_currentRecord = nullptr;
+
+static const char *k_stageNames[] = { "io", "decode", "finalize", "upload" };
+static_assert(eastl::size(k_stageNames) == static_cast<size_t>(AssetLoadStage::COUNT));
+
+static double nsToMs(uint64_t ns) noexcept
+{
+	return ns * 1e-6;
+}
+
+AssetLoadTelemetry::StageTimer::StageTimer(AssetLoadStage stage) noexcept
+	:m_record(s_currentRecord),
+	m_stage(stage),
+	m_startTime(m_record ? getTimestamp() : 0)
+{
+}
+
+AssetLoadTelemetry::StageTimer::~StageTimer() noexcept
+{
+	setStage(m_stage);
+}
+
+void AssetLoadTelemetry::StageTimer::setStage(AssetLoadStage stage) noexcept
+{
+	if (m_record)
+	{
+		const uint64_t time = getTimestamp();
+		m_record->m_stageTimes[static_cast<size_t>(m_stage)] += time - m_startTime;
+		m_startTime = time;
+	}
+	m_stage = stage;
+}
+
+void AssetLoadTelemetry::addBytesRead(uint64_t bytes) noexcept
+{
+	if (s_currentRecord)
+	{
+		s_currentRecord->m_bytesRead += bytes;
+	}
+}
+
+uint64_t AssetLoadTelemetry::getTimestamp() noexcept
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+AssetLoadRecord *AssetLoadTelemetry::setCurrentRecord(AssetLoadRecord *record) noexcept
+{
+	AssetLoadRecord *prevRecord = s_currentRecord;
+	s_currentRecord = record;
+	return prevRecord;
+}
+
+void AssetLoadTelemetry::addRecord(const AssetLoadRecord &record) noexcept
+{
+	const uint64_t endTime = getTimestamp();
+
+	LOCK_HOLDER(m_mutex);
+
+	if (m_records.size() < k_maxRecords)
+	{
+		m_records.push_back(record);
+	}
+	else
+	{
+		m_records[m_nextRecord] = record;
+	}
+	m_nextRecord = (m_nextRecord + 1) % k_maxRecords;
+
+	auto it = m_typeStats.find(record.m_assetType);
+	if (it == m_typeStats.end())
+	{
+		AssetTypeLoadStats typeStats;
+		typeStats.m_assetType = record.m_assetType;
+		it = m_typeStats.insert(eastl::make_pair(record.m_assetType, typeStats)).first;
+	}
+
+	auto &typeStats = it->second;
+	++typeStats.m_loadCount;
+	typeStats.m_failedCount += record.m_success ? 0 : 1;
+	typeStats.m_bytesRead += record.m_bytesRead;
+	for (size_t i = 0; i < static_cast<size_t>(AssetLoadStage::COUNT); ++i)
+	{
+		typeStats.m_stageTimes[i] += record.m_stageTimes[i];
+	}
+	typeStats.m_handlerTime += record.m_handlerTime;
+	typeStats.m_maxHandlerTime = eastl::max(typeStats.m_maxHandlerTime, record.m_handlerTime);
+	typeStats.m_latency += record.m_latency;
+
+	m_bytesRead += record.m_bytesRead;
+	m_firstLoadStart = eastl::min(m_firstLoadStart, endTime - record.m_latency);
+	m_lastLoadEnd = eastl::max(m_lastLoadEnd, endTime);
+}
+
+void AssetLoadTelemetry::clear() noexcept
+{
+	LOCK_HOLDER(m_mutex);
+	m_records.clear();
+	m_nextRecord = 0;
+	m_typeStats.clear();
+	m_bytesRead = 0;
+	m_firstLoadStart = UINT64_MAX;
+	m_lastLoadEnd = 0;
+}
+
+void AssetLoadTelemetry::getRecords(eastl::vector<AssetLoadRecord> &records) const noexcept
+{
+	LOCK_HOLDER(m_mutex);
+
+	records.clear();
+	records.reserve(m_records.size());
+
+	// once the ring buffer is full, m_nextRecord is the oldest record
+	const size_t first = m_records.size() < k_maxRecords ? 0 : m_nextRecord;
+	for (size_t i = 0; i < m_records.size(); ++i)
+	{
+		records.push_back(m_records[(first + i) % m_records.size()]);
+	}
+}
+
+void AssetLoadTelemetry::getTypeStats(eastl::vector<AssetTypeLoadStats> &typeStats) const noexcept
+{
+	LOCK_HOLDER(m_mutex);
+	typeStats.clear();
+	typeStats.reserve(m_typeStats.size());
+	for (const auto &p : m_typeStats)
+	{
+		typeStats.push_back(p.second);
+	}
+}
+
+bool AssetLoadTelemetry::getTypeStats(const AssetType &assetType, AssetTypeLoadStats *typeStats) const noexcept
+{
+	LOCK_HOLDER(m_mutex);
+	auto it = m_typeStats.find(assetType);
+	if (it == m_typeStats.end())
+	{
+		return false;
+	}
+	*typeStats = it->second;
+	return true;
+}
+
+double AssetLoadTelemetry::getThroughput() const noexcept
+{
+	LOCK_HOLDER(m_mutex);
+	if (m_lastLoadEnd <= m_firstLoadStart || m_firstLoadStart == UINT64_MAX)
+	{
+		return 0.0;
+	}
+	return m_bytesRead / ((m_lastLoadEnd - m_firstLoadStart) * 1e-9);
+}
+
+bool AssetLoadTelemetry::writeCSV(const char *path) const noexcept
+{
+	eastl::vector<AssetLoadRecord> records;
+	getRecords(records);
+
+	eastl::string csv = "asset_id,asset_type,success,reload,bytes_read";
+	for (const char *stageName : k_stageNames)
+	{
+		csv.append_sprintf(",%s_ms", stageName);
+	}
+	csv += ",handler_ms,latency_ms\n";
+
+	for (const auto &record : records)
+	{
+		char assetTypeStr[AssetType::k_uuidStringSize];
+		record.m_assetType.toString(assetTypeStr);
+
+		csv.append_sprintf("\"%s\",%s,%d,%d,%llu", record.m_assetID.m_string, assetTypeStr, (int)record.m_success, (int)record.m_reload, (unsigned long long)record.m_bytesRead);
+		for (uint64_t stageTime : record.m_stageTimes)
+		{
+			csv.append_sprintf(",%.3f", nsToMs(stageTime));
+		}
+		csv.append_sprintf(",%.3f,%.3f\n", nsToMs(record.m_handlerTime), nsToMs(record.m_latency));
+	}
+
+	return VirtualFileSystem::get().writeFile(path, csv.length(), csv.c_str(), false);
+}
+
+bool AssetLoadTelemetry::writeJSON(const char *path) const noexcept
+{
+	eastl::vector<AssetLoadRecord> records;
+	eastl::vector<AssetTypeLoadStats> typeStats;
+	getRecords(records);
+	getTypeStats(typeStats);
+
+	auto stagesToJSON = [](const uint64_t *stageTimes)
+	{
+		nlohmann::json j;
+		for (size_t i = 0; i < static_cast<size_t>(AssetLoadStage::COUNT); ++i)
+		{
+			j[k_stageNames[i]] = nsToMs(stageTimes[i]);
+		}
+		return j;
+	};
+
+	nlohmann::json j;
+	j["throughputMBps"] = getThroughput() / (1024.0 * 1024.0);
+
+	j["types"] = nlohmann::json::array();
+	for (const auto &stats : typeStats)
+	{
+		char assetTypeStr[AssetType::k_uuidStringSize];
+		stats.m_assetType.toString(assetTypeStr);
+
+		nlohmann::json jtype;
+		jtype["assetType"] = assetTypeStr;
+		jtype["loadCount"] = stats.m_loadCount;
+		jtype["failedCount"] = stats.m_failedCount;
+		jtype["bytesRead"] = stats.m_bytesRead;
+		jtype["stagesMs"] = stagesToJSON(stats.m_stageTimes);
+		jtype["handlerMs"] = nsToMs(stats.m_handlerTime);
+		jtype["maxHandlerMs"] = nsToMs(stats.m_maxHandlerTime);
+		jtype["latencyMs"] = nsToMs(stats.m_latency);
+		j["types"].push_back(jtype);
+	}
+
+	j["records"] = nlohmann::json::array();
+	for (const auto &record : records)
+	{
+		char assetTypeStr[AssetType::k_uuidStringSize];
+		record.m_assetType.toString(assetTypeStr);
+
+		nlohmann::json jrecord;
+		jrecord["assetID"] = record.m_assetID.m_string;
+		jrecord["assetType"] = assetTypeStr;
+		jrecord["success"] = record.m_success;
+		jrecord["reload"] = record.m_reload;
+		jrecord["bytesRead"] = record.m_bytesRead;
+		jrecord["stagesMs"] = stagesToJSON(record.m_stageTimes);
+		jrecord["handlerMs"] = nsToMs(record.m_handlerTime);
+		jrecord["latencyMs"] = nsToMs(record.m_latency);
+		j["records"].push_back(jrecord);
+	}
+
+	const std::string str = j.dump(4);
+	return VirtualFileSystem::get().writeFile(path, str.length(), str.c_str(), false);
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include <stdint.h>
+#include <EASTL/vector.h>
+#include <EASTL/hash_map.h>
+#include "Asset.h"
+#include "utility/SpinLock.h"
+#include "utility/DeletedCopyMove.h"
+
+enum class AssetLoadStage
+{
+	IO, // reading or mapping the asset file
+	DECODE, // parsing and validating the file contents
+	FINALIZE, // creating the runtime objects of the asset, like physics meshes
+	UPLOAD, // creating GPU resources and enqueueing their uploads
+	COUNT
+};
+
+/// <summary>
+/// Timings of a single call to AssetHandler::loadAssetData(). All times are in nanoseconds.
+/// </summary>
+struct AssetLoadRecord
+{
+	AssetID m_assetID;
+	AssetType m_assetType;
+	uint64_t m_bytesRead = 0; // size of the files read or mapped
+	uint64_t m_stageTimes[static_cast<size_t>(AssetLoadStage::COUNT)] = {};
+	uint64_t m_handlerTime = 0; // total time spent in AssetHandler::loadAssetData(), including time not covered by any stage
+	uint64_t m_latency = 0; // time from queueing the asset until it finished loading, including the time its dependencies took
+	bool m_success = false;
+	bool m_reload = false;
+};
+
+/// <summary>
+/// The sums of all load records of an AssetType.
+/// </summary>
+struct AssetTypeLoadStats
+{
+	AssetType m_assetType;
+	uint64_t m_loadCount = 0;
+	uint64_t m_failedCount = 0;
+	uint64_t m_bytesRead = 0;
+	uint64_t m_stageTimes[static_cast<size_t>(AssetLoadStage::COUNT)] = {};
+	uint64_t m_handlerTime = 0;
+	uint64_t m_maxHandlerTime = 0;
+	uint64_t m_latency = 0;
+};
+
+/// <summary>
+/// Collects how long loading assets takes, split by AssetLoadStage, and how many bytes were read.
+/// The AssetManager creates a record for every call to AssetHandler::loadAssetData() and asset handlers fill it in
+/// through StageTimer and addBytesRead(), which refer to the record of the load running on the calling thread.
+/// With memory mapped files, page faults are attributed to the stage that first touches the data.
+/// All functions are thread-safe.
+/// </summary>
+class AssetLoadTelemetry
+{
+public:
+	// only the most recent records are kept, the per-type stats cover all loads
+	static constexpr size_t k_maxRecords = 4096;
+
+	/// <summary>
+	/// Adds the elapsed time to the current stage of the load running on the calling thread. The stage can be switched
+	/// with setStage(), so a handler can time its stages with a single StageTimer. Does nothing if there is no such load.
+	/// </summary>
+	class StageTimer
+	{
+	public:
+		explicit StageTimer(AssetLoadStage stage) noexcept;
+		DELETED_COPY_MOVE(StageTimer);
+		~StageTimer() noexcept;
+		void setStage(AssetLoadStage stage) noexcept;
+
+	private:
+		AssetLoadRecord *m_record;
+		AssetLoadStage m_stage;
+		uint64_t m_startTime;
+	};
+
+	/// <summary>
+	/// Adds to the bytes read by the load running on the calling thread. Does nothing if there is no such load.
+	/// </summary>
+	static void addBytesRead(uint64_t bytes) noexcept;
+
+	/// <summary>
+	/// Gets a monotonic timestamp in nanoseconds.
+	/// </summary>
+	static uint64_t getTimestamp() noexcept;
+
+	/// <summary>
+	/// Makes the given record the target of StageTimer and addBytesRead() on the calling thread.
+	/// </summary>
+	/// <returns>The previous record of the calling thread, which needs to be restored once the load finished.</returns>
+	static AssetLoadRecord *setCurrentRecord(AssetLoadRecord *record) noexcept;
+
+	explicit AssetLoadTelemetry() noexcept = default;
+	DELETED_COPY_MOVE(AssetLoadTelemetry);
+
+	void addRecord(const AssetLoadRecord &record) noexcept;
+	void clear() noexcept;
+
+	/// <summary>
+	/// Copies the kept records, oldest first.
+	/// </summary>
+	void getRecords(eastl::vector<AssetLoadRecord> &records) const noexcept;
+	void getTypeStats(eastl::vector<AssetTypeLoadStats> &typeStats) const noexcept;
+	bool getTypeStats(const AssetType &assetType, AssetTypeLoadStats *typeStats) const noexcept;
+
+	/// <summary>
+	/// Gets the throughput in bytes per second over the time between the first and the last recorded load.
+	/// </summary>
+	double getThroughput() const noexcept;
+
+	/// <summary>
+	/// Writes the kept records as CSV with one line per load.
+	/// </summary>
+	/// <param name="path">The virtual path of the file to write.</param>
+	bool writeCSV(const char *path) const noexcept;
+
+	/// <summary>
+	/// Writes the throughput, the per-type stats and the kept records as JSON.
+	/// </summary>
+	/// <param name="path">The virtual path of the file to write.</param>
+	bool writeJSON(const char *path) const noexcept;
+
+private:
+	mutable SpinLock m_mutex;
+	eastl::vector<AssetLoadRecord> m_records; // ring buffer
+	size_t m_nextRecord = 0;
+	eastl::hash_map<AssetType, AssetTypeLoadStats, UUIDHash> m_typeStats;
+	uint64_t m_bytesRead = 0;
+	uint64_t m_firstLoadStart = UINT64_MAX;
+	uint64_t m_lastLoadEnd = 0;
+};
@@ -4,7 +4,9 @@
 #include "UUID.h"
 #include "filesystem/VirtualFileSystem.h"
 #include "filesystem/Path.h"
-#include "AssetMetaDataRegistry.h" // for getAssetIDAndType()
+#include "AssetMetaDataRegistry.h" // for getAssetIDAndType() and setAssetDependencies()
+#include "job/JobSystem.h"
+#include "utility/Thread.h"
 
 AssetManager *AssetManager::s_instance = nullptr;
 FileSystemWatcherHandle s_filesystemWatcherHandle = NULL_FILE_SYSTEM_WATCHER_HANDLE;
@@ -26,7 +28,7 @@ static void fileSystemWatcherCallback(const char *path, FileChangeType changeTyp
 			AssetType assetType;
 			if (AssetMetaDataRegistry::getAssetIDAndType(metaFileName, &assetID, &assetType))
 			{
-				reinterpret_cast<AssetManager *>(userData)->reloadAsset(assetID, assetType);
+				reinterpret_cast<AssetManager *>(userData)->queueReload(assetID, assetType);
 			}
 		}
 	}
@@ -51,12 +53,28 @@ void AssetManager::shutdown()
 
 	Log::info("Shutting down AssetManager");
 
+	// load jobs and in-flight loads still reference their assets
+	while (s_instance->m_pendingLoadCount.load() != 0)
+	{
+		Thread::yield();
+	}
+
 	if (s_filesystemWatcherHandle != NULL_FILE_SYSTEM_WATCHER_HANDLE)
 	{
 		VirtualFileSystem::get().closeFileSystemWatcher(s_filesystemWatcherHandle);
 		s_filesystemWatcherHandle = NULL_FILE_SYSTEM_WATCHER_HANDLE;
 	}
 
+	// unload cached assets
+	{
+		for (auto &cache : s_instance->m_assetCaches)
+		{
+			cache.second.m_budget = 0;
+		}
+
+		s_instance->trimCaches();
+	}
+
 	// unload reloaded assets
 	if (!s_instance->m_reloadedAssetMap.empty())
 	{
@@ -142,10 +160,11 @@ AssetID AssetManager::createAsset(const AssetType &assetType, const char *path,
 	return resultAssetID;
 }
 
-AssetData *AssetManager::getAssetData(const AssetID &assetID, const AssetType &assetType) noexcept
+Asset<AssetData> AssetManager::getAssetData(const AssetID &assetID, const AssetType &assetType, job::Counter **counter) noexcept
 {
+	Asset<AssetData> asset;
 	AssetData *assetData = nullptr;
-	AssetHandler *handler = nullptr;
+	bool runLoadJob = false;
 	{
 		// need to hold mutex so other treads dont try to create the same asset if it couldnt be found in the map
 		LOCK_HOLDER(m_assetMutex);
@@ -153,119 +172,467 @@ AssetData *AssetManager::getAssetData(const AssetID &assetID, const AssetType &a
 		// try to find asset in map
 		auto assetMapIt = m_assetMap.find(assetID);
 
+		// the last reference to this asset was just released and unloadAsset() is about to destroy it.
+		// remove it from the map, so that unloadAsset() does not destroy the new asset data.
+		if (assetMapIt != m_assetMap.end() && !assetMapIt->second->m_cached && assetMapIt->second->getReferenceCount() == 0)
+		{
+			m_assetMap.erase(assetMapIt);
+			assetMapIt = m_assetMap.end();
+		}
+
 		// found asset in map
 		if (assetMapIt != m_assetMap.end())
 		{
-			return assetMapIt->second;
+			assetData = assetMapIt->second;
+
+			// the asset is referenced again, so it no longer counts towards the cache budget
+			if (assetData->m_cached)
+			{
+				removeFromCache(assetData);
+			}
+
+			// the caller wants to wait on a counter, so give it a job that finishes together with the pending load
+			const auto status = assetData->getAssetStatus();
+			runLoadJob = counter && (status == AssetStatus::QUEUED_FOR_LOADING || status == AssetStatus::LOADING);
 		}
+		else
+		{
+			// couldnt find asset -> queue it for loading from disk
+			AssetHandler *handler = nullptr;
 
-		// couldnt find asset -> try to load from disk
-		Log::info("Loading asset \"%s\".", assetID.m_string);
+			// try to find asset handler
+			{
+				LOCK_HOLDER(m_assetHandlerMutex);
 
-		
+				auto handlerIt = m_assetHandlerMap.find(assetType);
 
-		// try to find asset handler
-		{
-			LOCK_HOLDER(m_assetHandlerMutex);
+				// failed to find handler
+				if (handlerIt == m_assetHandlerMap.end())
+				{
+					Log::warn("Could not find asset handler for asset \"%s\"!", assetID.m_string);
+					return {};
+				}
 
-			auto handlerIt = m_assetHandlerMap.find(assetType);
+				handler = handlerIt->second;
+			}
+
+			assetData = handler->createEmptyAssetData(assetID, assetType);
 
-			// failed to find handler
-			if (handlerIt == m_assetHandlerMap.end())
+			if (!assetData)
 			{
-				Log::warn("Could not find asset handler for asset \"%s\"!", assetID.m_string);
-				return nullptr;
+				Log::warn("Failed to create asset \"%s\"!", assetID.m_string);
+				return {};
 			}
 
-			handler = handlerIt->second;
+			assetData->setAssetStatus(AssetStatus::QUEUED_FOR_LOADING);
+			assetData->m_loadQueueTime = AssetLoadTelemetry::getTimestamp();
+
+			// store in map
+			m_assetMap[assetID] = assetData;
+
+			runLoadJob = true;
 		}
 
-		// load asset
-		assetData = handler->createEmptyAssetData(assetID, assetType);
+		// acquire the caller's reference while holding the mutex. otherwise the load job could release
+		// the last reference and unload the asset before the caller got to acquire it.
+		asset = Asset<AssetData>(assetData);
 
-		if (!assetData)
+		// the job holds a reference, so the asset can not be unloaded before the job ran
+		if (runLoadJob)
 		{
-			Log::warn("Failed to create asset \"%s\"!", assetID.m_string);
-			return nullptr;
+			assetData->acquire();
+			++m_pendingLoadCount;
 		}
+	}
 
-		// store in map
-		m_assetMap[assetID] = assetData;
+	if (runLoadJob)
+	{
+		// only wait for the whole dependency graph if the caller wants to be notified through the counter
+		job::Job loadJob(counter ? waitForAssetJob : loadAssetJob, assetData);
+		job::run(1, &loadJob, counter);
+	}
+
+	return asset;
+}
+
+bool AssetManager::waitForAssetData(AssetData *assetData) noexcept
+{
+	// take over the load if no job started it yet
+	if (assetData->trySetAssetStatus(AssetStatus::QUEUED_FOR_LOADING, AssetStatus::LOADING))
+	{
+		beginLoad(assetData);
 	}
 
-	if (!handler->loadAssetData(assetData, (eastl::string("/assets/") + assetID.m_string).c_str()))
+	// help with dependencies that are still queued and run the handler if its finish job is still queued. this way a waiting
+	// thread never blocks on a job that is still queued and asset handlers can simply wait on their dependencies.
+	while (isLoadPending(assetData))
 	{
+		Asset<AssetData> dependency = getPendingDependency(assetData);
+
+		if (dependency)
 		{
-			LOCK_HOLDER(m_assetMutex);
-			m_assetMap.erase(assetID);
+			waitForAssetData(dependency.get());
+		}
+		else if (!tryFinishLoad(assetData))
+		{
+			// some other thread is running the load or its handler, so this only takes as long as that load
+			Thread::yield();
 		}
-		handler->destroyAssetData(assetData);
-		Log::warn("Failed to load asset \"%s\"!", assetID.m_string);
-		return nullptr;
 	}
 
-	Log::info("Successfully loaded asset \"%s\".", assetID.m_string);
+	return assetData->getAssetStatus() == AssetStatus::READY;
+}
 
-	return assetData;
+bool AssetManager::isLoadPending(const AssetData *assetData) noexcept
+{
+	const auto status = assetData->getAssetStatus();
+	return status == AssetStatus::QUEUED_FOR_LOADING || status == AssetStatus::LOADING;
 }
 
-void AssetManager::unloadAsset(const AssetID &assetID, const AssetType &assetType, AssetData *assetData) noexcept
+AssetHandler *AssetManager::getAssetHandler(const AssetType &assetType) noexcept
 {
-	// assetID is owned by the asset and when the asset gets deleted, so does the assetID,
-	// which is why using the original assetID string is a bad idea.
-	auto assetIDCopy = assetID;
-	Log::info("Unloading asset \"%s\".", assetIDCopy.m_string);
+	LOCK_HOLDER(m_assetHandlerMutex);
+
+	auto handlerIt = m_assetHandlerMap.find(assetType);
+	return handlerIt != m_assetHandlerMap.end() ? handlerIt->second : nullptr;
+}
 
-	AssetHandler *handler = nullptr;
+Asset<AssetData> AssetManager::getPendingDependency(AssetData *assetData) noexcept
+{
+	LOCK_HOLDER(m_assetMutex);
 
-	// try to find asset handler
+	// prefer dependencies that no thread started loading yet
+	AssetData *pendingDependency = nullptr;
+	for (AssetData *dependency : assetData->m_loadDependencies)
 	{
-		LOCK_HOLDER(m_assetHandlerMutex);
+		const auto status = dependency->getAssetStatus();
+		if (status == AssetStatus::QUEUED_FOR_LOADING)
+		{
+			return dependency;
+		}
+		else if (!pendingDependency && status == AssetStatus::LOADING)
+		{
+			pendingDependency = dependency;
+		}
+	}
 
-		auto handlerIt = m_assetHandlerMap.find(assetType);
+	return pendingDependency;
+}
 
-		// failed to find handler
-		if (handlerIt == m_assetHandlerMap.end())
+void AssetManager::beginLoad(AssetData *assetData) noexcept
+{
+	// the load holds a reference until it completed
+	assetData->acquire();
+	++m_pendingLoadCount;
+
+	const AssetID &assetID = assetData->getAssetID();
+
+	Log::info("Loading asset \"%s\".", assetID.m_string);
+
+	eastl::vector<AssetDependency> dependencies;
+	if (AssetHandler *handler = getAssetHandler(assetData->getAssetType()))
+	{
+		handler->getAssetDependencies((eastl::string("/assets/") + assetID.m_string).c_str(), dependencies);
+	}
+
+	// persisted in the registry index and kept with the asset to find the assets that need to be reloaded together with a dependency
+	{
+		eastl::vector<AssetID> dependencyIDs;
+		dependencyIDs.reserve(dependencies.size());
+		for (const auto &dependency : dependencies)
 		{
-			Log::warn("Could not find asset handler for asset \"%s\"!", assetIDCopy.m_string);
-			return;
+			dependencyIDs.push_back(dependency.m_assetID);
 		}
+		AssetMetaDataRegistry::get()->setAssetDependencies(assetID, dependencyIDs.size(), dependencyIDs.data());
 
-		handler = handlerIt->second;
+		LOCK_HOLDER(m_assetMutex);
+		assetData->m_dependencyIDs = eastl::move(dependencyIDs);
 	}
 
-	// remove from map
-	bool erased = false;
+	// keeps the load from completing while dependencies are still being added
+	assetData->m_finishState = FINISH_STATE_WAITING;
+	assetData->m_pendingDependencyCount = 1;
+
+	for (const auto &dependency : dependencies)
+	{
+		// queues a load job if the dependency is not loaded yet, so the whole dependency graph loads in parallel
+		Asset<AssetData> dependencyAsset = getAssetData(dependency.m_assetID, dependency.m_assetType, nullptr);
+
+		if (!dependencyAsset || dependencyAsset.get() == assetData)
+		{
+			continue;
+		}
+
+		LOCK_HOLDER(m_assetMutex);
+
+		// neither asset of a dependency cycle could finish loading, so the edge closing the cycle is dropped
+		if (isLoadPending(dependencyAsset.get()) && waitsOnLoad(dependencyAsset.get(), assetData))
+		{
+			Log::warn("Asset \"%s\" has a cyclic dependency on asset \"%s\"! The dependency is ignored.", assetID.m_string, dependency.m_assetID.m_string);
+			continue;
+		}
+
+		// keep the dependency alive until this asset is loaded, so that it is not unloaded and loaded again in between
+		dependencyAsset->acquire();
+		assetData->m_loadDependencies.push_back(dependencyAsset.get());
+
+		// the status only changes from pending to finished while holding the mutex, see finishLoad()
+		if (isLoadPending(dependencyAsset.get()))
+		{
+			dependencyAsset->m_loadDependents.push_back(assetData);
+			++assetData->m_pendingDependencyCount;
+		}
+	}
+
+	if (--assetData->m_pendingDependencyCount == 0)
+	{
+		readyToFinishLoad(assetData);
+	}
+}
+
+bool AssetManager::waitsOnLoad(const AssetData *assetData, const AssetData *dependency) noexcept
+{
+	// m_loadDependencies only contains assets while their dependent is loading, so this only walks the pending part of the graph
+	eastl::vector<const AssetData *> visited;
+	eastl::vector<const AssetData *> stack;
+	stack.push_back(assetData);
+
+	while (!stack.empty())
+	{
+		const AssetData *current = stack.back();
+		stack.pop_back();
+
+		if (current == dependency)
+		{
+			return true;
+		}
+
+		if (eastl::find(visited.begin(), visited.end(), current) != visited.end())
+		{
+			continue;
+		}
+		visited.push_back(current);
+
+		for (const AssetData *next : current->m_loadDependencies)
+		{
+			if (isLoadPending(next))
+			{
+				stack.push_back(next);
+			}
+		}
+	}
+
+	return false;
+}
+
+void AssetManager::readyToFinishLoad(AssetData *assetData) noexcept
+{
+	assetData->m_finishState = FINISH_STATE_READY;
+	tryFinishLoad(assetData);
+}
+
+bool AssetManager::tryFinishLoad(AssetData *assetData) noexcept
+{
+	uint32_t expected = FINISH_STATE_READY;
+	if (assetData->m_finishState.compare_exchange_strong(expected, FINISH_STATE_CLAIMED))
+	{
+		finishLoad(assetData);
+		return true;
+	}
+	return false;
+}
+
+void AssetManager::finishLoad(AssetData *assetData) noexcept
+{
+	const AssetID &assetID = assetData->getAssetID();
+
+	// all dependencies finished loading, so the handler does not need to wait on any of them
+	AssetHandler *handler = getAssetHandler(assetData->getAssetType());
+	const bool success = handler && loadAssetData(handler, assetData, false);
+
+	if (success)
+	{
+		Log::info("Successfully loaded asset \"%s\".", assetID.m_string);
+	}
+	else
+	{
+		// failed assets stay in the map with an ERROR status until they are unloaded or successfully reloaded
+		Log::warn("Failed to load asset \"%s\"!", assetID.m_string);
+	}
+
+	eastl::vector<AssetData *> dependencies;
+	eastl::vector<AssetData *> dependents;
+	{
+		LOCK_HOLDER(m_assetMutex);
+		assetData->setAssetStatus(success ? AssetStatus::READY : AssetStatus::ERROR);
+		dependencies.swap(assetData->m_loadDependencies);
+		dependents.swap(assetData->m_loadDependents);
+	}
+
+	// finish the dependents bottom-up. the first one continues on this thread, the others run as jobs
+	AssetData *continuation = nullptr;
+	for (AssetData *dependent : dependents)
+	{
+		if (--dependent->m_pendingDependencyCount == 0)
+		{
+			if (!continuation)
+			{
+				continuation = dependent;
+			}
+			else
+			{
+				// a thread waiting on the dependent may claim the finish before the job runs, so the job needs its own reference
+				dependent->m_finishState = FINISH_STATE_READY;
+				dependent->acquire();
+				++m_pendingLoadCount;
+
+				job::Job finishJob(finishLoadJob, dependent);
+				job::run(1, &finishJob, nullptr);
+			}
+		}
+	}
+
+	for (AssetData *dependency : dependencies)
+	{
+		dependency->release();
+	}
+
+	if (continuation)
+	{
+		readyToFinishLoad(continuation);
+	}
+
+	assetData->release();
+	--m_pendingLoadCount;
+}
+
+bool AssetManager::loadAssetData(AssetHandler *handler, AssetData *assetData, bool reload) noexcept
+{
+	AssetLoadRecord record;
+	record.m_assetID = assetData->getAssetID();
+	record.m_assetType = assetData->getAssetType();
+	record.m_reload = reload;
+
+	// a handler may wait on another asset, which then loads on this thread
+	AssetLoadRecord *prevRecord = AssetLoadTelemetry::setCurrentRecord(&record);
+	const uint64_t startTime = AssetLoadTelemetry::getTimestamp();
+
+	record.m_success = handler->loadAssetData(assetData, (eastl::string("/assets/") + record.m_assetID.m_string).c_str());
+
+	const uint64_t endTime = AssetLoadTelemetry::getTimestamp();
+	AssetLoadTelemetry::setCurrentRecord(prevRecord);
+
+	record.m_handlerTime = endTime - startTime;
+	record.m_latency = reload ? record.m_handlerTime : endTime - assetData->m_loadQueueTime;
+	m_loadTelemetry.addRecord(record);
+
+	return record.m_success;
+}
+
+void AssetManager::loadAssetJob(void *assetData) noexcept
+{
+	AssetData *data = static_cast<AssetData *>(assetData);
+	if (data->trySetAssetStatus(AssetStatus::QUEUED_FOR_LOADING, AssetStatus::LOADING))
+	{
+		s_instance->beginLoad(data);
+	}
+	data->release();
+	--s_instance->m_pendingLoadCount;
+}
+
+void AssetManager::waitForAssetJob(void *assetData) noexcept
+{
+	AssetData *data = static_cast<AssetData *>(assetData);
+	s_instance->waitForAssetData(data);
+	data->release();
+	--s_instance->m_pendingLoadCount;
+}
+
+void AssetManager::finishLoadJob(void *assetData) noexcept
+{
+	AssetData *data = static_cast<AssetData *>(assetData);
+	s_instance->tryFinishLoad(data);
+	data->release();
+	--s_instance->m_pendingLoadCount;
+}
+
+void AssetManager::unloadAsset(const AssetID &assetID, const AssetType &assetType, AssetData *assetData) noexcept
+{
+	eastl::vector<AssetData *> evictedAssets;
+	bool cached = false;
+
+	// remove from map or keep it cached
 	{
 		LOCK_HOLDER(m_assetMutex);
 		auto it = m_assetMap.find(assetID);
 
 		// guard against deleting new asset data when unloading old asset data after a reload
+		// (doesn't matter if the asset was not in the map, which might happen with old versions of reloaded assets)
 		if (it != m_assetMap.end() && it->second == assetData)
 		{
-			erased = m_assetMap.erase(assetID) >= 1;
+			auto cacheIt = m_assetCaches.find(assetType);
+
+			// only keep successfully loaded assets that fit into the budget of their type
+			if (assetData->getAssetStatus() == AssetStatus::READY
+				&& cacheIt != m_assetCaches.end()
+				&& cacheIt->second.m_budget > 0
+				&& assetData->getMemorySize() <= cacheIt->second.m_budget)
+			{
+				insertIntoCache(cacheIt->second, assetData);
+				evictFromCache(cacheIt->second, evictedAssets);
+				cached = true;
+			}
+			else
+			{
+				m_assetMap.erase(it);
+			}
 		}
 	}
 
-	// destroy asset data 
-	// (doesn't matter if the asset was not in the map, which might happen with old versions of reloaded assets)
-	handler->destroyAssetData(assetData);
+	// destroy outside of the mutex: destroying an asset releases the assets it references
+	if (!cached)
+	{
+		destroyAssetData(assetData);
+	}
 
-	Log::info("Successfully unloaded asset \"%s\".", assetIDCopy.m_string);
+	for (AssetData *evictedAsset : evictedAssets)
+	{
+		destroyAssetData(evictedAsset);
+	}
 }
 
 void AssetManager::reloadAsset(const AssetID &assetID, const AssetType &assetType) noexcept
 {
-	AssetData *newAssetData = nullptr;
-	AssetData *oldAssetData = nullptr;
-	Asset<AssetData> prevReloadedAsset;
+	// nothing references a cached asset, so simply evict it. the next getAsset() loads the new version.
+	{
+		AssetData *evictedAssetData = nullptr;
+		{
+			LOCK_HOLDER(m_assetMutex);
+
+			auto assetIt = m_assetMap.find(assetID);
+			if (assetIt != m_assetMap.end() && assetIt->second->m_cached && assetIt->second->getAssetType() == assetType)
+			{
+				evictedAssetData = assetIt->second;
+				removeFromCache(evictedAssetData);
+				m_assetMap.erase(assetIt);
+			}
+		}
+
+		if (evictedAssetData)
+		{
+			destroyAssetData(evictedAssetData);
+			return;
+		}
+	}
+
+	Asset<AssetData> oldAsset;
 	{
 		LOCK_HOLDER(m_assetMutex);
 
 		auto assetIt = m_assetMap.find(assetID);
 
-		// only allow reloading already loaded assets
-		if (assetIt == m_assetMap.end())
+		// only allow reloading already loaded assets. an asset without references is about to be unloaded.
+		if (assetIt == m_assetMap.end() || assetIt->second->getReferenceCount() == 0)
 		{
 			return;
 		}
@@ -283,81 +650,192 @@ void AssetManager::reloadAsset(const AssetID &assetID, const AssetType &assetTyp
 			return;
 		}
 
-		// is this asset already queued for reload?
-		auto reloadedAssetIt = m_reloadedAssetMap.find(assetID);
-		if (reloadedAssetIt != m_reloadedAssetMap.end())
+		// no need to reload if the asset is still queued and has not yet begun loading
+		if (assetIt->second->getAssetStatus() == AssetStatus::QUEUED_FOR_LOADING)
 		{
-			auto status = reloadedAssetIt->second->getAssetStatus();
+			return;
+		}
 
-			// no need to reload if the asset is still queued and has not yet begun loading
-			if (status == AssetStatus::QUEUED_FOR_LOADING)
-			{
-				return;
-			}
+		// keeps the old asset data alive, so it can be compared against the map entry once the new version is loaded
+		oldAsset = assetIt->second;
+	}
 
-			// TODO: check and handle other possible states?
+	// load from disk
+	Log::info("Reloading asset \"%s\".", assetID.m_string);
 
-			// get the previous entry so that we can manually release it later without running into problems with (the lack of) reentrant locks
-			prevReloadedAsset = reloadedAssetIt->second;
-			m_reloadedAssetMap.erase(reloadedAssetIt);
-		}
+	AssetHandler *handler = getAssetHandler(assetType);
 
-		// load from disk
-		Log::info("Reloading asset \"%s\".", assetID.m_string);
+	// failed to find handler
+	if (!handler)
+	{
+		Log::warn("Could not find asset handler for asset \"%s\"!", assetID.m_string);
+		return;
+	}
 
-		AssetHandler *handler = nullptr;
+	AssetData *newAssetData = handler->createEmptyAssetData(assetID, assetType);
+	if (!newAssetData)
+	{
+		Log::warn("Failed to create asset \"%s\"!", assetID.m_string);
+		return;
+	}
+
+	// the dependencies may have changed with the new version
+	{
+		eastl::vector<AssetDependency> dependencies;
+		handler->getAssetDependencies((eastl::string("/assets/") + assetID.m_string).c_str(), dependencies);
 
-		// try to find asset handler
+		newAssetData->m_dependencyIDs.reserve(dependencies.size());
+		for (const auto &dependency : dependencies)
 		{
-			LOCK_HOLDER(m_assetHandlerMutex);
+			newAssetData->m_dependencyIDs.push_back(dependency.m_assetID);
+		}
+		AssetMetaDataRegistry::get()->setAssetDependencies(assetID, newAssetData->m_dependencyIDs.size(), newAssetData->m_dependencyIDs.data());
+	}
 
-			auto handlerIt = m_assetHandlerMap.find(assetType);
+	// load without holding the mutex, since the handler gets the assets this asset depends on
+	if (!loadAssetData(handler, newAssetData, true))
+	{
+		handler->destroyAssetData(newAssetData);
+		Log::warn("Failed to load asset \"%s\"!", assetID.m_string);
+		return;
+	}
+
+	// like finishLoad(), so that handlers do not need to set the status themselves
+	newAssetData->setAssetStatus(AssetStatus::READY);
+
+	Asset<AssetData> prevReloadedAsset;
+	bool replaced = false;
+	{
+		LOCK_HOLDER(m_assetMutex);
 
-			// failed to find handler
-			if (handlerIt == m_assetHandlerMap.end())
+		// another thread may have reloaded the asset in the meantime
+		auto assetIt = m_assetMap.find(assetID);
+		if (assetIt != m_assetMap.end() && assetIt->second == oldAsset.get())
+		{
+			// get the previous entry so that we can manually release it later without running into problems with (the lack of) reentrant locks
+			auto reloadedAssetIt = m_reloadedAssetMap.find(assetID);
+			if (reloadedAssetIt != m_reloadedAssetMap.end())
 			{
-				Log::warn("Could not find asset handler for asset \"%s\"!", assetID.m_string);
-				return;
+				prevReloadedAsset = reloadedAssetIt->second;
+				m_reloadedAssetMap.erase(reloadedAssetIt);
 			}
 
-			handler = handlerIt->second;
+			// replace old asset in map with reloaded one
+			assetIt->second = newAssetData;
+
+			// hold an internal reference to the reloaded asset. this needs to happen while holding the mutex,
+			// otherwise getAsset() would consider the unreferenced asset to be in the process of being unloaded.
+			m_reloadedAssetMap[assetID] = newAssetData;
+
+			replaced = true;
 		}
+	}
+
+	if (!replaced)
+	{
+		handler->destroyAssetData(newAssetData);
+		Log::warn("Discarded reloaded asset \"%s\" because the asset was replaced while reloading it!", assetID.m_string);
+		return;
+	}
+
+	prevReloadedAsset.release();
+
+	// flag old asset as having a newer version available
+	oldAsset->setIsReloadedAssetAvailable(true);
 
-		// load asset
-		newAssetData = handler->createEmptyAssetData(assetID, assetType);
+	Log::info("Successfully reloaded asset \"%s\".", assetID.m_string);
+}
+
+void AssetManager::queueReload(const AssetID &assetID, const AssetType &assetType) noexcept
+{
+	// a file is often written in several steps, so every change restarts the delay
+	PendingReload pendingReload;
+	pendingReload.m_assetType = assetType;
+	pendingReload.m_lastQueueTime = AssetLoadTelemetry::getTimestamp();
+
+	LOCK_HOLDER(m_reloadMutex);
+	m_pendingReloads[assetID] = pendingReload;
+}
+
+void AssetManager::update() noexcept
+{
+	eastl::vector<AssetDependency> *assets = nullptr;
+	{
+		LOCK_HOLDER(m_reloadMutex);
+
+		// a second batch could reload a dependent before the first batch reloaded its dependency
+		if (m_reloadInProgress || m_pendingReloads.empty())
 		{
-			if (!newAssetData)
+			return;
+		}
+
+		const uint64_t time = AssetLoadTelemetry::getTimestamp();
+		for (auto it = m_pendingReloads.begin(); it != m_pendingReloads.end();)
+		{
+			if (time - it->second.m_lastQueueTime >= m_reloadDelay)
 			{
-				Log::warn("Failed to create asset \"%s\"!", assetID.m_string);
-				return;
+				if (!assets)
+				{
+					assets = new eastl::vector<AssetDependency>();
+				}
+				assets->push_back({ it->first, it->second.m_assetType });
+				it = m_pendingReloads.erase(it);
 			}
-
-			if (!handler->loadAssetData(newAssetData, (eastl::string("/assets/") + assetID.m_string).c_str()))
+			else
 			{
-				handler->destroyAssetData(newAssetData);
-				Log::warn("Failed to load asset \"%s\"!", assetID.m_string);
-				return;
+				++it;
 			}
 		}
 
-		// replace old asset in map with reloaded one
-		oldAssetData = assetIt->second;
-		assetIt->second = newAssetData;
+		if (!assets)
+		{
+			return;
+		}
+
+		m_reloadInProgress = true;
 	}
 
-	prevReloadedAsset.release();
-	
-	// hold an internal reference to the reloaded asset
+	// shutdown() waits for the reload job
+	++m_pendingLoadCount;
+
+	job::Job batchJob(reloadJob, assets);
+	job::run(1, &batchJob, nullptr, job::Priority::LOW);
+}
+
+void AssetManager::setReloadDelay(uint64_t delayMilliseconds) noexcept
+{
+	LOCK_HOLDER(m_reloadMutex);
+	m_reloadDelay = delayMilliseconds * 1000000;
+}
+
+bool AssetManager::isReloadPending() noexcept
+{
+	LOCK_HOLDER(m_reloadMutex);
+	return m_reloadInProgress || !m_pendingReloads.empty();
+}
+
+void AssetManager::setCacheBudget(const AssetType &assetType, uint64_t budgetBytes) noexcept
+{
 	{
 		LOCK_HOLDER(m_assetMutex);
-		m_reloadedAssetMap[assetID] = newAssetData;
-		m_assetMap[assetID] = newAssetData;
+		m_assetCaches[assetType].m_budget = budgetBytes;
 	}
 
-	// flag old asset as having a newer version available
-	oldAssetData->setIsReloadedAssetAvailable(true);
+	trimCaches();
+}
 
-	Log::info("Successfully reloaded asset \"%s\".", assetID.m_string);
+uint64_t AssetManager::getCacheBudget(const AssetType &assetType) noexcept
+{
+	LOCK_HOLDER(m_assetMutex);
+	auto it = m_assetCaches.find(assetType);
+	return it != m_assetCaches.end() ? it->second.m_budget : 0;
+}
+
+uint64_t AssetManager::getCacheSize(const AssetType &assetType) noexcept
+{
+	LOCK_HOLDER(m_assetMutex);
+	auto it = m_assetCaches.find(assetType);
+	return it != m_assetCaches.end() ? it->second.m_size : 0;
 }
 
 void AssetManager::registerAssetHandler(const AssetType &assetType, AssetHandler *handler) noexcept
@@ -370,4 +848,285 @@ void AssetManager::unregisterAssetHandler(const AssetType &assetType)
 {
 	LOCK_HOLDER(m_assetHandlerMutex);
 	m_assetHandlerMap.erase(assetType);
+}
+
+AssetLoadTelemetry *AssetManager::getLoadTelemetry() noexcept
+{
+	return &m_loadTelemetry;
+}
+
+void AssetManager::reloadWithDependents(const eastl::vector<AssetDependency> &assets) noexcept
+{
+	struct ReloadNode
+	{
+		AssetType m_assetType;
+		eastl::vector<AssetID> m_dependencyIDs;
+		eastl::vector<AssetID> m_dependentIDs;
+		uint32_t m_pendingDependencyCount = 0; // dependencies that are reloaded but did not finish yet
+		bool m_reload = false;
+	};
+
+	// snapshot the dependency graph of the loaded assets
+	eastl::hash_map<AssetID, ReloadNode, StringIDHash> nodes;
+	{
+		LOCK_HOLDER(m_assetMutex);
+		for (const auto &p : m_assetMap)
+		{
+			auto &node = nodes[p.first];
+			node.m_assetType = p.second->getAssetType();
+			node.m_dependencyIDs = p.second->m_dependencyIDs;
+		}
+	}
+
+	for (auto &p : nodes)
+	{
+		for (const auto &dependencyID : p.second.m_dependencyIDs)
+		{
+			auto it = nodes.find(dependencyID);
+			if (it != nodes.end())
+			{
+				it->second.m_dependentIDs.push_back(p.first);
+			}
+		}
+	}
+
+	// mark the changed assets and everything that depends on them
+	eastl::vector<AssetID> stack;
+	for (const auto &asset : assets)
+	{
+		auto it = nodes.find(asset.m_assetID);
+		if (it != nodes.end() && it->second.m_assetType == asset.m_assetType && !it->second.m_reload)
+		{
+			it->second.m_reload = true;
+			stack.push_back(asset.m_assetID);
+		}
+	}
+
+	while (!stack.empty())
+	{
+		const AssetID assetID = stack.back();
+		stack.pop_back();
+
+		for (const auto &dependentID : nodes[assetID].m_dependentIDs)
+		{
+			auto &dependent = nodes[dependentID];
+			if (!dependent.m_reload)
+			{
+				dependent.m_reload = true;
+				stack.push_back(dependentID);
+			}
+		}
+	}
+
+	// reload in topological order, so handlers of dependents get the new versions of their dependencies
+	size_t reloadCount = 0;
+	for (auto &p : nodes)
+	{
+		if (!p.second.m_reload)
+		{
+			continue;
+		}
+
+		++reloadCount;
+		for (const auto &dependencyID : p.second.m_dependencyIDs)
+		{
+			auto it = nodes.find(dependencyID);
+			if (it != nodes.end() && it->second.m_reload && it->first != p.first)
+			{
+				++p.second.m_pendingDependencyCount;
+			}
+		}
+	}
+
+	eastl::vector<AssetID> level;
+	for (const auto &p : nodes)
+	{
+		if (p.second.m_reload && p.second.m_pendingDependencyCount == 0)
+		{
+			level.push_back(p.first);
+		}
+	}
+
+	eastl::vector<AssetDependency> levelAssets;
+	eastl::vector<job::Job> jobs;
+	size_t reloadedCount = 0;
+	while (reloadedCount < reloadCount)
+	{
+		if (level.empty())
+		{
+			Log::warn("AssetManager: Found a dependency cycle while reloading assets. Reloading the remaining assets in arbitrary order.");
+
+			for (auto &p : nodes)
+			{
+				if (p.second.m_reload && p.second.m_pendingDependencyCount != 0)
+				{
+					p.second.m_pendingDependencyCount = 0;
+					level.push_back(p.first);
+				}
+			}
+		}
+
+		// the assets of a level do not depend on each other, so they reload in parallel
+		levelAssets.clear();
+		jobs.clear();
+		for (const auto &assetID : level)
+		{
+			levelAssets.push_back({ assetID, nodes[assetID].m_assetType });
+		}
+		for (auto &asset : levelAssets)
+		{
+			jobs.push_back(job::Job(reloadAssetJob, &asset));
+		}
+
+		job::Counter *counter = nullptr;
+		job::run(jobs.size(), jobs.data(), &counter);
+		job::waitForCounter(counter);
+		job::freeCounter(counter);
+
+		reloadedCount += level.size();
+
+		// dependents whose reloaded dependencies all finished form the next level
+		eastl::vector<AssetID> nextLevel;
+		for (const auto &assetID : level)
+		{
+			for (const auto &dependentID : nodes[assetID].m_dependentIDs)
+			{
+				auto &dependent = nodes[dependentID];
+				if (dependent.m_reload && dependent.m_pendingDependencyCount != 0 && --dependent.m_pendingDependencyCount == 0)
+				{
+					nextLevel.push_back(dependentID);
+				}
+			}
+		}
+		level.swap(nextLevel);
+	}
+}
+
+void AssetManager::reloadJob(void *assets) noexcept
+{
+	auto *reloadAssets = static_cast<eastl::vector<AssetDependency> *>(assets);
+	s_instance->reloadWithDependents(*reloadAssets);
+	delete reloadAssets;
+
+	{
+		LOCK_HOLDER(s_instance->m_reloadMutex);
+		s_instance->m_reloadInProgress = false;
+	}
+
+	--s_instance->m_pendingLoadCount;
+}
+
+void AssetManager::reloadAssetJob(void *asset) noexcept
+{
+	const auto *reloadAsset = static_cast<const AssetDependency *>(asset);
+	s_instance->reloadAsset(reloadAsset->m_assetID, reloadAsset->m_assetType);
+}
+
+void AssetManager::insertIntoCache(AssetCache &cache, AssetData *assetData) noexcept
+{
+	assert(!assetData->m_cached);
+
+	assetData->m_cached = true;
+	assetData->m_cachePrev = nullptr;
+	assetData->m_cacheNext = cache.m_head;
+
+	if (cache.m_head)
+	{
+		cache.m_head->m_cachePrev = assetData;
+	}
+	else
+	{
+		cache.m_tail = assetData;
+	}
+
+	cache.m_head = assetData;
+	cache.m_size += assetData->getMemorySize();
+}
+
+void AssetManager::removeFromCache(AssetData *assetData) noexcept
+{
+	assert(assetData->m_cached);
+
+	AssetCache &cache = m_assetCaches[assetData->getAssetType()];
+
+	if (assetData->m_cachePrev)
+	{
+		assetData->m_cachePrev->m_cacheNext = assetData->m_cacheNext;
+	}
+	else
+	{
+		cache.m_head = assetData->m_cacheNext;
+	}
+
+	if (assetData->m_cacheNext)
+	{
+		assetData->m_cacheNext->m_cachePrev = assetData->m_cachePrev;
+	}
+	else
+	{
+		cache.m_tail = assetData->m_cachePrev;
+	}
+
+	assetData->m_cached = false;
+	assetData->m_cachePrev = nullptr;
+	assetData->m_cacheNext = nullptr;
+	cache.m_size -= assetData->getMemorySize();
+}
+
+void AssetManager::evictFromCache(AssetCache &cache, eastl::vector<AssetData *> &evictedAssets) noexcept
+{
+	while (cache.m_tail && (cache.m_size > cache.m_budget || cache.m_budget == 0))
+	{
+		AssetData *assetData = cache.m_tail;
+		removeFromCache(assetData);
+		m_assetMap.erase(assetData->getAssetID());
+		evictedAssets.push_back(assetData);
+	}
+}
+
+void AssetManager::trimCaches() noexcept
+{
+	// destroying an evicted asset may release more assets into the caches
+	while (true)
+	{
+		eastl::vector<AssetData *> evictedAssets;
+		{
+			LOCK_HOLDER(m_assetMutex);
+			for (auto &cache : m_assetCaches)
+			{
+				evictFromCache(cache.second, evictedAssets);
+			}
+		}
+
+		if (evictedAssets.empty())
+		{
+			break;
+		}
+
+		for (AssetData *assetData : evictedAssets)
+		{
+			destroyAssetData(assetData);
+		}
+	}
+}
+
+void AssetManager::destroyAssetData(AssetData *assetData) noexcept
+{
+	// assetID is owned by the asset and when the asset gets deleted, so does the assetID,
+	// which is why using the original assetID string is a bad idea.
+	auto assetIDCopy = assetData->getAssetID();
+	Log::info("Unloading asset \"%s\".", assetIDCopy.m_string);
+
+	AssetHandler *handler = getAssetHandler(assetData->getAssetType());
+
+	// failed to find handler
+	if (!handler)
+	{
+		Log::warn("Could not find asset handler for asset \"%s\"!", assetIDCopy.m_string);
+		return;
+	}
+
+	handler->destroyAssetData(assetData);
+
+	Log::info("Successfully unloaded asset \"%s\".", assetIDCopy.m_string);
 }
\ No newline at end of file
@@ -3,11 +3,18 @@
 #include <stdint.h>
 #include "UUID.h"
 #include "Asset.h"
+#include "AssetLoadTelemetry.h"
 #include "utility/SpinLock.h"
 
 class AssetData;
 class AssetHandler;
 class AssetDatabase;
+struct AssetDependency;
+
+namespace job
+{
+	struct Counter;
+}
 
 class AssetManager
 {
@@ -19,30 +26,114 @@ public:
 	// assets
 	AssetID createAsset(const AssetType &assetType, const char *path, const char *sourcePath) noexcept;
 
+	// queues the asset for loading on the job system and returns immediately. poll Asset<T>::isLoaded() or call
+	// Asset<T>::waitUntilLoaded(). if counter is not null, it is incremented until the asset finished loading.
 	template<typename T>
-	Asset<T> getAsset(const AssetID &assetID) noexcept;
+	Asset<T> getAsset(const AssetID &assetID, job::Counter **counter = nullptr) noexcept;
+	// returns true if the asset was loaded successfully. loads the asset on the calling thread if no job started loading it yet.
+	bool waitForAssetData(AssetData *assetData) noexcept;
 	void unloadAsset(const AssetID &assetID, const AssetType &assetType, AssetData *assetData) noexcept;
+	// reloads an already loaded asset on the calling thread. assets depending on it are not reloaded.
 	void reloadAsset(const AssetID &assetID, const AssetType &assetType) noexcept;
+	// queues an asset for a debounced reload, which is used when the file system watcher reports modified asset files.
+	// once an asset was not queued again for the reload delay, update() reloads it in a background job,
+	// followed by all loaded assets that depend on it, directly or indirectly. dependencies are reloaded before their dependents.
+	void queueReload(const AssetID &assetID, const AssetType &assetType) noexcept;
+	// starts the queued reloads whose delay expired. should be called once per frame.
+	void update() noexcept;
+	void setReloadDelay(uint64_t delayMilliseconds) noexcept;
+	// returns true while there are queued reloads or a background reload is in progress
+	bool isReloadPending() noexcept;
+	// keeps unreferenced assets of the given type loaded as long as their total memory size fits into the budget,
+	// evicting the least recently released ones first. the default budget of 0 unloads assets as soon as they are unreferenced.
+	void setCacheBudget(const AssetType &assetType, uint64_t budgetBytes) noexcept;
+	uint64_t getCacheBudget(const AssetType &assetType) noexcept;
+	// returns the total memory size of the unreferenced assets of the given type that are still loaded
+	uint64_t getCacheSize(const AssetType &assetType) noexcept;
 	
 	// asset handlers
 	
 	void registerAssetHandler(const AssetType &assetType, AssetHandler *handler) noexcept;
 	void unregisterAssetHandler(const AssetType &assetType);
 
+	// timings and bytes read of all asset loads
+	AssetLoadTelemetry *getLoadTelemetry() noexcept;
+
 private:
+	struct AssetCache
+	{
+		uint64_t m_budget = 0;
+		uint64_t m_size = 0;
+		AssetData *m_head = nullptr; // most recently released
+		AssetData *m_tail = nullptr; // least recently released
+	};
+
+	struct PendingReload
+	{
+		AssetType m_assetType;
+		uint64_t m_lastQueueTime; // AssetLoadTelemetry timestamp of the latest file change
+	};
+
+	// the handler of a load is called by exactly one thread once all dependencies finished. this is either the thread
+	// finishing the last dependency, a queued job, or a thread waiting on the asset, whichever claims it first.
+	enum FinishState : uint32_t
+	{
+		FINISH_STATE_WAITING, // dependencies are still loading
+		FINISH_STATE_READY, // all dependencies finished, but no thread claimed the finish yet
+		FINISH_STATE_CLAIMED, // a thread is calling the handler or already did
+	};
+
+	static constexpr uint64_t k_defaultReloadDelay = 250; // milliseconds
+
 	static AssetManager *s_instance;
 	eastl::hash_map<AssetID, AssetData *, StringIDHash> m_assetMap;
 	eastl::hash_map<AssetID, Asset<AssetData>, StringIDHash> m_reloadedAssetMap;
 	eastl::hash_map<AssetType, AssetHandler *, UUIDHash> m_assetHandlerMap;
+	eastl::hash_map<AssetType, AssetCache, UUIDHash> m_assetCaches; // guarded by m_assetMutex
 	SpinLock m_assetMutex;
 	SpinLock m_assetHandlerMutex;
+	SpinLock m_reloadMutex;
+	eastl::hash_map<AssetID, PendingReload, StringIDHash> m_pendingReloads; // guarded by m_reloadMutex
+	uint64_t m_reloadDelay = k_defaultReloadDelay * 1000000; // nanoseconds, guarded by m_reloadMutex
+	bool m_reloadInProgress = false; // guarded by m_reloadMutex
+	AssetLoadTelemetry m_loadTelemetry;
+	eastl::atomic<uint32_t> m_pendingLoadCount = 0; // load jobs and loads that did not finish yet
 
 	explicit AssetManager() = default;
-	AssetData *getAssetData(const AssetID &assetID, const AssetType &assetType) noexcept;
+	Asset<AssetData> getAssetData(const AssetID &assetID, const AssetType &assetType, job::Counter **counter) noexcept;
+	AssetHandler *getAssetHandler(const AssetType &assetType) noexcept;
+	Asset<AssetData> getPendingDependency(AssetData *assetData) noexcept;
+	// queues the dependencies of an asset that is in the LOADING state. the asset is finished once all of them are loaded.
+	void beginLoad(AssetData *assetData) noexcept;
+	// marks the load as ready to finish after its last dependency finished and tries to finish it on the calling thread
+	void readyToFinishLoad(AssetData *assetData) noexcept;
+	// calls finishLoad() if no other thread claimed the finish of the ready load yet. returns true if it did
+	bool tryFinishLoad(AssetData *assetData) noexcept;
+	// calls the handler, then finishes all dependents that no longer wait on any dependencies
+	void finishLoad(AssetData *assetData) noexcept;
+	static bool isLoadPending(const AssetData *assetData) noexcept;
+	// calls AssetHandler::loadAssetData() and records its timings in m_loadTelemetry
+	bool loadAssetData(AssetHandler *handler, AssetData *assetData, bool reload) noexcept;
+	// these must be called while holding m_assetMutex
+	void insertIntoCache(AssetCache &cache, AssetData *assetData) noexcept;
+	void removeFromCache(AssetData *assetData) noexcept;
+	void evictFromCache(AssetCache &cache, eastl::vector<AssetData *> &evictedAssets) noexcept;
+	// returns true if the pending load of assetData transitively waits on the load of dependency
+	static bool waitsOnLoad(const AssetData *assetData, const AssetData *dependency) noexcept;
+	// unloads cached assets until all caches are within budget
+	void trimCaches() noexcept;
+	void destroyAssetData(AssetData *assetData) noexcept;
+	static void loadAssetJob(void *assetData) noexcept;
+	static void waitForAssetJob(void *assetData) noexcept;
+	static void finishLoadJob(void *assetData) noexcept;
+	// reloads the given assets and all loaded assets depending on them, one dependency level after another
+	void reloadWithDependents(const eastl::vector<AssetDependency> &assets) noexcept;
+	static void reloadJob(void *assets) noexcept;
+	static void reloadAssetJob(void *asset) noexcept;
 };
 
 template<typename T>
-inline Asset<T> AssetManager::getAsset(const AssetID &assetID) noexcept
+inline Asset<T> AssetManager::getAsset(const AssetID &assetID, job::Counter **counter) noexcept
 {
-	return getAssetData(assetID, T::k_assetType);
+	return getAssetData(assetID, T::k_assetType, counter).get();
 }
@@ -1,12 +1,66 @@
 #include "AssetMetaDataRegistry.h"
 #include <assert.h>
+#include <EASTL/hash_set.h>
 #include "filesystem/VirtualFileSystem.h"
+#include "Log.h"
+
+// first line is the AssetID, which is currently a path (max of 260). second line is AssetType, which is 37 bytes
+static constexpr size_t k_maxMetaFileSize = 512;
+static constexpr const char *k_assetsPath = "/assets";
+static constexpr const char *k_indexPath = "/assets/assets.registry";
+
+static bool parseMetaFile(size_t size, char *buffer, AssetID *assetID, AssetType *assetType, uint64_t *sourcePathHash = nullptr) noexcept
+{
+	// meta files may have been read in binary mode, so drop any carriage returns and terminate the lines
+	size_t length = 0;
+	for (size_t i = 0; i < size; ++i)
+	{
+		if (buffer[i] != '\r')
+		{
+			buffer[length++] = buffer[i] == '\n' ? '\0' : buffer[i];
+		}
+	}
+
+	if (length == 0 || buffer[length - 1] != '\0')
+	{
+		return false;
+	}
+
+	const char *assetTypeStr = buffer + strlen(buffer) + 1;
+	if (assetTypeStr >= buffer + length)
+	{
+		return false;
+	}
+
+	*assetID = AssetID(buffer);
+	*assetType = AssetType(assetTypeStr);
+
+	// the third line is the path of the file the asset was imported from
+	if (sourcePathHash)
+	{
+		const char *sourcePath = assetTypeStr + strlen(assetTypeStr) + 1;
+		*sourcePathHash = sourcePath < buffer + length ? stringHashFNV1a(sourcePath) : 0;
+	}
+
+	return true;
+}
 
 static void fileSystemWatcherCallback(const char *path, FileChangeType changeType, void *userData)
 {
 	AssetMetaDataRegistry *reg = (AssetMetaDataRegistry *)userData;
 	VirtualFileSystem &vfs = VirtualFileSystem::get();
 
+	// changes to a .meta file are changes to its asset. meta files are usually written after the asset itself.
+	char assetPath[VirtualFileSystem::k_maxPathLength];
+	assetPath[0] = '\0';
+	strcat_s(assetPath, path);
+	const size_t assetPathLen = strlen(assetPath);
+	const bool isMetaFile = assetPathLen > 5 && strcmp(assetPath + assetPathLen - 5, ".meta") == 0;
+	if (isMetaFile)
+	{
+		assetPath[assetPathLen - 5] = '\0';
+	}
+
 	switch (changeType)
 	{
 	case FileChangeType::ADDED:
@@ -15,25 +69,24 @@ static void fileSystemWatcherCallback(const char *path, FileChangeType changeTyp
 	{
 		char metaFileName[VirtualFileSystem::k_maxPathLength];
 		metaFileName[0] = '\0';
-		strcat_s(metaFileName, path);
+		strcat_s(metaFileName, assetPath);
 		strcat_s(metaFileName, ".meta");
 
-		if (vfs.exists(metaFileName))
+		if (vfs.exists(metaFileName) && vfs.exists(assetPath))
 		{
-			AssetID assetID;
-			AssetType assetType;
-			if (AssetMetaDataRegistry::getAssetIDAndType(metaFileName, &assetID, &assetType))
+			if (FileHandle fh = vfs.open(metaFileName, FileMode::READ, false))
 			{
-				LOCK_HOLDER(reg->m_typeToIDsMutex);
-				LOCK_HOLDER(reg->m_idToTypeMutex);
+				char buffer[k_maxMetaFileSize];
+				const auto bytesRead = vfs.read(fh, sizeof(buffer), buffer);
+				vfs.close(fh);
 
-				reg->m_assetIDToType[assetID] = assetType;
-				eastl::vector<AssetID> &vec = reg->m_assetTypeToIDs[assetType];
-				if (eastl::find(vec.begin(), vec.end(), assetID) == vec.end())
+				AssetID assetID;
+				AssetType assetType;
+				uint64_t sourcePathHash;
+				if (parseMetaFile(bytesRead, buffer, &assetID, &assetType, &sourcePathHash))
 				{
-					reg->m_assetTypeToIDs[assetType].push_back(assetID);
+					reg->registerAsset(assetPath, assetID, assetType, sourcePathHash);
 				}
-				reg->m_pathToAssetID[path] = assetID;
 			}
 		}
 
@@ -43,21 +96,7 @@ static void fileSystemWatcherCallback(const char *path, FileChangeType changeTyp
 	case FileChangeType::REMOVED:
 	case FileChangeType::RENAMED_OLD_NAME:
 	{
-		LOCK_HOLDER(reg->m_typeToIDsMutex);
-		LOCK_HOLDER(reg->m_idToTypeMutex);
-
-		auto it = reg->m_pathToAssetID.find(path);
-		if (it != reg->m_pathToAssetID.end())
-		{
-			AssetID assetID = it->second;
-			assert(reg->m_assetIDToType.find(assetID) != reg->m_assetIDToType.end());
-			auto assetType = reg->m_assetIDToType[assetID];
-			reg->m_assetIDToType.erase(assetID);
-
-			assert(reg->m_assetTypeToIDs.find(assetType) != reg->m_assetTypeToIDs.end());
-			eastl::vector<AssetID> &vec = reg->m_assetTypeToIDs[assetType];
-			vec.erase(eastl::remove(vec.begin(), vec.end(), assetID), vec.end());
-		}
+		reg->unregisterAsset(assetPath);
 		break;
 	}
 
@@ -79,64 +118,145 @@ bool AssetMetaDataRegistry::getAssetIDAndType(const char *metaFilePath, AssetID
 
 	if (FileHandle fh = vfs.open(metaFilePath, FileMode::READ, false))
 	{
-		char buffer[512]; // first line is the AssetID, which is currently a path (max of 260). second line is AssetType, which is 37 bytes
+		char buffer[k_maxMetaFileSize];
 		const auto bytesRead = vfs.read(fh, sizeof(buffer), buffer);
+		vfs.close(fh);
 
-		if (bytesRead == 0 || buffer[bytesRead - 1] != '\n')
-		{
-			vfs.close(fh);
-			return false;
-		}
+		return parseMetaFile(bytesRead, buffer, assetID, assetType);
+	}
+	return false;
+}
 
-		for (size_t i = 0; i < bytesRead; ++i)
-		{
-			if (buffer[i] == '\n')
+bool AssetMetaDataRegistry::init() noexcept
+{
+	if (!loadIndex())
+	{
+		Log::info("AssetMetaDataRegistry: No valid or up to date index found at \"%s\". Reading all .meta files.", k_indexPath);
+		rebuildIndex();
+	}
+
+	m_watcherHandle = VirtualFileSystem::get().openFileSystemWatcher(k_assetsPath, fileSystemWatcherCallback, this);
+	return m_watcherHandle != NULL_FILE_SYSTEM_WATCHER_HANDLE;
+}
+
+void AssetMetaDataRegistry::shutdown() noexcept
+{
+	VirtualFileSystem::get().closeFileSystemWatcher(m_watcherHandle);
+
+	bool indexDirty;
+	{
+		LOCK_HOLDER(m_idToTypeMutex);
+		indexDirty = m_indexDirty;
+	}
+
+	// directories that changed while the registry was running are gathered again, so that new ones are tracked as well
+	const bool directoriesChanged = this->directoriesChanged();
+	if (directoriesChanged)
+	{
+		eastl::vector<DirectoryInfo> directories;
+		directories.push_back({ k_assetsPath, 0 });
+		VirtualFileSystem::get().iterateRecursive(k_assetsPath, [&](const FileFindData &ffd)
 			{
-				buffer[i] = '\0';
-			}
-		}
+				if (ffd.m_isDirectory)
+				{
+					directories.push_back({ ffd.m_path, 0 });
+				}
 
-		*assetID = AssetID(buffer);
-		*assetType = AssetType(buffer + strlen(buffer) + 1);
+				return true;
+			});
 
-		vfs.close(fh);
+		updateLastWriteTimes(directories);
+		m_directories = eastl::move(directories);
+	}
 
-		return true;
+	if (indexDirty || directoriesChanged)
+	{
+		writeIndex();
 	}
-	return false;
 }
 
-bool AssetMetaDataRegistry::init() noexcept
+void AssetMetaDataRegistry::rebuildIndex() noexcept
 {
-	const char *path = "/assets";
-
 	VirtualFileSystem &vfs = VirtualFileSystem::get();
 
-	vfs.iterateRecursive(path, [&](const FileFindData &ffd)
+	// creating the index changes the write time of its directory, so it has to exist before the write times are queried
+	if (!vfs.exists(k_indexPath))
+	{
+		vfs.writeFile(k_indexPath, 0, nullptr, true);
+	}
+
+	// gather all meta files first, so that they can be read in batches instead of one open/read/close after the other
+	eastl::hash_set<eastl::string> filePaths;
+	eastl::vector<eastl::string> metaFilePaths;
+	eastl::vector<DirectoryInfo> directories;
+	directories.push_back({ k_assetsPath, 0 });
+	vfs.iterateRecursive(k_assetsPath, [&](const FileFindData &ffd)
 		{
-			auto metaFileName = eastl::string(ffd.m_path) + ".meta";
-			if (vfs.exists(metaFileName.c_str()))
+			const size_t pathLen = strlen(ffd.m_path);
+			if (ffd.m_isDirectory)
 			{
-				AssetID assetID;
-				AssetType assetType;
-				if (getAssetIDAndType(metaFileName.c_str(), &assetID, &assetType))
-				{
-					m_assetIDToType[assetID] = assetType;
-					m_assetTypeToIDs[assetType].push_back(assetID);
-					m_pathToAssetID[ffd.m_path] = assetID;
-				}
+				directories.push_back({ ffd.m_path, 0 });
+			}
+			else if (pathLen > 5 && strcmp(ffd.m_path + pathLen - 5, ".meta") == 0)
+			{
+				metaFilePaths.push_back(ffd.m_path);
+			}
+			else
+			{
+				filePaths.insert(ffd.m_path);
 			}
 
 			return true;
 		});
 
-	m_watcherHandle = VirtualFileSystem::get().openFileSystemWatcher(path, fileSystemWatcherCallback, this);
-	return m_watcherHandle != NULL_FILE_SYSTEM_WATCHER_HANDLE;
-}
+	// the write times are queried before the files are read, so that changes made while reading cause another rebuild
+	updateLastWriteTimes(directories);
+	m_directories = eastl::move(directories);
 
-void AssetMetaDataRegistry::shutdown() noexcept
-{
-	VirtualFileSystem::get().closeFileSystemWatcher(m_watcherHandle);
+	clear();
+
+	constexpr size_t k_batchSize = 256;
+	eastl::vector<char> buffers(k_batchSize * k_maxMetaFileSize);
+	eastl::vector<FileReadRequest> requests;
+	requests.reserve(k_batchSize);
+
+	for (size_t batchStart = 0; batchStart < metaFilePaths.size(); batchStart += k_batchSize)
+	{
+		requests.clear();
+		const size_t batchEnd = eastl::min(batchStart + k_batchSize, metaFilePaths.size());
+		for (size_t i = batchStart; i < batchEnd; ++i)
+		{
+			requests.push_back({ metaFilePaths[i].c_str(), k_maxMetaFileSize, buffers.data() + (i - batchStart) * k_maxMetaFileSize });
+		}
+
+		vfs.readFiles(requests.size(), requests.data());
+
+		LOCK_HOLDER(m_typeToIDsMutex);
+		LOCK_HOLDER(m_idToTypeMutex);
+
+		for (const auto &request : requests)
+		{
+			// meta files of assets that no longer exist are ignored
+			eastl::string assetPath(request.m_path, strlen(request.m_path) - 5);
+			if (!request.m_success || filePaths.find(assetPath) == filePaths.end())
+			{
+				continue;
+			}
+
+			AssetID assetID;
+			AssetType assetType;
+			uint64_t sourcePathHash;
+			if (parseMetaFile(request.m_bytesRead, (char *)request.m_buffer, &assetID, &assetType, &sourcePathHash))
+			{
+				m_assetIDToType[assetID] = assetType;
+				m_assetTypeToIDs[assetType].push_back(assetID);
+				m_pathToAssetID[assetPath.c_str()] = assetID;
+				m_assetInfos[assetID].m_sourcePathHash = sourcePathHash;
+			}
+		}
+	}
+
+	writeIndex();
 }
 
 bool AssetMetaDataRegistry::getAssetIDs(const AssetType &assetType, size_t *count, AssetID *resultArray) noexcept
@@ -207,3 +327,310 @@ bool AssetMetaDataRegistry::isRegistered(const AssetID &assetID) noexcept
 	LOCK_HOLDER(m_idToTypeMutex);
 	return  m_assetIDToType.find(assetID) != m_assetIDToType.end();
 }
+
+void AssetMetaDataRegistry::setAssetDependencies(const AssetID &assetID, size_t count, const AssetID *dependencies) noexcept
+{
+	LOCK_HOLDER(m_idToTypeMutex);
+
+	// only registered assets are persisted in the index
+	auto it = m_assetInfos.find(assetID);
+	if (it == m_assetInfos.end())
+	{
+		return;
+	}
+
+	auto &infoDependencies = it->second.m_dependencies;
+	if (infoDependencies.size() != count || !eastl::equal(infoDependencies.begin(), infoDependencies.end(), dependencies))
+	{
+		infoDependencies.assign(dependencies, dependencies + count);
+		m_indexDirty = true;
+	}
+}
+
+bool AssetMetaDataRegistry::getAssetDependencies(const AssetID &assetID, size_t *count, AssetID *resultArray) noexcept
+{
+	assert(count);
+	LOCK_HOLDER(m_idToTypeMutex);
+
+	auto it = m_assetInfos.find(assetID);
+	if (it == m_assetInfos.end())
+	{
+		*count = 0;
+		return false;
+	}
+
+	*count = it->second.m_dependencies.size();
+
+	// caller wants the data copied into the result array
+	if (resultArray)
+	{
+		eastl::copy(it->second.m_dependencies.begin(), it->second.m_dependencies.end(), resultArray);
+	}
+
+	return true;
+}
+
+void AssetMetaDataRegistry::updateLastWriteTimes(eastl::vector<DirectoryInfo> &directories) noexcept
+{
+	VirtualFileSystem &vfs = VirtualFileSystem::get();
+	for (auto &directory : directories)
+	{
+		directory.m_lastWriteTime = vfs.getLastWriteTime(directory.m_path.c_str());
+	}
+}
+
+bool AssetMetaDataRegistry::directoriesChanged() const noexcept
+{
+	VirtualFileSystem &vfs = VirtualFileSystem::get();
+	for (const auto &directory : m_directories)
+	{
+		if (vfs.getLastWriteTime(directory.m_path.c_str()) != directory.m_lastWriteTime)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool AssetMetaDataRegistry::loadIndex() noexcept
+{
+	if (!VirtualFileSystem::get().exists(k_indexPath))
+	{
+		return false;
+	}
+
+	ScopedFileMapping fileMapping(VirtualFileSystem::get(), k_indexPath);
+	const uint64_t fileSize = fileMapping.getSize();
+
+	if (!fileMapping.isValid() || fileSize < sizeof(IndexHeader))
+	{
+		return false;
+	}
+
+	const char *data = fileMapping.getData();
+	const auto &header = *reinterpret_cast<const IndexHeader *>(data);
+
+	IndexHeader defaultHeader{};
+	if (memcmp(header.m_magicNumber, defaultHeader.m_magicNumber, sizeof(defaultHeader.m_magicNumber)) != 0 || header.m_version != defaultHeader.m_version)
+	{
+		Log::warn("AssetMetaDataRegistry: Index \"%s\" has a wrong format or version!", k_indexPath);
+		return false;
+	}
+
+	const uint64_t expectedSize = sizeof(IndexHeader)
+		+ uint64_t(header.m_entryCount) * sizeof(IndexEntry)
+		+ uint64_t(header.m_dependencyCount) * sizeof(IndexDependency)
+		+ uint64_t(header.m_directoryCount) * sizeof(IndexDirectory)
+		+ header.m_stringDataSize;
+
+	if (expectedSize != fileSize || (header.m_stringDataSize > 0 && data[fileSize - 1] != '\0'))
+	{
+		Log::warn("AssetMetaDataRegistry: Index \"%s\" is corrupted!", k_indexPath);
+		return false;
+	}
+
+	const auto *entries = reinterpret_cast<const IndexEntry *>(data + sizeof(IndexHeader));
+	const auto *dependencies = reinterpret_cast<const IndexDependency *>(entries + header.m_entryCount);
+	const auto *directories = reinterpret_cast<const IndexDirectory *>(dependencies + header.m_dependencyCount);
+	const char *strings = reinterpret_cast<const char *>(directories + header.m_directoryCount);
+
+	m_directories.clear();
+	m_directories.reserve(header.m_directoryCount);
+	for (size_t i = 0; i < header.m_directoryCount; ++i)
+	{
+		if (directories[i].m_pathOffset >= header.m_stringDataSize)
+		{
+			Log::warn("AssetMetaDataRegistry: Index \"%s\" is corrupted!", k_indexPath);
+			return false;
+		}
+		m_directories.push_back({ strings + directories[i].m_pathOffset, directories[i].m_lastWriteTime });
+	}
+
+	if (m_directories.empty() || directoriesChanged())
+	{
+		Log::info("AssetMetaDataRegistry: Index \"%s\" is out of date!", k_indexPath);
+		return false;
+	}
+
+	clear();
+
+	LOCK_HOLDER(m_typeToIDsMutex);
+	LOCK_HOLDER(m_idToTypeMutex);
+
+	m_assetIDToType.reserve(header.m_entryCount);
+	m_assetInfos.reserve(header.m_entryCount);
+	m_pathToAssetID.reserve(header.m_entryCount);
+
+	bool valid = true;
+	for (size_t i = 0; i < header.m_entryCount && valid; ++i)
+	{
+		const auto &entry = entries[i];
+
+		valid = entry.m_assetIDOffset < header.m_stringDataSize
+			&& entry.m_pathOffset < header.m_stringDataSize
+			&& uint64_t(entry.m_firstDependency) + entry.m_dependencyCount <= header.m_dependencyCount;
+
+		if (!valid)
+		{
+			break;
+		}
+
+		// the hash is stored, so loading does not need to hash all strings again
+		const AssetID assetID(strings + entry.m_assetIDOffset, entry.m_assetIDHash);
+		m_assetIDToType[assetID] = entry.m_assetType;
+		m_assetTypeToIDs[entry.m_assetType].push_back(assetID);
+		m_pathToAssetID[strings + entry.m_pathOffset] = assetID;
+
+		auto &info = m_assetInfos[assetID];
+		info.m_sourcePathHash = entry.m_sourcePathHash;
+		info.m_dependencies.reserve(entry.m_dependencyCount);
+		for (size_t j = 0; j < entry.m_dependencyCount; ++j)
+		{
+			const auto &dependency = dependencies[entry.m_firstDependency + j];
+			valid = valid && dependency.m_assetIDOffset < header.m_stringDataSize;
+			if (valid)
+			{
+				info.m_dependencies.push_back(AssetID(strings + dependency.m_assetIDOffset, dependency.m_assetIDHash));
+			}
+		}
+	}
+
+	if (!valid)
+	{
+		Log::warn("AssetMetaDataRegistry: Index \"%s\" is corrupted!", k_indexPath);
+		return false;
+	}
+
+	m_indexDirty = false;
+
+	return true;
+}
+
+void AssetMetaDataRegistry::writeIndex() noexcept
+{
+	eastl::vector<IndexEntry> entries;
+	eastl::vector<IndexDependency> dependencies;
+	eastl::vector<IndexDirectory> directories;
+	eastl::vector<char> strings;
+
+	auto addString = [&](const char *str) -> uint32_t
+	{
+		const uint32_t offset = static_cast<uint32_t>(strings.size());
+		strings.insert(strings.end(), str, str + strlen(str) + 1);
+		return offset;
+	};
+
+	{
+		LOCK_HOLDER(m_idToTypeMutex);
+
+		entries.reserve(m_pathToAssetID.size());
+
+		for (const auto &p : m_pathToAssetID)
+		{
+			const AssetID &assetID = p.second;
+			const auto &info = m_assetInfos[assetID];
+
+			IndexEntry entry;
+			entry.m_assetIDHash = assetID.m_hash;
+			entry.m_assetType = m_assetIDToType[assetID];
+			entry.m_sourcePathHash = info.m_sourcePathHash;
+			entry.m_assetIDOffset = addString(assetID.m_string);
+			entry.m_pathOffset = addString(p.first);
+			entry.m_firstDependency = static_cast<uint32_t>(dependencies.size());
+			entry.m_dependencyCount = static_cast<uint32_t>(info.m_dependencies.size());
+
+			for (const auto &dependency : info.m_dependencies)
+			{
+				dependencies.push_back({ dependency.m_hash, addString(dependency.m_string), 0 });
+			}
+
+			entries.push_back(entry);
+		}
+
+		m_indexDirty = false;
+	}
+
+	directories.reserve(m_directories.size());
+	for (const auto &directory : m_directories)
+	{
+		directories.push_back({ directory.m_lastWriteTime, addString(directory.m_path.c_str()), 0 });
+	}
+
+	IndexHeader header{};
+	header.m_entryCount = static_cast<uint32_t>(entries.size());
+	header.m_dependencyCount = static_cast<uint32_t>(dependencies.size());
+	header.m_directoryCount = static_cast<uint32_t>(directories.size());
+	header.m_stringDataSize = static_cast<uint32_t>(strings.size());
+	header.m_padding = 0;
+
+	eastl::vector<char> fileData;
+	fileData.reserve(sizeof(header) + entries.size() * sizeof(IndexEntry) + dependencies.size() * sizeof(IndexDependency) + directories.size() * sizeof(IndexDirectory) + strings.size());
+	fileData.insert(fileData.end(), reinterpret_cast<const char *>(&header), reinterpret_cast<const char *>(&header + 1));
+	fileData.insert(fileData.end(), reinterpret_cast<const char *>(entries.data()), reinterpret_cast<const char *>(entries.data() + entries.size()));
+	fileData.insert(fileData.end(), reinterpret_cast<const char *>(dependencies.data()), reinterpret_cast<const char *>(dependencies.data() + dependencies.size()));
+	fileData.insert(fileData.end(), reinterpret_cast<const char *>(directories.data()), reinterpret_cast<const char *>(directories.data() + directories.size()));
+	fileData.insert(fileData.end(), strings.begin(), strings.end());
+
+	if (!VirtualFileSystem::get().writeFile(k_indexPath, fileData.size(), fileData.data(), true))
+	{
+		Log::warn("AssetMetaDataRegistry: Failed to write index \"%s\"!", k_indexPath);
+	}
+}
+
+void AssetMetaDataRegistry::clear() noexcept
+{
+	LOCK_HOLDER(m_typeToIDsMutex);
+	LOCK_HOLDER(m_idToTypeMutex);
+
+	m_assetTypeToIDs.clear();
+	m_assetIDToType.clear();
+	m_assetInfos.clear();
+	m_pathToAssetID.clear();
+	m_indexDirty = true;
+}
+
+void AssetMetaDataRegistry::registerAsset(const char *assetPath, const AssetID &assetID, const AssetType &assetType, uint64_t sourcePathHash) noexcept
+{
+	// the path may have been registered with another AssetID or type before
+	unregisterAsset(assetPath);
+
+	LOCK_HOLDER(m_typeToIDsMutex);
+	LOCK_HOLDER(m_idToTypeMutex);
+
+	m_assetIDToType[assetID] = assetType;
+	eastl::vector<AssetID> &vec = m_assetTypeToIDs[assetType];
+	if (eastl::find(vec.begin(), vec.end(), assetID) == vec.end())
+	{
+		vec.push_back(assetID);
+	}
+	m_pathToAssetID[assetPath] = assetID;
+	m_assetInfos[assetID].m_sourcePathHash = sourcePathHash;
+	m_indexDirty = true;
+}
+
+void AssetMetaDataRegistry::unregisterAsset(const char *assetPath) noexcept
+{
+	LOCK_HOLDER(m_typeToIDsMutex);
+	LOCK_HOLDER(m_idToTypeMutex);
+
+	auto it = m_pathToAssetID.find(assetPath);
+	if (it == m_pathToAssetID.end())
+	{
+		return;
+	}
+
+	AssetID assetID = it->second;
+	m_pathToAssetID.erase(it);
+
+	auto typeIt = m_assetIDToType.find(assetID);
+	if (typeIt != m_assetIDToType.end())
+	{
+		eastl::vector<AssetID> &vec = m_assetTypeToIDs[typeIt->second];
+		vec.erase(eastl::remove(vec.begin(), vec.end(), assetID), vec.end());
+		m_assetIDToType.erase(typeIt);
+	}
+
+	m_assetInfos.erase(assetID);
+	m_indexDirty = true;
+}
\ No newline at end of file
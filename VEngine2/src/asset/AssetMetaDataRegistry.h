@@ -13,18 +13,94 @@ public:
 	static AssetMetaDataRegistry *get();
 	static bool getAssetIDAndType(const char *metaFilePath, AssetID *assetID, AssetType *assetType) noexcept;
 
+	/// <summary>
+	/// Loads the persisted registry index with a single file mapping. If there is no valid index or any of the indexed directories
+	/// changed since it was written, all .meta files are read and a new index is written. The file watcher keeps the registry up to date while it is running.
+	/// </summary>
 	bool init() noexcept;
+	/// <summary>
+	/// Writes the index if it or any of the indexed directories changed since it was loaded.
+	/// </summary>
 	void shutdown() noexcept;
+	/// <summary>
+	/// Reads all .meta files and writes a new index.
+	/// </summary>
+	void rebuildIndex() noexcept;
 	bool getAssetIDs(const AssetType &assetType, size_t *count, AssetID *resultArray) noexcept;
 	bool getAssetIDAt(const AssetType &assetType, size_t idx, AssetID *resultAssetID) noexcept;
 	bool getAssetType(const AssetID &assetID, AssetType *resultAssetType) noexcept;
 	bool isRegistered(const AssetID &assetID) noexcept;
+	// the dependencies are recorded by the AssetManager whenever an asset is loaded
+	void setAssetDependencies(const AssetID &assetID, size_t count, const AssetID *dependencies) noexcept;
+	bool getAssetDependencies(const AssetID &assetID, size_t *count, AssetID *resultArray) noexcept;
 
 private:
+	// the write time of a directory changes whenever a file in it is added, removed or renamed, so comparing the write times
+	// of all directories under /assets detects changes made while the registry was not running (like pulling from version control)
+	// without iterating all files. a .meta file that is edited in place is not detected, rebuildIndex() picks up such changes.
+	struct DirectoryInfo
+	{
+		eastl::string m_path;
+		uint64_t m_lastWriteTime;
+	};
+
+	struct IndexHeader
+	{
+		char m_magicNumber[8] = { 'V', 'E', 'A', 'R', 'E', 'G', ' ', ' ' };
+		uint32_t m_version = 3;
+		uint32_t m_entryCount;
+		uint32_t m_dependencyCount;
+		uint32_t m_directoryCount;
+		uint32_t m_stringDataSize;
+		uint32_t m_padding;
+	};
+
+	struct IndexEntry
+	{
+		uint64_t m_assetIDHash;
+		AssetType m_assetType;
+		uint64_t m_sourcePathHash;
+		uint32_t m_assetIDOffset;
+		uint32_t m_pathOffset;
+		uint32_t m_firstDependency;
+		uint32_t m_dependencyCount;
+	};
+
+	struct IndexDependency
+	{
+		uint64_t m_assetIDHash;
+		uint32_t m_assetIDOffset;
+		uint32_t m_padding;
+	};
+
+	struct IndexDirectory
+	{
+		uint64_t m_lastWriteTime;
+		uint32_t m_pathOffset;
+		uint32_t m_padding;
+	};
+
+	struct AssetInfo
+	{
+		uint64_t m_sourcePathHash = 0; // hash of the path of the file the asset was imported from
+		eastl::vector<AssetID> m_dependencies;
+	};
+
 	mutable SpinLock m_typeToIDsMutex;
-	mutable SpinLock m_idToTypeMutex;
+	mutable SpinLock m_idToTypeMutex; // also guards m_pathToAssetID, m_assetInfos and m_indexDirty
 	eastl::hash_map<AssetType, eastl::vector<AssetID>, UUIDHash> m_assetTypeToIDs;
 	eastl::hash_map<AssetID, AssetType, StringIDHash> m_assetIDToType;
+	eastl::hash_map<AssetID, AssetInfo, StringIDHash> m_assetInfos;
 	eastl::string_hash_map<AssetID> m_pathToAssetID;
+	eastl::vector<DirectoryInfo> m_directories; // only accessed by init(), shutdown() and rebuildIndex()
 	FileSystemWatcherHandle m_watcherHandle = {};
+	bool m_indexDirty = false;
+
+	static void updateLastWriteTimes(eastl::vector<DirectoryInfo> &directories) noexcept;
+	bool directoriesChanged() const noexcept;
+	bool loadIndex() noexcept;
+	void writeIndex() noexcept;
+	void clear() noexcept;
+	void registerAsset(const char *assetPath, const AssetID &assetID, const AssetType &assetType, uint64_t sourcePathHash) noexcept;
+	void unregisterAsset(const char *assetPath) noexcept;
 };
\ No newline at end of file
@@ -12,16 +12,35 @@ class MaterialAsset : public AssetData
 public:
 	static constexpr AssetType k_assetType = "17024075-022D-4AEA-8FD6-BEB267A0F7DF"_uuid;
 
+	enum class Version : uint32_t
+	{
+		V_1_0 = 0,
+		LATEST = V_1_0,
+	};
+
+	// albedo, normal, metalness, roughness, occlusion, emissive, displacement
+	static constexpr uint32_t k_textureCount = 7;
+	static constexpr uint32_t k_noTexture = UINT32_MAX;
+
+	// followed by the string table, which holds the null terminated asset IDs of the textures
+	struct FileHeader
+	{
+		char m_magicNumber[8] = { 'V', 'E', 'M', 'A', 'T', ' ', ' ', ' ' };
+		Version m_version = Version::V_1_0;
+		uint32_t m_fileSize;
+		uint32_t m_alphaMode; // MaterialAlphaMode
+		uint32_t m_albedoFactor; // RGBA8 unorm
+		float m_metalnessFactor;
+		float m_roughnessFactor;
+		float m_emissiveFactor[3];
+		uint32_t m_textureAssetIDOffsets[k_textureCount]; // offsets into the string table or k_noTexture
+		uint32_t m_stringTableSize;
+	};
+
 	explicit MaterialAsset(const AssetID &assetID) noexcept : AssetData(assetID, k_assetType) {}
 	MaterialHandle getMaterialHandle() const noexcept { return m_materialHandle; }
 
 private:
 	MaterialHandle m_materialHandle = {};
-	Asset<TextureAsset> m_albedoTexture;
-	Asset<TextureAsset> m_normalTexture;
-	Asset<TextureAsset> m_metalnessTexture;
-	Asset<TextureAsset> m_roughnessTexture;
-	Asset<TextureAsset> m_occlusionTexture;
-	Asset<TextureAsset> m_emissiveTexture;
-	Asset<TextureAsset> m_displacementTexture;
+	Asset<TextureAsset> m_textures[k_textureCount];
 };
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "utility/Utility.h"
 #include "asset/AnimationClipAsset.h"
 #include "asset/AssetManager.h"
+#include "asset/AssetLoadTelemetry.h"
 #include "filesystem/VirtualFileSystem.h"
 
 static AssetManager *s_assetManager = nullptr;
@@ -48,6 +49,8 @@ bool AnimationClipAssetHandler::loadAssetData(AssetData *assetData, const char *
 
 	// load asset
 	{
+		AssetLoadTelemetry::StageTimer stageTimer(AssetLoadStage::IO);
+
 		if (!VirtualFileSystem::get().exists(path) || VirtualFileSystem::get().isDirectory(path))
 		{
 			assetData->setAssetStatus(AssetStatus::ERROR);
@@ -55,22 +58,24 @@ bool AnimationClipAssetHandler::loadAssetData(AssetData *assetData, const char *
 			return false;
 		}
 
-		auto fileSize = VirtualFileSystem::get().size(path);
+		ScopedFileMapping fileMapping(VirtualFileSystem::get(), path);
+		const uint64_t fileSize = fileMapping.getSize();
+
+		AssetLoadTelemetry::addBytesRead(fileSize);
+		stageTimer.setStage(AssetLoadStage::DECODE);
 
-		if (fileSize < sizeof(AnimationClipAsset::FileHeader))
+		if (fileMapping.isValid() && fileSize < sizeof(AnimationClipAsset::FileHeader))
 		{
 			assetData->setAssetStatus(AssetStatus::ERROR);
 			Log::err("AnimationClipAssetHandler: Animation clip asset data file \"%s\" has a wrong format! (Too small to contain header data)", path);
 			return false;
 		}
 
-		eastl::vector<char> fileData(fileSize);
-
 		bool success = false;
 
-		if (VirtualFileSystem::get().readFile(path, fileSize, fileData.data(), true))
+		if (fileMapping.isValid())
 		{
-			const char *data = fileData.data();
+			const char *data = fileMapping.getData();
 
 			// we checked earlier that the header actually fits inside the file
 			AnimationClipAsset::FileHeader header = *reinterpret_cast<const AnimationClipAsset::FileHeader *>(data);
@@ -89,6 +94,11 @@ bool AnimationClipAssetHandler::loadAssetData(AssetData *assetData, const char *
 			{
 				assetData->setAssetStatus(AssetStatus::ERROR);
 				Log::err("AnimationClipAssetHandler: Animation clip asset data file \"%s\" has unsupported version \"%u\"!", path, (unsigned)header.m_version);
+				if (header.m_version < AnimationClipAsset::Version::LATEST)
+				{
+					// uncompressed clips are not converted when loading
+					Log::err("AnimationClipAssetHandler: Re-import \"%s\" from its source file to convert it to the compressed format.", path);
+				}
 				return false;
 			}
 
@@ -106,63 +116,40 @@ bool AnimationClipAssetHandler::loadAssetData(AssetData *assetData, const char *
 			}
 
 			data += sizeof(header);
-			size_t curFileOffset = 0;
-
-			AnimationClipCreateInfo animClipCreateInfo{};
-			{
-				animClipCreateInfo.m_jointCount = header.m_jointCount;
-				animClipCreateInfo.m_duration = header.m_duration;
-
-				const AnimationClipJointInfo *jointInfo = reinterpret_cast<const AnimationClipJointInfo *>(data + curFileOffset);
-
-				assert((sizeof(header) + curFileOffset + animClipCreateInfo.m_jointCount * sizeof(AnimationClipJointInfo)) < fileSize);
-
-				const auto &lastJointInfo = jointInfo[animClipCreateInfo.m_jointCount - 1];
-				const uint32_t translationCount = lastJointInfo.m_translationArrayOffset + lastJointInfo.m_translationFrameCount;
-				const uint32_t rotationCount = lastJointInfo.m_rotationArrayOffset + lastJointInfo.m_rotationFrameCount;
-				const uint32_t scaleCount = lastJointInfo.m_scaleArrayOffset + lastJointInfo.m_scaleFrameCount;
-
-				size_t memorySize = 0;
-				memorySize += animClipCreateInfo.m_jointCount * sizeof(AnimationClipJointInfo); // per joint info
-				memorySize += (translationCount + rotationCount + scaleCount) * sizeof(float); // time keys
-				memorySize += translationCount * sizeof(float) * 3; // translation data
-				memorySize += rotationCount * sizeof(float) * 4; // rotation data
-				memorySize += scaleCount * sizeof(float) * 1; // scale data
-
-				assert((curFileOffset + memorySize) <= fileSize);
-
-				// allocate memory
-				char *memory = new char[memorySize];
-				assert(memory);
 
-				// copy data to our allocation
-				memcpy(memory, data + curFileOffset, memorySize);
+			const AnimationClipLayout layout = header.getLayout();
+			const size_t memorySize = layout.getMemorySize();
 
-				// set up pointers
-				animClipCreateInfo.m_memory = memory;
-				size_t curMemOffset = 0;
-
-				animClipCreateInfo.m_perJointInfo = reinterpret_cast<const AnimationClipJointInfo *>(memory + curMemOffset);
-				curMemOffset += animClipCreateInfo.m_jointCount * sizeof(AnimationClipJointInfo);
-
-				animClipCreateInfo.m_translationTimeKeys = reinterpret_cast<const float *>(memory + curMemOffset);
-				curMemOffset += translationCount * sizeof(float);
+			// check that the arrays fit inside the file
+			if ((sizeof(header) + memorySize) > fileSize)
+			{
+				assetData->setAssetStatus(AssetStatus::ERROR);
+				Log::err("AnimationClipAssetHandler: Animation clip asset data file \"%s\" has a wrong format! (Too small to contain the animation data)", path);
+				return false;
+			}
 
-				animClipCreateInfo.m_rotationTimeKeys = reinterpret_cast<const float *>(memory + curMemOffset);
-				curMemOffset += rotationCount * sizeof(float);
+			// check that all tracks reference valid ranges of the arrays
+			if (!layout.isValid(data))
+			{
+				assetData->setAssetStatus(AssetStatus::ERROR);
+				Log::err("AnimationClipAssetHandler: Animation clip asset data file \"%s\" has a wrong format! (Track references data outside of the arrays)", path);
+				return false;
+			}
 
-				animClipCreateInfo.m_scaleTimeKeys = reinterpret_cast<const float *>(memory + curMemOffset);
-				curMemOffset += scaleCount * sizeof(float);
+			assetData->setMemorySize(memorySize);
 
-				animClipCreateInfo.m_translationData = reinterpret_cast<const float *>(memory + curMemOffset);
-				curMemOffset += translationCount * sizeof(float) * 3;
+			// allocate memory
+			char *memory = new char[memorySize];
+			assert(memory);
 
-				animClipCreateInfo.m_rotationData = reinterpret_cast<const float *>(memory + curMemOffset);
-				curMemOffset += rotationCount * sizeof(float) * 4;
+			// copy data to our allocation
+			memcpy(memory, data, memorySize);
 
-				animClipCreateInfo.m_scaleData = reinterpret_cast<const float *>(memory + curMemOffset);
-				curMemOffset += scaleCount * sizeof(float) * 1;
-			}
+			AnimationClipCreateInfo animClipCreateInfo{};
+			animClipCreateInfo.m_jointCount = header.m_jointCount;
+			animClipCreateInfo.m_duration = header.m_duration;
+			animClipCreateInfo.m_memory = memory;
+			animClipCreateInfo.setArrays(layout, memory);
 
 			static_cast<AnimationClipAsset *>(assetData)->m_animationClip = AnimationClip(animClipCreateInfo);
 
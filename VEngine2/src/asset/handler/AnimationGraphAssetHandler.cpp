@@ -4,6 +4,7 @@
 #include "utility/Utility.h"
 #include "asset/AnimationGraphAsset.h"
 #include "asset/AssetManager.h"
+#include "asset/AssetLoadTelemetry.h"
 #include "filesystem/VirtualFileSystem.h"
 
 static AssetManager *s_assetManager = nullptr;
@@ -48,6 +49,8 @@ bool AnimationGraphAssetHandler::loadAssetData(AssetData *assetData, const char
 
 	// load asset
 	{
+		AssetLoadTelemetry::StageTimer stageTimer(AssetLoadStage::IO);
+
 		if (!VirtualFileSystem::get().exists(path) || VirtualFileSystem::get().isDirectory(path))
 		{
 			assetData->setAssetStatus(AssetStatus::ERROR);
@@ -55,22 +58,24 @@ bool AnimationGraphAssetHandler::loadAssetData(AssetData *assetData, const char
 			return false;
 		}
 
-		auto fileSize = VirtualFileSystem::get().size(path);
+		ScopedFileMapping fileMapping(VirtualFileSystem::get(), path);
+		const uint64_t fileSize = fileMapping.getSize();
+
+		AssetLoadTelemetry::addBytesRead(fileSize);
+		stageTimer.setStage(AssetLoadStage::DECODE);
 
-		if (fileSize < sizeof(AnimationGraphAsset::FileHeader))
+		if (fileMapping.isValid() && fileSize < sizeof(AnimationGraphAsset::FileHeader))
 		{
 			assetData->setAssetStatus(AssetStatus::ERROR);
 			Log::err("AnimationGraphAssetHandler: Animation clip asset data file \"%s\" has a wrong format! (Too small to contain header data)", path);
 			return false;
 		}
 
-		eastl::vector<char> fileData(fileSize);
-
 		bool success = false;
 
-		if (VirtualFileSystem::get().readFile(path, fileSize, fileData.data(), true))
+		if (fileMapping.isValid())
 		{
-			const char *data = fileData.data();
+			const char *data = fileMapping.getData();
 
 			// we checked earlier that the header actually fits inside the file
 			AnimationGraphAsset::FileHeader header = *reinterpret_cast<const AnimationGraphAsset::FileHeader *>(data);
@@ -173,6 +178,14 @@ bool AnimationGraphAssetHandler::loadAssetData(AssetData *assetData, const char
 				animGraphCreateInfo.m_parameters = reinterpret_cast<AnimationGraphParameter *>(memory + paramsOffset);
 				animGraphCreateInfo.m_animationClips = reinterpret_cast<Asset<AnimationClipAsset> *>(memory + clipsOffset);
 				animGraphCreateInfo.m_memory = memory;
+
+				// graph instances evaluate the clips and the controller script as soon as the graph is loaded.
+				// these are dependencies, so this only blocks when reloading.
+				animGraphCreateInfo.m_controllerScript.waitUntilLoaded();
+				for (size_t i = 0; i < header.m_animationClipAssetCount; ++i)
+				{
+					animGraphCreateInfo.m_animationClips[i].waitUntilLoaded();
+				}
 			}
 
 			static_cast<AnimationGraphAsset *>(assetData)->m_animationGraph = AnimationGraph(animGraphCreateInfo);
@@ -204,3 +217,79 @@ void AnimationGraphAssetHandler::destroyAssetData(AssetData *assetData) noexcept
 
 	delete assetData;
 }
+
+void AnimationGraphAssetHandler::getAssetDependencies(const char *path, eastl::vector<AssetDependency> &dependencies) noexcept
+{
+	ScopedFileMapping fileMapping(VirtualFileSystem::get(), path);
+	const uint64_t fileSize = fileMapping.getSize();
+
+	if (!fileMapping.isValid() || fileSize < sizeof(AnimationGraphAsset::FileHeader))
+	{
+		return;
+	}
+
+	const char *data = fileMapping.getData();
+	const char *dataEnd = data + fileSize;
+	const auto &header = *reinterpret_cast<const AnimationGraphAsset::FileHeader *>(data);
+
+	AnimationGraphAsset::FileHeader defaultHeader{};
+	if (memcmp(header.m_magicNumber, defaultHeader.m_magicNumber, sizeof(defaultHeader.m_magicNumber)) != 0 || header.m_version != AnimationGraphAsset::Version::LATEST)
+	{
+		// loadAssetData() reports the error
+		return;
+	}
+
+	data += sizeof(header);
+
+	// returns nullptr if the string is not terminated inside the file
+	auto readString = [&](const char *&cur) -> const char *
+	{
+		const char *str = cur;
+		const size_t strLen = strnlen(str, dataEnd - str);
+		if (str + strLen == dataEnd)
+		{
+			return nullptr;
+		}
+		cur += strLen + 1;
+		return str;
+	};
+
+	const char *controllerScriptAssetID = readString(data);
+	if (!controllerScriptAssetID)
+	{
+		return;
+	}
+	dependencies.push_back({ AssetID(controllerScriptAssetID), ScriptAsset::k_assetType });
+
+	// skip nodes and parameters
+	if (static_cast<uint64_t>(dataEnd - data) < header.m_nodeCount * sizeof(AnimationGraphNode))
+	{
+		return;
+	}
+	data += header.m_nodeCount * sizeof(AnimationGraphNode);
+
+	for (size_t i = 0; i < header.m_parameterCount; ++i)
+	{
+		constexpr size_t paramSize = sizeof(AnimationGraphParameter::Type) + sizeof(AnimationGraphParameter::Data);
+		if (static_cast<size_t>(dataEnd - data) < paramSize)
+		{
+			return;
+		}
+		data += paramSize;
+
+		if (!readString(data))
+		{
+			return;
+		}
+	}
+
+	for (size_t i = 0; i < header.m_animationClipAssetCount; ++i)
+	{
+		const char *clipAssetID = readString(data);
+		if (!clipAssetID)
+		{
+			return;
+		}
+		dependencies.push_back({ AssetID(clipAssetID), AnimationClipAsset::k_assetType });
+	}
+}
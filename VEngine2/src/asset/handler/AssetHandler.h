@@ -1,5 +1,12 @@
 #pragma once
 #include "asset/Asset.h"
+#include <EASTL/vector.h>
+
+struct AssetDependency
+{
+	AssetID m_assetID;
+	AssetType m_assetType;
+};
 
 class AssetHandler
 {
@@ -7,4 +14,13 @@ public:
 	virtual AssetData *createEmptyAssetData(const AssetID &assetID, const AssetType &assetType) noexcept = 0;
 	virtual bool loadAssetData(AssetData *assetData, const char *path) noexcept = 0;
 	virtual void destroyAssetData(AssetData *assetData) noexcept = 0;
+
+	/// <summary>
+	/// Appends the assets that loadAssetData() needs for the asset at the given path. This should only read
+	/// as much of the file as necessary, usually the header. The AssetManager loads all dependencies in parallel
+	/// and only calls loadAssetData() once all of them finished loading. Dependencies must not be cyclic.
+	/// </summary>
+	/// <param name="path">The path of the asset file.</param>
+	/// <param name="dependencies">The dependencies are appended to this vector.</param>
+	virtual void getAssetDependencies(const char *path, eastl::vector<AssetDependency> &dependencies) noexcept {}
 };
\ No newline at end of file
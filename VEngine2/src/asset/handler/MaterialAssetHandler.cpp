@@ -5,15 +5,71 @@
 #include "graphics/Renderer.h"
 #include "asset/MaterialAsset.h"
 #include "asset/AssetManager.h"
+#include "asset/AssetLoadTelemetry.h"
 #include "filesystem/VirtualFileSystem.h"
-#include <nlohmann/json.hpp>
-#include <glm/packing.hpp>
-#include <string>
-#include <sstream>
+#include <string.h>
 
 static AssetManager *s_assetManager = nullptr;
 static MaterialAssetHandler s_materialAssetHandler;
 
+// returns the header of a valid material file. all texture asset IDs in the string table are checked to be null terminated.
+static const MaterialAsset::FileHeader *getValidatedHeader(const char *data, uint64_t fileSize, const char *path, bool reportErrors) noexcept
+{
+	if (fileSize < sizeof(MaterialAsset::FileHeader))
+	{
+		if (reportErrors)
+		{
+			Log::err("MaterialAssetHandler: Material asset data file \"%s\" has a wrong format! (Too small to contain header data)", path);
+		}
+		return nullptr;
+	}
+
+	const auto *header = reinterpret_cast<const MaterialAsset::FileHeader *>(data);
+
+	MaterialAsset::FileHeader defaultHeader{};
+	if (memcmp(header->m_magicNumber, defaultHeader.m_magicNumber, sizeof(defaultHeader.m_magicNumber)) != 0)
+	{
+		if (reportErrors)
+		{
+			Log::err("MaterialAssetHandler: Material asset data file \"%s\" has a wrong format! (Magic number does not match)", path);
+		}
+		return nullptr;
+	}
+
+	if (header->m_version != MaterialAsset::Version::LATEST)
+	{
+		if (reportErrors)
+		{
+			Log::err("MaterialAssetHandler: Material asset data file \"%s\" has unsupported version \"%u\"!", path, (unsigned)header->m_version);
+		}
+		return nullptr;
+	}
+
+	if (header->m_fileSize > fileSize || sizeof(MaterialAsset::FileHeader) + header->m_stringTableSize > header->m_fileSize)
+	{
+		if (reportErrors)
+		{
+			Log::err("MaterialAssetHandler: Material asset data file \"%s\" is truncated!", path);
+		}
+		return nullptr;
+	}
+
+	const char *stringTable = data + sizeof(MaterialAsset::FileHeader);
+	for (uint32_t offset : header->m_textureAssetIDOffsets)
+	{
+		if (offset != MaterialAsset::k_noTexture && (offset >= header->m_stringTableSize || !memchr(stringTable + offset, '\0', header->m_stringTableSize - offset)))
+		{
+			if (reportErrors)
+			{
+				Log::err("MaterialAssetHandler: Material asset data file \"%s\" has an invalid texture asset ID!", path);
+			}
+			return nullptr;
+		}
+	}
+
+	return header;
+}
+
 void MaterialAssetHandler::init(AssetManager *assetManager, Renderer *renderer) noexcept
 {
 	if (s_assetManager == nullptr)
@@ -54,6 +110,8 @@ bool MaterialAssetHandler::loadAssetData(AssetData *assetData, const char *path)
 
 	// load file
 	{
+		AssetLoadTelemetry::StageTimer stageTimer(AssetLoadStage::IO);
+
 		if (!VirtualFileSystem::get().exists(path) || VirtualFileSystem::get().isDirectory(path))
 		{
 			assetData->setAssetStatus(AssetStatus::ERROR);
@@ -61,71 +119,79 @@ bool MaterialAssetHandler::loadAssetData(AssetData *assetData, const char *path)
 			return false;
 		}
 
-		auto fileSize = VirtualFileSystem::get().size(path);
-		eastl::vector<char> fileData(fileSize);
+		ScopedFileMapping fileMapping(VirtualFileSystem::get(), path);
+		const uint64_t fileSize = fileMapping.getSize();
 
-		bool success = false;
+		AssetLoadTelemetry::addBytesRead(fileSize);
+		stageTimer.setStage(AssetLoadStage::DECODE);
+
+		if (!fileMapping.isValid())
+		{
+			assetData->setAssetStatus(AssetStatus::ERROR);
+			Log::err("MaterialAssetHandler: Failed to open asset data file \"%s\"!", path);
+			return false;
+		}
 
-		if (VirtualFileSystem::get().readFile(path, fileSize, fileData.data(), true))
+		const auto *header = getValidatedHeader(fileMapping.getData(), fileSize, path, true);
+		if (!header)
 		{
-			nlohmann::json jmat;
-			std::stringstream ss(fileData.data());
-			ss >> jmat;
+			assetData->setAssetStatus(AssetStatus::ERROR);
+			return false;
+		}
 
-			auto getTextureAsset = [&](const std::string &filepath) -> Asset<TextureAsset>
+		const char *stringTable = fileMapping.getData() + sizeof(MaterialAsset::FileHeader);
+
+		auto *materialAssetData = static_cast<MaterialAsset *>(assetData);
+		for (uint32_t i = 0; i < MaterialAsset::k_textureCount; ++i)
+		{
+			const uint32_t offset = header->m_textureAssetIDOffsets[i];
+			if (offset != MaterialAsset::k_noTexture)
 			{
-				if (filepath.empty())
-				{
-					return {};
-				}
-
-				return s_assetManager->getAsset<TextureAsset>(AssetID(filepath.c_str()));
-			};
-
-			auto *materialAssetData = static_cast<MaterialAsset *>(assetData);
-			materialAssetData->m_albedoTexture = getTextureAsset(jmat["albedoTexture"].get<std::string>());
-			materialAssetData->m_normalTexture = getTextureAsset(jmat["normalTexture"].get<std::string>());
-			materialAssetData->m_metalnessTexture = getTextureAsset(jmat["metalnessTexture"].get<std::string>());
-			materialAssetData->m_roughnessTexture = getTextureAsset(jmat["roughnessTexture"].get<std::string>());
-			materialAssetData->m_occlusionTexture = getTextureAsset(jmat["occlusionTexture"].get<std::string>());
-			materialAssetData->m_emissiveTexture = getTextureAsset(jmat["emissiveTexture"].get<std::string>());
-			materialAssetData->m_displacementTexture = getTextureAsset(jmat["displacementTexture"].get<std::string>());
-
-			MaterialCreateInfo material{};
-			material.m_alpha = MaterialAlphaMode(jmat["alphaMode"].get<uint32_t>());
-			material.m_albedoFactor = glm::packUnorm4x8(glm::vec4(jmat["albedo"][0].get<float>(), jmat["albedo"][1].get<float>(), jmat["albedo"][2].get<float>(), 1.0f));
-			material.m_metallicFactor = jmat["metalness"].get<float>();
-			material.m_roughnessFactor = jmat["roughness"].get<float>();
-			material.m_emissiveFactor[0] = jmat["emissive"][0].get<float>();
-			material.m_emissiveFactor[1] = jmat["emissive"][1].get<float>();
-			material.m_emissiveFactor[2] = jmat["emissive"][2].get<float>();
-			material.m_albedoTexture = materialAssetData->m_albedoTexture.isLoaded() ? materialAssetData->m_albedoTexture->getTextureHandle() : TextureHandle();
-			material.m_normalTexture = materialAssetData->m_normalTexture.isLoaded() ? materialAssetData->m_normalTexture->getTextureHandle() : TextureHandle();
-			material.m_metallicTexture = materialAssetData->m_metalnessTexture.isLoaded() ? materialAssetData->m_metalnessTexture->getTextureHandle() : TextureHandle();
-			material.m_roughnessTexture = materialAssetData->m_roughnessTexture.isLoaded() ? materialAssetData->m_roughnessTexture->getTextureHandle() : TextureHandle();
-			material.m_occlusionTexture = materialAssetData->m_occlusionTexture.isLoaded() ? materialAssetData->m_occlusionTexture->getTextureHandle() : TextureHandle();
-			material.m_emissiveTexture = materialAssetData->m_emissiveTexture.isLoaded() ? materialAssetData->m_emissiveTexture->getTextureHandle() : TextureHandle();
-			material.m_displacementTexture = materialAssetData->m_displacementTexture.isLoaded() ? materialAssetData->m_displacementTexture->getTextureHandle() : TextureHandle();
-
-			MaterialHandle materialHandle = {};
-			m_renderer->createMaterials(1, &material, &materialHandle);
-			materialAssetData->m_materialHandle = materialHandle;
-			success = materialHandle != 0;
+				materialAssetData->m_textures[i] = s_assetManager->getAsset<TextureAsset>(AssetID(stringTable + offset));
+			}
 		}
 
-		if (!success)
+		// the texture handles are baked into the material, so all textures need to be done loading.
+		// textures are dependencies, so this only blocks when reloading.
+		TextureHandle textureHandles[MaterialAsset::k_textureCount] = {};
+		for (uint32_t i = 0; i < MaterialAsset::k_textureCount; ++i)
 		{
-			Log::warn("TextureAssetHandler: Failed to load texture asset!");
+			const auto &texture = materialAssetData->m_textures[i];
+			texture.waitUntilLoaded();
+			textureHandles[i] = texture.isLoaded() ? texture->getTextureHandle() : TextureHandle();
+		}
+
+		MaterialCreateInfo material{};
+		material.m_alpha = static_cast<MaterialAlphaMode>(header->m_alphaMode);
+		material.m_albedoFactor = header->m_albedoFactor;
+		material.m_metallicFactor = header->m_metalnessFactor;
+		material.m_roughnessFactor = header->m_roughnessFactor;
+		material.m_emissiveFactor[0] = header->m_emissiveFactor[0];
+		material.m_emissiveFactor[1] = header->m_emissiveFactor[1];
+		material.m_emissiveFactor[2] = header->m_emissiveFactor[2];
+		material.m_albedoTexture = textureHandles[0];
+		material.m_normalTexture = textureHandles[1];
+		material.m_metallicTexture = textureHandles[2];
+		material.m_roughnessTexture = textureHandles[3];
+		material.m_occlusionTexture = textureHandles[4];
+		material.m_emissiveTexture = textureHandles[5];
+		material.m_displacementTexture = textureHandles[6];
+
+		stageTimer.setStage(AssetLoadStage::UPLOAD);
+
+		MaterialHandle materialHandle = {};
+		m_renderer->createMaterials(1, &material, &materialHandle);
+		materialAssetData->m_materialHandle = materialHandle;
+
+		if (materialHandle == 0)
+		{
+			Log::warn("MaterialAssetHandler: Failed to load material asset!");
 			assetData->setAssetStatus(AssetStatus::ERROR);
 
-			auto *materialAssetData = static_cast<MaterialAsset *>(assetData);
-			materialAssetData->m_albedoTexture.release();
-			materialAssetData->m_normalTexture.release();
-			materialAssetData->m_metalnessTexture.release();
-			materialAssetData->m_roughnessTexture.release();
-			materialAssetData->m_occlusionTexture.release();
-			materialAssetData->m_emissiveTexture.release();
-			materialAssetData->m_displacementTexture.release();
+			for (auto &texture : materialAssetData->m_textures)
+			{
+				texture.release();
+			}
 
 			return false;
 		}
@@ -147,3 +213,29 @@ void MaterialAssetHandler::destroyAssetData(AssetData *assetData) noexcept
 
 	delete assetData;
 }
+
+void MaterialAssetHandler::getAssetDependencies(const char *path, eastl::vector<AssetDependency> &dependencies) noexcept
+{
+	ScopedFileMapping fileMapping(VirtualFileSystem::get(), path);
+
+	if (!fileMapping.isValid())
+	{
+		return;
+	}
+
+	// loadAssetData() reports malformed files
+	const auto *header = getValidatedHeader(fileMapping.getData(), fileMapping.getSize(), path, false);
+	if (!header)
+	{
+		return;
+	}
+
+	const char *stringTable = fileMapping.getData() + sizeof(MaterialAsset::FileHeader);
+	for (uint32_t offset : header->m_textureAssetIDOffsets)
+	{
+		if (offset != MaterialAsset::k_noTexture)
+		{
+			dependencies.push_back({ AssetID(stringTable + offset), TextureAsset::k_assetType });
+		}
+	}
+}
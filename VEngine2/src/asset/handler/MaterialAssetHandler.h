@@ -22,6 +22,7 @@ public:
 	AssetData *createEmptyAssetData(const AssetID &assetID, const AssetType &assetType) noexcept override;
 	bool loadAssetData(AssetData *assetData, const char *path) noexcept override;
 	void destroyAssetData(AssetData *assetData) noexcept override;
+	void getAssetDependencies(const char *path, eastl::vector<AssetDependency> &dependencies) noexcept override;
 
 private:
 	Renderer *m_renderer = nullptr;
@@ -7,6 +7,7 @@
 #include "asset/MeshAsset.h"
 #include "asset/MaterialAsset.h"
 #include "asset/AssetManager.h"
+#include "asset/AssetLoadTelemetry.h"
 #include "filesystem/VirtualFileSystem.h"
 #include <EASTL/fixed_vector.h>
 #include <glm/gtc/type_ptr.hpp>
@@ -59,6 +60,8 @@ bool MeshAssetHandler::loadAssetData(AssetData *assetData, const char *path) noe
 
 		// load mesh
 		{
+			AssetLoadTelemetry::StageTimer stageTimer(AssetLoadStage::IO);
+
 			if (!VirtualFileSystem::get().exists(path) || VirtualFileSystem::get().isDirectory(path))
 			{
 				assetData->setAssetStatus(AssetStatus::ERROR);
@@ -66,20 +69,22 @@ bool MeshAssetHandler::loadAssetData(AssetData *assetData, const char *path) noe
 				return false;
 			}
 
-			auto fileSize = VirtualFileSystem::get().size(path);
+			ScopedFileMapping fileMapping(VirtualFileSystem::get(), path);
+			const uint64_t fileSize = fileMapping.getSize();
+
+			AssetLoadTelemetry::addBytesRead(fileSize);
+			stageTimer.setStage(AssetLoadStage::DECODE);
 
-			if (fileSize < sizeof(MeshAsset::FileHeader))
+			if (fileMapping.isValid() && fileSize < sizeof(MeshAsset::FileHeader))
 			{
 				assetData->setAssetStatus(AssetStatus::ERROR);
 				Log::err("MeshAssetHandler: Mesh asset data file \"%s\" has a wrong format! (Too small to contain header data)", path);
 				return false;
 			}
 
-			eastl::vector<char> fileData(fileSize);
-
-			if (VirtualFileSystem::get().readFile(path, fileSize, fileData.data(), true))
+			if (fileMapping.isValid())
 			{
-				const char *data = fileData.data();
+				const char *data = fileMapping.getData();
 
 				// we checked earlier that the header actually fits inside the file
 				MeshAsset::FileHeader header = *reinterpret_cast<const MeshAsset::FileHeader *>(data);
@@ -114,10 +119,13 @@ bool MeshAssetHandler::loadAssetData(AssetData *assetData, const char *path) noe
 					Log::warn("MeshAssetHandler: File size (%u) specified in header of mesh asset data file \"%s\" is less than actual file size (%u)!", path, (unsigned)header.m_fileSize, (unsigned)fileSize);
 				}
 
-				const char *dataSegment = fileData.data() + header.m_dataSegmentStart;
+				const char *dataSegment = fileMapping.getData() + header.m_dataSegmentStart;
 
 				meshAssetData->m_matrixPaletteSize = header.m_matrixPaletteSize;
 
+				// approximates the size of the vertex and physics data created from the file
+				meshAssetData->setMemorySize(fileSize);
+
 				data += sizeof(header);
 
 				// materials
@@ -147,6 +155,7 @@ bool MeshAssetHandler::loadAssetData(AssetData *assetData, const char *path) noe
 				}
 
 				// physics meshes
+				stageTimer.setStage(AssetLoadStage::FINALIZE);
 				{
 					if (header.m_physicsConvexMeshDataSize > 0)
 					{
@@ -167,6 +176,7 @@ bool MeshAssetHandler::loadAssetData(AssetData *assetData, const char *path) noe
 				float meshAABBMinZ = FLT_MAX;
 
 				// graphics submeshes
+				stageTimer.setStage(AssetLoadStage::DECODE);
 				{
 					eastl::vector<SubMeshCreateInfo> subMeshes;
 					subMeshes.reserve(header.m_subMeshCount);
@@ -235,9 +245,12 @@ bool MeshAssetHandler::loadAssetData(AssetData *assetData, const char *path) noe
 						subMeshes.push_back(subMesh);
 					}
 
+					stageTimer.setStage(AssetLoadStage::UPLOAD);
 					m_renderer->createSubMeshes(static_cast<uint32_t>(subMeshes.size()), subMeshes.data(), meshAssetData->m_subMeshHandles.data());
 				}
 
+				stageTimer.setStage(AssetLoadStage::FINALIZE);
+
 				// bounding sphere
 				{
 					meshAssetData->m_boundingSphere[0] = (meshAABBMinX + meshAABBMaxX) * 0.5f;
@@ -245,6 +258,13 @@ bool MeshAssetHandler::loadAssetData(AssetData *assetData, const char *path) noe
 					meshAssetData->m_boundingSphere[2] = (meshAABBMinZ + meshAABBMaxZ) * 0.5f;
 					meshAssetData->m_boundingSphere[3] = glm::distance(glm::make_vec3(meshAssetData->m_boundingSphere), glm::vec3(meshAABBMaxX, meshAABBMaxY, meshAABBMaxZ));
 				}
+
+				// the renderer reads the material handles as soon as the mesh is loaded.
+				// materials are dependencies, so this only blocks when reloading.
+				for (const auto &materialAsset : materialAssets)
+				{
+					materialAsset.waitUntilLoaded();
+				}
 			}
 			else
 			{
@@ -271,3 +291,41 @@ void MeshAssetHandler::destroyAssetData(AssetData *assetData) noexcept
 
 	delete assetData;
 }
+
+void MeshAssetHandler::getAssetDependencies(const char *path, eastl::vector<AssetDependency> &dependencies) noexcept
+{
+	// only the pages holding the header and the material asset IDs are touched
+	ScopedFileMapping fileMapping(VirtualFileSystem::get(), path);
+	const uint64_t fileSize = fileMapping.getSize();
+
+	if (!fileMapping.isValid() || fileSize < sizeof(MeshAsset::FileHeader))
+	{
+		return;
+	}
+
+	const auto &header = *reinterpret_cast<const MeshAsset::FileHeader *>(fileMapping.getData());
+
+	MeshAsset::FileHeader defaultHeader{};
+	if (memcmp(header.m_magicNumber, defaultHeader.m_magicNumber, sizeof(defaultHeader.m_magicNumber)) != 0 || header.m_version != MeshAsset::Version::LATEST)
+	{
+		// loadAssetData() reports the error
+		return;
+	}
+
+	const char *dataSegment = fileMapping.getData() + header.m_dataSegmentStart;
+	const uint64_t dataSegmentSize = fileSize - eastl::min<uint64_t>(header.m_dataSegmentStart, fileSize);
+
+	size_t curFileOffset = header.m_materialAssetIDDataOffset;
+	for (size_t i = 0; i < header.m_materialSlotCount && curFileOffset < dataSegmentSize; ++i)
+	{
+		const char *materialAssetID = dataSegment + curFileOffset;
+		const size_t strLen = strnlen(materialAssetID, dataSegmentSize - curFileOffset);
+
+		if (strLen > 0 && curFileOffset + strLen < dataSegmentSize)
+		{
+			dependencies.push_back({ AssetID(materialAssetID), MaterialAsset::k_assetType });
+		}
+
+		curFileOffset += strLen + 1; // dont forget the null terminator
+	}
+}
@@ -1,6 +1,7 @@
 #include "ScriptAssetHandler.h"
 #include "asset/ScriptAsset.h"
 #include "asset/AssetManager.h"
+#include "asset/AssetLoadTelemetry.h"
 #include "Log.h"
 #include "filesystem/VirtualFileSystem.h"
 
@@ -46,6 +47,8 @@ bool ScriptAssetHandler::loadAssetData(AssetData *assetData, const char *path) n
 
 	// load file
 	{
+		AssetLoadTelemetry::StageTimer stageTimer(AssetLoadStage::IO);
+
 		if (!VirtualFileSystem::get().exists(path) || VirtualFileSystem::get().isDirectory(path))
 		{
 			assetData->setAssetStatus(AssetStatus::ERROR);
@@ -58,6 +61,7 @@ bool ScriptAssetHandler::loadAssetData(AssetData *assetData, const char *path) n
 
 		if (VirtualFileSystem::get().readFile(path, fileSize + 1, fileData, true))
 		{
+			AssetLoadTelemetry::addBytesRead(fileSize);
 			fileData[fileSize] = '\0';
 			static_cast<ScriptAsset *>(assetData)->m_scriptString = fileData;
 		}
@@ -5,6 +5,7 @@
 #include "animation/AnimationSystem.h"
 #include "asset/SkeletonAsset.h"
 #include "asset/AssetManager.h"
+#include "asset/AssetLoadTelemetry.h"
 #include "filesystem/VirtualFileSystem.h"
 #include <glm/mat4x4.hpp>
 
@@ -50,6 +51,8 @@ bool SkeletonAssetHandler::loadAssetData(AssetData *assetData, const char *path)
 
 	// load asset
 	{
+		AssetLoadTelemetry::StageTimer stageTimer(AssetLoadStage::IO);
+
 		if (!VirtualFileSystem::get().exists(path) || VirtualFileSystem::get().isDirectory(path))
 		{
 			assetData->setAssetStatus(AssetStatus::ERROR);
@@ -57,22 +60,24 @@ bool SkeletonAssetHandler::loadAssetData(AssetData *assetData, const char *path)
 			return false;
 		}
 
-		auto fileSize = VirtualFileSystem::get().size(path);
+		ScopedFileMapping fileMapping(VirtualFileSystem::get(), path);
+		const uint64_t fileSize = fileMapping.getSize();
+
+		AssetLoadTelemetry::addBytesRead(fileSize);
+		stageTimer.setStage(AssetLoadStage::DECODE);
 
-		if (fileSize < sizeof(SkeletonAsset::FileHeader))
+		if (fileMapping.isValid() && fileSize < sizeof(SkeletonAsset::FileHeader))
 		{
 			assetData->setAssetStatus(AssetStatus::ERROR);
 			Log::err("SkeletonAssetHandler: Skeleton asset data file \"%s\" has a wrong format! (Too small to contain header data)", path);
 			return false;
 		}
 
-		eastl::vector<char> fileData(fileSize);
-
 		bool success = false;
 
-		if (VirtualFileSystem::get().readFile(path, fileSize, fileData.data(), true))
+		if (fileMapping.isValid())
 		{
-			const char *data = fileData.data();
+			const char *data = fileMapping.getData();
 
 			// we checked earlier that the header actually fits inside the file
 			SkeletonAsset::FileHeader header = *reinterpret_cast<const SkeletonAsset::FileHeader *>(data);
@@ -5,6 +5,7 @@
 #include "graphics/Renderer.h"
 #include "asset/TextureAsset.h"
 #include "asset/AssetManager.h"
+#include "asset/AssetLoadTelemetry.h"
 #include "filesystem/VirtualFileSystem.h"
 
 static AssetManager *s_assetManager = nullptr;
@@ -50,6 +51,8 @@ bool TextureAssetHandler::loadAssetData(AssetData *assetData, const char *path)
 
 	// load file
 	{
+		AssetLoadTelemetry::StageTimer stageTimer(AssetLoadStage::IO);
+
 		if (!VirtualFileSystem::get().exists(path) || VirtualFileSystem::get().isDirectory(path))
 		{
 			assetData->setAssetStatus(AssetStatus::ERROR);
@@ -57,15 +60,22 @@ bool TextureAssetHandler::loadAssetData(AssetData *assetData, const char *path)
 			return false;
 		}
 
-		auto fileSize = VirtualFileSystem::get().size(path);
-		eastl::vector<char> fileData(fileSize);
+		ScopedFileMapping fileMapping(VirtualFileSystem::get(), path);
+		const uint64_t fileSize = fileMapping.getSize();
+
+		AssetLoadTelemetry::addBytesRead(fileSize);
 
 		bool success = false;
 
-		if (VirtualFileSystem::get().readFile(path, fileSize, fileData.data(), true))
+		if (fileMapping.isValid())
 		{
-			auto handle = m_renderer->loadTexture(fileSize, fileData.data(), path);
+			// parsing the DDS header is negligible compared to creating the image and copying the mip tail
+			stageTimer.setStage(AssetLoadStage::UPLOAD);
+
+			// only the smallest mip levels are loaded here, the renderer streams in the others as needed
+			auto handle = m_renderer->loadStreamedTexture(static_cast<size_t>(fileSize), fileMapping.getData(), path);
 			static_cast<TextureAsset *>(assetData)->m_textureHandle = handle;
+			assetData->setMemorySize(fileSize); // the file holds the full texture in its GPU format
 			success = handle != 0;
 		}
 
@@ -23,9 +23,7 @@ static bool serialize(ParticipatingMediumComponent &c, Stream &stream) noexcept
 	serializeFloat(stream, c.m_maxHeight);
 	serializeAsset(stream, c.m_densityTexture, TextureAsset);
 	serializeFloat(stream, c.m_textureScale);
-	serializeFloat(stream, c.m_textureBias[0]);
-	serializeFloat(stream, c.m_textureBias[1]);
-	serializeFloat(stream, c.m_textureBias[2]);
+	serializeArray(stream, 3, c.m_textureBias);
 	serializeBool(stream, c.m_spherical);
 
 	return true;
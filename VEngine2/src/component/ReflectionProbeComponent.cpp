@@ -12,15 +12,10 @@
 template<typename Stream>
 static bool serialize(ReflectionProbeComponent &c, Stream &stream) noexcept
 {
-	serializeFloat(stream, c.m_captureOffset.x);
-	serializeFloat(stream, c.m_captureOffset.y);
-	serializeFloat(stream, c.m_captureOffset.z);
+	serializeArray(stream, 3, &c.m_captureOffset[0]);
 	serializeFloat(stream, c.m_nearPlane);
 	serializeFloat(stream, c.m_farPlane);
-	for (auto &d : c.m_boxFadeDistances)
-	{
-		serializeFloat(stream, d);
-	}
+	serializeArray(stream, 6, c.m_boxFadeDistances);
 	serializeBool(stream, c.m_lockedFadeDistance);
 
 	return true;
@@ -12,16 +12,9 @@ static bool serialize(TransformComponent &c, Stream &stream) noexcept
 	uint32_t mobilityInt = static_cast<uint32_t>(c.m_mobility);
 	serializeUInt32(stream, mobilityInt);
 	c.m_mobility = static_cast<Mobility>(mobilityInt);
-	serializeFloat(stream, c.m_transform.m_translation.x);
-	serializeFloat(stream, c.m_transform.m_translation.y);
-	serializeFloat(stream, c.m_transform.m_translation.z);
-	serializeFloat(stream, c.m_transform.m_rotation.x);
-	serializeFloat(stream, c.m_transform.m_rotation.y);
-	serializeFloat(stream, c.m_transform.m_rotation.z);
-	serializeFloat(stream, c.m_transform.m_rotation.w);
-	serializeFloat(stream, c.m_transform.m_scale.x);
-	serializeFloat(stream, c.m_transform.m_scale.y);
-	serializeFloat(stream, c.m_transform.m_scale.z);
+	serializeArray(stream, 3, &c.m_transform.m_translation[0]);
+	serializeArray(stream, 4, &c.m_transform.m_rotation[0]);
+	serializeArray(stream, 3, &c.m_transform.m_scale[0]);
 
 	return true;
 }
@@ -255,6 +255,7 @@ EntityRecord Archetype::migrate(EntityID entity, const EntityRecord &oldRecord,
 	EntityRecord newRecord{};
 	newRecord.m_archetype = this;
 	newRecord.m_slot = slot;
+	newRecord.m_generation = oldRecord.m_generation;
 
 	return newRecord;
 }
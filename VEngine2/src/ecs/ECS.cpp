@@ -1,6 +1,7 @@
 #include "ECS.h"
 #include <assert.h>
 #include "utility/Utility.h"
+#include "utility/allocator/SmallObjectAllocator.h"
 
 ComponentID ComponentIDGenerator::m_idCount = 0;
 
@@ -8,7 +9,7 @@ ErasedType ECS::s_componentInfo[k_ecsMaxComponentTypes];
 eastl::bitset<k_ecsMaxComponentTypes> ECS::s_singletonComponentsBitset;
 
 ECS::ECS() noexcept
-	:m_componentMemoryAllocator(k_componentMemoryChunkSize, 256, "ECS Component Memory Allocator")
+	:m_componentMemoryAllocator(SmallObjectAllocator::get(), "ECS Component Memory Allocator", "ECS")
 {
 }
 
@@ -51,6 +52,10 @@ void ECS::destroyEntity(EntityID entity) noexcept
 
 		// delete entity
 		freeEntityID(entity);
+
+		// invalidates the ID right away instead of only when the index is reused
+		m_entityRecords[entityIndex].m_archetype = nullptr;
+		++m_entityRecords[entityIndex].m_generation;
 	}
 }
 
@@ -365,6 +370,7 @@ EntityID ECS::createEntityInternal(size_t componentCount, const ComponentID *com
 	EntityRecord record{};
 	record.m_archetype = archetype;
 	record.m_slot = slot;
+	record.m_generation = static_cast<uint32_t>(entityID & 0xFFFFFFFF);
 
 	m_entityRecords[entityID >> 32] = record;
 
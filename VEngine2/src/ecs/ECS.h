@@ -5,7 +5,7 @@
 #include "utility/ErasedType.h"
 #include "ECSCommon.h"
 #include "Archetype.h"
-#include "utility/allocator/PoolAllocator.h"
+#include "utility/allocator/TrackingAllocator.h"
 
 class Archetype;
 
@@ -388,7 +388,7 @@ private:
 	eastl::vector<uint32_t> m_freeEntityIDIndices;
 	eastl::vector<Archetype *> m_archetypes;
 	eastl::vector<EntityRecord> m_entityRecords;
-	DynamicPoolAllocator m_componentMemoryAllocator;
+	TrackingAllocator m_componentMemoryAllocator;
 	mutable void *m_singletonComponents[k_ecsMaxComponentTypes] = {}; // mutable so that lazy construction of singleton components works even if the const version getSingletonComponent() is called
 
 	template<typename ...T>
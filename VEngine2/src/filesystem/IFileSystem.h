@@ -1,6 +1,7 @@
 #pragma once
 #include <stdint.h>
 #include "Handles.h"
+#include "utility/DeletedCopyMove.h"
 
 enum FileHandle : size_t { NULL_FILE_HANDLE };
 enum FileFindHandle : size_t { NULL_FILE_FIND_HANDLE };
@@ -86,6 +87,16 @@ struct FileFindData
 	char m_path[260];
 	bool m_isFile;
 	bool m_isDirectory;
+	uint64_t m_lastWriteTime; // file system specific timestamp of the last modification of a file, 0 if unknown
+};
+
+struct FileReadRequest
+{
+	const char *m_path;
+	size_t m_bufferSize;
+	void *m_buffer; // receives up to m_bufferSize bytes from the start of the file
+	uint64_t m_bytesRead; // written by readFiles()
+	bool m_success; // written by readFiles(). false if the file could not be opened or read
 };
 
 class IFileSystem
@@ -101,6 +112,8 @@ public:
 	virtual bool createDirectoryHierarchy(const char *path) const noexcept = 0;
 	virtual bool rename(const char *path, const char *newName) const noexcept = 0;
 	virtual bool remove(const char *path) const noexcept = 0;
+	// file system specific timestamp of the last modification of a file or directory, 0 if it does not exist or is unknown
+	virtual uint64_t getLastWriteTime(const char *path) const noexcept = 0;
 
 
 	virtual FileHandle open(const char *filePath, FileMode mode, bool binary) noexcept = 0;
@@ -113,6 +126,43 @@ public:
 	virtual bool readFile(const char *filePath, size_t bufferSize, void *buffer, bool binary) noexcept = 0;
 	virtual bool writeFile(const char *filePath, size_t bufferSize, const void *buffer, bool binary) noexcept = 0;
 
+	/// <summary>
+	/// Reads the beginning of many files in binary mode. Implementations may keep all reads in flight at once,
+	/// which is much faster than calling readFile() in a loop when there are lots of small files.
+	/// </summary>
+	/// <param name="count">The number of requests.</param>
+	/// <param name="requests">The requests. m_bytesRead and m_success are written for all of them.</param>
+	/// <returns>The number of successful requests.</returns>
+	virtual size_t readFiles(size_t count, FileReadRequest *requests) noexcept
+	{
+		size_t successCount = 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			auto &request = requests[i];
+			request.m_bytesRead = 0;
+			request.m_success = false;
+
+			if (FileHandle fh = open(request.m_path, FileMode::READ, true))
+			{
+				request.m_bytesRead = read(fh, request.m_bufferSize, request.m_buffer);
+				request.m_success = true;
+				++successCount;
+				close(fh);
+			}
+		}
+		return successCount;
+	}
+
+	/// <summary>
+	/// Maps the whole file read-only into memory. The view stays valid until it is passed to unmapFile(),
+	/// even if the file is modified or deleted in the meantime. Empty files are mapped to a valid zero-sized view.
+	/// </summary>
+	/// <param name="filePath">The path of the file to map.</param>
+	/// <param name="fileSize">Receives the size of the file in bytes.</param>
+	/// <returns>A pointer to the file contents or nullptr if the file could not be mapped.</returns>
+	virtual const char *mapFile(const char *filePath, uint64_t *fileSize) noexcept = 0;
+	virtual void unmapFile(const char *mappedData, uint64_t fileSize) noexcept = 0;
+
 	virtual FileFindHandle findFirst(const char *dirPath, FileFindData *result) noexcept = 0;
 	virtual bool findNext(FileFindHandle findHandle, FileFindData *result) noexcept = 0;
 	virtual void findClose(FileFindHandle findHandle) noexcept = 0;
@@ -171,4 +221,47 @@ private:
 			return true;
 		}
 	}
+};
+
+/// <summary>
+/// Maps a file with IFileSystem::mapFile() and unmaps it again when going out of scope.
+/// </summary>
+class ScopedFileMapping
+{
+public:
+	explicit ScopedFileMapping(IFileSystem &fileSystem, const char *filePath) noexcept
+		:m_fileSystem(fileSystem),
+		m_data(fileSystem.mapFile(filePath, &m_size))
+	{
+	}
+
+	DELETED_COPY_MOVE(ScopedFileMapping);
+
+	~ScopedFileMapping() noexcept
+	{
+		if (m_data)
+		{
+			m_fileSystem.unmapFile(m_data, m_size);
+		}
+	}
+
+	bool isValid() const noexcept
+	{
+		return m_data != nullptr;
+	}
+
+	const char *getData() const noexcept
+	{
+		return m_data;
+	}
+
+	uint64_t getSize() const noexcept
+	{
+		return m_size;
+	}
+
+private:
+	IFileSystem &m_fileSystem;
+	uint64_t m_size = 0;
+	const char *m_data;
 };
\ No newline at end of file
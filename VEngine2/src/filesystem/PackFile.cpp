@@ -0,0 +1,318 @@
+#include "PackFile.h"
+#include <stdio.h>
+#include <string.h>
+#include <EASTL/vector.h>
+#include <EASTL/string.h>
+#include <EASTL/sort.h>
+#include "RawFileSystem.h"
+#include "Log.h"
+#include "utility/StringID.h"
+#include "utility/Utility.h"
+#include "utility/Compression.h"
+
+namespace
+{
+	struct SourceEntry
+	{
+		eastl::string m_path;
+		uint64_t m_pathHash;
+		bool m_isDirectory;
+	};
+
+	char normalizePathChar(char c) noexcept
+	{
+		if (c >= 'A' && c <= 'Z')
+		{
+			return c - 'A' + 'a';
+		}
+		return c == '\\' ? '/' : c;
+	}
+
+	// compresses all blocks of a file. returns false if compression does not save enough space to be worth it
+	bool compressBlocks(uint64_t size, const char *data, eastl::vector<char> &compressedData, eastl::vector<uint64_t> &blockOffsets) noexcept
+	{
+		compressedData.clear();
+		blockOffsets.clear();
+
+		eastl::vector<char> blockBuffer(Compression::getMaxCompressedSize(PackFile::k_blockSize));
+
+		for (uint64_t blockStart = 0; blockStart < size; blockStart += PackFile::k_blockSize)
+		{
+			const size_t blockSize = static_cast<size_t>(eastl::min<uint64_t>(PackFile::k_blockSize, size - blockStart));
+			size_t compressedSize = Compression::compress(blockSize, data + blockStart, blockBuffer.size(), blockBuffer.data());
+
+			blockOffsets.push_back(compressedData.size());
+
+			// blocks that do not shrink are stored as is, which the reader detects by the stored size
+			if (compressedSize == 0 || compressedSize >= blockSize)
+			{
+				compressedData.insert(compressedData.end(), data + blockStart, data + blockStart + blockSize);
+			}
+			else
+			{
+				compressedData.insert(compressedData.end(), blockBuffer.data(), blockBuffer.data() + compressedSize);
+			}
+		}
+
+		blockOffsets.push_back(compressedData.size());
+
+		return compressedData.size() < size - size / 8;
+	}
+}
+
+uint64_t PackFile::hashPath(const char *path, size_t pathLength) noexcept
+{
+	uint64_t hash = k_fnvOffsetBasis;
+	for (size_t i = 0; i < pathLength; ++i)
+	{
+		hash = (hash ^ static_cast<uint8_t>(normalizePathChar(path[i]))) * k_fnvPrime;
+	}
+	return hash;
+}
+
+bool PackFile::pathsEqual(const char *path0, size_t pathLength0, const char *path1, size_t pathLength1) noexcept
+{
+	if (pathLength0 != pathLength1)
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < pathLength0; ++i)
+	{
+		if (normalizePathChar(path0[i]) != normalizePathChar(path1[i]))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool PackFile::write(const char *nativeSourceDirectory, const char *nativePackFilePath, bool compress) noexcept
+{
+	auto &rfs = RawFileSystem::get();
+
+	if (!rfs.isDirectory(nativeSourceDirectory))
+	{
+		Log::err("PackFile: Source directory \"%s\" does not exist!", nativeSourceDirectory);
+		return false;
+	}
+
+	eastl::string sourceDirectory = nativeSourceDirectory;
+	while (!sourceDirectory.empty() && (sourceDirectory.back() == '/' || sourceDirectory.back() == '\\'))
+	{
+		sourceDirectory.pop_back();
+	}
+
+	// gather all entries, starting with the root directory
+	eastl::vector<SourceEntry> sourceEntries;
+	sourceEntries.push_back({ "", hashPath("", 0), true });
+
+	rfs.iterateRecursive(sourceDirectory.c_str(), [&](const FileFindData &ffd)
+		{
+			if (ffd.m_isDirectory || rfs.isFile(ffd.m_path))
+			{
+				const char *relativePath = ffd.m_path + sourceDirectory.length() + 1;
+				sourceEntries.push_back({ relativePath, hashPath(relativePath, strlen(relativePath)), ffd.m_isDirectory });
+			}
+			return true;
+		});
+
+	if (sourceEntries.size() > UINT32_MAX / 2)
+	{
+		Log::err("PackFile: Too many files in \"%s\"!", nativeSourceDirectory);
+		return false;
+	}
+
+	eastl::sort(sourceEntries.begin(), sourceEntries.end(), [](const auto &lhs, const auto &rhs) { return lhs.m_pathHash < rhs.m_pathHash; });
+
+	for (size_t i = 1; i < sourceEntries.size(); ++i)
+	{
+		if (sourceEntries[i].m_pathHash == sourceEntries[i - 1].m_pathHash)
+		{
+			Log::err("PackFile: Paths \"%s\" and \"%s\" have the same hash! Paths only differing in case can not be packed.", sourceEntries[i - 1].m_path.c_str(), sourceEntries[i].m_path.c_str());
+			return false;
+		}
+	}
+
+	const uint32_t entryCount = static_cast<uint32_t>(sourceEntries.size());
+
+	auto findEntry = [&](uint64_t pathHash) -> uint32_t
+	{
+		auto it = eastl::lower_bound(sourceEntries.begin(), sourceEntries.end(), pathHash, [](const auto &entry, uint64_t hash) { return entry.m_pathHash < hash; });
+		assert(it != sourceEntries.end() && it->m_pathHash == pathHash);
+		return static_cast<uint32_t>(it - sourceEntries.begin());
+	};
+
+	// build the child lists of all directories, sorted by path to get a deterministic enumeration order
+	eastl::vector<eastl::vector<uint32_t>> directoryChildren(entryCount);
+	for (uint32_t i = 0; i < entryCount; ++i)
+	{
+		const auto &path = sourceEntries[i].m_path;
+		if (path.empty())
+		{
+			continue;
+		}
+
+		const size_t separatorPos = path.find_last_of('/');
+		const size_t parentPathLength = separatorPos == eastl::string::npos ? 0 : separatorPos;
+		directoryChildren[findEntry(hashPath(path.c_str(), parentPathLength))].push_back(i);
+	}
+
+	eastl::vector<PackFile::Entry> entries(entryCount);
+	eastl::vector<uint32_t> children;
+	eastl::vector<char> strings;
+
+	for (uint32_t i = 0; i < entryCount; ++i)
+	{
+		auto &entry = entries[i];
+		entry = {};
+		entry.m_pathHash = sourceEntries[i].m_pathHash;
+		entry.m_pathOffset = static_cast<uint32_t>(strings.size());
+		strings.insert(strings.end(), sourceEntries[i].m_path.c_str(), sourceEntries[i].m_path.c_str() + sourceEntries[i].m_path.length() + 1);
+
+		if (sourceEntries[i].m_isDirectory)
+		{
+			auto &childList = directoryChildren[i];
+			eastl::sort(childList.begin(), childList.end(), [&](uint32_t lhs, uint32_t rhs) { return sourceEntries[lhs].m_path < sourceEntries[rhs].m_path; });
+
+			entry.m_flags = ENTRY_FLAG_DIRECTORY;
+			entry.m_first = static_cast<uint32_t>(children.size());
+			entry.m_count = static_cast<uint32_t>(childList.size());
+			children.insert(children.end(), childList.begin(), childList.end());
+		}
+	}
+
+	FILE *file = nullptr;
+	if (fopen_s(&file, nativePackFilePath, "wb") != 0 || !file)
+	{
+		Log::err("PackFile: Failed to open \"%s\" for writing!", nativePackFilePath);
+		return false;
+	}
+
+	bool success = true;
+	uint64_t fileOffset = 0;
+
+	auto writeData = [&](const void *data, size_t size)
+	{
+		success = success && fwrite(data, 1, size, file) == size;
+		fileOffset += size;
+	};
+
+	auto alignFileOffset = [&](uint64_t alignment)
+	{
+		static const char s_padding[k_dataAlignment] = {};
+		writeData(s_padding, static_cast<size_t>(util::alignUp(fileOffset, alignment) - fileOffset));
+	};
+
+	// the header is written again at the end, once all offsets are known
+	PackFile::Header header{};
+	writeData(&header, sizeof(header));
+
+	// entry data
+	eastl::vector<uint64_t> blockOffsets;
+	eastl::vector<char> compressedData;
+	uint64_t totalSize = 0;
+	uint64_t totalStoredSize = 0;
+
+	for (uint32_t i = 0; i < entryCount && success; ++i)
+	{
+		auto &entry = entries[i];
+
+		if (entry.m_flags & ENTRY_FLAG_DIRECTORY)
+		{
+			continue;
+		}
+
+		const eastl::string nativePath = sourceDirectory + "/" + sourceEntries[i].m_path;
+
+		uint64_t size = 0;
+		const char *data = rfs.mapFile(nativePath.c_str(), &size);
+		if (!data)
+		{
+			success = false;
+			break;
+		}
+
+		alignFileOffset(k_dataAlignment);
+
+		entry.m_dataOffset = fileOffset;
+		entry.m_size = size;
+
+		eastl::vector<uint64_t> entryBlockOffsets;
+		if (compress && compressBlocks(size, data, compressedData, entryBlockOffsets))
+		{
+			entry.m_flags |= ENTRY_FLAG_COMPRESSED;
+			entry.m_storedSize = compressedData.size();
+			entry.m_first = static_cast<uint32_t>(blockOffsets.size());
+			entry.m_count = static_cast<uint32_t>(entryBlockOffsets.size() - 1);
+			blockOffsets.insert(blockOffsets.end(), entryBlockOffsets.begin(), entryBlockOffsets.end());
+			writeData(compressedData.data(), compressedData.size());
+		}
+		else
+		{
+			entry.m_storedSize = size;
+			writeData(data, static_cast<size_t>(size));
+		}
+
+		rfs.unmapFile(data, size);
+
+		totalSize += entry.m_size;
+		totalStoredSize += entry.m_storedSize;
+	}
+
+	// bucket table
+	header.m_bucketCountLog2 = entryCount > 1 ? util::findLastSetBit(entryCount - 1) + 1 : 0;
+	const uint32_t bucketCount = 1u << header.m_bucketCountLog2;
+	eastl::vector<uint32_t> buckets(bucketCount + 1);
+	{
+		uint32_t entryIndex = 0;
+		for (uint32_t bucket = 0; bucket < bucketCount; ++bucket)
+		{
+			while (entryIndex < entryCount && getBucketIndex(entries[entryIndex].m_pathHash, header.m_bucketCountLog2) < bucket)
+			{
+				++entryIndex;
+			}
+			buckets[bucket] = entryIndex;
+		}
+		buckets[bucketCount] = entryCount;
+	}
+
+	alignFileOffset(8);
+	header.m_bucketsOffset = fileOffset;
+	writeData(buckets.data(), buckets.size() * sizeof(uint32_t));
+
+	alignFileOffset(8);
+	header.m_entriesOffset = fileOffset;
+	writeData(entries.data(), entries.size() * sizeof(PackFile::Entry));
+
+	alignFileOffset(8);
+	header.m_childrenOffset = fileOffset;
+	writeData(children.data(), children.size() * sizeof(uint32_t));
+
+	alignFileOffset(8);
+	header.m_blocksOffset = fileOffset;
+	writeData(blockOffsets.data(), blockOffsets.size() * sizeof(uint64_t));
+
+	header.m_stringsOffset = fileOffset;
+	writeData(strings.data(), strings.size());
+
+	header.m_magic = k_magic;
+	header.m_version = k_version;
+	header.m_entryCount = entryCount;
+	header.m_fileSize = fileOffset;
+
+	success = success && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+	success = fclose(file) == 0 && success;
+
+	if (!success)
+	{
+		Log::err("PackFile: Failed to write pack file \"%s\"!", nativePackFilePath);
+		rfs.remove(nativePackFilePath);
+		return false;
+	}
+
+	Log::info("PackFile: Packed %u entries from \"%s\" into \"%s\" (%.2f MiB stored, %.2f MiB uncompressed)", (unsigned)entryCount, nativeSourceDirectory, nativePackFilePath, totalStoredSize / (1024.0 * 1024.0), totalSize / (1024.0 * 1024.0));
+
+	return true;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+/// <summary>
+/// Pack files bundle a directory tree into a single file that can be mounted in the VirtualFileSystem.
+///
+/// Layout: Header, entry data (each entry aligned to k_dataAlignment), then the tables referenced by the header.
+/// Entries are sorted by path hash and the bucket table maps the top bits of a hash to the range of entries
+/// with these bits, so lookups only compare against the handful of entries in a single bucket.
+/// Paths are stored relative to the packed directory without leading slash; the root directory has the empty path.
+/// Compressed entries are split into k_blockSize blocks that are compressed independently, so any range of the
+/// entry can be read without decompressing the blocks before it.
+/// </summary>
+namespace PackFile
+{
+	constexpr uint32_t k_magic = 0x4B415056; // "VPAK" in little endian
+	constexpr uint32_t k_version = 1;
+	constexpr uint64_t k_dataAlignment = 64;
+	constexpr uint32_t k_blockSize = 64 * 1024;
+
+	enum EntryFlags : uint32_t
+	{
+		ENTRY_FLAG_DIRECTORY = 1u << 0,
+		ENTRY_FLAG_COMPRESSED = 1u << 1,
+	};
+
+	struct Header
+	{
+		uint32_t m_magic;
+		uint32_t m_version;
+		uint32_t m_entryCount;
+		uint32_t m_bucketCountLog2;
+		uint64_t m_bucketsOffset; // (1 << m_bucketCountLog2) + 1 uint32_t indices of the first entry in each bucket
+		uint64_t m_entriesOffset; // m_entryCount Entry structs sorted by m_pathHash
+		uint64_t m_childrenOffset; // uint32_t entry indices of the children of all directories
+		uint64_t m_blocksOffset; // uint64_t block offsets of all compressed entries
+		uint64_t m_stringsOffset; // null terminated entry paths
+		uint64_t m_fileSize;
+	};
+
+	struct Entry
+	{
+		uint64_t m_pathHash;
+		uint64_t m_dataOffset; // offset of the entry data from the start of the pack file
+		uint64_t m_size; // uncompressed size
+		uint64_t m_storedSize; // size of the entry data in the pack file
+		uint32_t m_pathOffset; // offset into the string table
+		uint32_t m_flags;
+		uint32_t m_first; // directories: first child in the child table. compressed files: first block offset in the block table
+		uint32_t m_count; // directories: number of children. compressed files: number of blocks, the block table holds one more offset marking the end
+	};
+
+	static_assert(sizeof(Header) == 64);
+	static_assert(sizeof(Entry) == 48);
+
+	/// <summary>
+	/// Hashes a path inside a pack file. Matches the native file system on Windows in that it ignores ASCII case
+	/// and treats backslashes as forward slashes. Leading and trailing slashes are expected to be stripped.
+	/// </summary>
+	uint64_t hashPath(const char *path, size_t pathLength) noexcept;
+
+	/// <summary>
+	/// Compares two paths inside a pack file with the same rules as hashPath().
+	/// </summary>
+	bool pathsEqual(const char *path0, size_t pathLength0, const char *path1, size_t pathLength1) noexcept;
+
+	inline uint32_t getBucketIndex(uint64_t pathHash, uint32_t bucketCountLog2) noexcept
+	{
+		return bucketCountLog2 == 0 ? 0 : static_cast<uint32_t>(pathHash >> (64 - bucketCountLog2));
+	}
+
+	/// <summary>
+	/// Packs all files and directories below a native directory into a pack file.
+	/// </summary>
+	/// <param name="nativeSourceDirectory">The native path of the directory to pack.</param>
+	/// <param name="nativePackFilePath">The native path of the pack file to write.</param>
+	/// <param name="compress">Compress files that shrink noticeably. Uncompressed files can be mapped without copying them.</param>
+	/// <returns>True if the pack file was written successfully.</returns>
+	bool write(const char *nativeSourceDirectory, const char *nativePackFilePath, bool compress) noexcept;
+}
@@ -0,0 +1,624 @@
+#include "PackFileSystem.h"
+#include <assert.h>
+#include <string.h>
+#include "RawFileSystem.h"
+#include "Log.h"
+#include "utility/Compression.h"
+
+namespace
+{
+	bool isSeparator(char c) noexcept
+	{
+		return c == '/' || c == '\\';
+	}
+
+	// emulates text mode reads of the native file system by turning \r\n into \n
+	size_t removeCarriageReturns(char *buffer, size_t size) noexcept
+	{
+		size_t dstIdx = 0;
+		for (size_t srcIdx = 0; srcIdx < size; ++srcIdx)
+		{
+			if (buffer[srcIdx] != '\r' || srcIdx + 1 == size || buffer[srcIdx + 1] != '\n')
+			{
+				buffer[dstIdx++] = buffer[srcIdx];
+			}
+		}
+		return dstIdx;
+	}
+}
+
+PackFileSystem::PackFileSystem() noexcept
+{
+}
+
+PackFileSystem::~PackFileSystem() noexcept
+{
+	for (auto &openFile : m_openFiles)
+	{
+		delete[] openFile.m_blockCache;
+	}
+
+	if (m_data)
+	{
+		RawFileSystem::get().unmapFile(m_data, m_size);
+	}
+}
+
+bool PackFileSystem::init(const char *nativePath) noexcept
+{
+	assert(!m_data);
+
+	m_data = RawFileSystem::get().mapFile(nativePath, &m_size);
+	if (!m_data)
+	{
+		return false;
+	}
+
+	auto tableFits = [&](uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t tableEnd)
+	{
+		return offset <= tableEnd && count <= (tableEnd - offset) / elementSize;
+	};
+
+	const auto *header = reinterpret_cast<const PackFile::Header *>(m_data);
+
+	bool valid = m_size >= sizeof(PackFile::Header)
+		&& header->m_magic == PackFile::k_magic
+		&& header->m_version == PackFile::k_version
+		&& header->m_fileSize == m_size
+		&& header->m_bucketCountLog2 < 32
+		&& header->m_entryCount > 0
+		&& header->m_bucketsOffset % 8 == 0
+		&& header->m_entriesOffset % 8 == 0
+		&& header->m_childrenOffset % 8 == 0
+		&& header->m_blocksOffset % 8 == 0
+		&& tableFits(header->m_bucketsOffset, (1ull << header->m_bucketCountLog2) + 1, sizeof(uint32_t), header->m_entriesOffset)
+		&& tableFits(header->m_entriesOffset, header->m_entryCount, sizeof(PackFile::Entry), header->m_childrenOffset)
+		&& header->m_childrenOffset <= header->m_blocksOffset
+		&& header->m_blocksOffset <= header->m_stringsOffset
+		&& header->m_stringsOffset < m_size
+		&& m_data[m_size - 1] == '\0'; // all paths are null terminated
+
+	if (valid)
+	{
+		m_header = header;
+		m_buckets = reinterpret_cast<const uint32_t *>(m_data + header->m_bucketsOffset);
+		m_entries = reinterpret_cast<const PackFile::Entry *>(m_data + header->m_entriesOffset);
+		m_children = reinterpret_cast<const uint32_t *>(m_data + header->m_childrenOffset);
+		m_blockOffsets = reinterpret_cast<const uint64_t *>(m_data + header->m_blocksOffset);
+		m_strings = m_data + header->m_stringsOffset;
+
+		const uint64_t childCount = (header->m_blocksOffset - header->m_childrenOffset) / sizeof(uint32_t);
+		const uint64_t blockOffsetCount = (header->m_stringsOffset - header->m_blocksOffset) / sizeof(uint64_t);
+		const uint64_t stringsSize = m_size - header->m_stringsOffset;
+		const uint32_t bucketCount = 1u << header->m_bucketCountLog2;
+
+		for (uint32_t i = 0; i <= bucketCount && valid; ++i)
+		{
+			valid = m_buckets[i] <= header->m_entryCount && (i == 0 || m_buckets[i - 1] <= m_buckets[i]);
+		}
+		valid = valid && m_buckets[bucketCount] == header->m_entryCount;
+
+		// validate all references, so that the accessors do not need to
+		for (uint32_t i = 0; i < header->m_entryCount && valid; ++i)
+		{
+			const auto &entry = m_entries[i];
+
+			// paths are returned with a leading slash by findFirst()/findNext()
+			valid = entry.m_pathOffset < stringsSize && strnlen(m_strings + entry.m_pathOffset, k_maxPathLength - 1) < k_maxPathLength - 1;
+
+			if (entry.m_flags & PackFile::ENTRY_FLAG_DIRECTORY)
+			{
+				valid = valid && tableFits(entry.m_first, entry.m_count, 1, childCount);
+				for (uint32_t j = 0; j < entry.m_count && valid; ++j)
+				{
+					valid = m_children[entry.m_first + j] < header->m_entryCount;
+				}
+			}
+			else
+			{
+				valid = valid && tableFits(entry.m_dataOffset, entry.m_storedSize, 1, header->m_bucketsOffset);
+
+				if (entry.m_flags & PackFile::ENTRY_FLAG_COMPRESSED)
+				{
+					const uint64_t blockCount = (entry.m_size + PackFile::k_blockSize - 1) / PackFile::k_blockSize;
+					valid = valid && entry.m_count == blockCount && tableFits(entry.m_first, entry.m_count + 1ull, 1, blockOffsetCount);
+				}
+				else
+				{
+					valid = valid && entry.m_storedSize == entry.m_size;
+				}
+			}
+		}
+	}
+
+	if (!valid)
+	{
+		Log::err("PackFileSystem: \"%s\" is not a valid pack file!", nativePath);
+		RawFileSystem::get().unmapFile(m_data, m_size);
+		m_data = nullptr;
+		m_size = 0;
+		m_header = nullptr;
+		return false;
+	}
+
+	return true;
+}
+
+bool PackFileSystem::exists(const char *path) const noexcept
+{
+	return findEntry(path) != k_invalidEntry;
+}
+
+bool PackFileSystem::isDirectory(const char *path) const noexcept
+{
+	const uint32_t entryIndex = findEntry(path);
+	return entryIndex != k_invalidEntry && (m_entries[entryIndex].m_flags & PackFile::ENTRY_FLAG_DIRECTORY) != 0;
+}
+
+bool PackFileSystem::isFile(const char *path) const noexcept
+{
+	const uint32_t entryIndex = findEntry(path);
+	return entryIndex != k_invalidEntry && (m_entries[entryIndex].m_flags & PackFile::ENTRY_FLAG_DIRECTORY) == 0;
+}
+
+bool PackFileSystem::createDirectoryHierarchy(const char *path) const noexcept
+{
+	return false;
+}
+
+bool PackFileSystem::rename(const char *path, const char *newName) const noexcept
+{
+	return false;
+}
+
+bool PackFileSystem::remove(const char *path) const noexcept
+{
+	return false;
+}
+
+uint64_t PackFileSystem::getLastWriteTime(const char *path) const noexcept
+{
+	// pack files are immutable, so there is nothing to track
+	return 0;
+}
+
+FileHandle PackFileSystem::open(const char *filePath, FileMode mode, bool binary) noexcept
+{
+	if (mode != FileMode::READ)
+	{
+		Log::err("PackFileSystem: Failed to open file \"%s\" for writing. Pack files are read-only!", filePath);
+		return NULL_FILE_HANDLE;
+	}
+
+	const uint32_t entryIndex = findEntry(filePath);
+	if (entryIndex == k_invalidEntry || (m_entries[entryIndex].m_flags & PackFile::ENTRY_FLAG_DIRECTORY) != 0)
+	{
+		Log::err("PackFileSystem: Failed to open file \"%s\": No such file", filePath);
+		return NULL_FILE_HANDLE;
+	}
+
+	LOCK_HOLDER(m_openFilesSpinLock);
+	FileHandle resultHandle = (FileHandle)m_openFileHandleManager.allocate();
+
+	if (!resultHandle)
+	{
+		return NULL_FILE_HANDLE;
+	}
+
+	const size_t idx = (size_t)resultHandle - 1;
+
+	if (m_openFiles.size() <= idx)
+	{
+		size_t newSize = idx;
+		newSize += eastl::max<size_t>(1, newSize / 2);
+		newSize = eastl::max<size_t>(16, newSize);
+		m_openFiles.resize(newSize);
+	}
+
+	auto &openFile = m_openFiles[idx];
+	openFile.m_entryIndex = entryIndex;
+	openFile.m_binary = binary;
+	openFile.m_position = 0;
+	openFile.m_blockCache = nullptr;
+	openFile.m_cachedBlock = k_invalidEntry;
+
+	return resultHandle;
+}
+
+uint64_t PackFileSystem::size(FileHandle fileHandle) const noexcept
+{
+	if (!fileHandle)
+	{
+		return 0;
+	}
+
+	LOCK_HOLDER(m_openFilesSpinLock);
+
+	const uint32_t entryIndex = m_openFiles[fileHandle - 1].m_entryIndex;
+	return entryIndex != k_invalidEntry ? m_entries[entryIndex].m_size : 0;
+}
+
+uint64_t PackFileSystem::size(const char *filePath) const noexcept
+{
+	const uint32_t entryIndex = findEntry(filePath);
+	return entryIndex != k_invalidEntry ? m_entries[entryIndex].m_size : 0;
+}
+
+uint64_t PackFileSystem::read(FileHandle fileHandle, size_t bufferSize, void *buffer) const noexcept
+{
+	if (!fileHandle)
+	{
+		return 0;
+	}
+
+	// copy the state, so that the lock is not held while decompressing
+	OpenFile openFile;
+	{
+		LOCK_HOLDER(m_openFilesSpinLock);
+		openFile = m_openFiles[fileHandle - 1];
+	}
+
+	if (openFile.m_entryIndex == k_invalidEntry)
+	{
+		return 0;
+	}
+
+	uint64_t bytesRead = readEntry(m_entries[openFile.m_entryIndex], openFile.m_position, bufferSize, static_cast<char *>(buffer), openFile.m_blockCache, openFile.m_cachedBlock);
+	openFile.m_position += bytesRead;
+
+	if (!openFile.m_binary)
+	{
+		bytesRead = removeCarriageReturns(static_cast<char *>(buffer), static_cast<size_t>(bytesRead));
+	}
+
+	{
+		LOCK_HOLDER(m_openFilesSpinLock);
+		m_openFiles[fileHandle - 1] = openFile;
+	}
+
+	return bytesRead;
+}
+
+uint64_t PackFileSystem::write(FileHandle fileHandle, size_t bufferSize, const void *buffer) const noexcept
+{
+	return 0;
+}
+
+void PackFileSystem::close(FileHandle fileHandle) noexcept
+{
+	if (!fileHandle)
+	{
+		return;
+	}
+
+	LOCK_HOLDER(m_openFilesSpinLock);
+
+	auto &openFile = m_openFiles[fileHandle - 1];
+
+	if (openFile.m_entryIndex != k_invalidEntry)
+	{
+		delete[] openFile.m_blockCache;
+		openFile = {};
+
+		m_openFileHandleManager.free((uint32_t)fileHandle);
+	}
+}
+
+bool PackFileSystem::readFile(const char *filePath, size_t bufferSize, void *buffer, bool binary) noexcept
+{
+	const uint32_t entryIndex = findEntry(filePath);
+	if (entryIndex == k_invalidEntry || (m_entries[entryIndex].m_flags & PackFile::ENTRY_FLAG_DIRECTORY) != 0)
+	{
+		return false;
+	}
+
+	char *blockCache = nullptr;
+	uint32_t cachedBlock = k_invalidEntry;
+	const uint64_t bytesRead = readEntry(m_entries[entryIndex], 0, bufferSize, static_cast<char *>(buffer), blockCache, cachedBlock);
+	delete[] blockCache;
+
+	if (!binary)
+	{
+		removeCarriageReturns(static_cast<char *>(buffer), static_cast<size_t>(bytesRead));
+	}
+
+	return bytesRead == eastl::min<uint64_t>(bufferSize, m_entries[entryIndex].m_size);
+}
+
+bool PackFileSystem::writeFile(const char *filePath, size_t bufferSize, const void *buffer, bool binary) noexcept
+{
+	Log::err("PackFileSystem: Failed to write file \"%s\". Pack files are read-only!", filePath);
+	return false;
+}
+
+const char *PackFileSystem::mapFile(const char *filePath, uint64_t *fileSize) noexcept
+{
+	*fileSize = 0;
+
+	const uint32_t entryIndex = findEntry(filePath);
+	if (entryIndex == k_invalidEntry || (m_entries[entryIndex].m_flags & PackFile::ENTRY_FLAG_DIRECTORY) != 0)
+	{
+		Log::err("PackFileSystem::mapFile(): Failed to open file \"%s\": No such file", filePath);
+		return nullptr;
+	}
+
+	const auto &entry = m_entries[entryIndex];
+
+	// uncompressed entries are handed out directly from the mapped pack file
+	if ((entry.m_flags & PackFile::ENTRY_FLAG_COMPRESSED) == 0)
+	{
+		*fileSize = entry.m_size;
+		return m_data + entry.m_dataOffset;
+	}
+
+	if (entry.m_size > SIZE_MAX)
+	{
+		return nullptr;
+	}
+
+	char *data = new char[static_cast<size_t>(entry.m_size)];
+
+	for (uint32_t i = 0; i < entry.m_count; ++i)
+	{
+		if (!decompressBlock(entry, i, data + static_cast<size_t>(i) * PackFile::k_blockSize))
+		{
+			delete[] data;
+			return nullptr;
+		}
+	}
+
+	*fileSize = entry.m_size;
+	return data;
+}
+
+void PackFileSystem::unmapFile(const char *mappedData, uint64_t fileSize) noexcept
+{
+	const uintptr_t address = reinterpret_cast<uintptr_t>(mappedData);
+	const uintptr_t packBegin = reinterpret_cast<uintptr_t>(m_data);
+
+	// only decompressed entries own their memory
+	if (mappedData && (address < packBegin || address >= packBegin + m_size))
+	{
+		delete[] mappedData;
+	}
+}
+
+FileFindHandle PackFileSystem::findFirst(const char *dirPath, FileFindData *result) noexcept
+{
+	*result = {};
+
+	const uint32_t entryIndex = findEntry(dirPath);
+	if (entryIndex == k_invalidEntry || (m_entries[entryIndex].m_flags & PackFile::ENTRY_FLAG_DIRECTORY) == 0 || m_entries[entryIndex].m_count == 0)
+	{
+		return NULL_FILE_FIND_HANDLE;
+	}
+
+	FileFindHandle resultHandle = {};
+	{
+		LOCK_HOLDER(m_fileFindsSpinLock);
+		resultHandle = (FileFindHandle)m_fileFindHandleManager.allocate();
+
+		if (!resultHandle)
+		{
+			return NULL_FILE_FIND_HANDLE;
+		}
+
+		const size_t idx = (size_t)resultHandle - 1;
+
+		if (m_fileFinds.size() <= idx)
+		{
+			size_t newSize = idx;
+			newSize += eastl::max<size_t>(1, newSize / 2);
+			newSize = eastl::max<size_t>(16, newSize);
+			m_fileFinds.resize(newSize);
+		}
+
+		m_fileFinds[idx].m_directoryIndex = entryIndex;
+		m_fileFinds[idx].m_nextChild = 1;
+	}
+
+	getEntryPath(m_children[m_entries[entryIndex].m_first], result);
+
+	return resultHandle;
+}
+
+bool PackFileSystem::findNext(FileFindHandle findHandle, FileFindData *result) noexcept
+{
+	if (!findHandle)
+	{
+		return false;
+	}
+
+	uint32_t childIndex = k_invalidEntry;
+	{
+		LOCK_HOLDER(m_fileFindsSpinLock);
+
+		auto &ff = m_fileFinds[findHandle - 1];
+		if (ff.m_directoryIndex == k_invalidEntry)
+		{
+			return false;
+		}
+
+		const auto &directory = m_entries[ff.m_directoryIndex];
+		if (ff.m_nextChild < directory.m_count)
+		{
+			childIndex = m_children[directory.m_first + ff.m_nextChild];
+			++ff.m_nextChild;
+		}
+	}
+
+	if (childIndex == k_invalidEntry)
+	{
+		return false;
+	}
+
+	*result = {};
+	getEntryPath(childIndex, result);
+
+	return true;
+}
+
+void PackFileSystem::findClose(FileFindHandle findHandle) noexcept
+{
+	if (!findHandle)
+	{
+		return;
+	}
+
+	LOCK_HOLDER(m_fileFindsSpinLock);
+
+	m_fileFinds[findHandle - 1] = {};
+	m_fileFindHandleManager.free((uint32_t)findHandle);
+}
+
+FileSystemWatcherHandle PackFileSystem::openFileSystemWatcher(const char *path, FileSystemWatcherCallback callback, void *userData) noexcept
+{
+	// pack files are immutable while mounted
+	return NULL_FILE_SYSTEM_WATCHER_HANDLE;
+}
+
+void PackFileSystem::closeFileSystemWatcher(FileSystemWatcherHandle watcherHandle) noexcept
+{
+}
+
+TextureHandle PackFileSystem::getIcon(const char *path, Renderer *renderer, uint32_t *preferredWidth, uint32_t *preferredHeight) noexcept
+{
+	return NULL_TEXTURE_HANDLE;
+}
+
+uint32_t PackFileSystem::findEntry(const char *path) const noexcept
+{
+	if (!m_header || !path)
+	{
+		return k_invalidEntry;
+	}
+
+	// entry paths have neither leading nor trailing slashes
+	while (isSeparator(*path))
+	{
+		++path;
+	}
+
+	size_t pathLength = strlen(path);
+	while (pathLength > 0 && isSeparator(path[pathLength - 1]))
+	{
+		--pathLength;
+	}
+
+	const uint64_t pathHash = PackFile::hashPath(path, pathLength);
+	const uint32_t bucket = PackFile::getBucketIndex(pathHash, m_header->m_bucketCountLog2);
+
+	for (uint32_t i = m_buckets[bucket]; i < m_buckets[bucket + 1]; ++i)
+	{
+		if (m_entries[i].m_pathHash == pathHash)
+		{
+			// path hashes are unique within a pack file, so there is no need to look any further
+			const char *entryPath = m_strings + m_entries[i].m_pathOffset;
+			return PackFile::pathsEqual(entryPath, strlen(entryPath), path, pathLength) ? i : k_invalidEntry;
+		}
+	}
+
+	return k_invalidEntry;
+}
+
+void PackFileSystem::getEntryPath(uint32_t entryIndex, FileFindData *result) const noexcept
+{
+	const auto &entry = m_entries[entryIndex];
+
+	result->m_path[0] = '/';
+	strcpy_s(result->m_path + 1, k_maxPathLength - 1, m_strings + entry.m_pathOffset);
+	result->m_isDirectory = (entry.m_flags & PackFile::ENTRY_FLAG_DIRECTORY) != 0;
+	result->m_isFile = !result->m_isDirectory;
+	result->m_lastWriteTime = 0; // pack files are immutable
+}
+
+bool PackFileSystem::decompressBlock(const PackFile::Entry &entry, uint32_t blockIndex, char *dst) const noexcept
+{
+	const uint64_t *blockOffsets = m_blockOffsets + entry.m_first;
+	const uint64_t storedBegin = blockOffsets[blockIndex];
+	const uint64_t storedEnd = blockOffsets[blockIndex + 1];
+	const uint64_t blockBegin = static_cast<uint64_t>(blockIndex) * PackFile::k_blockSize;
+	const size_t blockSize = static_cast<size_t>(eastl::min<uint64_t>(PackFile::k_blockSize, entry.m_size - blockBegin));
+
+	if (storedEnd < storedBegin || storedEnd > entry.m_storedSize)
+	{
+		Log::err("PackFileSystem: Block %u of compressed entry \"%s\" is out of bounds!", (unsigned)blockIndex, m_strings + entry.m_pathOffset);
+		return false;
+	}
+
+	const char *src = m_data + entry.m_dataOffset + storedBegin;
+	const size_t storedSize = static_cast<size_t>(storedEnd - storedBegin);
+
+	// blocks that did not shrink are stored uncompressed
+	if (storedSize == blockSize)
+	{
+		memcpy(dst, src, blockSize);
+		return true;
+	}
+
+	if (!Compression::decompress(storedSize, src, blockSize, dst))
+	{
+		Log::err("PackFileSystem: Failed to decompress block %u of entry \"%s\"!", (unsigned)blockIndex, m_strings + entry.m_pathOffset);
+		return false;
+	}
+
+	return true;
+}
+
+uint64_t PackFileSystem::readEntry(const PackFile::Entry &entry, uint64_t offset, size_t bufferSize, char *buffer, char *&blockCache, uint32_t &cachedBlock) const noexcept
+{
+	if (offset >= entry.m_size)
+	{
+		return 0;
+	}
+
+	const uint64_t readSize = eastl::min<uint64_t>(bufferSize, entry.m_size - offset);
+
+	if ((entry.m_flags & PackFile::ENTRY_FLAG_COMPRESSED) == 0)
+	{
+		memcpy(buffer, m_data + entry.m_dataOffset + offset, static_cast<size_t>(readSize));
+		return readSize;
+	}
+
+	uint64_t bytesRead = 0;
+	while (bytesRead < readSize)
+	{
+		const uint64_t position = offset + bytesRead;
+		const uint32_t blockIndex = static_cast<uint32_t>(position / PackFile::k_blockSize);
+		const size_t offsetInBlock = static_cast<size_t>(position % PackFile::k_blockSize);
+		const size_t blockSize = static_cast<size_t>(eastl::min<uint64_t>(PackFile::k_blockSize, entry.m_size - static_cast<uint64_t>(blockIndex) * PackFile::k_blockSize));
+		const size_t copySize = static_cast<size_t>(eastl::min<uint64_t>(blockSize - offsetInBlock, readSize - bytesRead));
+
+		if (offsetInBlock == 0 && copySize == blockSize)
+		{
+			// whole blocks are decompressed straight into the destination
+			if (!decompressBlock(entry, blockIndex, buffer + bytesRead))
+			{
+				break;
+			}
+		}
+		else
+		{
+			if (cachedBlock != blockIndex)
+			{
+				if (!blockCache)
+				{
+					blockCache = new char[PackFile::k_blockSize];
+				}
+
+				cachedBlock = k_invalidEntry;
+				if (!decompressBlock(entry, blockIndex, blockCache))
+				{
+					break;
+				}
+				cachedBlock = blockIndex;
+			}
+
+			memcpy(buffer + bytesRead, blockCache + offsetInBlock, copySize);
+		}
+
+		bytesRead += copySize;
+	}
+
+	return bytesRead;
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <EASTL/vector.h>
+#include "IFileSystem.h"
+#include "PackFile.h"
+#include "utility/HandleManager.h"
+#include "utility/SpinLock.h"
+
+/// <summary>
+/// Read-only IFileSystem exposing the contents of a pack file written by PackFile::write().
+/// The pack file is memory mapped as a whole, so lookups and uncompressed reads never touch the OS.
+/// Paths are relative to the packed directory and may start with a slash, e.g. "/textures/a.dds".
+/// </summary>
+class PackFileSystem : public IFileSystem
+{
+public:
+	explicit PackFileSystem() noexcept;
+	DELETED_COPY_MOVE(PackFileSystem);
+	~PackFileSystem() noexcept;
+
+	/// <summary>
+	/// Maps and validates the pack file. Must be called once before using any other function.
+	/// </summary>
+	/// <param name="nativePath">The native path of the pack file.</param>
+	/// <returns>False if the file could not be mapped or is not a valid pack file.</returns>
+	bool init(const char *nativePath) noexcept;
+
+	bool exists(const char *path) const noexcept override;
+	bool isDirectory(const char *path) const noexcept override;
+	bool isFile(const char *path) const noexcept override;
+	bool createDirectoryHierarchy(const char *path) const noexcept override;
+	bool rename(const char *path, const char *newName) const noexcept override;
+	bool remove(const char *path) const noexcept override;
+	uint64_t getLastWriteTime(const char *path) const noexcept override;
+
+	FileHandle open(const char *filePath, FileMode mode, bool binary) noexcept override;
+	uint64_t size(FileHandle fileHandle) const noexcept override;
+	uint64_t size(const char *filePath) const noexcept override;
+	uint64_t read(FileHandle fileHandle, size_t bufferSize, void *buffer) const noexcept override;
+	uint64_t write(FileHandle fileHandle, size_t bufferSize, const void *buffer) const noexcept override;
+	void close(FileHandle fileHandle) noexcept override;
+
+	bool readFile(const char *filePath, size_t bufferSize, void *buffer, bool binary) noexcept override;
+	bool writeFile(const char *filePath, size_t bufferSize, const void *buffer, bool binary) noexcept override;
+	const char *mapFile(const char *filePath, uint64_t *fileSize) noexcept override;
+	void unmapFile(const char *mappedData, uint64_t fileSize) noexcept override;
+
+	FileFindHandle findFirst(const char *dirPath, FileFindData *result) noexcept override;
+	bool findNext(FileFindHandle findHandle, FileFindData *result) noexcept override;
+	void findClose(FileFindHandle findHandle) noexcept override;
+
+	FileSystemWatcherHandle openFileSystemWatcher(const char *path, FileSystemWatcherCallback callback, void *userData) noexcept override;
+	void closeFileSystemWatcher(FileSystemWatcherHandle watcherHandle) noexcept override;
+
+	TextureHandle getIcon(const char *path, Renderer *renderer, uint32_t *preferredWidth, uint32_t *preferredHeight) noexcept override;
+
+private:
+	static constexpr uint32_t k_invalidEntry = UINT32_MAX;
+
+	struct OpenFile
+	{
+		uint32_t m_entryIndex = k_invalidEntry;
+		bool m_binary;
+		uint64_t m_position;
+		char *m_blockCache; // last decompressed block of compressed entries
+		uint32_t m_cachedBlock;
+	};
+
+	struct FileFind
+	{
+		uint32_t m_directoryIndex = k_invalidEntry;
+		uint32_t m_nextChild;
+	};
+
+	const char *m_data = nullptr;
+	uint64_t m_size = 0;
+	const PackFile::Header *m_header = nullptr;
+	const uint32_t *m_buckets = nullptr;
+	const PackFile::Entry *m_entries = nullptr;
+	const uint32_t *m_children = nullptr;
+	const uint64_t *m_blockOffsets = nullptr;
+	const char *m_strings = nullptr;
+
+	mutable eastl::vector<OpenFile> m_openFiles;
+	eastl::vector<FileFind> m_fileFinds;
+	HandleManager m_openFileHandleManager;
+	HandleManager m_fileFindHandleManager;
+	mutable SpinLock m_openFilesSpinLock;
+	mutable SpinLock m_fileFindsSpinLock;
+
+	uint32_t findEntry(const char *path) const noexcept;
+	void getEntryPath(uint32_t entryIndex, FileFindData *result) const noexcept;
+	// decompresses a single block of a compressed entry. dst must hold the uncompressed size of the block
+	bool decompressBlock(const PackFile::Entry &entry, uint32_t blockIndex, char *dst) const noexcept;
+	// reads from an entry at the given offset and returns the number of bytes read
+	uint64_t readEntry(const PackFile::Entry &entry, uint64_t offset, size_t bufferSize, char *buffer, char *&blockCache, uint32_t &cachedBlock) const noexcept;
+};
@@ -0,0 +1,116 @@
+#include "PathCache.h"
+#include <string.h>
+#include "IFileSystem.h"
+
+bool PathCache::lookup(const char *path, char *resolvedPath, Info *info) const noexcept
+{
+	// must be read before the entry, see update()
+	info->m_generation = m_generation.load();
+
+	const Shard &shard = m_shards[getShardIndex(path)];
+	LOCK_HOLDER(shard.m_spinLock);
+
+	auto it = shard.m_entries.find_as(path);
+	if (it == shard.m_entries.end())
+	{
+		return false;
+	}
+
+	const Entry &entry = it->second;
+	memcpy(resolvedPath, entry.m_resolvedPath.c_str(), entry.m_resolvedPath.length() + 1);
+	info->m_fileSystem = entry.m_fileSystem;
+	info->m_size = entry.m_size;
+	info->m_flags = entry.m_flags;
+
+	return true;
+}
+
+void PathCache::insert(const char *path, const char *resolvedPath, const Info &info) noexcept
+{
+	Shard &shard = m_shards[getShardIndex(path)];
+	LOCK_HOLDER(shard.m_spinLock);
+
+	if (m_generation.load() != info.m_generation)
+	{
+		return;
+	}
+
+	// another thread may have resolved the same path in the meantime, in which case both results are equal
+	shard.m_entries.insert(eastl::make_pair(eastl::string(path), Entry{ info.m_fileSystem, resolvedPath, info.m_size, info.m_flags }));
+}
+
+void PathCache::update(const char *path, uint64_t generation, uint32_t flags, uint64_t size) noexcept
+{
+	Shard &shard = m_shards[getShardIndex(path)];
+	LOCK_HOLDER(shard.m_spinLock);
+
+	// invalidations bump the generation before removing entries, so an entry that is still present
+	// but was looked up before the bump can not be updated with results computed from stale data
+	if (m_generation.load() != generation)
+	{
+		return;
+	}
+
+	auto it = shard.m_entries.find_as(path);
+	if (it != shard.m_entries.end())
+	{
+		it->second.m_flags |= flags;
+		if (flags & FLAG_SIZE_VALID)
+		{
+			it->second.m_size = size;
+		}
+	}
+}
+
+void PathCache::invalidate(const char *path) noexcept
+{
+	Shard &shard = m_shards[getShardIndex(path)];
+	LOCK_HOLDER(shard.m_spinLock);
+
+	++m_generation;
+
+	auto it = shard.m_entries.find_as(path);
+	if (it != shard.m_entries.end())
+	{
+		shard.m_entries.erase(it);
+	}
+}
+
+void PathCache::invalidateRecursive(const char *path) noexcept
+{
+	++m_generation;
+
+	const size_t pathLength = strlen(path);
+
+	for (auto &shard : m_shards)
+	{
+		LOCK_HOLDER(shard.m_spinLock);
+
+		for (auto it = shard.m_entries.begin(); it != shard.m_entries.end();)
+		{
+			const auto &entryPath = it->first;
+			const bool match = entryPath.length() >= pathLength
+				&& memcmp(entryPath.c_str(), path, pathLength) == 0
+				&& (entryPath.length() == pathLength || entryPath[pathLength] == '/');
+
+			it = match ? shard.m_entries.erase(it) : eastl::next(it);
+		}
+	}
+}
+
+void PathCache::clear() noexcept
+{
+	++m_generation;
+
+	for (auto &shard : m_shards)
+	{
+		LOCK_HOLDER(shard.m_spinLock);
+		shard.m_entries.clear();
+	}
+}
+
+size_t PathCache::getShardIndex(const char *path) noexcept
+{
+	// use different bits than the bucket index of the hash_map inside the shard
+	return (eastl::hash<const char *>()(path) >> 24) % k_shardCount;
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <stdint.h>
+#include <EASTL/hash_map.h>
+#include <EASTL/string.h>
+#include <EASTL/atomic.h>
+#include "utility/SpinLock.h"
+#include "utility/DeletedCopyMove.h"
+
+class IFileSystem;
+
+/// <summary>
+/// Thread-safe cache of resolved virtual paths and the results of stat queries on them.
+/// Entries are spread over several independently locked shards, so that concurrent loads rarely contend.
+/// Every invalidation bumps a generation counter; results computed from a lookup that missed or that
+/// happened before an invalidation are discarded, so a stale stat can never overwrite a fresh invalidation.
+/// </summary>
+class PathCache
+{
+public:
+	enum Flags : uint32_t
+	{
+		FLAG_EXISTS = 1u << 0,
+		FLAG_IS_DIRECTORY_VALID = 1u << 1,
+		FLAG_IS_DIRECTORY = 1u << 2,
+		FLAG_IS_FILE_VALID = 1u << 3,
+		FLAG_IS_FILE = 1u << 4,
+		FLAG_SIZE_VALID = 1u << 5,
+	};
+
+	struct Info
+	{
+		IFileSystem *m_fileSystem;
+		uint64_t m_size;
+		uint32_t m_flags;
+		uint64_t m_generation; // generation at the time of the lookup. passed to insert() and update()
+	};
+
+	explicit PathCache() noexcept = default;
+	DELETED_COPY_MOVE(PathCache);
+
+	/// <summary>
+	/// Looks up a virtual path.
+	/// </summary>
+	/// <param name="path">The virtual path.</param>
+	/// <param name="resolvedPath">Receives the resolved path on a hit. Must hold IFileSystem::k_maxPathLength chars.</param>
+	/// <param name="info">Receives the cached info on a hit. m_generation is always written.</param>
+	/// <returns>True on a cache hit.</returns>
+	bool lookup(const char *path, char *resolvedPath, Info *info) const noexcept;
+
+	/// <summary>
+	/// Adds the resolved path of a virtual path, unless the cache was invalidated since info.m_generation.
+	/// </summary>
+	void insert(const char *path, const char *resolvedPath, const Info &info) noexcept;
+
+	/// <summary>
+	/// Adds flags (and the size if FLAG_SIZE_VALID is set) to an existing entry,
+	/// unless the cache was invalidated since the given generation.
+	/// </summary>
+	void update(const char *path, uint64_t generation, uint32_t flags, uint64_t size = 0) noexcept;
+
+	/// <summary>
+	/// Removes a single virtual path.
+	/// </summary>
+	void invalidate(const char *path) noexcept;
+
+	/// <summary>
+	/// Removes a virtual path and all paths below it.
+	/// </summary>
+	void invalidateRecursive(const char *path) noexcept;
+
+	/// <summary>
+	/// Removes all entries.
+	/// </summary>
+	void clear() noexcept;
+
+private:
+	static constexpr size_t k_shardCount = 16;
+
+	struct Entry
+	{
+		IFileSystem *m_fileSystem;
+		eastl::string m_resolvedPath;
+		uint64_t m_size;
+		uint32_t m_flags;
+	};
+
+	struct Shard
+	{
+		mutable SpinLock m_spinLock;
+		eastl::hash_map<eastl::string, Entry> m_entries;
+	};
+
+	Shard m_shards[k_shardCount];
+	eastl::atomic<uint64_t> m_generation = 0;
+
+	static size_t getShardIndex(const char *path) noexcept;
+};
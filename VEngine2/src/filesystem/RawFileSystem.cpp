@@ -1,3 +1,4 @@
+#ifdef _WIN32
 #define NOMINMAX
 #define WIN32_LEAN_AND_MEAN
 
@@ -361,6 +362,25 @@ bool RawFileSystem::remove(const char *path) const noexcept
 	}
 }
 
+uint64_t RawFileSystem::getLastWriteTime(const char *path) const noexcept
+{
+	const size_t pathLen = strlen(path);
+	wchar_t *pathW = ALLOC_A_T(wchar_t, pathLen + 1);
+	if (!widen(path, pathLen + 1, pathW))
+	{
+		Log::err("RawFileSystem::getLastWriteTime(): Failed to widen() path!");
+		return 0;
+	}
+
+	WIN32_FILE_ATTRIBUTE_DATA attributeData;
+	if (!::GetFileAttributesExW(pathW, ::GetFileExInfoStandard, &attributeData))
+	{
+		return 0;
+	}
+
+	return (uint64_t(attributeData.ftLastWriteTime.dwHighDateTime) << 32) | attributeData.ftLastWriteTime.dwLowDateTime;
+}
+
 FileHandle RawFileSystem::open(const char *filePath, FileMode mode, bool binary) noexcept
 {
 	const size_t filePathStrLen = strlen(filePath);
@@ -565,6 +585,80 @@ bool RawFileSystem::writeFile(const char *filePath, size_t bufferSize, const voi
 	return false;
 }
 
+const char *RawFileSystem::mapFile(const char *filePath, uint64_t *fileSize) noexcept
+{
+	// MapViewOfFile() can not map empty files, so all of them share this view
+	static const char s_emptyFileData[1] = {};
+
+	*fileSize = 0;
+
+	const size_t pathLen = strlen(filePath);
+	wchar_t *pathW = ALLOC_A_T(wchar_t, pathLen + 1);
+	if (!widen(filePath, pathLen + 1, pathW))
+	{
+		Log::err("RawFileSystem::mapFile(): Failed to widen() path!");
+		return nullptr;
+	}
+
+	HANDLE fileHandle = ::CreateFileW(pathW, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+	{
+		Log::err("RawFileSystem::mapFile(): Failed to open file \"%s\"! Error: %u", filePath, (unsigned)GetLastError());
+		return nullptr;
+	}
+
+	LARGE_INTEGER size{};
+	if (!::GetFileSizeEx(fileHandle, &size) || static_cast<uint64_t>(size.QuadPart) > SIZE_MAX)
+	{
+		Log::err("RawFileSystem::mapFile(): Failed to query size of file \"%s\" or file is too large to be mapped!", filePath);
+		::CloseHandle(fileHandle);
+		return nullptr;
+	}
+
+	if (size.QuadPart == 0)
+	{
+		::CloseHandle(fileHandle);
+		return s_emptyFileData;
+	}
+
+	// the view keeps the mapping and the file alive, so both handles can be closed right away
+	HANDLE mappingHandle = ::CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	::CloseHandle(fileHandle);
+
+	if (!mappingHandle)
+	{
+		Log::err("RawFileSystem::mapFile(): Failed to create file mapping for \"%s\"! Error: %u", filePath, (unsigned)GetLastError());
+		return nullptr;
+	}
+
+	void *view = ::MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	::CloseHandle(mappingHandle);
+
+	if (!view)
+	{
+		Log::err("RawFileSystem::mapFile(): Failed to map view of file \"%s\"! Error: %u", filePath, (unsigned)GetLastError());
+		return nullptr;
+	}
+
+	*fileSize = static_cast<uint64_t>(size.QuadPart);
+
+	return static_cast<const char *>(view);
+}
+
+void RawFileSystem::unmapFile(const char *mappedData, uint64_t fileSize) noexcept
+{
+	// empty files were never actually mapped
+	if (!mappedData || fileSize == 0)
+	{
+		return;
+	}
+
+	if (!::UnmapViewOfFile(mappedData))
+	{
+		Log::err("RawFileSystem::unmapFile(): Failed to unmap view! Error: %u", (unsigned)GetLastError());
+	}
+}
+
 FileFindHandle RawFileSystem::findFirst(const char *dirPath, FileFindData *result) noexcept
 {
 	*result = {};
@@ -669,6 +763,7 @@ FileFindHandle RawFileSystem::findFirst(const char *dirPath, FileFindData *resul
 		assert(narrowRes);
 
 		getDirectoryFileFlags(win32FindData.dwFileAttributes, &result->m_isDirectory, &result->m_isFile);
+		result->m_lastWriteTime = (uint64_t(win32FindData.ftLastWriteTime.dwHighDateTime) << 32) | win32FindData.ftLastWriteTime.dwLowDateTime;
 
 		return resultHandle;
 	}
@@ -725,6 +820,7 @@ bool RawFileSystem::findNext(FileFindHandle findHandle, FileFindData *result) no
 		assert(narrowRes);
 
 		getDirectoryFileFlags(win32FindData.dwFileAttributes, &result->m_isDirectory, &result->m_isFile);
+		result->m_lastWriteTime = (uint64_t(win32FindData.ftLastWriteTime.dwHighDateTime) << 32) | win32FindData.ftLastWriteTime.dwLowDateTime;
 	}
 
 	return res;
@@ -961,3 +1057,5 @@ RawFileSystem::RawFileSystem() noexcept
 	:m_fileSystemWatcherHandleManager(k_maxFileSystemWatchers)
 {
 }
+
+#endif // _WIN32
\ No newline at end of file
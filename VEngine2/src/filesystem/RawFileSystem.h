@@ -1,5 +1,9 @@
 #pragma once
 #include <EASTL/vector.h>
+#ifdef __linux__
+#include <EASTL/hash_map.h>
+#include <EASTL/string.h>
+#endif // __linux__
 #include "IFileSystem.h"
 #include "utility/HandleManager.h"
 #include "utility/SpinLock.h"
@@ -18,6 +22,11 @@ public:
 		void *m_watchDirectoryHandle;
 		IFileSystem::FileSystemWatcherCallback m_userCallback;
 		void *m_userCallbackUserData;
+#ifdef __linux__
+		int m_inotifyFd;
+		int m_wakeUpFd;
+		eastl::hash_map<int, eastl::string> m_watchDescriptorPaths; // inotify is not recursive, so every directory has its own watch
+#endif // __linux__
 	};
 
 	static RawFileSystem &get() noexcept;
@@ -30,6 +39,7 @@ public:
 	bool createDirectoryHierarchy(const char *path) const noexcept override;
 	bool rename(const char *path, const char *newName) const noexcept override;
 	bool remove(const char *path) const noexcept override;
+	uint64_t getLastWriteTime(const char *path) const noexcept override;
 
 	FileHandle open(const char *filePath, FileMode mode, bool binary) noexcept override;
 	uint64_t size(FileHandle fileHandle) const noexcept override;
@@ -40,6 +50,11 @@ public:
 
 	bool readFile(const char *filePath, size_t bufferSize, void *buffer, bool binary) noexcept override;
 	bool writeFile(const char *filePath, size_t bufferSize, const void *buffer, bool binary) noexcept override;
+#ifdef __linux__
+	size_t readFiles(size_t count, FileReadRequest *requests) noexcept override;
+#endif // __linux__
+	const char *mapFile(const char *filePath, uint64_t *fileSize) noexcept override;
+	void unmapFile(const char *mappedData, uint64_t fileSize) noexcept override;
 
 	FileFindHandle findFirst(const char *dirPath, FileFindData *result) noexcept override;
 	bool findNext(FileFindHandle findHandle, FileFindData *result) noexcept override;
@@ -0,0 +1,1248 @@
+#ifdef __linux__
+
+#include "RawFileSystem.h"
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#include <EASTL/algorithm.h>
+#include "Log.h"
+#include "Path.h"
+
+namespace
+{
+	constexpr uint32_t k_ioUringEntryCount = 64;
+	constexpr uint32_t k_inotifyMask = IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR | IN_DONT_FOLLOW;
+
+	// record layout returned by getdents64(). glibc only exposes it through readdir(), which allocates
+	struct LinuxDirent64
+	{
+		uint64_t d_ino;
+		int64_t d_off;
+		unsigned short d_reclen;
+		unsigned char d_type;
+		char d_name[1];
+	};
+
+	struct DirectoryIterator
+	{
+		int m_fd;
+		size_t m_position;
+		size_t m_size;
+		alignas(8) char m_buffer[8192];
+	};
+
+	// returns the next entry other than . and .. or nullptr at the end of the directory
+	const LinuxDirent64 *nextDirectoryEntry(DirectoryIterator &it) noexcept
+	{
+		while (true)
+		{
+			if (it.m_position >= it.m_size)
+			{
+				const long bytesRead = syscall(SYS_getdents64, it.m_fd, it.m_buffer, sizeof(it.m_buffer));
+				if (bytesRead <= 0)
+				{
+					return nullptr;
+				}
+				it.m_position = 0;
+				it.m_size = static_cast<size_t>(bytesRead);
+			}
+
+			const LinuxDirent64 *entry = reinterpret_cast<const LinuxDirent64 *>(it.m_buffer + it.m_position);
+			it.m_position += entry->d_reclen;
+
+			if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0)
+			{
+				return entry;
+			}
+		}
+	}
+
+	void getDirectoryFileFlags(int dirFd, const LinuxDirent64 &entry, bool *isDir, bool *isFile) noexcept
+	{
+		*isDir = false;
+		*isFile = false;
+
+		// dot files are hidden, which matches how hidden files are reported on Windows
+		if (entry.d_name[0] == '.')
+		{
+			return;
+		}
+
+		unsigned char type = entry.d_type;
+
+		// not all file systems fill in d_type and symlinks should report their target
+		if (type == DT_UNKNOWN || type == DT_LNK)
+		{
+			struct stat st;
+			type = DT_UNKNOWN;
+			if (fstatat(dirFd, entry.d_name, &st, 0) == 0)
+			{
+				type = S_ISDIR(st.st_mode) ? DT_DIR : S_ISREG(st.st_mode) ? DT_REG : DT_UNKNOWN;
+			}
+		}
+
+		*isDir = type == DT_DIR;
+		*isFile = type == DT_REG;
+	}
+
+	uint64_t getEntryLastWriteTime(int dirFd, const LinuxDirent64 &entry) noexcept
+	{
+		struct stat st;
+		if (fstatat(dirFd, entry.d_name, &st, 0) != 0)
+		{
+			return 0;
+		}
+		return uint64_t(st.st_mtim.tv_sec) * 1000000000ull + uint64_t(st.st_mtim.tv_nsec);
+	}
+
+	bool concatPath(char *result, const char *prefix, const char *suffix) noexcept
+	{
+		const int length = snprintf(result, IFileSystem::k_maxPathLength, "%s%s", prefix, suffix);
+		return length >= 0 && static_cast<size_t>(length) < IFileSystem::k_maxPathLength;
+	}
+
+	/// <summary>
+	/// Minimal io_uring wrapper on top of the raw system calls, so that there is no dependency on liburing.
+	/// </summary>
+	class IoUring
+	{
+	public:
+		explicit IoUring() noexcept = default;
+		DELETED_COPY_MOVE(IoUring);
+
+		~IoUring() noexcept
+		{
+			if (m_fd < 0)
+			{
+				return;
+			}
+
+			munmap(m_sqes, m_sqesSize);
+			if (m_cqRing != m_sqRing)
+			{
+				munmap(m_cqRing, m_cqRingSize);
+			}
+			munmap(m_sqRing, m_sqRingSize);
+			close(m_fd);
+		}
+
+		bool init(uint32_t entryCount) noexcept
+		{
+			io_uring_params params{};
+			const int fd = static_cast<int>(syscall(__NR_io_uring_setup, entryCount, &params));
+			if (fd < 0)
+			{
+				return false;
+			}
+
+			m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+			m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+			m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+			// newer kernels map both rings with a single mmap
+			const bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+			if (singleMmap)
+			{
+				m_sqRingSize = m_cqRingSize = eastl::max(m_sqRingSize, m_cqRingSize);
+			}
+
+			m_sqRing = mmap(nullptr, m_sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+			m_cqRing = singleMmap ? m_sqRing : mmap(nullptr, m_cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+			void *sqes = mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+
+			if (m_sqRing == MAP_FAILED || m_cqRing == MAP_FAILED || sqes == MAP_FAILED)
+			{
+				if (sqes != MAP_FAILED)
+				{
+					munmap(sqes, m_sqesSize);
+				}
+				if (m_cqRing != MAP_FAILED && m_cqRing != m_sqRing)
+				{
+					munmap(m_cqRing, m_cqRingSize);
+				}
+				if (m_sqRing != MAP_FAILED)
+				{
+					munmap(m_sqRing, m_sqRingSize);
+				}
+				close(fd);
+				return false;
+			}
+
+			char *sqRing = static_cast<char *>(m_sqRing);
+			char *cqRing = static_cast<char *>(m_cqRing);
+
+			m_fd = fd;
+			m_sqEntryCount = params.sq_entries;
+			m_sqHead = reinterpret_cast<uint32_t *>(sqRing + params.sq_off.head);
+			m_sqTail = reinterpret_cast<uint32_t *>(sqRing + params.sq_off.tail);
+			m_sqMask = *reinterpret_cast<uint32_t *>(sqRing + params.sq_off.ring_mask);
+			m_sqArray = reinterpret_cast<uint32_t *>(sqRing + params.sq_off.array);
+			m_sqes = static_cast<io_uring_sqe *>(sqes);
+			m_cqHead = reinterpret_cast<uint32_t *>(cqRing + params.cq_off.head);
+			m_cqTail = reinterpret_cast<uint32_t *>(cqRing + params.cq_off.tail);
+			m_cqMask = *reinterpret_cast<uint32_t *>(cqRing + params.cq_off.ring_mask);
+			m_cqes = reinterpret_cast<io_uring_cqe *>(cqRing + params.cq_off.cqes);
+			m_sqLocalTail = *m_sqTail;
+
+			return true;
+		}
+
+		bool isValid() const noexcept
+		{
+			return m_fd >= 0;
+		}
+
+		uint32_t getEntryCount() const noexcept
+		{
+			return m_sqEntryCount;
+		}
+
+		// returns a zeroed submission queue entry or nullptr if the queue is full
+		io_uring_sqe *getSqe() noexcept
+		{
+			const uint32_t head = __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+			if (m_sqLocalTail - head >= m_sqEntryCount)
+			{
+				return nullptr;
+			}
+
+			const uint32_t idx = m_sqLocalTail & m_sqMask;
+			io_uring_sqe *sqe = &m_sqes[idx];
+			memset(sqe, 0, sizeof(*sqe));
+			m_sqArray[idx] = idx;
+			++m_sqLocalTail;
+			++m_pendingSubmitCount;
+
+			return sqe;
+		}
+
+		// submits all entries returned by getSqe() and waits until at least waitCount completions are available
+		bool submitAndWait(uint32_t waitCount) noexcept
+		{
+			__atomic_store_n(m_sqTail, m_sqLocalTail, __ATOMIC_RELEASE);
+
+			do
+			{
+				const int ret = static_cast<int>(syscall(__NR_io_uring_enter, m_fd, m_pendingSubmitCount, waitCount, waitCount ? IORING_ENTER_GETEVENTS : 0, nullptr, 0));
+				if (ret < 0)
+				{
+					if (errno == EINTR)
+					{
+						continue;
+					}
+					return false;
+				}
+				m_pendingSubmitCount -= static_cast<uint32_t>(ret);
+			} while (m_pendingSubmitCount > 0);
+
+			return true;
+		}
+
+		// consumes all available completions
+		template<typename T>
+		void forEachCqe(T &&func) noexcept
+		{
+			uint32_t head = *m_cqHead;
+			const uint32_t tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+
+			while (head != tail)
+			{
+				func(m_cqes[head & m_cqMask]);
+				++head;
+			}
+
+			__atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+		}
+
+	private:
+		int m_fd = -1;
+		uint32_t m_sqEntryCount = 0;
+		uint32_t *m_sqHead = nullptr;
+		uint32_t *m_sqTail = nullptr;
+		uint32_t m_sqMask = 0;
+		uint32_t *m_sqArray = nullptr;
+		io_uring_sqe *m_sqes = nullptr;
+		uint32_t m_sqLocalTail = 0; // includes entries that were not submitted yet
+		uint32_t m_pendingSubmitCount = 0;
+		uint32_t *m_cqHead = nullptr;
+		uint32_t *m_cqTail = nullptr;
+		uint32_t m_cqMask = 0;
+		io_uring_cqe *m_cqes = nullptr;
+		void *m_sqRing = MAP_FAILED;
+		void *m_cqRing = MAP_FAILED;
+		size_t m_sqRingSize = 0;
+		size_t m_cqRingSize = 0;
+		size_t m_sqesSize = 0;
+	};
+
+	// submits all queued entries and calls func for the next expectedCount completions
+	template<typename T>
+	bool waitForCompletions(IoUring &ring, size_t expectedCount, T &&func) noexcept
+	{
+		size_t completedCount = 0;
+		while (completedCount < expectedCount)
+		{
+			if (!ring.submitAndWait(1))
+			{
+				return false;
+			}
+
+			ring.forEachCqe([&](const io_uring_cqe &cqe)
+				{
+					func(cqe);
+					++completedCount;
+				});
+		}
+		return true;
+	}
+
+	// reads at most ring.getEntryCount() files with all opens and reads of the batch in flight at once
+	size_t readFileBatch(IoUring &ring, size_t count, FileReadRequest *requests) noexcept
+	{
+		assert(count <= ring.getEntryCount());
+
+		int fds[k_ioUringEntryCount];
+		uint64_t offsets[k_ioUringEntryCount] = {};
+		bool pending[k_ioUringEntryCount] = {};
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			fds[i] = -1;
+
+			io_uring_sqe *sqe = ring.getSqe();
+			sqe->opcode = IORING_OP_OPENAT;
+			sqe->fd = AT_FDCWD;
+			sqe->addr = reinterpret_cast<uint64_t>(requests[i].m_path);
+			sqe->open_flags = O_RDONLY | O_CLOEXEC;
+			sqe->user_data = i;
+		}
+
+		bool ringFailed = !waitForCompletions(ring, count, [&](const io_uring_cqe &cqe)
+			{
+				// kernels before 5.6 do not support opening files through io_uring
+				fds[cqe.user_data] = cqe.res == -EINVAL ? open(requests[cqe.user_data].m_path, O_RDONLY | O_CLOEXEC) : cqe.res;
+			});
+
+		if (ringFailed)
+		{
+			// the files whose open completed before the ring failed are still open
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (fds[i] >= 0)
+				{
+					close(fds[i]);
+				}
+			}
+			return 0;
+		}
+
+		size_t pendingCount = 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			pending[i] = fds[i] >= 0 && requests[i].m_bufferSize > 0;
+			pendingCount += pending[i] ? 1 : 0;
+			requests[i].m_success = fds[i] >= 0;
+		}
+
+		// reads only need to be resubmitted if they were interrupted or the buffer is larger than a single read can fill
+		while (pendingCount > 0 && !ringFailed)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (pending[i])
+				{
+					io_uring_sqe *sqe = ring.getSqe();
+					sqe->opcode = IORING_OP_READ;
+					sqe->fd = fds[i];
+					sqe->addr = reinterpret_cast<uint64_t>(static_cast<char *>(requests[i].m_buffer) + offsets[i]);
+					sqe->len = static_cast<uint32_t>(eastl::min<uint64_t>(requests[i].m_bufferSize - offsets[i], 1u << 30));
+					sqe->off = offsets[i];
+					sqe->user_data = i;
+				}
+			}
+
+			ringFailed = !waitForCompletions(ring, pendingCount, [&](const io_uring_cqe &cqe)
+				{
+					const size_t i = static_cast<size_t>(cqe.user_data);
+					const uint64_t requestedSize = eastl::min<uint64_t>(requests[i].m_bufferSize - offsets[i], 1u << 30);
+					int64_t res = cqe.res;
+
+					if (res == -EINVAL)
+					{
+						// kernels before 5.6 do not support IORING_OP_READ
+						res = pread(fds[i], static_cast<char *>(requests[i].m_buffer) + offsets[i], requestedSize, offsets[i]);
+						res = res < 0 ? -errno : res;
+					}
+
+					if (res == -EAGAIN || res == -EINTR)
+					{
+						return;
+					}
+
+					if (res < 0)
+					{
+						requests[i].m_success = false;
+					}
+					else
+					{
+						offsets[i] += static_cast<uint64_t>(res);
+					}
+
+					// regular files only return short reads at the end of the file
+					if (res < 0 || static_cast<uint64_t>(res) < requestedSize || offsets[i] == requests[i].m_bufferSize)
+					{
+						pending[i] = false;
+						--pendingCount;
+					}
+				});
+		}
+
+		size_t successCount = 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (fds[i] >= 0)
+			{
+				close(fds[i]);
+			}
+
+			requests[i].m_success = requests[i].m_success && !ringFailed;
+			requests[i].m_bytesRead = requests[i].m_success ? offsets[i] : 0;
+			successCount += requests[i].m_success ? 1 : 0;
+		}
+
+		return successCount;
+	}
+
+	void addWatchesRecursive(RawFileSystem::FileSystemWatcherThreadData *threadData, const char *relativePath, bool reportContents) noexcept
+	{
+		char path[IFileSystem::k_maxPathLength];
+		if (!concatPath(path, threadData->m_path, relativePath))
+		{
+			return;
+		}
+
+		const int wd = inotify_add_watch(threadData->m_inotifyFd, path, k_inotifyMask);
+		if (wd < 0)
+		{
+			Log::warn("RawFileSystem: Failed to watch \"%s\": %s", path, strerror(errno));
+			return;
+		}
+
+		threadData->m_watchDescriptorPaths[wd] = relativePath;
+
+		DirectoryIterator *it = new DirectoryIterator();
+		it->m_fd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+		if (it->m_fd >= 0)
+		{
+			while (const LinuxDirent64 *entry = nextDirectoryEntry(*it))
+			{
+				bool isDir = false;
+				bool isFile = false;
+				getDirectoryFileFlags(it->m_fd, *entry, &isDir, &isFile);
+
+				char childPath[IFileSystem::k_maxPathLength];
+				if (!concatPath(childPath, relativePath, entry->d_name))
+				{
+					continue;
+				}
+
+				// files created in a new directory before its watch was added would otherwise go unnoticed
+				if (reportContents)
+				{
+					char fullPath[IFileSystem::k_maxPathLength];
+					if (concatPath(fullPath, threadData->m_path, childPath))
+					{
+						threadData->m_userCallback(fullPath, FileChangeType::ADDED, threadData->m_userCallbackUserData);
+					}
+				}
+
+				char childDirPath[IFileSystem::k_maxPathLength];
+				if (isDir && concatPath(childDirPath, childPath, "/"))
+				{
+					addWatchesRecursive(threadData, childDirPath, reportContents);
+				}
+			}
+
+			close(it->m_fd);
+		}
+
+		delete it;
+	}
+
+	void removeWatchesRecursive(RawFileSystem::FileSystemWatcherThreadData *threadData, const char *relativePath) noexcept
+	{
+		const size_t relativePathLen = strlen(relativePath);
+
+		for (auto it = threadData->m_watchDescriptorPaths.begin(); it != threadData->m_watchDescriptorPaths.end();)
+		{
+			if (strncmp(it->second.c_str(), relativePath, relativePathLen) == 0)
+			{
+				inotify_rm_watch(threadData->m_inotifyFd, it->first);
+				it = threadData->m_watchDescriptorPaths.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+	void handleInotifyEvent(RawFileSystem::FileSystemWatcherThreadData *threadData, const inotify_event &event) noexcept
+	{
+		if (event.mask & IN_Q_OVERFLOW)
+		{
+			Log::warn("RawFileSystem: File system watcher of \"%s\" missed changes because its event queue overflowed!", threadData->m_path);
+			return;
+		}
+
+		if (event.mask & IN_IGNORED)
+		{
+			threadData->m_watchDescriptorPaths.erase(event.wd);
+			return;
+		}
+
+		auto dirIt = threadData->m_watchDescriptorPaths.find(event.wd);
+
+		// events without a name refer to the watched directory itself and are reported by its parent
+		if (dirIt == threadData->m_watchDescriptorPaths.end() || event.len == 0)
+		{
+			return;
+		}
+
+		char relativePath[IFileSystem::k_maxPathLength];
+		char fullPath[IFileSystem::k_maxPathLength];
+		if (!concatPath(relativePath, dirIt->second.c_str(), event.name) || !concatPath(fullPath, threadData->m_path, relativePath))
+		{
+			return;
+		}
+
+		const bool isDir = (event.mask & IN_ISDIR) != 0;
+
+		if (event.mask & IN_MOVED_FROM)
+		{
+			threadData->m_userCallback(fullPath, FileChangeType::RENAMED_OLD_NAME, threadData->m_userCallbackUserData);
+
+			// the watches stay attached to the moved directories, so they would report changes under the old path
+			char dirPath[IFileSystem::k_maxPathLength];
+			if (isDir && concatPath(dirPath, relativePath, "/"))
+			{
+				removeWatchesRecursive(threadData, dirPath);
+			}
+		}
+		else if (event.mask & (IN_CREATE | IN_MOVED_TO))
+		{
+			threadData->m_userCallback(fullPath, (event.mask & IN_CREATE) ? FileChangeType::ADDED : FileChangeType::RENAMED_NEW_NAME, threadData->m_userCallbackUserData);
+
+			char dirPath[IFileSystem::k_maxPathLength];
+			if (isDir && concatPath(dirPath, relativePath, "/"))
+			{
+				addWatchesRecursive(threadData, dirPath, (event.mask & IN_CREATE) != 0);
+			}
+		}
+		else if (event.mask & IN_DELETE)
+		{
+			threadData->m_userCallback(fullPath, FileChangeType::REMOVED, threadData->m_userCallbackUserData);
+		}
+		else if (event.mask & (IN_CLOSE_WRITE | IN_ATTRIB))
+		{
+			// unlike IN_MODIFY, IN_CLOSE_WRITE is only reported once the writer is done with the file
+			threadData->m_userCallback(fullPath, FileChangeType::MODIFIED, threadData->m_userCallbackUserData);
+		}
+	}
+
+	void *fileSystemWatcherThreadFunc(void *arg)
+	{
+		pthread_setname_np(pthread_self(), "FSWatcher");
+
+		RawFileSystem::FileSystemWatcherThreadData *threadData = (RawFileSystem::FileSystemWatcherThreadData *)arg;
+
+		pollfd fds[2] = {};
+		fds[0].fd = threadData->m_inotifyFd;
+		fds[0].events = POLLIN;
+		fds[1].fd = threadData->m_wakeUpFd;
+		fds[1].events = POLLIN;
+
+		while (threadData->m_keepRunning.test())
+		{
+			if (poll(fds, 2, -1) < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+				break;
+			}
+
+			// closeFileSystemWatcher() wants us to exit
+			if (fds[1].revents != 0)
+			{
+				break;
+			}
+
+			const ssize_t bytesRead = read(threadData->m_inotifyFd, threadData->m_buffer, threadData->m_bufferSize);
+			if (bytesRead <= 0)
+			{
+				continue;
+			}
+
+			for (ssize_t offset = 0; offset < bytesRead;)
+			{
+				const inotify_event *event = reinterpret_cast<const inotify_event *>(threadData->m_buffer + offset);
+				handleInotifyEvent(threadData, *event);
+				offset += sizeof(inotify_event) + event->len;
+			}
+		}
+
+		return nullptr;
+	}
+}
+
+RawFileSystem &RawFileSystem::get() noexcept
+{
+	static RawFileSystem rfs;
+	return rfs;
+}
+
+void RawFileSystem::getCurrentPath(char *path) const noexcept
+{
+	if (!getcwd(path, k_maxPathLength))
+	{
+		Log::err("RawFileSystem::getCurrentPath(): Failed to get the current directory: %s", strerror(errno));
+		path[0] = '\0';
+	}
+}
+
+bool RawFileSystem::exists(const char *path) const noexcept
+{
+	struct stat st;
+	return stat(path, &st) == 0;
+}
+
+bool RawFileSystem::isDirectory(const char *path) const noexcept
+{
+	struct stat st;
+	return stat(path, &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+bool RawFileSystem::isFile(const char *path) const noexcept
+{
+	struct stat st;
+	return stat(path, &st) == 0 && !S_ISDIR(st.st_mode);
+}
+
+bool RawFileSystem::createDirectoryHierarchy(const char *path) const noexcept
+{
+	const size_t pathLen = strlen(path);
+	if ((pathLen + 1) > k_maxPathLength)
+	{
+		return false;
+	}
+
+	char folder[k_maxPathLength];
+	memcpy(folder, path, pathLen + 1);
+
+	// create every directory along the path, starting after a potential leading slash
+	for (size_t i = 1; i <= pathLen; ++i)
+	{
+		if (folder[i] != '/' && folder[i] != '\0')
+		{
+			continue;
+		}
+
+		const char c = folder[i];
+		folder[i] = '\0';
+
+		struct stat st;
+		if (stat(folder, &st) != 0 || !S_ISDIR(st.st_mode))
+		{
+			if (mkdir(folder, 0755) != 0 && errno != EEXIST)
+			{
+				Log::err("RawFileSystem::createDirectoryHierarchy(): Failed to create directory \"%s\": %s", folder, strerror(errno));
+				return false;
+			}
+		}
+
+		folder[i] = c;
+	}
+
+	return true;
+}
+
+bool RawFileSystem::rename(const char *path, const char *newName) const noexcept
+{
+	// build new path from input path + new name
+	char newPath[k_maxPathLength];
+	if (!concatPath(newPath, path, ""))
+	{
+		return false;
+	}
+	newPath[Path::getParentPath(newPath) + 1] = '\0';
+
+	char parentPath[k_maxPathLength];
+	memcpy(parentPath, newPath, strlen(newPath) + 1);
+	if (!concatPath(newPath, parentPath, newName))
+	{
+		return false;
+	}
+
+	return ::rename(path, newPath) == 0;
+}
+
+bool RawFileSystem::remove(const char *path) const noexcept
+{
+	struct stat st;
+
+	// file/directory does not exist
+	if (lstat(path, &st) != 0)
+	{
+		return false;
+	}
+
+	return S_ISDIR(st.st_mode) ? rmdir(path) == 0 : unlink(path) == 0;
+}
+
+uint64_t RawFileSystem::getLastWriteTime(const char *path) const noexcept
+{
+	struct stat st;
+	if (stat(path, &st) != 0)
+	{
+		return 0;
+	}
+
+	return uint64_t(st.st_mtim.tv_sec) * 1000000000ull + uint64_t(st.st_mtim.tv_nsec);
+}
+
+FileHandle RawFileSystem::open(const char *filePath, FileMode mode, bool binary) noexcept
+{
+	const size_t filePathStrLen = strlen(filePath);
+	if ((filePathStrLen + 1) > k_maxPathLength)
+	{
+		return NULL_FILE_HANDLE;
+	}
+
+	// there is no difference between text and binary mode on Linux
+	const char *fileMode = nullptr;
+
+	switch (mode)
+	{
+	case FileMode::READ:
+		fileMode = "r";
+		break;
+	case FileMode::WRITE:
+		fileMode = "w";
+		break;
+	case FileMode::APPEND:
+		fileMode = "a";
+		break;
+	case FileMode::OPEN_READ_WRITE:
+		fileMode = "r+";
+		break;
+	case FileMode::CREATE_READ_WRITE:
+		fileMode = "w+";
+		break;
+	case FileMode::APPEND_OR_CREATE_READ_WRITE:
+		fileMode = "a+";
+		break;
+	default:
+		return NULL_FILE_HANDLE;
+		break;
+	}
+
+	FILE *file = fopen(filePath, fileMode);
+
+	if (!file)
+	{
+		Log::err("Failed to open file \"%s\": %s", filePath, strerror(errno));
+		return NULL_FILE_HANDLE;
+	}
+
+	FileHandle resultHandle = {};
+	{
+		LOCK_HOLDER(m_openFilesSpinLock);
+		resultHandle = (FileHandle)m_openFileHandleManager.allocate();
+
+		if (!resultHandle)
+		{
+			fclose(file);
+			return NULL_FILE_HANDLE;
+		}
+
+		OpenFile openFile{};
+		memcpy(openFile.m_path, filePath, filePathStrLen + 1 /*null terminator*/);
+		openFile.m_file = file;
+
+		const size_t idx = (size_t)resultHandle - 1;
+
+		if (m_openFiles.size() <= idx)
+		{
+			size_t newSize = idx;
+			newSize += eastl::max<size_t>(1, newSize / 2);
+			newSize = eastl::max<size_t>(16, newSize);
+			m_openFiles.resize(newSize);
+		}
+
+		m_openFiles[idx] = openFile;
+	}
+
+	return resultHandle;
+}
+
+uint64_t RawFileSystem::size(FileHandle fileHandle) const noexcept
+{
+	if (!fileHandle)
+	{
+		return 0;
+	}
+
+	LOCK_HOLDER(m_openFilesSpinLock);
+
+	const char *path = m_openFiles[fileHandle - 1].m_path;
+
+	// path might be empty when the handle is invalid
+	if (*path)
+	{
+		return size(path);
+	}
+
+	return 0;
+}
+
+uint64_t RawFileSystem::size(const char *filePath) const noexcept
+{
+	struct stat st;
+	if (stat(filePath, &st) != 0)
+	{
+		return 0;
+	}
+
+	return static_cast<uint64_t>(st.st_size);
+}
+
+uint64_t RawFileSystem::read(FileHandle fileHandle, size_t bufferSize, void *buffer) const noexcept
+{
+	if (!fileHandle)
+	{
+		return 0;
+	}
+
+	LOCK_HOLDER(m_openFilesSpinLock);
+
+	FILE *file = (FILE *)m_openFiles[fileHandle - 1].m_file;
+
+	if (file)
+	{
+		return fread(buffer, 1, bufferSize, file);
+	}
+
+	return 0;
+}
+
+uint64_t RawFileSystem::write(FileHandle fileHandle, size_t bufferSize, const void *buffer) const noexcept
+{
+	if (!fileHandle)
+	{
+		return 0;
+	}
+
+	LOCK_HOLDER(m_openFilesSpinLock);
+
+	FILE *file = (FILE *)m_openFiles[fileHandle - 1].m_file;
+
+	if (file)
+	{
+		return fwrite(buffer, 1, bufferSize, file);
+	}
+
+	return 0;
+}
+
+void RawFileSystem::close(FileHandle fileHandle) noexcept
+{
+	if (!fileHandle)
+	{
+		return;
+	}
+
+	LOCK_HOLDER(m_openFilesSpinLock);
+
+	FILE *file = (FILE *)m_openFiles[fileHandle - 1].m_file;
+
+	if (file)
+	{
+		fclose(file);
+
+		m_openFiles[fileHandle - 1] = {};
+
+		m_openFileHandleManager.free((uint32_t)fileHandle);
+	}
+}
+
+bool RawFileSystem::readFile(const char *filePath, size_t bufferSize, void *buffer, bool binary) noexcept
+{
+	FileReadRequest request{ filePath, bufferSize, buffer };
+	return readFiles(1, &request) == 1;
+}
+
+bool RawFileSystem::writeFile(const char *filePath, size_t bufferSize, const void *buffer, bool binary) noexcept
+{
+	auto fh = open(filePath, FileMode::WRITE, binary);
+	if (fh)
+	{
+		uint64_t writeCount = write(fh, bufferSize, buffer);
+		close(fh);
+		return writeCount == bufferSize;
+	}
+	return false;
+}
+
+size_t RawFileSystem::readFiles(size_t count, FileReadRequest *requests) noexcept
+{
+	// every thread gets its own ring, so that loading jobs can read concurrently without locking
+	thread_local IoUring t_ring;
+	thread_local bool t_ringInitialized = false;
+
+	if (!t_ringInitialized)
+	{
+		t_ringInitialized = true;
+		if (!t_ring.init(k_ioUringEntryCount))
+		{
+			Log::warn("RawFileSystem::readFiles(): io_uring is not available, falling back to synchronous reads.");
+		}
+	}
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		requests[i].m_bytesRead = 0;
+		requests[i].m_success = false;
+	}
+
+	if (!t_ring.isValid())
+	{
+		return IFileSystem::readFiles(count, requests);
+	}
+
+	// the kernel may round the entry count up, but readFileBatch() only has room for k_ioUringEntryCount files
+	const size_t maxBatchSize = eastl::min(t_ring.getEntryCount(), k_ioUringEntryCount);
+
+	size_t successCount = 0;
+	for (size_t batchStart = 0; batchStart < count; batchStart += maxBatchSize)
+	{
+		const size_t batchSize = eastl::min(count - batchStart, maxBatchSize);
+		successCount += readFileBatch(t_ring, batchSize, requests + batchStart);
+	}
+
+	return successCount;
+}
+
+const char *RawFileSystem::mapFile(const char *filePath, uint64_t *fileSize) noexcept
+{
+	// mmap() can not map empty files, so all of them share this view
+	static const char s_emptyFileData[1] = {};
+
+	*fileSize = 0;
+
+	const int fd = ::open(filePath, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+	{
+		Log::err("RawFileSystem::mapFile(): Failed to open file \"%s\": %s", filePath, strerror(errno));
+		return nullptr;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) > SIZE_MAX)
+	{
+		Log::err("RawFileSystem::mapFile(): Failed to query size of file \"%s\" or file is too large to be mapped!", filePath);
+		::close(fd);
+		return nullptr;
+	}
+
+	if (st.st_size == 0)
+	{
+		::close(fd);
+		return s_emptyFileData;
+	}
+
+	// the mapping keeps the file alive, so the descriptor can be closed right away
+	void *view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+
+	if (view == MAP_FAILED)
+	{
+		Log::err("RawFileSystem::mapFile(): Failed to map file \"%s\": %s", filePath, strerror(errno));
+		return nullptr;
+	}
+
+	*fileSize = static_cast<uint64_t>(st.st_size);
+
+	return static_cast<const char *>(view);
+}
+
+void RawFileSystem::unmapFile(const char *mappedData, uint64_t fileSize) noexcept
+{
+	// empty files were never actually mapped
+	if (!mappedData || fileSize == 0)
+	{
+		return;
+	}
+
+	if (munmap(const_cast<char *>(mappedData), static_cast<size_t>(fileSize)) != 0)
+	{
+		Log::err("RawFileSystem::unmapFile(): Failed to unmap view: %s", strerror(errno));
+	}
+}
+
+FileFindHandle RawFileSystem::findFirst(const char *dirPath, FileFindData *result) noexcept
+{
+	*result = {};
+
+	DirectoryIterator *it = new DirectoryIterator();
+	it->m_fd = ::open(dirPath, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+	const LinuxDirent64 *entry = it->m_fd >= 0 ? nextDirectoryEntry(*it) : nullptr;
+
+	// the directory does not exist or is empty
+	if (!entry)
+	{
+		if (it->m_fd >= 0)
+		{
+			::close(it->m_fd);
+		}
+		delete it;
+		return NULL_FILE_FIND_HANDLE;
+	}
+
+	FileFind ff{};
+	if (!concatPath(ff.m_searchPath, dirPath, "/"))
+	{
+		::close(it->m_fd);
+		delete it;
+		return NULL_FILE_FIND_HANDLE;
+	}
+	ff.m_handle = it;
+
+	// allocate our handle
+	FileFindHandle resultHandle = {};
+	{
+		LOCK_HOLDER(m_fileFindsSpinLock);
+		resultHandle = (FileFindHandle)m_fileFindHandleManager.allocate();
+
+		if (!resultHandle)
+		{
+			::close(it->m_fd);
+			delete it;
+			return NULL_FILE_FIND_HANDLE;
+		}
+
+		const size_t idx = (size_t)resultHandle - 1;
+
+		if (m_fileFinds.size() <= idx)
+		{
+			size_t newSize = idx;
+			newSize += eastl::max<size_t>(1, newSize / 2);
+			newSize = eastl::max<size_t>(16, newSize);
+			m_fileFinds.resize(newSize);
+		}
+
+		m_fileFinds[idx] = ff;
+	}
+
+	bool pathRes = concatPath(result->m_path, ff.m_searchPath, entry->d_name);
+	assert(pathRes);
+
+	getDirectoryFileFlags(it->m_fd, *entry, &result->m_isDirectory, &result->m_isFile);
+	result->m_lastWriteTime = result->m_isFile ? getEntryLastWriteTime(it->m_fd, *entry) : 0;
+
+	return resultHandle;
+}
+
+bool RawFileSystem::findNext(FileFindHandle findHandle, FileFindData *result) noexcept
+{
+	if (!findHandle)
+	{
+		return false;
+	}
+
+	FileFind ff{};
+	{
+		LOCK_HOLDER(m_fileFindsSpinLock);
+
+		ff = m_fileFinds[findHandle - 1];
+	}
+
+	DirectoryIterator *it = (DirectoryIterator *)ff.m_handle;
+	assert(it);
+
+	const LinuxDirent64 *entry = nextDirectoryEntry(*it);
+
+	if (entry)
+	{
+		*result = {};
+
+		bool pathRes = concatPath(result->m_path, ff.m_searchPath, entry->d_name);
+		assert(pathRes);
+
+		getDirectoryFileFlags(it->m_fd, *entry, &result->m_isDirectory, &result->m_isFile);
+		result->m_lastWriteTime = result->m_isFile ? getEntryLastWriteTime(it->m_fd, *entry) : 0;
+	}
+
+	return entry != nullptr;
+}
+
+void RawFileSystem::findClose(FileFindHandle findHandle) noexcept
+{
+	if (!findHandle)
+	{
+		return;
+	}
+
+	LOCK_HOLDER(m_fileFindsSpinLock);
+
+	DirectoryIterator *it = (DirectoryIterator *)m_fileFinds[findHandle - 1].m_handle;
+	::close(it->m_fd);
+	delete it;
+
+	m_fileFinds[findHandle - 1].m_searchPath[0] = '\0';
+	m_fileFinds[findHandle - 1].m_handle = nullptr;
+	m_fileFindHandleManager.free(findHandle);
+}
+
+FileSystemWatcherHandle RawFileSystem::openFileSystemWatcher(const char *path, FileSystemWatcherCallback callback, void *userData) noexcept
+{
+	if (!isDirectory(path))
+	{
+		return NULL_FILE_SYSTEM_WATCHER_HANDLE;
+	}
+
+	const int inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (inotifyFd < 0)
+	{
+		Log::err("RawFileSystem::openFileSystemWatcher(): Failed to create inotify instance: %s", strerror(errno));
+		return NULL_FILE_SYSTEM_WATCHER_HANDLE;
+	}
+
+	const int wakeUpFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (wakeUpFd < 0)
+	{
+		::close(inotifyFd);
+		return NULL_FILE_SYSTEM_WATCHER_HANDLE;
+	}
+
+	// create handle of our watcher
+	FileSystemWatcherHandle resultHandle = {};
+	{
+		LOCK_HOLDER(m_fileSystemWatchersSpinLock);
+		resultHandle = (FileSystemWatcherHandle)m_fileSystemWatcherHandleManager.allocate();
+
+		// failed to allocate handle
+		if (!resultHandle)
+		{
+			::close(wakeUpFd);
+			::close(inotifyFd);
+			return NULL_FILE_SYSTEM_WATCHER_HANDLE;
+		}
+	}
+
+	const size_t idx = (size_t)resultHandle - 1;
+	FileSystemWatcherThreadData &threadData = m_fileSystemWatcherThreadData[idx];
+	assert(!threadData.m_keepRunning.test());
+
+	// buffer for inotify events. inotify never splits an event, so this must hold at least one event with a maximum length name
+	const size_t bufferSize = 4096;
+
+	concatPath(threadData.m_path, path, "/");
+	threadData.m_pathLen = strlen(threadData.m_path);
+	threadData.m_buffer = new char[bufferSize];
+	threadData.m_bufferSize = bufferSize;
+	threadData.m_keepRunning.test_and_set();
+	threadData.m_inotifyFd = inotifyFd;
+	threadData.m_wakeUpFd = wakeUpFd;
+	threadData.m_userCallback = callback;
+	threadData.m_userCallbackUserData = userData;
+
+	// the thread is not running yet, so the watch table can be filled without synchronization
+	addWatchesRecursive(&threadData, "", false);
+
+	pthread_t thread{};
+	if (threadData.m_watchDescriptorPaths.empty() || pthread_create(&thread, nullptr, fileSystemWatcherThreadFunc, &threadData) != 0)
+	{
+		threadData.m_keepRunning.clear();
+		threadData.m_watchDescriptorPaths.clear();
+		delete[] threadData.m_buffer;
+		threadData.m_buffer = nullptr;
+		::close(wakeUpFd);
+		::close(inotifyFd);
+
+		LOCK_HOLDER(m_fileSystemWatchersSpinLock);
+		m_fileSystemWatcherHandleManager.free((uint32_t)resultHandle);
+
+		return NULL_FILE_SYSTEM_WATCHER_HANDLE;
+	}
+
+	static_assert(sizeof(pthread_t) <= sizeof(void *));
+	threadData.m_threadhandle = (void *)thread;
+
+	return resultHandle;
+}
+
+void RawFileSystem::closeFileSystemWatcher(FileSystemWatcherHandle watcherHandle) noexcept
+{
+	if (!watcherHandle)
+	{
+		return;
+	}
+
+	const size_t idx = (size_t)watcherHandle - 1;
+	FileSystemWatcherThreadData &threadData = m_fileSystemWatcherThreadData[idx];
+
+	// reset atomic flag to signal to the thread to kill itself and wake it up
+	threadData.m_keepRunning.clear();
+
+	const uint64_t wakeUpValue = 1;
+	ssize_t written = ::write(threadData.m_wakeUpFd, &wakeUpValue, sizeof(wakeUpValue));
+	assert(written == sizeof(wakeUpValue));
+	(void)written;
+
+	// wait for the thread to actually finish before freeing its slot on the array
+	pthread_join((pthread_t)threadData.m_threadhandle, nullptr);
+	threadData.m_threadhandle = nullptr;
+
+	::close(threadData.m_wakeUpFd);
+	::close(threadData.m_inotifyFd);
+	threadData.m_wakeUpFd = -1;
+	threadData.m_inotifyFd = -1;
+	threadData.m_watchDescriptorPaths.clear();
+
+	// free buffer
+	delete[] threadData.m_buffer;
+	threadData.m_buffer = nullptr;
+
+	// now we can free our handle
+	LOCK_HOLDER(m_fileSystemWatchersSpinLock);
+	m_fileSystemWatcherHandleManager.free(watcherHandle);
+}
+
+TextureHandle RawFileSystem::getIcon(const char *path, Renderer *renderer, uint32_t *preferredWidth, uint32_t *preferredHeight) noexcept
+{
+	// there is no shell icon lookup on Linux; callers fall back to their default icons
+	return NULL_TEXTURE_HANDLE;
+}
+
+RawFileSystem::RawFileSystem() noexcept
+	:m_fileSystemWatcherHandleManager(k_maxFileSystemWatchers)
+{
+}
+
+#endif // __linux__
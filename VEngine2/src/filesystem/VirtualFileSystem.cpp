@@ -1,5 +1,6 @@
 #include "VirtualFileSystem.h"
 #include "RawFileSystem.h"
+#include "PackFileSystem.h"
 #include "Log.h"
 
 VirtualFileSystem &VirtualFileSystem::get() noexcept
@@ -8,40 +9,247 @@ VirtualFileSystem &VirtualFileSystem::get() noexcept
 	return vfs;
 }
 
+VirtualFileSystem::VirtualFileSystem() noexcept
+{
+	// make sure the RawFileSystem outlives us, so that unmounting in the destructor can still close watchers and mappings
+	RawFileSystem::get();
+}
+
+VirtualFileSystem::~VirtualFileSystem() noexcept
+{
+	unmountAll();
+}
+
 bool VirtualFileSystem::mount(const char *nativePath, const char *mountName) noexcept
 {
-	m_mountPoints[mountName].push_back(nativePath);
+	// a missing directory can not be watched and would disable the path cache for the pack files mounted under the same name
+	if (!RawFileSystem::get().exists(nativePath))
+	{
+		Log::warn("VirtualFileSystem: Failed to mount \"%s\" as \"/%s\", because the directory does not exist.", nativePath, mountName);
+		return false;
+	}
+
+	FileSystemWatcherHandle watcherHandle = RawFileSystem::get().openFileSystemWatcher(nativePath, onNativeFileChanged, this);
+	if (!watcherHandle)
+	{
+		Log::warn("VirtualFileSystem: Failed to watch \"%s\". Paths in \"/%s\" will not be cached.", nativePath, mountName);
+	}
+
+	m_mountPoints[mountName].push_back({ nativePath, &RawFileSystem::get(), nullptr, watcherHandle });
+	m_pathCache.clear();
+	return true;
+}
+
+bool VirtualFileSystem::mountPackFile(const char *nativePath, const char *mountName) noexcept
+{
+	PackFileSystem *packFileSystem = new PackFileSystem();
+	if (!packFileSystem->init(nativePath))
+	{
+		delete packFileSystem;
+		return false;
+	}
+
+	m_mountPoints[mountName].push_back({ "", packFileSystem, packFileSystem, NULL_FILE_SYSTEM_WATCHER_HANDLE });
+	m_pathCache.clear();
 	return true;
 }
 
-void VirtualFileSystem::unmount(const char *mountName) noexcept
+bool VirtualFileSystem::unmount(const char *mountName) noexcept
 {
 	auto it = m_mountPoints.find(mountName);
-	if (it != m_mountPoints.end())
+	if (it == m_mountPoints.end())
 	{
-		auto &v = it->second;
-		v.erase(eastl::remove_if(v.begin(), v.end(), [&](const auto &str) { return str == mountName; }), v.end());
+		return false;
 	}
+
+	for (const auto &mountPoint : it->second)
+	{
+		if (mountPoint.m_packFileSystem && isInUse(mountPoint.m_packFileSystem))
+		{
+			Log::err("VirtualFileSystem: Failed to unmount \"/%s\", because files of a mounted pack file are still open!", mountName);
+			return false;
+		}
+	}
+
+	for (auto &mountPoint : it->second)
+	{
+		unmount(mountPoint);
+	}
+	m_mountPoints.erase(it);
+	m_pathCache.clear();
+	return true;
 }
 
 void VirtualFileSystem::unmountAll() noexcept
 {
+	for (auto &p : m_mountPoints)
+	{
+		for (auto &mountPoint : p.second)
+		{
+			if (mountPoint.m_packFileSystem)
+			{
+				closeAll(mountPoint.m_packFileSystem);
+			}
+			unmount(mountPoint);
+		}
+	}
 	m_mountPoints.clear();
+	m_pathCache.clear();
+}
+
+IFileSystem *VirtualFileSystem::resolve(const char *path, char *result) const noexcept
+{
+	PathCache::Info info;
+	return resolveCached(path, result, &info);
+}
+
+void VirtualFileSystem::onNativeFileChanged(const char *path, FileChangeType changeType, void *userData)
+{
+	VirtualFileSystem *vfs = (VirtualFileSystem *)userData;
+
+	char virtualPath[k_maxPathLength];
+	if (!vfs->unresolve(path, virtualPath))
+	{
+		vfs->m_pathCache.clear();
+		return;
+	}
+
+	if (changeType == FileChangeType::MODIFIED)
+	{
+		vfs->m_pathCache.invalidate(virtualPath);
+	}
+	else
+	{
+		// the path might be a directory, in which case everything below it changed as well
+		vfs->m_pathCache.invalidateRecursive(virtualPath);
+	}
+}
+
+void VirtualFileSystem::unmount(MountPoint &mountPoint) noexcept
+{
+	if (mountPoint.m_watcherHandle)
+	{
+		RawFileSystem::get().closeFileSystemWatcher(mountPoint.m_watcherHandle);
+	}
+	delete mountPoint.m_packFileSystem;
+}
+
+bool VirtualFileSystem::isInUse(const PackFileSystem *packFileSystem) const noexcept
+{
+	const IFileSystem *fs = packFileSystem;
+	{
+		LOCK_HOLDER(m_openFilesSpinLock);
+		for (const auto &openFile : m_openFiles)
+		{
+			if (openFile.m_fileSystem == fs)
+			{
+				return true;
+			}
+		}
+		for (const auto &p : m_packFileMappings)
+		{
+			if (p.second.m_fileSystem == fs)
+			{
+				return true;
+			}
+		}
+	}
+	{
+		LOCK_HOLDER(m_fileFindsSpinLock);
+		for (const auto &fileFind : m_fileFinds)
+		{
+			if (fileFind.m_fileSystem == fs)
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void VirtualFileSystem::closeAll(const PackFileSystem *packFileSystem) noexcept
+{
+	const IFileSystem *fs = packFileSystem;
+	{
+		LOCK_HOLDER(m_openFilesSpinLock);
+		for (size_t i = 0; i < m_openFiles.size(); ++i)
+		{
+			if (m_openFiles[i].m_fileSystem == fs)
+			{
+				m_openFiles[i].m_fileSystem->close(m_openFiles[i].m_handle);
+				m_openFiles[i] = {};
+				m_openFileHandleManager.free(static_cast<uint32_t>(i + 1));
+			}
+		}
+		for (auto it = m_packFileMappings.begin(); it != m_packFileMappings.end();)
+		{
+			it = it->second.m_fileSystem == fs ? m_packFileMappings.erase(it) : eastl::next(it);
+		}
+	}
+	{
+		LOCK_HOLDER(m_fileFindsSpinLock);
+		for (size_t i = 0; i < m_fileFinds.size(); ++i)
+		{
+			if (m_fileFinds[i].m_fileSystem == fs)
+			{
+				m_fileFinds[i].m_fileSystem->findClose(m_fileFinds[i].m_handle);
+				m_fileFinds[i].m_fileSystem = nullptr;
+				m_fileFindHandleManager.free(static_cast<uint32_t>(i + 1));
+			}
+		}
+	}
+}
+
+IFileSystem *VirtualFileSystem::resolveCached(const char *path, char *result, PathCache::Info *info) const noexcept
+{
+	if (m_pathCache.lookup(path, result, info))
+	{
+		return info->m_fileSystem;
+	}
+
+	bool exists = false;
+	bool cacheable = false;
+	const MountPoint *mountPoint = resolveMountPoint(path, result, &exists, &cacheable);
+
+	if (!mountPoint)
+	{
+		return nullptr;
+	}
+
+	info->m_fileSystem = mountPoint->m_fileSystem;
+	info->m_size = 0;
+	info->m_flags = exists ? PathCache::FLAG_EXISTS : 0;
+
+	if (cacheable)
+	{
+		m_pathCache.insert(path, result, *info);
+	}
+
+	return info->m_fileSystem;
 }
 
-bool VirtualFileSystem::resolve(const char *path, char *result) const noexcept
+const VirtualFileSystem::MountPoint *VirtualFileSystem::resolveMountPoint(const char *path, char *result, bool *exists, bool *cacheable, bool writable) const noexcept
 {
+	if (exists)
+	{
+		*exists = false;
+	}
+	if (cacheable)
+	{
+		*cacheable = false;
+	}
+
 	// we only support absolute paths
 	if (!path || path[0] != '/')
 	{
-		return false;
+		return nullptr;
 	}
 
 	const size_t inputPathLen = strlen(path);
 
 	if ((inputPathLen + 1) > k_maxPathLength)
 	{
-		return false;
+		return nullptr;
 	}
 
 	// get mount name
@@ -75,35 +283,73 @@ bool VirtualFileSystem::resolve(const char *path, char *result) const noexcept
 	auto it = m_mountPoints.find(mountName);
 	if (it == m_mountPoints.end())
 	{
-		return false;
+		return nullptr;
 	}
 
-	auto &rfs = RawFileSystem::get();
+	const auto &mountPoints = it->second;
+	const MountPoint *fallbackMountPoint = nullptr;
 
-	const auto &mountPaths = it->second;
+	if (cacheable)
+	{
+		*cacheable = true;
+		for (const auto &mountPoint : mountPoints)
+		{
+			*cacheable = *cacheable && (mountPoint.m_packFileSystem || mountPoint.m_watcherHandle);
+		}
+	}
 
-	for (auto mountPathIt = mountPaths.rbegin(); mountPathIt != mountPaths.rend(); ++mountPathIt)
+	for (auto mountPointIt = mountPoints.rbegin(); mountPointIt != mountPoints.rend(); ++mountPointIt)
 	{
-		const auto &mountPath = *mountPathIt;
+		// pack files are read-only
+		if (writable && mountPointIt->m_packFileSystem)
+		{
+			continue;
+		}
+
+		const auto &mountPath = mountPointIt->m_path;
 		const size_t mountPathLen = mountPath.length();
 
 		if (mountPathLen + remainderLen + 1 > k_maxPathLength)
 		{
 			Log::err("VirtualFileSystem: The sum of the length of the mount point path \"%s\" and the virtual path \"%s\" exceed the maximum path length (%u)", mountPath.c_str(), remainder, (unsigned)k_maxPathLength);
+			continue;
 		}
 
-		size_t curLength = 0;
 		memcpy(result, mountPath.c_str(), mountPathLen);
 		memcpy(result + mountPathLen, remainder, remainderLen);
 		result[mountPathLen + remainderLen] = '\0';
 
-		if (rfs.exists(result))
+		if (mountPointIt->m_fileSystem->exists(result))
 		{
-			return true;
+			if (exists)
+			{
+				*exists = true;
+			}
+			return &*mountPointIt;
+		}
+
+		// pack files are read-only, so new files are created in the native directory with the highest precedence
+		if (!fallbackMountPoint && !mountPointIt->m_packFileSystem)
+		{
+			fallbackMountPoint = &*mountPointIt;
 		}
 	}
 
-	return false;
+	if (fallbackMountPoint)
+	{
+		memcpy(result, fallbackMountPoint->m_path.c_str(), fallbackMountPoint->m_path.length());
+		memcpy(result + fallbackMountPoint->m_path.length(), remainder, remainderLen);
+		result[fallbackMountPoint->m_path.length() + remainderLen] = '\0';
+		return fallbackMountPoint;
+	}
+
+	// only pack files are mounted under this name, so there is no directory to write to
+	if (writable)
+	{
+		return nullptr;
+	}
+
+	return mountPoints.empty() ? nullptr : &mountPoints.front();
 }
 
 bool VirtualFileSystem::unresolve(const char *path, char *result) const noexcept
@@ -117,11 +363,17 @@ bool VirtualFileSystem::unresolve(const char *path, char *result) const noexcept
 
 	for (const auto &p : m_mountPoints)
 	{
-		const auto &mountPaths = p.second;
+		const auto &mountPoints = p.second;
 
-		for (auto mountPathIt = mountPaths.rbegin(); mountPathIt != mountPaths.rend(); ++mountPathIt)
+		for (auto mountPointIt = mountPoints.rbegin(); mountPointIt != mountPoints.rend(); ++mountPointIt)
 		{
-			const auto &mountPath = *mountPathIt;
+			const auto &mountPath = mountPointIt->m_path;
+
+			// pack files do not have a native path
+			if (mountPointIt->m_packFileSystem)
+			{
+				continue;
+			}
 
 			if (memcmp(mountPath.c_str(), path, mountPath.length()) == 0)
 			{
@@ -143,127 +395,452 @@ bool VirtualFileSystem::unresolve(const char *path, char *result) const noexcept
 bool VirtualFileSystem::exists(const char *path) const noexcept
 {
 	char resolvedPath[k_maxPathLength] = {};
-	resolve(path, resolvedPath);
-	return RawFileSystem::get().exists(resolvedPath);
+	PathCache::Info info;
+	return resolveCached(path, resolvedPath, &info) && (info.m_flags & PathCache::FLAG_EXISTS) != 0;
 }
 
 bool VirtualFileSystem::isDirectory(const char *path) const noexcept
 {
 	char resolvedPath[k_maxPathLength] = {};
-	resolve(path, resolvedPath);
-	return RawFileSystem::get().isDirectory(resolvedPath);
+	PathCache::Info info;
+	IFileSystem *fs = resolveCached(path, resolvedPath, &info);
+
+	if (!fs || (info.m_flags & PathCache::FLAG_EXISTS) == 0)
+	{
+		return false;
+	}
+
+	if (info.m_flags & PathCache::FLAG_IS_DIRECTORY_VALID)
+	{
+		return (info.m_flags & PathCache::FLAG_IS_DIRECTORY) != 0;
+	}
+
+	const bool result = fs->isDirectory(resolvedPath);
+	m_pathCache.update(path, info.m_generation, PathCache::FLAG_IS_DIRECTORY_VALID | (result ? PathCache::FLAG_IS_DIRECTORY : 0));
+	return result;
 }
 
 bool VirtualFileSystem::isFile(const char *path) const noexcept
 {
 	char resolvedPath[k_maxPathLength] = {};
-	resolve(path, resolvedPath);
-	return RawFileSystem::get().isFile(resolvedPath);
+	PathCache::Info info;
+	IFileSystem *fs = resolveCached(path, resolvedPath, &info);
+
+	if (!fs || (info.m_flags & PathCache::FLAG_EXISTS) == 0)
+	{
+		return false;
+	}
+
+	if (info.m_flags & PathCache::FLAG_IS_FILE_VALID)
+	{
+		return (info.m_flags & PathCache::FLAG_IS_FILE) != 0;
+	}
+
+	const bool result = fs->isFile(resolvedPath);
+	m_pathCache.update(path, info.m_generation, PathCache::FLAG_IS_FILE_VALID | (result ? PathCache::FLAG_IS_FILE : 0));
+	return result;
 }
 
 bool VirtualFileSystem::createDirectoryHierarchy(const char *path) const noexcept
 {
 	char resolvedPath[k_maxPathLength] = {};
-	resolve(path, resolvedPath);
-	return RawFileSystem::get().createDirectoryHierarchy(resolvedPath);
+	IFileSystem *fs = resolve(path, resolvedPath);
+	const bool result = fs && fs->createDirectoryHierarchy(resolvedPath);
+
+	// any of the parent directories may have been created
+	m_pathCache.clear();
+
+	return result;
 }
 
 bool VirtualFileSystem::rename(const char *path, const char *newName) const noexcept
 {
 	char resolvedPath[k_maxPathLength] = {};
-	resolve(path, resolvedPath);
-	return RawFileSystem::get().rename(resolvedPath, newName);
+	IFileSystem *fs = resolve(path, resolvedPath);
+	const bool result = fs && fs->rename(resolvedPath, newName);
+
+	m_pathCache.clear();
+
+	return result;
 }
 
 bool VirtualFileSystem::remove(const char *path) const noexcept
 {
 	char resolvedPath[k_maxPathLength] = {};
-	resolve(path, resolvedPath);
-	return RawFileSystem::get().remove(resolvedPath);
+	IFileSystem *fs = resolve(path, resolvedPath);
+	const bool result = fs && fs->remove(resolvedPath);
+
+	m_pathCache.invalidateRecursive(path);
+
+	return result;
+}
+
+uint64_t VirtualFileSystem::getLastWriteTime(const char *path) const noexcept
+{
+	char resolvedPath[k_maxPathLength] = {};
+	IFileSystem *fs = resolve(path, resolvedPath);
+	return fs ? fs->getLastWriteTime(resolvedPath) : 0;
 }
 
 FileHandle VirtualFileSystem::open(const char *filePath, FileMode mode, bool binary) noexcept
 {
 	char resolvedPath[k_maxPathLength] = {};
-	resolve(filePath, resolvedPath);
-	return RawFileSystem::get().open(resolvedPath, mode, binary);
+	IFileSystem *fs = nullptr;
+
+	if (mode == FileMode::READ)
+	{
+		fs = resolve(filePath, resolvedPath);
+	}
+	else
+	{
+		const MountPoint *mountPoint = resolveMountPoint(filePath, resolvedPath, nullptr, nullptr, true);
+		fs = mountPoint ? mountPoint->m_fileSystem : nullptr;
+
+		// the file is created or modified; invalidate before and after opening it, as size() may be called while writing
+		m_pathCache.invalidate(filePath);
+	}
+
+	FileHandle fileHandle = fs ? fs->open(resolvedPath, mode, binary) : NULL_FILE_HANDLE;
+
+	if (mode != FileMode::READ)
+	{
+		m_pathCache.invalidate(filePath);
+	}
+
+	if (!fileHandle)
+	{
+		return NULL_FILE_HANDLE;
+	}
+
+	// handles of different file systems overlap, so hand out our own handles that remember the file system
+	FileHandle resultHandle = {};
+	{
+		LOCK_HOLDER(m_openFilesSpinLock);
+		resultHandle = (FileHandle)m_openFileHandleManager.allocate();
+
+		if (resultHandle)
+		{
+			const size_t idx = (size_t)resultHandle - 1;
+
+			if (m_openFiles.size() <= idx)
+			{
+				size_t newSize = idx;
+				newSize += eastl::max<size_t>(1, newSize / 2);
+				newSize = eastl::max<size_t>(16, newSize);
+				m_openFiles.resize(newSize);
+			}
+
+			m_openFiles[idx] = { fs, fileHandle };
+		}
+	}
+
+	if (!resultHandle)
+	{
+		fs->close(fileHandle);
+	}
+
+	return resultHandle;
 }
 
 uint64_t VirtualFileSystem::size(FileHandle fileHandle) const noexcept
 {
-	return RawFileSystem::get().size(fileHandle);
+	OpenFile openFile = getOpenFile(fileHandle);
+	return openFile.m_fileSystem ? openFile.m_fileSystem->size(openFile.m_handle) : 0;
 }
 
 uint64_t VirtualFileSystem::size(const char *filePath) const noexcept
 {
 	char resolvedPath[k_maxPathLength] = {};
-	resolve(filePath, resolvedPath);
-	return RawFileSystem::get().size(resolvedPath);
+	PathCache::Info info;
+	IFileSystem *fs = resolveCached(filePath, resolvedPath, &info);
+
+	if (!fs || (info.m_flags & PathCache::FLAG_EXISTS) == 0)
+	{
+		return 0;
+	}
+
+	if (info.m_flags & PathCache::FLAG_SIZE_VALID)
+	{
+		return info.m_size;
+	}
+
+	const uint64_t result = fs->size(resolvedPath);
+	m_pathCache.update(filePath, info.m_generation, PathCache::FLAG_SIZE_VALID, result);
+	return result;
 }
 
 uint64_t VirtualFileSystem::read(FileHandle fileHandle, size_t bufferSize, void *buffer) const noexcept
 {
-	return RawFileSystem::get().read(fileHandle, bufferSize, buffer);
+	OpenFile openFile = getOpenFile(fileHandle);
+	return openFile.m_fileSystem ? openFile.m_fileSystem->read(openFile.m_handle, bufferSize, buffer) : 0;
 }
 
 uint64_t VirtualFileSystem::write(FileHandle fileHandle, size_t bufferSize, const void *buffer) const noexcept
 {
-	return RawFileSystem::get().write(fileHandle, bufferSize, buffer);
+	OpenFile openFile = getOpenFile(fileHandle);
+	return openFile.m_fileSystem ? openFile.m_fileSystem->write(openFile.m_handle, bufferSize, buffer) : 0;
 }
 
 void VirtualFileSystem::close(FileHandle fileHandle) noexcept
 {
-	RawFileSystem::get().close(fileHandle);
+	if (!fileHandle)
+	{
+		return;
+	}
+
+	OpenFile openFile{};
+	{
+		LOCK_HOLDER(m_openFilesSpinLock);
+
+		openFile = m_openFiles[fileHandle - 1];
+
+		if (!openFile.m_fileSystem)
+		{
+			return;
+		}
+
+		m_openFiles[fileHandle - 1] = {};
+		m_openFileHandleManager.free((uint32_t)fileHandle);
+	}
+
+	openFile.m_fileSystem->close(openFile.m_handle);
 }
 
 bool VirtualFileSystem::readFile(const char *filePath, size_t bufferSize, void *buffer, bool binary) noexcept
 {
 	char resolvedPath[k_maxPathLength] = {};
-	resolve(filePath, resolvedPath);
-	return RawFileSystem::get().readFile(resolvedPath, bufferSize, buffer, binary);
+	IFileSystem *fs = resolve(filePath, resolvedPath);
+	return fs && fs->readFile(resolvedPath, bufferSize, buffer, binary);
 }
 
 bool VirtualFileSystem::writeFile(const char *filePath, size_t bufferSize, const void *buffer, bool binary) noexcept
 {
 	char resolvedPath[k_maxPathLength] = {};
-	resolve(filePath, resolvedPath);
-	return RawFileSystem::get().writeFile(resolvedPath, bufferSize, buffer, binary);
+	const MountPoint *mountPoint = resolveMountPoint(filePath, resolvedPath, nullptr, nullptr, true);
+	const bool result = mountPoint && mountPoint->m_fileSystem->writeFile(resolvedPath, bufferSize, buffer, binary);
+
+	m_pathCache.invalidate(filePath);
+
+	return result;
+}
+
+size_t VirtualFileSystem::readFiles(size_t count, FileReadRequest *requests) noexcept
+{
+	// resolve all paths first, so that every file system gets all of its requests in a single batch
+	eastl::vector<char> resolvedPaths(count * k_maxPathLength);
+	eastl::vector<IFileSystem *> fileSystems(count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		requests[i].m_bytesRead = 0;
+		requests[i].m_success = false;
+		fileSystems[i] = resolve(requests[i].m_path, resolvedPaths.data() + i * k_maxPathLength);
+	}
+
+	size_t successCount = 0;
+	eastl::vector<FileReadRequest> batch;
+	eastl::vector<size_t> batchIndices;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		IFileSystem *fs = fileSystems[i];
+
+		if (!fs)
+		{
+			continue;
+		}
+
+		batch.clear();
+		batchIndices.clear();
+
+		for (size_t j = i; j < count; ++j)
+		{
+			if (fileSystems[j] == fs)
+			{
+				batch.push_back({ resolvedPaths.data() + j * k_maxPathLength, requests[j].m_bufferSize, requests[j].m_buffer });
+				batchIndices.push_back(j);
+				fileSystems[j] = nullptr;
+			}
+		}
+
+		successCount += fs->readFiles(batch.size(), batch.data());
+
+		for (size_t j = 0; j < batch.size(); ++j)
+		{
+			requests[batchIndices[j]].m_bytesRead = batch[j].m_bytesRead;
+			requests[batchIndices[j]].m_success = batch[j].m_success;
+		}
+	}
+
+	return successCount;
+}
+
+const char *VirtualFileSystem::mapFile(const char *filePath, uint64_t *fileSize) noexcept
+{
+	*fileSize = 0;
+
+	char resolvedPath[k_maxPathLength] = {};
+	IFileSystem *fs = resolve(filePath, resolvedPath);
+	const char *mappedData = fs ? fs->mapFile(resolvedPath, fileSize) : nullptr;
+
+	if (mappedData && fs != &RawFileSystem::get())
+	{
+		// unmapFile() only gets the pointer, so remember which pack file system it came from
+		LOCK_HOLDER(m_openFilesSpinLock);
+		auto &mapping = m_packFileMappings[mappedData];
+		mapping.m_fileSystem = fs;
+		++mapping.m_referenceCount;
+	}
+
+	return mappedData;
+}
+
+void VirtualFileSystem::unmapFile(const char *mappedData, uint64_t fileSize) noexcept
+{
+	if (!mappedData)
+	{
+		return;
+	}
+
+	IFileSystem *fs = &RawFileSystem::get();
+	{
+		LOCK_HOLDER(m_openFilesSpinLock);
+
+		auto it = m_packFileMappings.find(mappedData);
+		if (it != m_packFileMappings.end())
+		{
+			fs = it->second.m_fileSystem;
+			if (--it->second.m_referenceCount == 0)
+			{
+				m_packFileMappings.erase(it);
+			}
+		}
+	}
+
+	fs->unmapFile(mappedData, fileSize);
 }
 
 FileFindHandle VirtualFileSystem::findFirst(const char *dirPath, FileFindData *result) noexcept
 {
+	*result = {};
+
 	char resolvedPath[k_maxPathLength] = {};
-	resolve(dirPath, resolvedPath);
+	const MountPoint *mountPoint = resolveMountPoint(dirPath, resolvedPath);
+
+	if (!mountPoint)
+	{
+		return NULL_FILE_FIND_HANDLE;
+	}
 
 	FileFindData tmpFindData{};
-	auto handle = RawFileSystem::get().findFirst(resolvedPath, &tmpFindData);
-	
-	*result = {};
+	FileFindHandle fileFindHandle = mountPoint->m_fileSystem->findFirst(resolvedPath, &tmpFindData);
 
-	unresolve(tmpFindData.m_path, result->m_path);
-	result->m_isDirectory = tmpFindData.m_isDirectory;
-	result->m_isFile = tmpFindData.m_isFile;
+	if (!fileFindHandle)
+	{
+		return NULL_FILE_FIND_HANDLE;
+	}
+
+	FileFind fileFind{};
+	fileFind.m_fileSystem = mountPoint->m_fileSystem;
+	fileFind.m_handle = fileFindHandle;
+	fileFind.m_mountPathLength = mountPoint->m_path.length();
+
+	// the mount name is the first component of the virtual path
+	size_t mountNameLength = 0;
+	while (dirPath[mountNameLength + 1] && dirPath[mountNameLength + 1] != '/')
+	{
+		++mountNameLength;
+	}
+	memcpy(fileFind.m_mountName, dirPath + 1, mountNameLength);
+	fileFind.m_mountName[mountNameLength] = '\0';
+
+	getVirtualFindPath(fileFind, tmpFindData, result);
+
+	FileFindHandle resultHandle = {};
+	{
+		LOCK_HOLDER(m_fileFindsSpinLock);
+		resultHandle = (FileFindHandle)m_fileFindHandleManager.allocate();
+
+		if (resultHandle)
+		{
+			const size_t idx = (size_t)resultHandle - 1;
+
+			if (m_fileFinds.size() <= idx)
+			{
+				size_t newSize = idx;
+				newSize += eastl::max<size_t>(1, newSize / 2);
+				newSize = eastl::max<size_t>(16, newSize);
+				m_fileFinds.resize(newSize);
+			}
+
+			m_fileFinds[idx] = fileFind;
+		}
+	}
+
+	if (!resultHandle)
+	{
+		fileFind.m_fileSystem->findClose(fileFindHandle);
+	}
 
-	return handle;
+	return resultHandle;
 }
 
 bool VirtualFileSystem::findNext(FileFindHandle findHandle, FileFindData *result) noexcept
 {
+	if (!findHandle)
+	{
+		return false;
+	}
+
+	FileFind fileFind{};
+	{
+		LOCK_HOLDER(m_fileFindsSpinLock);
+		fileFind = m_fileFinds[findHandle - 1];
+	}
+
+	if (!fileFind.m_fileSystem)
+	{
+		return false;
+	}
+
 	FileFindData tmpFindData{};
-	bool res = RawFileSystem::get().findNext(findHandle, &tmpFindData);
-	
+	bool res = fileFind.m_fileSystem->findNext(fileFind.m_handle, &tmpFindData);
+
 	*result = {};
 
-	unresolve(tmpFindData.m_path, result->m_path);
-	result->m_isDirectory = tmpFindData.m_isDirectory;
-	result->m_isFile = tmpFindData.m_isFile;
+	if (res)
+	{
+		getVirtualFindPath(fileFind, tmpFindData, result);
+	}
 
 	return res;
 }
 
 void VirtualFileSystem::findClose(FileFindHandle findHandle) noexcept
 {
-	RawFileSystem::get().findClose(findHandle);
+	if (!findHandle)
+	{
+		return;
+	}
+
+	IFileSystem *fs = nullptr;
+	FileFindHandle fileFindHandle = {};
+	{
+		LOCK_HOLDER(m_fileFindsSpinLock);
+
+		fs = m_fileFinds[findHandle - 1].m_fileSystem;
+		fileFindHandle = m_fileFinds[findHandle - 1].m_handle;
+
+		if (!fs)
+		{
+			return;
+		}
+
+		m_fileFinds[findHandle - 1].m_fileSystem = nullptr;
+		m_fileFindHandleManager.free((uint32_t)findHandle);
+	}
+
+	fs->findClose(fileFindHandle);
 }
 
 namespace
@@ -273,19 +850,26 @@ namespace
 		VirtualFileSystem *m_vfs;
 		IFileSystem::FileSystemWatcherCallback m_actualCallback;
 		void *m_actualCallbackUserdata;
-		FileSystemWatcherHandle m_rawHandle;
+		IFileSystem *m_fileSystem;
+		FileSystemWatcherHandle m_handle;
 	};
 }
 
 FileSystemWatcherHandle VirtualFileSystem::openFileSystemWatcher(const char *path, FileSystemWatcherCallback callback, void *userData) noexcept
 {
 	char resolvedPath[k_maxPathLength] = {};
-	resolve(path, resolvedPath);
+	IFileSystem *fs = resolve(path, resolvedPath);
+
+	if (!fs)
+	{
+		return NULL_FILE_SYSTEM_WATCHER_HANDLE;
+	}
 
 	WrapperCallbackUserData *wrapperUserData = new WrapperCallbackUserData();
 	wrapperUserData->m_vfs = this;
 	wrapperUserData->m_actualCallback = callback;
 	wrapperUserData->m_actualCallbackUserdata = userData;
+	wrapperUserData->m_fileSystem = fs;
 
 	auto wrapperCallback = [](const char *path, FileChangeType changeType, void *userData)
 	{
@@ -297,7 +881,14 @@ FileSystemWatcherHandle VirtualFileSystem::openFileSystemWatcher(const char *pat
 		wrapperUserData->m_actualCallback(unresolved, changeType, wrapperUserData->m_actualCallbackUserdata);
 	};
 
-	wrapperUserData->m_rawHandle = RawFileSystem::get().openFileSystemWatcher(resolvedPath, wrapperCallback, wrapperUserData);
+	wrapperUserData->m_handle = fs->openFileSystemWatcher(resolvedPath, wrapperCallback, wrapperUserData);
+
+	// pack files do not change, so they can not be watched
+	if (!wrapperUserData->m_handle)
+	{
+		delete wrapperUserData;
+		return NULL_FILE_SYSTEM_WATCHER_HANDLE;
+	}
 
 	return (FileSystemWatcherHandle)(size_t)wrapperUserData;
 }
@@ -310,14 +901,36 @@ void VirtualFileSystem::closeFileSystemWatcher(FileSystemWatcherHandle watcherHa
 	}
 
 	WrapperCallbackUserData *data = (WrapperCallbackUserData *)(size_t)watcherHandle;
-	RawFileSystem::get().closeFileSystemWatcher(data->m_rawHandle);
+	data->m_fileSystem->closeFileSystemWatcher(data->m_handle);
 	delete data;
 }
 
 TextureHandle VirtualFileSystem::getIcon(const char *path, Renderer *renderer, uint32_t *preferredWidth, uint32_t *preferredHeight) noexcept
 {
 	char resolvedPath[k_maxPathLength] = {};
-	resolve(path, resolvedPath);
+	IFileSystem *fs = resolve(path, resolvedPath);
+
+	return fs ? fs->getIcon(resolvedPath, renderer, preferredWidth, preferredHeight) : NULL_TEXTURE_HANDLE;
+}
+
+VirtualFileSystem::OpenFile VirtualFileSystem::getOpenFile(FileHandle fileHandle) const noexcept
+{
+	if (!fileHandle)
+	{
+		return {};
+	}
 
-	return RawFileSystem::get().getIcon(resolvedPath, renderer, preferredWidth, preferredHeight);
+	LOCK_HOLDER(m_openFilesSpinLock);
+	return m_openFiles[fileHandle - 1];
 }
+
+void VirtualFileSystem::getVirtualFindPath(const FileFind &fileFind, const FileFindData &fileFindData, FileFindData *result) const noexcept
+{
+	// replace the mount path with the mount name
+	result->m_path[0] = '/';
+	strcpy_s(result->m_path + 1, k_maxPathLength - 1, fileFind.m_mountName);
+	strcat_s(result->m_path, fileFindData.m_path + fileFind.m_mountPathLength);
+	result->m_isDirectory = fileFindData.m_isDirectory;
+	result->m_isFile = fileFindData.m_isFile;
+	result->m_lastWriteTime = fileFindData.m_lastWriteTime;
+}
\ No newline at end of file
@@ -1,17 +1,57 @@
 #pragma once
 #include "IFileSystem.h"
+#include "PathCache.h"
 #include <EASTL/vector.h>
 #include <EASTL/string_map.h>
+#include <EASTL/hash_map.h>
+#include "utility/HandleManager.h"
+#include "utility/SpinLock.h"
+
+class PackFileSystem;
 
 class VirtualFileSystem : public IFileSystem
 {
 public:
 	static VirtualFileSystem &get() noexcept;
 
+	/// <summary>
+	/// Mounts a native directory. Multiple directories and pack files can be mounted under the same name,
+	/// in which case later mounts take precedence over earlier ones. Fails if the directory does not exist.
+	/// </summary>
 	bool mount(const char *nativePath, const char *mountName) noexcept;
-	void unmount(const char *mountName) noexcept;
+
+	/// <summary>
+	/// Mounts a pack file written by PackFile::write(). The contents of pack files are read-only.
+	/// </summary>
+	bool mountPackFile(const char *nativePath, const char *mountName) noexcept;
+
+	/// <summary>
+	/// Removes all directories and pack files mounted under the given name. Fails while files, file finds or mappings
+	/// opened from one of the pack files are still open, because they reference the pack file.
+	/// </summary>
+	bool unmount(const char *mountName) noexcept;
+
+	/// <summary>
+	/// Removes all mount points. Files, file finds and mappings still open from pack files are closed.
+	/// </summary>
 	void unmountAll() noexcept;
-	bool resolve(const char *path, char *result) const noexcept;
+
+	/// <summary>
+	/// Resolves a virtual path to a path inside one of the file systems mounted under its mount name.
+	/// Paths that do not exist in any of them resolve to the native directory with the highest precedence,
+	/// so that new files can be created.
+	/// Results are cached together with exists(), isDirectory(), isFile() and size() queries. Changes made through
+	/// the VirtualFileSystem invalidate the cache immediately, changes made by other processes once the
+	/// file system watcher of the mounted directory reports them.
+	/// </summary>
+	/// <param name="path">The virtual path to resolve.</param>
+	/// <param name="result">Receives the resolved path. Must hold k_maxPathLength chars.</param>
+	/// <returns>The file system the path was resolved against or nullptr if the mount name is unknown.</returns>
+	IFileSystem *resolve(const char *path, char *result) const noexcept;
+
+	/// <summary>
+	/// Turns a native path below a mounted directory back into a virtual path.
+	/// </summary>
 	bool unresolve(const char *path, char *result) const noexcept;
 
 	bool exists(const char *path) const noexcept override;
@@ -20,6 +60,7 @@ public:
 	bool createDirectoryHierarchy(const char *path) const noexcept override;
 	bool rename(const char *path, const char *newName) const noexcept override;
 	bool remove(const char *path) const noexcept override;
+	uint64_t getLastWriteTime(const char *path) const noexcept override;
 
 	FileHandle open(const char *filePath, FileMode mode, bool binary) noexcept override;
 	uint64_t size(FileHandle fileHandle) const noexcept override;
@@ -30,6 +71,9 @@ public:
 
 	bool readFile(const char *filePath, size_t bufferSize, void *buffer, bool binary) noexcept override;
 	bool writeFile(const char *filePath, size_t bufferSize, const void *buffer, bool binary) noexcept override;
+	size_t readFiles(size_t count, FileReadRequest *requests) noexcept override;
+	const char *mapFile(const char *filePath, uint64_t *fileSize) noexcept override;
+	void unmapFile(const char *mappedData, uint64_t fileSize) noexcept override;
 
 	FileFindHandle findFirst(const char *dirPath, FileFindData *result) noexcept override;
 	bool findNext(FileFindHandle findHandle, FileFindData *result) noexcept override;
@@ -41,7 +85,54 @@ public:
 	TextureHandle getIcon(const char *path, Renderer *renderer, uint32_t *preferredWidth, uint32_t *preferredHeight) noexcept override;
 
 private:
-	eastl::string_map<eastl::vector<eastl::string8>> m_mountPoints;
+	struct MountPoint
+	{
+		eastl::string8 m_path; // native directory or empty for pack files
+		IFileSystem *m_fileSystem;
+		PackFileSystem *m_packFileSystem; // owned by the mount point
+		FileSystemWatcherHandle m_watcherHandle; // invalidates the path cache when the native directory changes
+	};
+
+	struct OpenFile
+	{
+		IFileSystem *m_fileSystem;
+		FileHandle m_handle;
+	};
+
+	struct PackFileMapping
+	{
+		IFileSystem *m_fileSystem;
+		uint32_t m_referenceCount; // uncompressed pack entries are mapped to the same address every time
+	};
+
+	struct FileFind
+	{
+		IFileSystem *m_fileSystem;
+		FileFindHandle m_handle;
+		char m_mountName[k_maxPathLength];
+		size_t m_mountPathLength; // length of the prefix of found paths that is replaced by the mount name
+	};
+
+	eastl::string_map<eastl::vector<MountPoint>> m_mountPoints;
+	eastl::vector<OpenFile> m_openFiles;
+	eastl::vector<FileFind> m_fileFinds;
+	mutable PathCache m_pathCache;
+	eastl::hash_map<const char *, PackFileMapping> m_packFileMappings; // mapFile() results of pack files, guarded by m_openFilesSpinLock
+	HandleManager m_openFileHandleManager;
+	HandleManager m_fileFindHandleManager;
+	mutable SpinLock m_openFilesSpinLock;
+	mutable SpinLock m_fileFindsSpinLock;
 
-	explicit VirtualFileSystem() noexcept = default;
+	explicit VirtualFileSystem() noexcept;
+	~VirtualFileSystem() noexcept;
+	static void onNativeFileChanged(const char *path, FileChangeType changeType, void *userData);
+	void unmount(MountPoint &mountPoint) noexcept;
+	bool isInUse(const PackFileSystem *packFileSystem) const noexcept;
+	void closeAll(const PackFileSystem *packFileSystem) noexcept;
+	IFileSystem *resolveCached(const char *path, char *result, PathCache::Info *info) const noexcept;
+	// exists is set if the path exists in the returned mount point. cacheable is set if changes to all mount points
+	// with the same mount name are reported to the path cache. writable skips pack files
+	const MountPoint *resolveMountPoint(const char *path, char *result, bool *exists = nullptr, bool *cacheable = nullptr, bool writable = false) const noexcept;
+	OpenFile getOpenFile(FileHandle fileHandle) const noexcept;
+	void getVirtualFindPath(const FileFind &fileFind, const FileFindData &fileFindData, FileFindData *result) const noexcept;
 };
\ No newline at end of file
@@ -20,6 +20,7 @@
 #include "ecs/ECS.h"
 #include "MeshRenderWorld.h"
 #include "FrustumCulling.h"
+#include "utility/allocator/ScratchAllocator.h"
 
 
 using namespace gal;
@@ -420,17 +421,21 @@ void LightManager::update(const Data &data, rg::RenderGraph *graph, LightRecordD
 		LightComponent *m_lc;
 	};
 
-	eastl::vector<LightPointers> directionalLightPtrs;
-	eastl::vector<LightPointers> shadowedDirectionalLightPtrs;
-	eastl::vector<LightPointers> punctualLightPtrs;
-	eastl::vector<LightPointers> shadowedPunctualLightPtrs;
-	eastl::vector<glm::vec4> punctualLightBoundingSpheres;
-	eastl::vector<glm::vec4> shadowedPunctualLightBoundingSpheres;
+	// lists that are only used in this function are allocated from the per-thread scratch allocator.
+	// lists captured by render graph passes are copied into the pass and need to stay on the heap.
+	ProxyAllocator scratchAllocator(scratch::getThreadAllocator());
+
+	ScratchVector<LightPointers> directionalLightPtrs(scratchAllocator);
+	ScratchVector<LightPointers> shadowedDirectionalLightPtrs(scratchAllocator);
+	ScratchVector<LightPointers> punctualLightPtrs(scratchAllocator);
+	ScratchVector<LightPointers> shadowedPunctualLightPtrs(scratchAllocator);
+	ScratchVector<glm::vec4> punctualLightBoundingSpheres(scratchAllocator);
+	ScratchVector<glm::vec4> shadowedPunctualLightBoundingSpheres(scratchAllocator);
 	eastl::vector<glm::mat4> shadowMatrices;
 	eastl::vector<glm::mat4> shadowViewMatrices;
 	eastl::vector<float> shadowFarPlanes;
 	eastl::vector<rg::ResourceViewHandle> shadowTextureRenderHandles;
-	eastl::vector<DirectionalLightGPU> directionalLights;
+	ScratchVector<DirectionalLightGPU> directionalLights(scratchAllocator);
 	eastl::vector<DirectionalLightGPU> shadowedDirectionalLights;
 	eastl::vector<PunctualLightGPU> punctualLights;
 	eastl::vector<PunctualLightShadowedGPU> punctualLightsShadowed;
@@ -488,7 +493,7 @@ void LightManager::update(const Data &data, rg::RenderGraph *graph, LightRecordD
 			}
 		});
 
-	auto createShaderResourceBuffer = [&](DescriptorType descriptorType, auto dataAsVector, bool copyNow = true, void **resultBufferPtr = nullptr)
+	auto createShaderResourceBuffer = [&](DescriptorType descriptorType, const auto &dataAsVector, bool copyNow = true, void **resultBufferPtr = nullptr)
 	{
 		const size_t elementSize = sizeof(dataAsVector[0]);
 
@@ -606,7 +611,7 @@ void LightManager::update(const Data &data, rg::RenderGraph *graph, LightRecordD
 
 	// punctual lights
 	{
-		eastl::vector<uint64_t> punctualLightsOrder;
+		ScratchVector<uint64_t> punctualLightsOrder(scratchAllocator);
 		punctualLightsOrder.reserve(punctualLightPtrs.size());
 		for (size_t i = 0; i < punctualLightPtrs.size(); ++i)
 		{
@@ -655,7 +660,7 @@ void LightManager::update(const Data &data, rg::RenderGraph *graph, LightRecordD
 	// shadowed punctual lights
 	void *punctualLightsShadowedBufferPtr = nullptr;
 	{
-		eastl::vector<uint64_t> punctualLightsOrder;
+		ScratchVector<uint64_t> punctualLightsOrder(scratchAllocator);
 		punctualLightsOrder.reserve(shadowedPunctualLightPtrs.size());
 		for (size_t i = 0; i < shadowedPunctualLightPtrs.size(); ++i)
 		{
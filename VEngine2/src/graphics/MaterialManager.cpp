@@ -30,6 +30,7 @@ MaterialManager::MaterialManager(gal::GraphicsDevice *device, TextureManager *te
 	m_materialBuffer(materialBuffer)
 {
 	m_materials.resize(16);
+	m_materialCreateInfos.resize(16);
 }
 
 void MaterialManager::createMaterials(uint32_t count, const MaterialCreateInfo *materials, MaterialHandle *handles) noexcept
@@ -56,9 +57,11 @@ void MaterialManager::createMaterials(uint32_t count, const MaterialCreateInfo *
 			if (handles[i] >= m_materials.size())
 			{
 				m_materials.resize((size_t)(m_materials.size() * 1.5));
+				m_materialCreateInfos.resize(m_materials.size());
 			}
 
 			m_materials[handles[i]] = createGPUMaterial(materials[i], m_textureManager);
+			m_materialCreateInfos[handles[i]] = materials[i];
 			memcpy(gpuMaterials + handles[i], &m_materials[handles[i]], sizeof(MaterialGPU));
 		}
 	}
@@ -78,6 +81,7 @@ void MaterialManager::updateMaterials(uint32_t count, const MaterialCreateInfo *
 		}
 
 		m_materials[handles[i]] = createGPUMaterial(materials[i], m_textureManager);
+		m_materialCreateInfos[handles[i]] = materials[i];
 	}
 }
 
@@ -94,6 +98,7 @@ void MaterialManager::destroyMaterials(uint32_t count, MaterialHandle *handles)
 		}
 
 		m_materials[handles[i]] = {};
+		m_materialCreateInfos[handles[i]] = {};
 
 		{
 			LOCK_HOLDER(m_handleManagerMutex);
@@ -113,6 +118,21 @@ MaterialGPU MaterialManager::getMaterial(MaterialHandle handle) const noexcept
 	return m_materials[handle];
 }
 
+void MaterialManager::getTextures(MaterialHandle handle, TextureHandle *textures) const noexcept
+{
+	LOCK_HOLDER(m_materialsMutex);
+	const bool validHandle = handle != 0 && handle < m_materialCreateInfos.size();
+	const MaterialCreateInfo createInfo = validHandle ? m_materialCreateInfos[handle] : MaterialCreateInfo{};
+
+	textures[0] = createInfo.m_albedoTexture;
+	textures[1] = createInfo.m_normalTexture;
+	textures[2] = createInfo.m_metallicTexture;
+	textures[3] = createInfo.m_roughnessTexture;
+	textures[4] = createInfo.m_occlusionTexture;
+	textures[5] = createInfo.m_emissiveTexture;
+	textures[6] = createInfo.m_displacementTexture;
+}
+
 void MaterialManager::flushUploadCopies(gal::CommandList *cmdList, uint64_t frameIndex) noexcept
 {
 }
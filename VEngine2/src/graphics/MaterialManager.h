@@ -11,11 +11,14 @@ class TextureManager;
 class MaterialManager
 {
 public:
+	static constexpr size_t k_textureCount = 7;
+
 	explicit MaterialManager(gal::GraphicsDevice *device, TextureManager *textureManager, gal::Buffer *materialBuffer) noexcept;
 	void createMaterials(uint32_t count, const MaterialCreateInfo *materials, MaterialHandle *handles) noexcept;
 	void updateMaterials(uint32_t count, const MaterialCreateInfo *materials, MaterialHandle *handles) noexcept;
 	void destroyMaterials(uint32_t count, MaterialHandle *handles) noexcept;
 	MaterialGPU getMaterial(MaterialHandle handle) const noexcept;
+	void getTextures(MaterialHandle handle, TextureHandle *textures) const noexcept;
 	void flushUploadCopies(gal::CommandList *cmdList, uint64_t frameIndex) noexcept;
 
 private:
@@ -24,6 +27,7 @@ private:
 	mutable SpinLock m_materialsMutex;
 	HandleManager m_handleManager;
 	eastl::vector<MaterialGPU> m_materials;
+	eastl::vector<MaterialCreateInfo> m_materialCreateInfos;
 	TextureManager *m_textureManager;
 	gal::Buffer *m_materialBuffer;
 };
\ No newline at end of file
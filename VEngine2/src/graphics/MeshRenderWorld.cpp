@@ -10,12 +10,14 @@
 #include <glm/gtx/transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include "MaterialManager.h"
+#include "TextureStreamer.h"
 #include "MeshManager.h"
 #include "ResourceViewRegistry.h"
 #include "gal/GraphicsAbstractionLayer.h"
 #include "gal/Initializers.h"
 #include "LinearGPUBufferAllocator.h"
 #include "profiling/Profiling.h"
+#include "utility/allocator/ScratchAllocator.h"
 
 MeshRenderWorld::MeshRenderWorld(gal::GraphicsDevice *device, ResourceViewRegistry *viewRegistry, MeshManager *meshManager, MaterialManager *materialManager) noexcept
 	:m_device(device),
@@ -57,7 +59,13 @@ void MeshRenderWorld::update(ECS *ecs, LinearGPUBufferAllocator *shaderResourceB
 			{
 				auto &tc = transC[i];
 				const auto &meshAsset = skinned ? sMeshC[i].m_mesh : meshC[i].m_mesh;
-				if (!meshAsset.get())
+				if (!meshAsset.isLoaded())
+				{
+					continue;
+				}
+
+				// skinned meshes can only be drawn once their skeleton is loaded and there is a matrix palette
+				if (skinned && sMeshC[i].m_curRenderMatrixPalette.empty())
 				{
 					continue;
 				}
@@ -162,13 +170,23 @@ void MeshRenderWorld::createMeshRenderList(const glm::mat4 &viewMatrix, const gl
 	result->m_skinningMatricesBufferViewHandle = m_skinningMatricesBufferViewHandle;
 	result->m_prevSkinningMatricesBufferViewHandle = m_prevSkinningMatricesBufferViewHandle;
 
+	// transient lists are allocated from the per-thread scratch allocator, which is reset at the start of every frame
+	ProxyAllocator scratchAllocator(scratch::getThreadAllocator());
+
 	// frustum cull mesh instances
-	eastl::vector<uint32_t> survivingMeshInstances(m_meshInstances.size());
+	ScratchVector<uint32_t> survivingMeshInstances(m_meshInstances.size(), scratchAllocator);
 	survivingMeshInstances.resize(FrustumCulling::cull(m_meshInstances.size(), nullptr, m_meshInstanceBoundingSpheres.data(), viewProjectionMatrix, survivingMeshInstances.data()));
 
+	// count submesh instances so that the expanded list does not need to grow
+	size_t expandedSubmeshInstanceCount = 0;
+	for (auto idx : survivingMeshInstances)
+	{
+		expandedSubmeshInstanceCount += m_meshInstances[idx].m_subMeshInstanceHandles.size();
+	}
+
 	// expand mesh instances into submesh instances
-	eastl::vector<uint32_t> expandedSubmeshInstances;
-	expandedSubmeshInstances.reserve(survivingMeshInstances.size());
+	ScratchVector<uint32_t> expandedSubmeshInstances(scratchAllocator);
+	expandedSubmeshInstances.reserve(expandedSubmeshInstanceCount);
 	for (auto idx : survivingMeshInstances)
 	{
 		const auto &meshInstance = m_meshInstances[idx];
@@ -181,7 +199,7 @@ void MeshRenderWorld::createMeshRenderList(const glm::mat4 &viewMatrix, const gl
 	const size_t submeshInstanceCount = expandedSubmeshInstances.size();
 
 	// create array of bounding spheres for culling submesh instances
-	eastl::vector<glm::vec4> subMeshBoundingSpheres(submeshInstanceCount);
+	ScratchVector<glm::vec4> subMeshBoundingSpheres(submeshInstanceCount, scratchAllocator);
 	for (size_t i = 0; i < submeshInstanceCount; ++i)
 	{
 		subMeshBoundingSpheres[i] = m_submeshInstanceBoundingSpheres[expandedSubmeshInstances[i]];
@@ -195,7 +213,7 @@ void MeshRenderWorld::createMeshRenderList(const glm::mat4 &viewMatrix, const gl
 	const glm::vec4 viewMatDepthRow = glm::vec4(viewMatrix[0][2], viewMatrix[1][2], viewMatrix[2][2], viewMatrix[3][2]);
 
 	// create sort keys
-	eastl::vector<uint64_t> sortKeys;
+	ScratchVector<uint64_t> sortKeys(scratchAllocator);
 	sortKeys.reserve(result->m_indices.size());
 	for (auto idx : result->m_indices)
 	{
@@ -279,3 +297,24 @@ size_t MeshRenderList2::getListIndex(bool dynamic, MaterialAlphaMode alphaMode,
 
 	return index;
 }
+
+void MeshRenderWorld::requestTextureResolutions(const MeshRenderList2 &renderList, const glm::mat4 &viewMatrix, float pixelScale, TextureStreamer *textureStreamer) const noexcept
+{
+	PROFILING_ZONE_SCOPED;
+
+	const glm::vec4 viewMatDepthRow = glm::vec4(viewMatrix[0][2], viewMatrix[1][2], viewMatrix[2][2], viewMatrix[3][2]);
+
+	for (auto idx : renderList.m_indices)
+	{
+		const glm::vec4 &bsphere = m_submeshInstanceBoundingSpheres[idx];
+
+		// assume that the textures are mapped once across the submesh, so they need about as many texels as its diameter covers pixels.
+		// the depth is clamped to the radius, so submeshes around the camera request full screen resolution
+		const float viewSpaceDepth = -glm::dot(viewMatDepthRow, glm::vec4(glm::vec3(bsphere), 1.0f));
+		const float resolution = bsphere.w * pixelScale / fmaxf(viewSpaceDepth, bsphere.w);
+
+		TextureHandle textures[MaterialManager::k_textureCount];
+		m_materialManager->getTextures(m_submeshInstances[idx].m_materialHandle, textures);
+		textureStreamer->requestResolution(MaterialManager::k_textureCount, textures, resolution);
+	}
+}
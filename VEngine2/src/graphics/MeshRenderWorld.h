@@ -9,6 +9,7 @@ class MaterialManager;
 class MeshManager;
 class ResourceViewRegistry;
 class LinearGPUBufferAllocator;
+class TextureStreamer;
 
 struct MeshRenderList2
 {
@@ -30,6 +31,7 @@ public:
 	explicit MeshRenderWorld(gal::GraphicsDevice *device, ResourceViewRegistry *viewRegistry, MeshManager *meshManager, MaterialManager *materialManager) noexcept;
 	void update(ECS *ecs, LinearGPUBufferAllocator *shaderResourceBufferAllocator) noexcept;
 	void createMeshRenderList(const glm::mat4 &viewMatrix, const glm::mat4 &viewProjectionMatrix, float farPlane, MeshRenderList2 *result) const noexcept;
+	void requestTextureResolutions(const MeshRenderList2 &renderList, const glm::mat4 &viewMatrix, float pixelScale, TextureStreamer *textureStreamer) const noexcept;
 
 private:
 	gal::GraphicsDevice *m_device;
@@ -179,6 +179,13 @@ void RenderView::render(const Data &data, rg::RenderGraph *graph) noexcept
 
 	data.m_meshRenderWorld->createMeshRenderList(viewData.m_viewMatrix, viewData.m_jitteredViewProjectionMatrix, viewData.m_far, &m_meshRenderList);
 
+	if (data.m_textureStreamer)
+	{
+		// an object with a radius of 1 at a distance of 1 covers this many pixels vertically
+		const float pixelScale = viewData.m_projectionMatrix[1][1] * m_height;
+		data.m_meshRenderWorld->requestTextureResolutions(m_meshRenderList, viewData.m_viewMatrix, pixelScale, data.m_textureStreamer);
+	}
+
 	// prepare data
 	const bool initializeExposureBuffer = m_frame < 2;
 	eastl::fixed_vector<rg::ResourceUsageDesc, 8> prepareFrameDataPassUsages;
@@ -27,6 +27,7 @@ struct CameraComponent;
 class LightManager;
 class ECS;
 class MeshRenderWorld;
+class TextureStreamer;
 
 class RenderView
 {
@@ -59,6 +60,7 @@ public:
 		StructuredBufferViewHandle m_irradianceVolumeBufferViewHandle;
 		uint32_t m_irradianceVolumeCount;
 		const MeshRenderWorld *m_meshRenderWorld;
+		TextureStreamer *m_textureStreamer; // optional. receives the resolutions at which visible textures are drawn
 		glm::mat4 m_viewMatrix;
 		glm::mat4 m_projectionMatrix;
 		glm::vec3 m_cameraPosition;
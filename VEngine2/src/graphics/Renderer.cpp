@@ -14,6 +14,7 @@
 #include "MeshManager.h"
 #include "TextureLoader.h"
 #include "TextureManager.h"
+#include "TextureStreamer.h"
 #include "MaterialManager.h"
 #include "component/TransformComponent.h"
 #include "component/CameraComponent.h"
@@ -74,6 +75,7 @@ Renderer::Renderer(void *windowHandle, uint32_t width, uint32_t height) noexcept
 	m_meshManager = new MeshManager(m_device, m_viewRegistry);
 	m_textureLoader = new TextureLoader(m_device);
 	m_textureManager = new TextureManager(m_device, m_viewRegistry);
+	m_textureStreamer = new TextureStreamer(m_textureLoader, m_textureManager);
 	m_rendererResources = new RendererResources(m_device, m_viewRegistry, m_textureLoader);
 	m_materialManager = new MaterialManager(m_device, m_textureManager, m_rendererResources->m_materialsBuffer);
 
@@ -101,6 +103,7 @@ Renderer::~Renderer() noexcept
 	delete m_irradianceVolumeManager;
 	delete m_reflectionProbeManager;
 	delete m_materialManager;
+	delete m_textureStreamer;
 	delete m_textureLoader;
 	delete m_textureManager;
 	delete m_meshManager;
@@ -134,7 +137,8 @@ void Renderer::render(float deltaTime, ECS *ecs, uint64_t cameraEntity, float fr
 					tc.m_prevRenderTransform = tc.m_mobility == Mobility::Static ? tc.m_globalTransform : tc.m_curRenderTransform;
 					tc.m_curRenderTransform = tc.m_mobility == Mobility::Static ? tc.m_globalTransform : lerp(tc.m_prevGlobalTransform, tc.m_globalTransform, fractionalSimFrameTime);
 
-					if (skinnedMeshC)
+					// there is no matrix palette until the skeleton is loaded
+					if (skinnedMeshC && !skinnedMeshC[i].m_matrixPalette.empty())
 					{
 						auto &sc = skinnedMeshC[i];
 						assert(sc.m_matrixPalette.size() == sc.m_skeleton->getSkeleton()->getJointCount());
@@ -175,6 +179,9 @@ void Renderer::render(float deltaTime, ECS *ecs, uint64_t cameraEntity, float fr
 	m_textureManager->flushDeletionQueue(m_frame);
 	m_meshManager->flushDeletionQueue(m_frame);
 
+	// swap in finished textures before any pass of this frame references them
+	m_textureStreamer->update(m_frame);
+
 	{
 		PROFILING_ZONE_SCOPED_N("Record CommandList");
 
@@ -307,6 +314,7 @@ void Renderer::render(float deltaTime, ECS *ecs, uint64_t cameraEntity, float fr
 			renderViewData.m_irradianceVolumeBufferViewHandle = m_irradianceVolumeManager->getIrradianceVolumeBufferViewHandle();
 			renderViewData.m_irradianceVolumeCount = m_irradianceVolumeManager->getIrradianceVolumeCount();
 			renderViewData.m_meshRenderWorld = m_meshRenderWorld;
+			renderViewData.m_textureStreamer = m_textureStreamer;
 			renderViewData.m_viewMatrix = camera.getViewMatrix();
 			renderViewData.m_projectionMatrix = camera.getProjectionMatrix();
 			renderViewData.m_cameraPosition = camera.getPosition();
@@ -444,6 +452,11 @@ TextureHandle Renderer::loadTexture(size_t fileSize, const char *fileData, const
 	return m_textureManager->add(image, view);
 }
 
+TextureHandle Renderer::loadStreamedTexture(size_t fileSize, const char *fileData, const char *path) noexcept
+{
+	return m_textureStreamer->loadTexture(fileSize, fileData, path);
+}
+
 TextureHandle Renderer::loadRawRGBA8(size_t fileSize, const char *fileData, const char *textureName, uint32_t width, uint32_t height) noexcept
 {
 	gal::Image *image = nullptr;
@@ -458,7 +471,16 @@ TextureHandle Renderer::loadRawRGBA8(size_t fileSize, const char *fileData, cons
 
 void Renderer::destroyTexture(TextureHandle handle) noexcept
 {
-	m_textureManager->free(handle, m_frame);
+	// streamed textures with a request in flight are freed by the TextureStreamer once the request finished
+	if (m_textureStreamer->removeTexture(handle))
+	{
+		m_textureManager->free(handle, m_frame);
+	}
+}
+
+void Renderer::setTextureStreamingBudget(uint64_t budget) noexcept
+{
+	m_textureStreamer->setBudget(budget);
 }
 
 void Renderer::createMaterials(uint32_t count, const MaterialCreateInfo *materials, MaterialHandle *handles) noexcept
@@ -20,6 +20,7 @@ class RendererResources;
 class MeshManager;
 class TextureLoader;
 class TextureManager;
+class TextureStreamer;
 class MaterialManager;
 class ImGuiPass;
 class ECS;
@@ -45,8 +46,10 @@ public:
 	void createSubMeshes(uint32_t count, SubMeshCreateInfo *subMeshes, SubMeshHandle *handles) noexcept;
 	void destroySubMeshes(uint32_t count, SubMeshHandle *handles) noexcept;
 	TextureHandle loadTexture(size_t fileSize, const char *fileData, const char *textureName) noexcept;
+	TextureHandle loadStreamedTexture(size_t fileSize, const char *fileData, const char *path) noexcept;
 	TextureHandle loadRawRGBA8(size_t fileSize, const char *fileData, const char *textureName, uint32_t width, uint32_t height) noexcept;
 	void destroyTexture(TextureHandle handle) noexcept;
+	void setTextureStreamingBudget(uint64_t budget) noexcept;
 	void createMaterials(uint32_t count, const MaterialCreateInfo *materials, MaterialHandle *handles) noexcept;
 	void updateMaterials(uint32_t count, const MaterialCreateInfo *materials, MaterialHandle *handles) noexcept;
 	void destroyMaterials(uint32_t count, MaterialHandle *handles) noexcept;
@@ -89,6 +92,7 @@ private:
 	MeshManager *m_meshManager = nullptr;
 	TextureLoader *m_textureLoader = nullptr;
 	TextureManager *m_textureManager = nullptr;
+	TextureStreamer *m_textureStreamer = nullptr;
 	MaterialManager *m_materialManager = nullptr;
 	ReflectionProbeManager *m_reflectionProbeManager = nullptr;
 	IrradianceVolumeManager *m_irradianceVolumeManager = nullptr;
@@ -192,9 +192,8 @@ RendererResources::RendererResources(gal::GraphicsDevice *device, ResourceViewRe
 	// blue noise texture
 	{
 		const char *k_filepath = "/assets/textures/blue_noise.dds";
-		eastl::vector<char> fileData(VirtualFileSystem::get().size(k_filepath));
-		VirtualFileSystem::get().readFile(k_filepath, fileData.size(), fileData.data(), true);
-		textureLoader->load(fileData.size(), fileData.data(), k_filepath, &m_blueNoiseTexture, &m_blueNoiseTextureView);
+		ScopedFileMapping fileMapping(VirtualFileSystem::get(), k_filepath);
+		textureLoader->load(static_cast<size_t>(fileMapping.getSize()), fileMapping.getData(), k_filepath, &m_blueNoiseTexture, &m_blueNoiseTextureView);
 		m_blueNoiseTextureViewHandle = m_resourceViewRegistry->createTextureViewHandle(m_blueNoiseTextureView);
 	}
 
@@ -28,7 +28,7 @@ TextureLoader::~TextureLoader() noexcept
 	}
 }
 
-bool TextureLoader::load(size_t fileSize, const char *fileData, const char *textureName, gal::Image **image, gal::ImageView **imageView) noexcept
+bool TextureLoader::load(size_t fileSize, const char *fileData, const char *textureName, gal::Image **image, gal::ImageView **imageView, uint32_t maxExtent, MipChainInfo *mipChainInfo) noexcept
 {
 	gli::texture gliTex(gli::load(fileData, fileSize));
 
@@ -38,14 +38,36 @@ bool TextureLoader::load(size_t fileSize, const char *fileData, const char *text
 		return false;
 	}
 
+	const size_t levelCount = glm::min(gliTex.levels(), (size_t)k_maxMipLevels);
+
+	// skip all levels that are larger than maxExtent, but always keep the smallest level
+	size_t baseLevel = 0;
+	while (baseLevel + 1 < levelCount && static_cast<uint32_t>(glm::max(gliTex.extent(baseLevel).x, gliTex.extent(baseLevel).y)) > maxExtent)
+	{
+		++baseLevel;
+	}
+
+	if (mipChainInfo)
+	{
+		*mipChainInfo = {};
+		mipChainInfo->m_width = static_cast<uint32_t>(gliTex.extent().x);
+		mipChainInfo->m_height = static_cast<uint32_t>(gliTex.extent().y);
+		mipChainInfo->m_levels = static_cast<uint32_t>(levelCount);
+		mipChainInfo->m_baseLevel = static_cast<uint32_t>(baseLevel);
+		for (size_t level = 0; level < levelCount; ++level)
+		{
+			mipChainInfo->m_levelSizes[level] = gliTex.size(level) * gliTex.layers() * gliTex.faces();
+		}
+	}
+
 	// create image
 	{
 		gal::ImageCreateInfo imageCreateInfo{};
-		imageCreateInfo.m_width = static_cast<uint32_t>(gliTex.extent().x);
-		imageCreateInfo.m_height = static_cast<uint32_t>(gliTex.extent().y);
-		imageCreateInfo.m_depth = static_cast<uint32_t>(gliTex.extent().z);
+		imageCreateInfo.m_width = static_cast<uint32_t>(gliTex.extent(baseLevel).x);
+		imageCreateInfo.m_height = static_cast<uint32_t>(gliTex.extent(baseLevel).y);
+		imageCreateInfo.m_depth = static_cast<uint32_t>(gliTex.extent(baseLevel).z);
 		imageCreateInfo.m_layers = static_cast<uint32_t>(gliTex.layers());
-		imageCreateInfo.m_levels = static_cast<uint32_t>(gliTex.levels());
+		imageCreateInfo.m_levels = static_cast<uint32_t>(levelCount - baseLevel);
 		imageCreateInfo.m_samples = gal::SampleCount::_1;
 		imageCreateInfo.m_imageType = (gliTex.target() == gli::TARGET_2D || gliTex.target() == gli::TARGET_2D_ARRAY) ? gal::ImageType::_2D : gal::ImageType::_3D;
 		imageCreateInfo.m_format = static_cast<gal::Format>(gliTex.format());
@@ -66,7 +88,7 @@ bool TextureLoader::load(size_t fileSize, const char *fileData, const char *text
 	{
 		// if this is a compressed format, how many texels is each block?
 		auto blockExtent = gli::block_extent(gliTex.format());
-		for (size_t level = 0; level < gliTex.levels(); ++level)
+		for (size_t level = baseLevel; level < levelCount; ++level)
 		{
 			// blocks in this level; use max to ensure we dont divide e.g. extent = 2 by blockExtent = 4
 			auto blockDims = glm::max(gliTex.extent(level), blockExtent) / blockExtent;
@@ -101,14 +123,14 @@ bool TextureLoader::load(size_t fileSize, const char *fileData, const char *text
 
 	Upload upload = {};
 	upload.m_imageSubresourceRange.m_baseMipLevel = 0;
-	upload.m_imageSubresourceRange.m_levelCount = static_cast<uint32_t>(gliTex.levels());
+	upload.m_imageSubresourceRange.m_levelCount = static_cast<uint32_t>(levelCount - baseLevel);
 	upload.m_imageSubresourceRange.m_baseArrayLayer = 0;
 	upload.m_imageSubresourceRange.m_layerCount = static_cast<uint32_t>(gliTex.layers());
 	upload.m_stagingBuffer = stagingBuffer;
 	upload.m_texture = *image;
 
 	// copy image data to staging buffer
-	upload.m_bufferCopyRegions.reserve(gliTex.levels());
+	upload.m_bufferCopyRegions.reserve((levelCount - baseLevel) * gliTex.layers() * gliTex.faces());
 	{
 		uint8_t *data;
 		stagingBuffer->map((void **)&data);
@@ -119,7 +141,7 @@ bool TextureLoader::load(size_t fileSize, const char *fileData, const char *text
 		// if this is a compressed format, how many texels is each block?
 		auto blockExtent = gli::block_extent(gliTex.format());
 
-		for (size_t level = 0; level < gliTex.levels(); ++level)
+		for (size_t level = baseLevel; level < levelCount; ++level)
 		{
 			// blocks in this level; use max to ensure we dont divide e.g. extent = 2 by blockExtent = 4
 			auto blockDims = glm::max(gliTex.extent(level), blockExtent) / blockExtent;
@@ -139,7 +161,7 @@ bool TextureLoader::load(size_t fileSize, const char *fileData, const char *text
 					const uint8_t *srcData = (uint8_t *)gliTex.data(layer, face, level);
 
 					gal::BufferImageCopy bufferCopyRegion{};
-					bufferCopyRegion.m_imageMipLevel = static_cast<uint32_t>(level);
+					bufferCopyRegion.m_imageMipLevel = static_cast<uint32_t>(level - baseLevel);
 					bufferCopyRegion.m_imageBaseLayer = static_cast<uint32_t>(layer);
 					bufferCopyRegion.m_imageLayerCount = 1;
 					bufferCopyRegion.m_extent.m_width = static_cast<uint32_t>(gliTex.extent(level).x);
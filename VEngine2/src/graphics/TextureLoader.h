@@ -11,6 +11,20 @@
 class TextureLoader
 {
 public:
+	static constexpr uint32_t k_maxMipLevels = 16;
+
+	/// <summary>
+	/// Describes the complete mip chain of a texture file and which part of it was loaded.
+	/// </summary>
+	struct MipChainInfo
+	{
+		uint32_t m_width;
+		uint32_t m_height;
+		uint32_t m_levels;
+		uint32_t m_baseLevel; // first loaded mip level of the file; becomes mip level 0 of the Image
+		uint64_t m_levelSizes[k_maxMipLevels]; // size in bytes of each level, including all layers and faces
+	};
+
 	explicit TextureLoader(gal::GraphicsDevice *device) noexcept;
 	~TextureLoader() noexcept;
 
@@ -24,8 +38,10 @@ public:
 	/// <param name="textureName">A (non-unique) name to refer to the texture in logs and debug tools.</param>
 	/// <param name="image">[Out] A pointer to the resulting Image.</param>
 	/// <param name="imageView">[Out] A pointer to the resulting ImageView.</param>
+	/// <param name="maxExtent">Mip levels that are larger than this in width or height are skipped. The smallest level is always loaded.</param>
+	/// <param name="mipChainInfo">[Out] Optional pointer to receive the mip chain of the file.</param>
 	/// <returns>True if the call succeeded.</returns>
-	bool load(size_t fileSize, const char *fileData, const char *textureName, gal::Image **image, gal::ImageView **imageView) noexcept;
+	bool load(size_t fileSize, const char *fileData, const char *textureName, gal::Image **image, gal::ImageView **imageView, uint32_t maxExtent = UINT32_MAX, MipChainInfo *mipChainInfo = nullptr) noexcept;
 
 	bool loadRawRGBA8(size_t fileSize, const char *fileData, const char *textureName, uint32_t width, uint32_t height, gal::Image **image, gal::ImageView **imageView) noexcept;
 
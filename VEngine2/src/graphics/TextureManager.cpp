@@ -106,9 +106,10 @@ TextureHandle TextureManager::add(gal::Image *image, gal::ImageView *view) noexc
 	return TextureHandle(handle);
 }
 
-void TextureManager::update(TextureHandle handle, gal::Image *image, gal::ImageView *view) noexcept
+void TextureManager::update(TextureHandle handle, gal::Image *image, gal::ImageView *view, uint64_t frameIndex) noexcept
 {
 	TextureViewHandle viewHandle = {};
+	Texture prevTex;
 	{
 		LOCK_HOLDER(m_texturesMutex);
 		const bool validHandle = handle != 0 && handle < m_textures.size();
@@ -119,7 +120,7 @@ void TextureManager::update(TextureHandle handle, gal::Image *image, gal::ImageV
 		}
 
 		auto &tex = m_textures[handle];
-		tex = {};
+		prevTex = tex;
 		tex.m_image = image;
 		tex.m_view = view;
 
@@ -127,6 +128,14 @@ void TextureManager::update(TextureHandle handle, gal::Image *image, gal::ImageV
 	}
 
 	m_viewRegistry->updateHandle(viewHandle, view);
+
+	if (prevTex.m_image)
+	{
+		LOCK_HOLDER(m_deletionQueueMutex);
+
+		// the previous texture may still be in use by frames in flight, so delete it in 2 frames from now
+		m_deletionQueue.push({ prevTex.m_image, prevTex.m_view, (frameIndex + 2) });
+	}
 }
 
 void TextureManager::free(TextureHandle handle, uint64_t frameIndex) noexcept
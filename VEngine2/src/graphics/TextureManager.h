@@ -49,13 +49,15 @@ public:
 	/// used to access the texture from the GPU. When free() is called, the TextureManager will free the
 	/// TextureViewHandle from the ResourceViewRegistry and destroy the Image and ImageView. Destruction
 	/// of Image and ImageView can be disabled by passing a null Image instead. The user is then responsible
-	/// for destroying the Image and ImageView. This function is internally synchronized.
+	/// for destroying the Image and ImageView. The previous Image and ImageView are destroyed with the same
+	/// delay as in free(), unless they were added with a null Image. This function is internally synchronized.
 	/// </summary>
 	/// <param name="handle">The TextureHandle to update.</param>
 	/// <param name="image">The Image object of the texture to add. Can be null if the user wants to manually destroy the Image and ImageView objects.</param>
 	/// <param name="view">The ImageView object of the texture to add.</param>
+	/// <param name="frameIndex">The current frame index. This is used internally to defer destruction of the previous Image and ImageView.</param>
 	/// <returns></returns>
-	void update(TextureHandle handle, gal::Image *image, gal::ImageView *view) noexcept;
+	void update(TextureHandle handle, gal::Image *image, gal::ImageView *view, uint64_t frameIndex) noexcept;
 
 	/// <summary>
 	/// Frees a TextureHandle that was created by a previous call to add().
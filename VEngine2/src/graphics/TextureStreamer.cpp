@@ -0,0 +1,335 @@
+#include "TextureStreamer.h"
+#include <math.h>
+#include <EASTL/sort.h>
+#include <EASTL/fixed_vector.h>
+#include "TextureManager.h"
+#include "Log.h"
+#include "job/JobSystem.h"
+#include "utility/Thread.h"
+#include "filesystem/VirtualFileSystem.h"
+#include "profiling/Profiling.h"
+
+TextureStreamer::TextureStreamer(TextureLoader *textureLoader, TextureManager *textureManager) noexcept
+	:m_textureLoader(textureLoader),
+	m_textureManager(textureManager)
+{
+	m_textures.resize(16);
+}
+
+TextureStreamer::~TextureStreamer() noexcept
+{
+	// streaming jobs still reference this object
+	while (m_pendingRequestCount.load() != 0)
+	{
+		Thread::yield();
+	}
+
+	// hand the Images of finished requests over to the TextureManager, which destroys them
+	LOCK_HOLDER(m_texturesMutex);
+	applyFinishedRequests(m_frame);
+}
+
+TextureHandle TextureStreamer::loadTexture(size_t fileSize, const char *fileData, const char *path) noexcept
+{
+	gal::Image *image = nullptr;
+	gal::ImageView *view = nullptr;
+	TextureLoader::MipChainInfo mipChain;
+	if (!m_textureLoader->load(fileSize, fileData, path, &image, &view, k_mipTailExtent, &mipChain))
+	{
+		return TextureHandle();
+	}
+
+	TextureHandle handle = m_textureManager->add(image, view);
+
+	if (handle == 0)
+	{
+		return TextureHandle();
+	}
+
+	LOCK_HOLDER(m_texturesMutex);
+
+	if (handle >= m_textures.size())
+	{
+		m_textures.resize(eastl::max<size_t>(handle + 1, (size_t)(m_textures.size() * 1.5)));
+	}
+
+	auto &tex = m_textures[handle];
+	tex = {};
+	tex.m_path = path;
+	tex.m_mipChain = mipChain;
+	tex.m_tailLevel = mipChain.m_baseLevel;
+	tex.m_residentLevel = mipChain.m_baseLevel;
+	tex.m_targetLevel = mipChain.m_baseLevel;
+	tex.m_lastRequestFrame = m_frame;
+	tex.m_registered = true;
+
+	m_residentSize += getLevelsSize(tex, tex.m_residentLevel);
+
+	return handle;
+}
+
+bool TextureStreamer::removeTexture(TextureHandle handle) noexcept
+{
+	LOCK_HOLDER(m_texturesMutex);
+
+	const bool validHandle = handle != 0 && handle < m_textures.size() && m_textures[handle].m_registered;
+	if (!validHandle)
+	{
+		return true;
+	}
+
+	auto &tex = m_textures[handle];
+
+	// the finished request still needs to replace the Image of the handle, so the handle is freed in applyFinishedRequests()
+	if (tex.m_pending)
+	{
+		tex.m_removed = true;
+		return false;
+	}
+
+	m_residentSize -= getLevelsSize(tex, tex.m_residentLevel);
+	tex = {};
+
+	return true;
+}
+
+void TextureStreamer::requestResolution(size_t count, const TextureHandle *handles, float resolution) noexcept
+{
+	LOCK_HOLDER(m_texturesMutex);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const bool validHandle = handles[i] != 0 && handles[i] < m_textures.size();
+		if (validHandle)
+		{
+			auto &tex = m_textures[handles[i]];
+			tex.m_requestedResolution = eastl::max(tex.m_requestedResolution, resolution);
+		}
+	}
+}
+
+void TextureStreamer::update(uint64_t frameIndex) noexcept
+{
+	PROFILING_ZONE_SCOPED;
+
+	eastl::fixed_vector<job::Job, k_maxPendingRequests> jobs;
+
+	{
+		LOCK_HOLDER(m_texturesMutex);
+
+		m_frame = frameIndex;
+
+		applyFinishedRequests(frameIndex);
+
+		// compute the level each texture should have resident
+		uint64_t targetSize = 0;
+		m_sortedTextures.clear();
+		for (size_t i = 0; i < m_textures.size(); ++i)
+		{
+			auto &tex = m_textures[i];
+
+			if (!tex.m_registered)
+			{
+				continue;
+			}
+
+			if (tex.m_failed)
+			{
+				tex.m_targetLevel = tex.m_residentLevel;
+			}
+			else if (tex.m_requestedResolution > 0.0f)
+			{
+				tex.m_resolution = tex.m_requestedResolution;
+				tex.m_lastRequestFrame = frameIndex;
+
+				// the level at which a texel roughly covers a pixel
+				const float extent = static_cast<float>(eastl::max(tex.m_mipChain.m_width, tex.m_mipChain.m_height));
+				const float level = floorf(log2f(extent / tex.m_resolution));
+				tex.m_targetLevel = level <= 0.0f ? 0 : eastl::min(static_cast<uint32_t>(level), tex.m_tailLevel);
+
+				// only stream out when at least two levels are unused, so textures do not bounce between two levels
+				if (tex.m_targetLevel == tex.m_residentLevel + 1)
+				{
+					tex.m_targetLevel = tex.m_residentLevel;
+				}
+			}
+			else
+			{
+				tex.m_targetLevel = (frameIndex - tex.m_lastRequestFrame) < k_keepAliveFrames ? tex.m_residentLevel : tex.m_tailLevel;
+			}
+
+			tex.m_requestedResolution = 0.0f;
+			targetSize += getLevelsSize(tex, tex.m_targetLevel);
+
+			m_sortedTextures.push_back(static_cast<uint32_t>(i));
+		}
+
+		// least important textures first: those that were not requested recently and those drawn at low resolutions
+		eastl::sort(m_sortedTextures.begin(), m_sortedTextures.end(), [&](uint32_t lhs, uint32_t rhs)
+			{
+				const auto &l = m_textures[lhs];
+				const auto &r = m_textures[rhs];
+				return l.m_lastRequestFrame != r.m_lastRequestFrame ? l.m_lastRequestFrame < r.m_lastRequestFrame : l.m_resolution < r.m_resolution;
+			});
+
+		// fit into the budget by repeatedly dropping the highest target level of every texture, starting with the least important ones
+		bool trimmed = true;
+		while (targetSize > m_budget && trimmed)
+		{
+			trimmed = false;
+			for (uint32_t idx : m_sortedTextures)
+			{
+				auto &tex = m_textures[idx];
+				if (tex.m_targetLevel < tex.m_tailLevel && !tex.m_failed)
+				{
+					targetSize -= tex.m_mipChain.m_levelSizes[tex.m_targetLevel];
+					++tex.m_targetLevel;
+					trimmed = true;
+
+					if (targetSize <= m_budget)
+					{
+						break;
+					}
+				}
+			}
+		}
+
+		auto issueRequest = [&](uint32_t idx)
+		{
+			auto &tex = m_textures[idx];
+
+			Request *request = new Request();
+			request->m_streamer = this;
+			request->m_handle = static_cast<TextureHandle>(idx);
+			request->m_level = tex.m_targetLevel;
+			request->m_maxExtent = eastl::max(eastl::max(tex.m_mipChain.m_width >> tex.m_targetLevel, tex.m_mipChain.m_height >> tex.m_targetLevel), 1u);
+			request->m_path = tex.m_path;
+			request->m_image = nullptr;
+			request->m_view = nullptr;
+			request->m_success = false;
+
+			tex.m_pending = true;
+			++m_pendingRequestCount;
+
+			jobs.push_back(job::Job(streamJob, request));
+		};
+
+		// stream out first to make room for the textures that are streamed in
+		for (uint32_t idx : m_sortedTextures)
+		{
+			const auto &tex = m_textures[idx];
+			if (m_pendingRequestCount.load() < k_maxPendingRequests && !tex.m_pending && tex.m_targetLevel > tex.m_residentLevel)
+			{
+				issueRequest(idx);
+			}
+		}
+
+		// stream in the most important textures first
+		for (auto it = m_sortedTextures.rbegin(); it != m_sortedTextures.rend(); ++it)
+		{
+			const auto &tex = m_textures[*it];
+			if (m_pendingRequestCount.load() < k_maxPendingRequests && !tex.m_pending && tex.m_targetLevel < tex.m_residentLevel)
+			{
+				issueRequest(*it);
+			}
+		}
+	}
+
+	if (!jobs.empty())
+	{
+		job::run(jobs.size(), jobs.data(), nullptr, job::Priority::LOW);
+	}
+}
+
+void TextureStreamer::setBudget(uint64_t budget) noexcept
+{
+	LOCK_HOLDER(m_texturesMutex);
+	m_budget = budget;
+}
+
+uint64_t TextureStreamer::getBudget() const noexcept
+{
+	LOCK_HOLDER(m_texturesMutex);
+	return m_budget;
+}
+
+uint64_t TextureStreamer::getResidentSize() const noexcept
+{
+	LOCK_HOLDER(m_texturesMutex);
+	return m_residentSize;
+}
+
+void TextureStreamer::applyFinishedRequests(uint64_t frameIndex) noexcept
+{
+	for (Request *request : m_finishedRequests)
+	{
+		auto &tex = m_textures[request->m_handle];
+		tex.m_pending = false;
+
+		if (request->m_success)
+		{
+			m_residentSize -= getLevelsSize(tex, tex.m_residentLevel);
+			m_residentSize += getLevelsSize(tex, request->m_level);
+			tex.m_residentLevel = request->m_level;
+
+			// the previous Image is destroyed once the frames in flight no longer use it
+			m_textureManager->update(request->m_handle, request->m_image, request->m_view, frameIndex);
+		}
+		else
+		{
+			// keep the resident levels and stop streaming this texture
+			Log::warn("TextureStreamer: Failed to stream texture \"%s\"!", tex.m_path.c_str());
+			tex.m_failed = true;
+		}
+
+		if (tex.m_removed)
+		{
+			m_residentSize -= getLevelsSize(tex, tex.m_residentLevel);
+			tex = {};
+			m_textureManager->free(request->m_handle, frameIndex);
+		}
+
+		delete request;
+	}
+
+	m_finishedRequests.clear();
+}
+
+uint64_t TextureStreamer::getLevelsSize(const Texture &texture, uint32_t baseLevel) noexcept
+{
+	uint64_t size = 0;
+	for (uint32_t level = baseLevel; level < texture.m_mipChain.m_levels; ++level)
+	{
+		size += texture.m_mipChain.m_levelSizes[level];
+	}
+	return size;
+}
+
+void TextureStreamer::streamJob(void *param) noexcept
+{
+	Request *request = reinterpret_cast<Request *>(param);
+	TextureStreamer *streamer = request->m_streamer;
+
+	{
+		ScopedFileMapping fileMapping(VirtualFileSystem::get(), request->m_path.c_str());
+
+		if (fileMapping.isValid())
+		{
+			TextureLoader::MipChainInfo mipChain;
+			request->m_success = streamer->m_textureLoader->load(static_cast<size_t>(fileMapping.getSize()), fileMapping.getData(), request->m_path.c_str(), &request->m_image, &request->m_view, request->m_maxExtent, &mipChain);
+
+			// the file may have been replaced in the meantime
+			if (request->m_success)
+			{
+				request->m_level = mipChain.m_baseLevel;
+			}
+		}
+	}
+
+	{
+		LOCK_HOLDER(streamer->m_texturesMutex);
+		streamer->m_finishedRequests.push_back(request);
+	}
+
+	--streamer->m_pendingRequestCount;
+}
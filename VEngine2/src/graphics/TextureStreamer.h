@@ -0,0 +1,122 @@
+#pragma once
+#include <stdint.h>
+#include <EASTL/vector.h>
+#include <EASTL/string.h>
+#include <EASTL/atomic.h>
+#include "Handles.h"
+#include "TextureLoader.h"
+#include "utility/SpinLock.h"
+#include "utility/DeletedCopyMove.h"
+
+class TextureManager;
+
+/// <summary>
+/// Streams the mip levels of textures in and out of GPU memory depending on how large they appear on screen.
+/// Streamed textures are initially loaded with only their smallest mip levels (the mip tail). Visible draws report the
+/// resolution at which their textures are used and once per frame, update() derives the mip level each texture should
+/// have resident, shrinks these requests to fit into the memory budget and reloads the textures in background jobs.
+/// Finished textures replace the previous Image of their TextureHandle, so TextureViewHandles and materials stay valid.
+/// </summary>
+class TextureStreamer
+{
+public:
+	static constexpr uint64_t k_defaultBudget = 1024ull * 1024ull * 1024ull;
+
+	explicit TextureStreamer(TextureLoader *textureLoader, TextureManager *textureManager) noexcept;
+	DELETED_COPY_MOVE(TextureStreamer);
+	~TextureStreamer() noexcept;
+
+	/// <summary>
+	/// Loads the mip tail of a texture and registers it for streaming. flushUploadCopies() of the TextureLoader
+	/// needs to be called before the texture can be used. This function is internally synchronized.
+	/// </summary>
+	/// <param name="fileSize">The size in bytes of the texture file.</param>
+	/// <param name="fileData">The texture file data. Must be a DDS file.</param>
+	/// <param name="path">The virtual path of the texture file. Higher mip levels are loaded from this file.</param>
+	/// <returns>A valid TextureHandle or a null handle if the call failed.</returns>
+	TextureHandle loadTexture(size_t fileSize, const char *fileData, const char *path) noexcept;
+
+	/// <summary>
+	/// Stops streaming a texture. If a streaming request for the texture is still in flight, the texture is freed
+	/// once the request finished. This function is internally synchronized.
+	/// </summary>
+	/// <param name="handle">The TextureHandle to remove. May also refer to a texture that is not streamed.</param>
+	/// <returns>True if the caller needs to free the TextureHandle with the TextureManager.</returns>
+	bool removeTexture(TextureHandle handle) noexcept;
+
+	/// <summary>
+	/// Reports that the given textures are drawn with the given resolution in pixels during the current frame.
+	/// This function is internally synchronized.
+	/// </summary>
+	void requestResolution(size_t count, const TextureHandle *handles, float resolution) noexcept;
+
+	/// <summary>
+	/// Applies finished streaming requests, computes the mip levels to stream in or out based on the
+	/// resolutions requested since the last call and the memory budget and issues new streaming requests.
+	/// This should be called once per frame from the render thread.
+	/// </summary>
+	/// <param name="frameIndex">The index of the current frame.</param>
+	void update(uint64_t frameIndex) noexcept;
+
+	/// <summary>
+	/// Sets the amount of GPU memory in bytes that streamed textures may use. Mip tails are always resident,
+	/// so this budget may be exceeded if the mip tails alone do not fit.
+	/// </summary>
+	void setBudget(uint64_t budget) noexcept;
+	uint64_t getBudget() const noexcept;
+
+	/// <summary>
+	/// Gets the amount of GPU memory in bytes currently used by streamed textures.
+	/// </summary>
+	uint64_t getResidentSize() const noexcept;
+
+private:
+	// textures are streamed down to the first mip level that is at most this large
+	static constexpr uint32_t k_mipTailExtent = 64;
+	// textures that have not been requested for this many frames are streamed down to their mip tail
+	static constexpr uint64_t k_keepAliveFrames = 120;
+	static constexpr uint32_t k_maxPendingRequests = 8;
+
+	struct Texture
+	{
+		eastl::string m_path;
+		TextureLoader::MipChainInfo m_mipChain = {};
+		uint32_t m_tailLevel = 0;
+		uint32_t m_residentLevel = 0;
+		uint32_t m_targetLevel = 0;
+		float m_requestedResolution = 0.0f; // largest resolution requested since the last update()
+		float m_resolution = 0.0f; // resolution of the most recent request
+		uint64_t m_lastRequestFrame = 0;
+		bool m_registered = false;
+		bool m_pending = false; // a streaming request is in flight
+		bool m_removed = false; // removeTexture() was called while a request was in flight
+		bool m_failed = false;
+	};
+
+	struct Request
+	{
+		TextureStreamer *m_streamer;
+		TextureHandle m_handle;
+		uint32_t m_level;
+		uint32_t m_maxExtent;
+		eastl::string m_path;
+		gal::Image *m_image;
+		gal::ImageView *m_view;
+		bool m_success;
+	};
+
+	mutable SpinLock m_texturesMutex;
+	TextureLoader *m_textureLoader = nullptr;
+	TextureManager *m_textureManager = nullptr;
+	eastl::vector<Texture> m_textures;
+	eastl::vector<Request *> m_finishedRequests;
+	eastl::vector<uint32_t> m_sortedTextures;
+	eastl::atomic<uint32_t> m_pendingRequestCount = 0;
+	uint64_t m_budget = k_defaultBudget;
+	uint64_t m_residentSize = 0;
+	uint64_t m_frame = 0;
+
+	void applyFinishedRequests(uint64_t frameIndex) noexcept;
+	static uint64_t getLevelsSize(const Texture &texture, uint32_t baseLevel) noexcept;
+	static void streamJob(void *request) noexcept;
+};
\ No newline at end of file
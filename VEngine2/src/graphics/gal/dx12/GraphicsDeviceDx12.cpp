@@ -21,12 +21,12 @@ using namespace gal;
 
 gal::GraphicsDeviceDx12::GraphicsDeviceDx12(void *windowHandle, bool debugLayer)
 	:m_windowHandle(windowHandle),
-	m_gpuDescriptorAllocator(GPU_DESCRIPTOR_HEAP_SIZE, 1),
-	m_gpuSamplerDescriptorAllocator(GPU_SAMPLER_DESCRIPTOR_HEAP_SIZE, 1),
-	m_cpuDescriptorAllocator(CPU_DESCRIPTOR_HEAP_SIZE, 1),
-	m_cpuSamplerDescriptorAllocator(CPU_SAMPLER_DESCRIPTOR_HEAP_SIZE, 1),
-	m_cpuRTVDescriptorAllocator(CPU_RTV_DESCRIPTOR_HEAP_SIZE, 1),
-	m_cpuDSVDescriptorAllocator(CPU_DSV_DESCRIPTOR_HEAP_SIZE, 1),
+	m_gpuDescriptorAllocator(GPU_DESCRIPTOR_HEAP_SIZE, 1, "GPU Descriptor Allocator"),
+	m_gpuSamplerDescriptorAllocator(GPU_SAMPLER_DESCRIPTOR_HEAP_SIZE, 1, "GPU Sampler Descriptor Allocator"),
+	m_cpuDescriptorAllocator(CPU_DESCRIPTOR_HEAP_SIZE, 1, "CPU Descriptor Allocator"),
+	m_cpuSamplerDescriptorAllocator(CPU_SAMPLER_DESCRIPTOR_HEAP_SIZE, 1, "CPU Sampler Descriptor Allocator"),
+	m_cpuRTVDescriptorAllocator(CPU_RTV_DESCRIPTOR_HEAP_SIZE, 1, "CPU RTV Descriptor Allocator"),
+	m_cpuDSVDescriptorAllocator(CPU_DSV_DESCRIPTOR_HEAP_SIZE, 1, "CPU DSV Descriptor Allocator"),
 	m_graphicsPipelineMemoryPool(sizeof(GraphicsPipelineDx12), 64, "GraphicsPipelineDx12 Pool Allocator"),
 	m_computePipelineMemoryPool(sizeof(ComputePipelineDx12), 64, "ComputePipelineDx12 Pool Allocator"),
 	m_commandListPoolMemoryPool(sizeof(CommandListPoolDx12), 32, "CommandListPoolDx12 Pool Allocator"),
@@ -265,6 +265,14 @@ gal::GraphicsDeviceDx12::GraphicsDeviceDx12(void *windowHandle, bool debugLayer)
 		m_cmdListRecordContext.m_descriptorIncrementSizes[2] = m_descriptorIncrementSizes[2] = m_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
 		m_cmdListRecordContext.m_descriptorIncrementSizes[3] = m_descriptorIncrementSizes[3] = m_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
 
+		// the descriptor allocators manage descriptors, but report their usage in bytes
+		m_gpuDescriptorAllocator.setStatsUnitSize(m_descriptorIncrementSizes[0]);
+		m_gpuSamplerDescriptorAllocator.setStatsUnitSize(m_descriptorIncrementSizes[1]);
+		m_cpuDescriptorAllocator.setStatsUnitSize(m_descriptorIncrementSizes[0]);
+		m_cpuSamplerDescriptorAllocator.setStatsUnitSize(m_descriptorIncrementSizes[1]);
+		m_cpuRTVDescriptorAllocator.setStatsUnitSize(m_descriptorIncrementSizes[2]);
+		m_cpuDSVDescriptorAllocator.setStatsUnitSize(m_descriptorIncrementSizes[3]);
+
 		m_cmdListRecordContext.m_cpuDescriptorAllocator = &m_cpuDescriptorAllocator;
 		m_cmdListRecordContext.m_dsvDescriptorAllocator = &m_cpuDSVDescriptorAllocator;
 		m_cmdListRecordContext.m_gpuDescriptorAllocator = &m_gpuDescriptorAllocator;
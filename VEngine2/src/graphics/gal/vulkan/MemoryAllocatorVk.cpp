@@ -451,7 +451,7 @@ VkResult gal::MemoryAllocatorVk::MemoryPoolVk::alloc(VkDeviceSize size, VkDevice
 
 		m_blockSizes[blockIndex] = memoryAllocateInfo.allocationSize;
 		char *tlsfAllocatorMemory = m_allocatorMemory + blockIndex * sizeof(TLSFAllocator);
-		m_allocators[blockIndex] = new (tlsfAllocatorMemory) TLSFAllocator(static_cast<uint32_t>(memoryAllocateInfo.allocationSize), static_cast<uint32_t>(m_bufferImageGranularity));
+		m_allocators[blockIndex] = new (tlsfAllocatorMemory) TLSFAllocator(static_cast<uint32_t>(memoryAllocateInfo.allocationSize), static_cast<uint32_t>(m_bufferImageGranularity), "Vulkan Memory Block Allocator");
 
 		if (allocFromBlock(blockIndex, size, alignment, allocationInfo))
 		{
@@ -193,6 +193,21 @@ void Physics::update(float deltaTime) noexcept
 						}
 					}
 
+					// mesh assets may be creating physics meshes on other threads
+					PxConvexMesh *convexMesh = nullptr;
+					PxTriangleMesh *triangleMesh = nullptr;
+					{
+						LOCK_HOLDER(m_meshesMutex);
+						if (pc.m_physicsShapeType == PhysicsShapeType::CONVEX_MESH)
+						{
+							convexMesh = m_convexMeshes[pc.m_physicsMesh->getPhysicsConvexMeshhandle() - 1];
+						}
+						else if (pc.m_physicsShapeType == PhysicsShapeType::TRIANGLE_MESH)
+						{
+							triangleMesh = m_triangleMeshes[pc.m_physicsMesh->getPhysicsTriangleMeshhandle() - 1];
+						}
+					}
+
 					// fetch material
 					PxMaterial *mat = m_pxPhysics->createMaterial(0.5f, 0.5f, 0.5f); //m_materials[pc.m_materialHandle - 1];
 
@@ -221,10 +236,10 @@ void Physics::update(float deltaTime) noexcept
 							actor = PxCreatePlane(*m_pxPhysics, PxPlane(pc.m_planeNx, pc.m_planeNy, pc.m_planeNz, pc.m_planeDistance), *mat);
 							break;
 						case PhysicsShapeType::CONVEX_MESH:
-							actor = PxCreateStatic(*m_pxPhysics, pxTransform, PxConvexMeshGeometry(m_convexMeshes[pc.m_physicsMesh->getPhysicsConvexMeshhandle() - 1]), *mat);
+							actor = PxCreateStatic(*m_pxPhysics, pxTransform, PxConvexMeshGeometry(convexMesh), *mat);
 							break;
 						case PhysicsShapeType::TRIANGLE_MESH:
-							actor = PxCreateStatic(*m_pxPhysics, pxTransform, PxTriangleMeshGeometry(m_triangleMeshes[pc.m_physicsMesh->getPhysicsTriangleMeshhandle() - 1]), *mat);
+							actor = PxCreateStatic(*m_pxPhysics, pxTransform, PxTriangleMeshGeometry(triangleMesh), *mat);
 							break;
 						default:
 							assert(false);
@@ -240,7 +255,7 @@ void Physics::update(float deltaTime) noexcept
 							dynamic = PxCreateDynamic(*m_pxPhysics, pxTransform, PxSphereGeometry(pc.m_sphereRadius), *mat, pc.m_density);
 							break;
 						case PhysicsShapeType::CONVEX_MESH:
-							dynamic = PxCreateDynamic(*m_pxPhysics, pxTransform, PxConvexMeshGeometry(m_convexMeshes[pc.m_physicsMesh->getPhysicsConvexMeshhandle() - 1]), *mat, pc.m_density);
+							dynamic = PxCreateDynamic(*m_pxPhysics, pxTransform, PxConvexMeshGeometry(convexMesh), *mat, pc.m_density);
 							break;
 						default:
 							assert(false);
@@ -484,11 +499,10 @@ PhysicsConvexMeshHandle Physics::createConvexMesh(uint32_t size, const char *dat
 {
 	PhysicsConvexMeshHandle handle{};
 
-	// LOCK_HOLDER(m_materialsMutex);
+	LOCK_HOLDER(m_meshesMutex);
 
 	// allocate handle
 	{
-		// LOCK_HOLDER(m_handleManagerMutex);
 		handle = (PhysicsConvexMeshHandle)m_convexMeshHandleManager.allocate();
 	}
 
@@ -500,7 +514,6 @@ PhysicsConvexMeshHandle Physics::createConvexMesh(uint32_t size, const char *dat
 
 	// create and store convex mesh
 	{
-		///LOCK_HOLDER(m_materialsMutex);
 		if (handle > m_convexMeshes.size())
 		{
 			m_convexMeshes.resize((size_t)(m_convexMeshes.size() * 1.5));
@@ -518,7 +531,7 @@ PhysicsConvexMeshHandle Physics::createConvexMesh(uint32_t size, const char *dat
 
 void Physics::destroyConvexMesh(PhysicsConvexMeshHandle handle) noexcept
 {
-	// LOCK_HOLDER(m_materialsMutex);
+	LOCK_HOLDER(m_meshesMutex);
 	{
 		const bool validHandle = handle != 0 && handle <= m_convexMeshes.size();
 
@@ -530,7 +543,6 @@ void Physics::destroyConvexMesh(PhysicsConvexMeshHandle handle) noexcept
 		PX_RELEASE(m_convexMeshes[handle - 1]);
 
 		{
-			//LOCK_HOLDER(m_handleManagerMutex);
 			m_convexMeshHandleManager.free(handle);
 		}
 	}
@@ -540,11 +552,10 @@ PhysicsTriangleMeshHandle Physics::createTriangleMesh(uint32_t size, const char
 {
 	PhysicsTriangleMeshHandle handle{};
 
-	// LOCK_HOLDER(m_materialsMutex);
+	LOCK_HOLDER(m_meshesMutex);
 
 	// allocate handle
 	{
-		// LOCK_HOLDER(m_handleManagerMutex);
 		handle = (PhysicsTriangleMeshHandle)m_triangleMeshHandleManager.allocate();
 	}
 
@@ -556,7 +567,6 @@ PhysicsTriangleMeshHandle Physics::createTriangleMesh(uint32_t size, const char
 
 	// create and store convex mesh
 	{
-		///LOCK_HOLDER(m_materialsMutex);
 		if (handle > m_triangleMeshes.size())
 		{
 			m_triangleMeshes.resize((size_t)(m_triangleMeshes.size() * 1.5));
@@ -574,7 +584,7 @@ PhysicsTriangleMeshHandle Physics::createTriangleMesh(uint32_t size, const char
 
 void Physics::destroyTriangleMesh(PhysicsTriangleMeshHandle handle) noexcept
 {
-	// LOCK_HOLDER(m_materialsMutex);
+	LOCK_HOLDER(m_meshesMutex);
 	{
 		const bool validHandle = handle != 0 && handle <= m_triangleMeshes.size();
 
@@ -586,7 +596,6 @@ void Physics::destroyTriangleMesh(PhysicsTriangleMeshHandle handle) noexcept
 		PX_RELEASE(m_triangleMeshes[handle - 1]);
 
 		{
-			//LOCK_HOLDER(m_handleManagerMutex);
 			m_triangleMeshHandleManager.free(handle);
 		}
 	}
@@ -1,6 +1,7 @@
 #pragma once
 #include "Handles.h"
 #include "utility/HandleManager.h"
+#include "utility/SpinLock.h"
 #include "ecs/ECSCommon.h"
 
 class ECS;
@@ -67,5 +68,6 @@ private:
 	eastl::vector<physx::PxMaterial *> m_materials;
 	eastl::vector<physx::PxConvexMesh *> m_convexMeshes;
 	eastl::vector<physx::PxTriangleMesh *> m_triangleMeshes;
+	mutable SpinLock m_meshesMutex; // meshes are created and destroyed by asset loading jobs
 	float m_timeAccumulator = 0.0f;
 };
\ No newline at end of file
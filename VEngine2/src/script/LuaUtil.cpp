@@ -1,6 +1,61 @@
 #include "LuaUtil.h"
 #include "lua-5.4.3/lua.hpp"
 #include <assert.h>
+#include <string.h>
+#include "utility/allocator/TLSFHeapAllocator.h"
+#include "Log.h"
+
+static TLSFHeapAllocator *getLuaHeap() noexcept
+{
+	// lua states are created and used from multiple threads. intentionally never destroyed, so that states can still be
+	// closed during static destruction
+	alignas(TLSFHeapAllocator) static char s_memory[sizeof(TLSFHeapAllocator)];
+	static TLSFHeapAllocator *s_heap = PLACEMENT_NEW(s_memory) TLSFHeapAllocator(8 * 1024 * 1024, true, true, "Lua Heap");
+	return s_heap;
+}
+
+static void *luaAlloc(void *ud, void *ptr, size_t osize, size_t nsize) noexcept
+{
+	TLSFHeapAllocator *heap = reinterpret_cast<TLSFHeapAllocator *>(ud);
+
+	if (nsize == 0)
+	{
+		heap->deallocate(ptr, osize);
+		return nullptr;
+	}
+
+	// if ptr is null, osize encodes the type of object being allocated
+	if (ptr && heap->getAllocationSize(ptr) >= nsize)
+	{
+		return ptr;
+	}
+
+	void *newPtr = heap->allocate(nsize);
+	if (newPtr && ptr)
+	{
+		memcpy(newPtr, ptr, osize < nsize ? osize : nsize);
+		heap->deallocate(ptr, osize);
+	}
+
+	return newPtr;
+}
+
+static int luaPanic(lua_State *L) noexcept
+{
+	const char *msg = lua_tostring(L, -1);
+	Log::err("Unprotected error in call to Lua API: %s", msg ? msg : "error object is not a string");
+	return 0; // return to Lua to abort
+}
+
+lua_State *LuaUtil::newState() noexcept
+{
+	lua_State *L = lua_newstate(luaAlloc, getLuaHeap());
+	if (L)
+	{
+		lua_atpanic(L, luaPanic);
+	}
+	return L;
+}
 
 void LuaUtil::stackDump(lua_State *L) noexcept
 {
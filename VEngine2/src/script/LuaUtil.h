@@ -32,6 +32,12 @@ namespace LuaUtil
 		static LuaValue makeLightUserDataValue(void *value) noexcept;
 	};
 
+	/// <summary>
+	/// Creates a new lua state. Unlike luaL_newstate(), all memory of the state is allocated from a shared TLSF heap.
+	/// </summary>
+	/// <returns>The new lua state or nullptr if it could not be created.</returns>
+	lua_State *newState() noexcept;
+
 	void stackDump(lua_State *L) noexcept;
 
 	lua_Number getTableNumberField(lua_State *L, const char *key) noexcept;
@@ -51,7 +51,7 @@ void ScriptSystem::update(float deltaTime) noexcept
 				// initialize lua state
 				if (!L)
 				{
-					L = luaL_newstate();
+					L = LuaUtil::newState();
 					luaL_openlibs(L);
 					ECSLua::open(L);
 
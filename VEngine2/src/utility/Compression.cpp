@@ -0,0 +1,250 @@
+#include "Compression.h"
+#include <stdint.h>
+#include <string.h>
+
+namespace
+{
+	constexpr size_t k_minMatchLength = 4;
+	constexpr size_t k_lastLiteralCount = 5; // the last bytes of a block are always literals
+	constexpr size_t k_matchSearchLimit = 12; // no match may start within this many bytes of the end of the block
+	constexpr size_t k_maxOffset = 65535;
+	constexpr uint32_t k_hashLog2 = 12;
+
+	uint32_t read32(const uint8_t *ptr) noexcept
+	{
+		uint32_t value;
+		memcpy(&value, ptr, sizeof(value));
+		return value;
+	}
+
+	uint32_t hashSequence(uint32_t sequence) noexcept
+	{
+		return (sequence * 2654435761u) >> (32 - k_hashLog2);
+	}
+
+	// writes the 15+ part of a literal or match length. returns nullptr if dst ran out of space
+	uint8_t *writeLengthExtension(size_t length, uint8_t *dst, const uint8_t *dstEnd) noexcept
+	{
+		for (; length >= 255; length -= 255)
+		{
+			if (dst >= dstEnd)
+			{
+				return nullptr;
+			}
+			*dst++ = 255;
+		}
+
+		if (dst >= dstEnd)
+		{
+			return nullptr;
+		}
+		*dst++ = static_cast<uint8_t>(length);
+
+		return dst;
+	}
+
+	// reads the 15+ part of a literal or match length. returns false if src ran out of data
+	bool readLengthExtension(const uint8_t *&src, const uint8_t *srcEnd, size_t &length) noexcept
+	{
+		uint8_t value = 0;
+		do
+		{
+			if (src >= srcEnd)
+			{
+				return false;
+			}
+			value = *src++;
+			length += value;
+		} while (value == 255);
+
+		return true;
+	}
+
+	// writes a sequence of literals followed by a match. matchLength is 0 for the last sequence, which has no match
+	uint8_t *writeSequence(const uint8_t *literals, size_t literalCount, size_t offset, size_t matchLength, uint8_t *dst, const uint8_t *dstEnd) noexcept
+	{
+		if (dst >= dstEnd)
+		{
+			return nullptr;
+		}
+
+		uint8_t *token = dst++;
+		*token = static_cast<uint8_t>((literalCount < 15 ? literalCount : 15) << 4);
+
+		if (literalCount >= 15 && !(dst = writeLengthExtension(literalCount - 15, dst, dstEnd)))
+		{
+			return nullptr;
+		}
+
+		if (static_cast<size_t>(dstEnd - dst) < literalCount)
+		{
+			return nullptr;
+		}
+		memcpy(dst, literals, literalCount);
+		dst += literalCount;
+
+		if (matchLength == 0)
+		{
+			return dst;
+		}
+
+		if (dstEnd - dst < 2)
+		{
+			return nullptr;
+		}
+		*dst++ = static_cast<uint8_t>(offset & 0xFF);
+		*dst++ = static_cast<uint8_t>(offset >> 8);
+
+		const size_t matchLengthCode = matchLength - k_minMatchLength;
+		*token |= static_cast<uint8_t>(matchLengthCode < 15 ? matchLengthCode : 15);
+
+		if (matchLengthCode >= 15 && !(dst = writeLengthExtension(matchLengthCode - 15, dst, dstEnd)))
+		{
+			return nullptr;
+		}
+
+		return dst;
+	}
+}
+
+size_t Compression::getMaxCompressedSize(size_t srcSize) noexcept
+{
+	return srcSize + srcSize / 255 + 16;
+}
+
+size_t Compression::compress(size_t srcSize, const void *src, size_t dstCapacity, void *dst) noexcept
+{
+	const uint8_t *srcBegin = static_cast<const uint8_t *>(src);
+	const uint8_t *srcEnd = srcBegin + srcSize;
+	uint8_t *dstBegin = static_cast<uint8_t *>(dst);
+	uint8_t *dstEnd = dstBegin + dstCapacity;
+	uint8_t *dstPtr = dstBegin;
+
+	const uint8_t *anchor = srcBegin;
+
+	if (srcSize > k_matchSearchLimit)
+	{
+		// positions of the last occurrence of each hashed 4 byte sequence
+		uint32_t hashTable[1u << k_hashLog2] = {};
+
+		const uint8_t *matchSearchEnd = srcEnd - k_matchSearchLimit;
+		const uint8_t *matchEnd = srcEnd - k_lastLiteralCount;
+		const uint8_t *ptr = srcBegin;
+
+		while (ptr < matchSearchEnd)
+		{
+			const uint32_t sequence = read32(ptr);
+			const uint32_t hash = hashSequence(sequence);
+			const uint8_t *candidate = srcBegin + hashTable[hash];
+			hashTable[hash] = static_cast<uint32_t>(ptr - srcBegin);
+
+			const size_t offset = static_cast<size_t>(ptr - candidate);
+			if (offset == 0 || offset > k_maxOffset || read32(candidate) != sequence)
+			{
+				++ptr;
+				continue;
+			}
+
+			size_t matchLength = k_minMatchLength;
+			while (ptr + matchLength < matchEnd && ptr[matchLength] == candidate[matchLength])
+			{
+				++matchLength;
+			}
+
+			dstPtr = writeSequence(anchor, static_cast<size_t>(ptr - anchor), offset, matchLength, dstPtr, dstEnd);
+			if (!dstPtr)
+			{
+				return 0;
+			}
+
+			ptr += matchLength;
+			anchor = ptr;
+		}
+	}
+
+	dstPtr = writeSequence(anchor, static_cast<size_t>(srcEnd - anchor), 0, 0, dstPtr, dstEnd);
+
+	return dstPtr ? static_cast<size_t>(dstPtr - dstBegin) : 0;
+}
+
+bool Compression::decompress(size_t srcSize, const void *src, size_t dstSize, void *dst) noexcept
+{
+	const uint8_t *srcPtr = static_cast<const uint8_t *>(src);
+	const uint8_t *srcEnd = srcPtr + srcSize;
+	uint8_t *dstBegin = static_cast<uint8_t *>(dst);
+	uint8_t *dstPtr = dstBegin;
+	uint8_t *dstEnd = dstBegin + dstSize;
+
+	while (true)
+	{
+		if (srcPtr >= srcEnd)
+		{
+			return false;
+		}
+
+		const uint8_t token = *srcPtr++;
+
+		// literals
+		size_t literalCount = token >> 4;
+		if (literalCount == 15 && !readLengthExtension(srcPtr, srcEnd, literalCount))
+		{
+			return false;
+		}
+
+		if (static_cast<size_t>(srcEnd - srcPtr) < literalCount || static_cast<size_t>(dstEnd - dstPtr) < literalCount)
+		{
+			return false;
+		}
+		memcpy(dstPtr, srcPtr, literalCount);
+		srcPtr += literalCount;
+		dstPtr += literalCount;
+
+		// the last sequence only consists of literals
+		if (srcPtr == srcEnd)
+		{
+			break;
+		}
+
+		// match
+		if (srcEnd - srcPtr < 2)
+		{
+			return false;
+		}
+		const size_t offset = static_cast<size_t>(srcPtr[0]) | (static_cast<size_t>(srcPtr[1]) << 8);
+		srcPtr += 2;
+
+		if (offset == 0 || offset > static_cast<size_t>(dstPtr - dstBegin))
+		{
+			return false;
+		}
+
+		size_t matchLength = token & 15;
+		if (matchLength == 15 && !readLengthExtension(srcPtr, srcEnd, matchLength))
+		{
+			return false;
+		}
+		matchLength += k_minMatchLength;
+
+		if (static_cast<size_t>(dstEnd - dstPtr) < matchLength)
+		{
+			return false;
+		}
+
+		const uint8_t *matchPtr = dstPtr - offset;
+		if (offset >= matchLength)
+		{
+			memcpy(dstPtr, matchPtr, matchLength);
+			dstPtr += matchLength;
+		}
+		else
+		{
+			// overlapping match repeats the last offset bytes
+			for (size_t i = 0; i < matchLength; ++i)
+			{
+				*dstPtr++ = *matchPtr++;
+			}
+		}
+	}
+
+	return dstPtr == dstEnd;
+}
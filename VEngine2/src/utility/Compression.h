@@ -0,0 +1,35 @@
+#pragma once
+#include <stddef.h>
+
+/// <summary>
+/// Fast LZ77 style block compression. The compressed data follows the LZ4 block format, so it can also be
+/// inspected and decompressed with external LZ4 tools. Blocks are independent and carry no header, so the
+/// caller has to store the compressed and uncompressed sizes.
+/// </summary>
+namespace Compression
+{
+	/// <summary>
+	/// Returns the size of the destination buffer that is required to compress srcSize bytes in the worst case.
+	/// </summary>
+	size_t getMaxCompressedSize(size_t srcSize) noexcept;
+
+	/// <summary>
+	/// Compresses a block of data.
+	/// </summary>
+	/// <param name="srcSize">The size of the source data in bytes.</param>
+	/// <param name="src">The data to compress.</param>
+	/// <param name="dstCapacity">The size of the destination buffer in bytes.</param>
+	/// <param name="dst">The destination buffer.</param>
+	/// <returns>The size of the compressed data or 0 if it did not fit into the destination buffer.</returns>
+	size_t compress(size_t srcSize, const void *src, size_t dstCapacity, void *dst) noexcept;
+
+	/// <summary>
+	/// Decompresses a block of data that was compressed with compress().
+	/// </summary>
+	/// <param name="srcSize">The size of the compressed data in bytes.</param>
+	/// <param name="src">The compressed data.</param>
+	/// <param name="dstSize">The exact size of the uncompressed data in bytes.</param>
+	/// <param name="dst">The destination buffer.</param>
+	/// <returns>False if the compressed data is malformed or does not decompress to exactly dstSize bytes.</returns>
+	bool decompress(size_t srcSize, const void *src, size_t dstSize, void *dst) noexcept;
+}
@@ -8,46 +8,42 @@ bool SerializationWriteStream::serialize(bool value) noexcept
 
 bool SerializationWriteStream::serialize(int32_t value) noexcept
 {
-	char bytes[4];
-	memcpy(bytes, &value, 4);
-	m_data.push_back(bytes[0]);
-	m_data.push_back(bytes[1]);
-	m_data.push_back(bytes[2]);
-	m_data.push_back(bytes[3]);
+	write(&value, 4);
 	return true;
 }
 
 bool SerializationWriteStream::serialize(uint32_t value) noexcept
 {
-	char bytes[4];
-	memcpy(bytes, &value, 4);
-	m_data.push_back(bytes[0]);
-	m_data.push_back(bytes[1]);
-	m_data.push_back(bytes[2]);
-	m_data.push_back(bytes[3]);
+	write(&value, 4);
 	return true;
 }
 
 bool SerializationWriteStream::serialize(float value) noexcept
 {
-	char bytes[4];
-	memcpy(bytes, &value, 4);
-	m_data.push_back(bytes[0]);
-	m_data.push_back(bytes[1]);
-	m_data.push_back(bytes[2]);
-	m_data.push_back(bytes[3]);
+	write(&value, 4);
 	return true;
 }
 
 bool SerializationWriteStream::serialize(size_t length, const char *value) noexcept
 {
-	for (size_t i = 0; i < length; ++i)
-	{
-		m_data.push_back(value[i]);
-	}
+	write(value, length);
 	return true;
 }
 
+bool SerializationWriteStream::serializeView(size_t length, const char *value) noexcept
+{
+	write(value, length);
+	return true;
+}
+
+void SerializationWriteStream::write(const void *data, size_t size) noexcept
+{
+	// resize grows the capacity geometrically, so appending stays amortized constant per byte
+	const size_t offset = m_data.size();
+	m_data.resize(offset + size);
+	memcpy(m_data.data() + offset, data, size);
+}
+
 bool SerializationReadStream::serialize(bool &value) noexcept
 {
 	if ((m_readOffset + 1) > m_bufferSize)
@@ -94,7 +90,7 @@ bool SerializationReadStream::serialize(float &value) noexcept
 
 bool SerializationReadStream::serialize(size_t length, char *value) noexcept
 {
-	if ((m_readOffset + length) > m_bufferSize)
+	if (length > (m_bufferSize - m_readOffset))
 	{
 		return false;
 	}
@@ -102,3 +98,14 @@ bool SerializationReadStream::serialize(size_t length, char *value) noexcept
 	m_readOffset += length;
 	return true;
 }
+
+bool SerializationReadStream::serializeView(size_t length, const char *&value) noexcept
+{
+	if (length > (m_bufferSize - m_readOffset))
+	{
+		return false;
+	}
+	value = m_data + m_readOffset;
+	m_readOffset += length;
+	return true;
+}
@@ -1,6 +1,8 @@
 #pragma once
 #include <stdint.h>
+#include <string.h>
 #include <EASTL/vector.h>
+#include <EASTL/type_traits.h>
 
 class SerializationWriteStream
 {
@@ -8,16 +10,32 @@ public:
 	static constexpr bool isWriting() noexcept { return true; }
 	static constexpr bool isReading() noexcept { return false; }
 
+	// sizeHint is the expected size of the serialized data. reserving it up front avoids growing the buffer while serializing.
+	explicit SerializationWriteStream(size_t sizeHint = 0) noexcept { m_data.reserve(sizeHint); }
+
 	const eastl::vector<char> &getData() const noexcept { return m_data; }
+	void reserve(size_t size) noexcept { m_data.reserve(size); }
 
 	bool serialize(bool value) noexcept;
 	bool serialize(int32_t value) noexcept;
 	bool serialize(uint32_t value) noexcept;
 	bool serialize(float value) noexcept;
 	bool serialize(size_t length, const char *value) noexcept;
+	bool serializeView(size_t length, const char *value) noexcept;
+
+	// writes count contiguous values with a single copy
+	template<typename T>
+	bool serialize(size_t count, const T *values) noexcept
+	{
+		static_assert(eastl::is_trivially_copyable_v<T>);
+		write(values, count * sizeof(T));
+		return true;
+	}
 
 private:
 	eastl::vector<char> m_data;
+
+	void write(const void *data, size_t size) noexcept;
 };
 
 class SerializationReadStream
@@ -33,6 +51,24 @@ public:
 	bool serialize(uint32_t &value) noexcept;
 	bool serialize(float &value) noexcept;
 	bool serialize(size_t length, char *value) noexcept;
+	// points value into the source buffer instead of copying. the buffer needs to outlive the pointer and the data is not aligned.
+	bool serializeView(size_t length, const char *&value) noexcept;
+
+	// reads count contiguous values with a single copy
+	template<typename T>
+	bool serialize(size_t count, T *values) noexcept
+	{
+		static_assert(eastl::is_trivially_copyable_v<T>);
+		if (count > (m_bufferSize - m_readOffset) / sizeof(T))
+		{
+			return false;
+		}
+		memcpy(values, m_data + m_readOffset, count * sizeof(T));
+		m_readOffset += count * sizeof(T);
+		return true;
+	}
+
+	size_t getReadOffset() const noexcept { return m_readOffset; }
 
 private:
 	const char *m_data = nullptr;
@@ -85,6 +121,26 @@ private:
 		}																						\
 	} while (false)
 
+// serializes count trivially copyable values, like a float[3], in one go
+#define serializeArray(stream, count, values)													\
+	do																							\
+	{																							\
+		if (!stream.serialize(count, values))													\
+		{																						\
+			return false;																		\
+		}																						\
+	} while (false)
+
+// like serializeBytes, but reading sets the const char pointer value to the data in the source buffer
+#define serializeBytesView(stream, length, value)												\
+	do																							\
+	{																							\
+		if (!stream.serializeView(length, value))												\
+		{																						\
+			return false;																		\
+		}																						\
+	} while (false)
+
 #define serializeAsset(stream, asset, AssetDataType)											\
 	do																							\
 	{																							\
@@ -103,8 +159,12 @@ private:
 			serializeUInt32(stream, strLen);													\
 			if (strLen > 0)																		\
 			{																					\
-				char *str = (char *)ALLOC_A(strLen);											\
-				serializeBytes(stream, strLen, str);											\
+				const char *str = nullptr;														\
+				serializeBytesView(stream, strLen, str);										\
+				if (str[strLen - 1] != '\0')														\
+				{																				\
+					return false;																\
+				}																				\
 				asset = AssetManager::get()->getAsset<AssetDataType>(AssetID(str));				\
 			}																					\
 		}																						\
@@ -1,31 +1,184 @@
 #include "StringID.h"
-#include <EASTL/hash_map.h>
 #include "SpinLock.h"
+#include <EASTL/atomic.h>
 #include <assert.h>
+#include <stdlib.h>
+#include <string.h>
 
-static eastl::hash_map<uint64_t, const char *> s_stringPool;
-static SpinLock s_stringPoolMutex;
+namespace
+{
+	// open addressing table with linear probing. lookups do not take any locks: a slot is published by storing its string
+	// after its hash, so a reader that sees the string also sees the hash. slots are never removed.
+	struct Table
+	{
+		struct Slot
+		{
+			eastl::atomic<uint64_t> m_hash;
+			eastl::atomic<const char *> m_string;
+		};
+
+		uint32_t m_capacity; // power of two
+		Slot *m_slots;
+		Table *m_prevTable; // readers may still probe a replaced table, so those are never freed
+	};
+
+	// interned strings are never freed, so they are bump allocated from blocks
+	struct Arena
+	{
+		static constexpr size_t k_blockSize = 64 * 1024;
+		static constexpr size_t k_maxArenaStringSize = k_blockSize / 4; // larger strings get their own allocation
+
+		char *m_cur = nullptr;
+		char *m_end = nullptr;
+	};
+
+	// inserts only lock their shard, so threads interning different strings rarely contend
+	struct Shard
+	{
+		SpinLock m_mutex;
+		eastl::atomic<Table *> m_table = nullptr;
+		uint32_t m_size = 0; // guarded by m_mutex
+		Arena m_arena = {}; // guarded by m_mutex
+	};
+}
+
+static constexpr size_t k_shardCountLog2 = 6;
+static constexpr size_t k_shardCount = 1ull << k_shardCountLog2;
+static constexpr uint32_t k_initialTableCapacity = 256;
+
+static Shard &getShard(uint64_t hash) noexcept
+{
+	// function local, so StringIDs can be created during static initialization
+	static Shard s_shards[k_shardCount];
+
+	// the low bits select the slot within the table of the shard
+	return s_shards[hash >> (64 - k_shardCountLog2)];
+}
+
+// string may be null to look up the string of a hash
+static const char *find(const Table *table, const char *string, uint64_t hash) noexcept
+{
+	if (!table)
+	{
+		return nullptr;
+	}
+
+	const uint32_t mask = table->m_capacity - 1;
+	for (uint32_t i = static_cast<uint32_t>(hash) & mask; ; i = (i + 1) & mask)
+	{
+		const auto &slot = table->m_slots[i];
+		const char *pooledStr = slot.m_string.load(eastl::memory_order_acquire);
+
+		if (!pooledStr)
+		{
+			return nullptr;
+		}
+
+		if (slot.m_hash.load(eastl::memory_order_relaxed) == hash)
+		{
+			// different strings with the same hash are not supported
+			assert(!string || strcmp(pooledStr, string) == 0);
+			return pooledStr;
+		}
+	}
+}
+
+static void insert(Table *table, const char *pooledStr, uint64_t hash) noexcept
+{
+	const uint32_t mask = table->m_capacity - 1;
+	uint32_t i = static_cast<uint32_t>(hash) & mask;
+	while (table->m_slots[i].m_string.load(eastl::memory_order_relaxed))
+	{
+		i = (i + 1) & mask;
+	}
+
+	table->m_slots[i].m_hash.store(hash, eastl::memory_order_relaxed);
+	table->m_slots[i].m_string.store(pooledStr, eastl::memory_order_release);
+}
+
+static Table *createTable(uint32_t capacity, Table *prevTable) noexcept
+{
+	Table *table = new Table();
+	table->m_capacity = capacity;
+	table->m_slots = new Table::Slot[capacity];
+	table->m_prevTable = prevTable;
+
+	for (uint32_t i = 0; i < capacity; ++i)
+	{
+		table->m_slots[i].m_hash.store(0, eastl::memory_order_relaxed);
+		table->m_slots[i].m_string.store(nullptr, eastl::memory_order_relaxed);
+	}
+
+	// copy the entries of the previous table
+	if (prevTable)
+	{
+		for (uint32_t i = 0; i < prevTable->m_capacity; ++i)
+		{
+			const auto &slot = prevTable->m_slots[i];
+			if (const char *pooledStr = slot.m_string.load(eastl::memory_order_relaxed))
+			{
+				insert(table, pooledStr, slot.m_hash.load(eastl::memory_order_relaxed));
+			}
+		}
+	}
+
+	return table;
+}
+
+static char *allocateString(Arena &arena, size_t size) noexcept
+{
+	if (size > Arena::k_maxArenaStringSize)
+	{
+		return static_cast<char *>(malloc(size));
+	}
+
+	// the rest of the current block is wasted
+	if (static_cast<size_t>(arena.m_end - arena.m_cur) < size)
+	{
+		arena.m_cur = static_cast<char *>(malloc(Arena::k_blockSize));
+		arena.m_end = arena.m_cur + Arena::k_blockSize;
+	}
+
+	char *result = arena.m_cur;
+	arena.m_cur += size;
+	return result;
+}
 
 static const char *getFromPool(const char *string, uint64_t hash) noexcept
 {
-	const char **pooledStr = nullptr;
+	Shard &shard = getShard(hash);
+
+	// fast path for strings that are already interned
+	if (const char *pooledStr = find(shard.m_table.load(eastl::memory_order_acquire), string, hash))
 	{
-		LOCK_HOLDER(s_stringPoolMutex);
-		pooledStr = &s_stringPool[hash];
+		return pooledStr;
 	}
 
-	// string did not exist before -> allocate memory and store in pool
-	if (!(*pooledStr))
+	LOCK_HOLDER(shard.m_mutex);
+
+	// another thread may have inserted the string in the meantime
+	Table *table = shard.m_table.load(eastl::memory_order_relaxed);
+	if (const char *pooledStr = find(table, string, hash))
 	{
-		*pooledStr = _strdup(string);
+		return pooledStr;
 	}
-	else
+
+	// keep the load factor below 0.5 so probe sequences stay short
+	if (!table || (shard.m_size + 1) * 2 > table->m_capacity)
 	{
-		// we found a hash collision!
-		assert(strcmp(*pooledStr, string) == 0);
+		table = createTable(table ? table->m_capacity * 2 : k_initialTableCapacity, table);
+		shard.m_table.store(table, eastl::memory_order_release);
 	}
 
-	return *pooledStr;
+	// string did not exist before -> allocate memory and store in pool
+	const size_t size = strlen(string) + 1;
+	char *pooledStr = allocateString(shard.m_arena, size);
+	memcpy(pooledStr, string, size);
+
+	insert(table, pooledStr, hash);
+	++shard.m_size;
+
+	return pooledStr;
 }
 
 StringID::StringID(const char *string) noexcept
@@ -39,3 +192,40 @@ StringID::StringID(const char *string, uint64_t hash) noexcept
 {
 	m_string = getFromPool(string, m_hash);
 }
+
+bool StringID::tryGet(const char *string, StringID *stringID) noexcept
+{
+	const uint64_t hash = stringHashFNV1a(string);
+	const char *pooledStr = find(getShard(hash).m_table.load(eastl::memory_order_acquire), string, hash);
+
+	if (pooledStr)
+	{
+		stringID->m_hash = hash;
+		stringID->m_string = pooledStr;
+	}
+
+	return pooledStr != nullptr;
+}
+
+StringID StringID::hashOnly(const char *string) noexcept
+{
+	StringID result;
+	result.m_hash = stringHashFNV1a(string);
+
+#ifdef _DEBUG
+	getFromPool(string, result.m_hash);
+#endif // _DEBUG
+
+	return result;
+}
+
+const char *StringID::getDebugName(const StringID &sid) noexcept
+{
+	if (sid.m_string)
+	{
+		return sid.m_string;
+	}
+
+	const char *pooledStr = find(getShard(sid.m_hash).m_table.load(eastl::memory_order_acquire), nullptr, sid.m_hash);
+	return pooledStr ? pooledStr : "<unknown>";
+}
\ No newline at end of file
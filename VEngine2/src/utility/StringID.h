@@ -1,17 +1,37 @@
 #pragma once
 #include <stdint.h>
 
-#define SID(str) StringID(str, str##_hash)
+// creates a StringID from a string literal at compile time
+#define SID(str) StringID::fromLiteral(str, str##_hash)
 
 struct StringID
 {
 	uint64_t m_hash = 0;
-	const char *m_string = nullptr;
+	const char *m_string = nullptr; // null for StringIDs created with hashOnly()
 
 	explicit StringID() noexcept = default;
 	explicit StringID(const char *string) noexcept;
 	explicit StringID(const char *string, uint64_t hash) noexcept;
 
+	// points to the literal instead of a pooled copy, so this never accesses the pool. use the SID() macro.
+	static constexpr StringID fromLiteral(const char *literal, uint64_t hash) noexcept
+	{
+		StringID result;
+		result.m_hash = hash;
+		result.m_string = literal;
+		return result;
+	}
+
+	// creates a StringID without a string for looking up names that are only known at runtime, like parameter names passed in
+	// from scripts. the string is only added to the pool in debug builds, so getDebugName() can find it.
+	static StringID hashOnly(const char *string) noexcept;
+
+	// gets the StringID of an already interned string without adding it to the pool. this never takes a lock.
+	static bool tryGet(const char *string, StringID *stringID) noexcept;
+
+	// gets the string of a StringID, which is looked up in the pool for StringIDs created with hashOnly()
+	static const char *getDebugName(const StringID &sid) noexcept;
+
 	bool operator==(const StringID &sid) const noexcept
 	{
 		return m_hash == sid.m_hash;
@@ -27,7 +47,8 @@ struct StringIDHash
 { 
 	size_t operator()(const StringID &value) const noexcept
 	{
-		return (size_t)value.m_string;
+		// literals and hash-only StringIDs do not point to the pooled string
+		return (size_t)value.m_hash;
 	}
 };
 
@@ -3,7 +3,7 @@
 #include <cassert>
 #include "Utility.h"
 
-TLSFAllocator::TLSFAllocator(uint32_t memorySize, uint32_t pageSize)
+TLSFAllocator::TLSFAllocator(uint32_t memorySize, uint32_t pageSize, const char *name)
 	:m_memorySize(memorySize),
 	m_pageSize(pageSize),
 	m_firstLevelBitset(),
@@ -13,7 +13,9 @@ TLSFAllocator::TLSFAllocator(uint32_t memorySize, uint32_t pageSize)
 	m_freeSize(memorySize),
 	m_usedSize(),
 	m_requiredDebugSpanCount(1),
-	m_spanPool(256)
+	m_statsUnitSize(1),
+	m_spanPool(256),
+	m_stats(name)
 {
 	memset(m_secondLevelBitsets, 0, sizeof(m_secondLevelBitsets));
 	memset(m_freeSpans, 0, sizeof(m_freeSpans));
@@ -154,6 +156,7 @@ bool TLSFAllocator::alloc(uint32_t size, uint32_t alignment, uint32_t &spanOffse
 
 	m_freeSize -= freeSpan->m_size;
 	m_usedSize += freeSpan->m_usedSize;
+	m_stats.onAllocate(size_t(freeSpan->m_usedSize) * m_statsUnitSize);
 	m_requiredDebugSpanCount += freeSpan->m_usedOffset > freeSpan->m_offset ? 1 : 0;
 	m_requiredDebugSpanCount += (freeSpan->m_offset + freeSpan->m_size) > (freeSpan->m_usedOffset + freeSpan->m_usedSize) ? 1 : 0;
 
@@ -172,6 +175,7 @@ void TLSFAllocator::free(void *backingSpan)
 
 	m_freeSize += span->m_size;
 	m_usedSize -= span->m_usedSize;
+	m_stats.onDeallocate(size_t(span->m_usedSize) * m_statsUnitSize);
 	m_requiredDebugSpanCount -= span->m_usedOffset > span->m_offset ? 1 : 0;
 	m_requiredDebugSpanCount -= (span->m_offset + span->m_size) > (span->m_usedOffset + span->m_usedSize) ? 1 : 0;
 
@@ -321,6 +325,12 @@ void TLSFAllocator::getFreeUsedWastedSizes(uint32_t &free, uint32_t &used, uint3
 	wasted = m_memorySize - m_freeSize - m_usedSize;
 }
 
+void TLSFAllocator::setStatsUnitSize(uint32_t unitSize)
+{
+	assert(m_allocationCount == 0);
+	m_statsUnitSize = unitSize;
+}
+
 void TLSFAllocator::mappingInsert(uint32_t size, uint32_t &firstLevelIndex, uint32_t &secondLevelIndex)
 {
 	assert(size >= SMALL_BLOCK);
@@ -382,7 +392,9 @@ TLSFAllocator::Span *TLSFAllocator::findFreeSpan(uint32_t size)
 			result = m_smallFreeSpans[index];
 		}
 	}
-	else
+
+	// fall back to the regular lists if none of the small spans is large enough
+	if (!result)
 	{
 		// size must be at least SMALL_BLOCK size if we want to use tlsf allocation
 		size = size < SMALL_BLOCK ? SMALL_BLOCK : size;
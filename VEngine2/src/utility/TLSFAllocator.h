@@ -1,6 +1,7 @@
 #pragma once
 #include <cstdint>
 #include "ObjectPool.h"
+#include "allocator/AllocatorRegistry.h"
 
 struct TLSFSpanDebugInfo
 {
@@ -18,7 +19,7 @@ struct TLSFSpanDebugInfo
 class TLSFAllocator
 {
 public:
-	explicit TLSFAllocator(uint32_t memorySize, uint32_t pageSize);
+	explicit TLSFAllocator(uint32_t memorySize, uint32_t pageSize, const char *name = nullptr);
 	bool alloc(uint32_t size, uint32_t alignment, uint32_t &spanOffset, void *&backingSpan);
 	void free(void *backingSpan);
 	uint32_t getAllocationCount() const;
@@ -26,6 +27,9 @@ public:
 	uint32_t getMemorySize() const;
 	uint32_t getPageSize() const;
 	void getFreeUsedWastedSizes(uint32_t &free, uint32_t &used, uint32_t &wasted) const;
+	// usage is reported to the AllocatorRegistry in bytes. set this if a unit of the managed range is not a byte
+	// (like a descriptor). must be called before the first allocation.
+	void setStatsUnitSize(uint32_t unitSize);
 
 private:
 	enum
@@ -60,7 +64,9 @@ private:
 	uint32_t m_freeSize;
 	uint32_t m_usedSize;
 	uint32_t m_requiredDebugSpanCount;
+	uint32_t m_statsUnitSize;
 	DynamicObjectPool<Span> m_spanPool;
+	AllocatorStats m_stats;
 
 	// returns indices of the list holding memory blocks that lie in the same size class as requestedSize.
 	// used for inserting free blocks into the data structure
@@ -0,0 +1,50 @@
+#include "VirtualMemory.h"
+#include <Windows.h>
+#include <assert.h>
+
+static const SYSTEM_INFO &getSystemInfo() noexcept
+{
+	static SYSTEM_INFO sysInfo = []()
+	{
+		SYSTEM_INFO info;
+		::GetSystemInfo(&info);
+		return info;
+	}();
+
+	return sysInfo;
+}
+
+size_t VirtualMemory::getPageSize() noexcept
+{
+	return static_cast<size_t>(getSystemInfo().dwPageSize);
+}
+
+size_t VirtualMemory::getAllocationGranularity() noexcept
+{
+	return static_cast<size_t>(getSystemInfo().dwAllocationGranularity);
+}
+
+void *VirtualMemory::reserve(size_t size) noexcept
+{
+	return ::VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_READWRITE);
+}
+
+bool VirtualMemory::commit(void *address, size_t size) noexcept
+{
+	assert((reinterpret_cast<size_t>(address) % getPageSize()) == 0);
+	return ::VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+}
+
+void VirtualMemory::decommit(void *address, size_t size) noexcept
+{
+	assert((reinterpret_cast<size_t>(address) % getPageSize()) == 0);
+	BOOL res = ::VirtualFree(address, size, MEM_DECOMMIT);
+	assert(res);
+}
+
+void VirtualMemory::release(void *address, size_t size) noexcept
+{
+	// MEM_RELEASE requires a size of 0 and frees the entire reservation
+	BOOL res = ::VirtualFree(address, 0, MEM_RELEASE);
+	assert(res);
+}
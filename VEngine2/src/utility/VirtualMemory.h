@@ -0,0 +1,16 @@
+#pragma once
+#include <stdint.h>
+
+/// <summary>
+/// Thin wrapper around the OS virtual memory API. Reserving only claims address space; memory must be committed
+/// before it can be accessed. All sizes and addresses passed to commit() and decommit() must be page aligned.
+/// </summary>
+namespace VirtualMemory
+{
+	size_t getPageSize() noexcept;
+	size_t getAllocationGranularity() noexcept;
+	void *reserve(size_t size) noexcept;
+	bool commit(void *address, size_t size) noexcept;
+	void decommit(void *address, size_t size) noexcept;
+	void release(void *address, size_t size) noexcept;
+}
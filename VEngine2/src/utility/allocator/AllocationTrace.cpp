@@ -0,0 +1,320 @@
+#include "AllocationTrace.h"
+#include <stdio.h>
+#include <string.h>
+#include <EASTL/hash_map.h>
+#include <EASTL/atomic.h>
+#include "utility/SpinLock.h"
+#include "utility/Utility.h"
+#include "IAllocator.h"
+#include "Log.h"
+
+static constexpr uint32_t k_traceMagic = 0x52544156; // "VATR" in little endian
+static constexpr uint32_t k_traceVersion = 1;
+static constexpr uint32_t k_maxThreadIndex = 255;
+
+namespace
+{
+	struct TraceFileHeader
+	{
+		uint32_t m_magic;
+		uint32_t m_version;
+		uint32_t m_eventSize;
+		uint32_t m_sourceCount;
+		uint64_t m_eventCount;
+	};
+}
+
+bool AllocationTrace::loadFromFile(const char *path) noexcept
+{
+	clear();
+
+	FILE *file = nullptr;
+	if (fopen_s(&file, path, "rb") != 0 || !file)
+	{
+		Log::err("AllocationTrace: Failed to open \"%s\"!", path);
+		return false;
+	}
+
+	bool success = false;
+
+	TraceFileHeader header{};
+	if (fread(&header, sizeof(header), 1, file) == 1
+		&& header.m_magic == k_traceMagic
+		&& header.m_version == k_traceVersion
+		&& header.m_eventSize == sizeof(AllocationTraceEvent))
+	{
+		success = true;
+
+		for (uint32_t i = 0; i < header.m_sourceCount && success; ++i)
+		{
+			uint16_t length = 0;
+			char name[256];
+			success = fread(&length, sizeof(length), 1, file) == 1 && length < sizeof(name) && fread(name, 1, length, file) == length;
+			if (success)
+			{
+				name[length] = '\0';
+				addSource(name);
+			}
+		}
+
+		if (success)
+		{
+			m_events.resize(static_cast<size_t>(header.m_eventCount));
+			success = fread(m_events.data(), sizeof(AllocationTraceEvent), m_events.size(), file) == m_events.size();
+		}
+	}
+
+	fclose(file);
+
+	if (!success)
+	{
+		Log::err("AllocationTrace: \"%s\" is not a valid allocation trace!", path);
+		clear();
+	}
+
+	return success;
+}
+
+bool AllocationTrace::saveToFile(const char *path) const noexcept
+{
+	FILE *file = nullptr;
+	if (fopen_s(&file, path, "wb") != 0 || !file)
+	{
+		Log::err("AllocationTrace: Failed to open \"%s\" for writing!", path);
+		return false;
+	}
+
+	TraceFileHeader header{};
+	header.m_magic = k_traceMagic;
+	header.m_version = k_traceVersion;
+	header.m_eventSize = sizeof(AllocationTraceEvent);
+	header.m_sourceCount = static_cast<uint32_t>(m_sourceNames.size());
+	header.m_eventCount = m_events.size();
+
+	bool success = fwrite(&header, sizeof(header), 1, file) == 1;
+
+	for (const auto &name : m_sourceNames)
+	{
+		const uint16_t length = static_cast<uint16_t>(name.length() < 255 ? name.length() : 255);
+		success = success && fwrite(&length, sizeof(length), 1, file) == 1;
+		success = success && fwrite(name.c_str(), 1, length, file) == length;
+	}
+
+	success = success && fwrite(m_events.data(), sizeof(AllocationTraceEvent), m_events.size(), file) == m_events.size();
+
+	fclose(file);
+
+	if (!success)
+	{
+		Log::err("AllocationTrace: Failed to write \"%s\"!", path);
+	}
+
+	return success;
+}
+
+void AllocationTrace::clear() noexcept
+{
+	m_events.clear();
+	m_sourceNames.clear();
+}
+
+void AllocationTrace::addEvent(const AllocationTraceEvent &event) noexcept
+{
+	m_events.push_back(event);
+}
+
+uint16_t AllocationTrace::addSource(const char *name) noexcept
+{
+	m_sourceNames.push_back(name ? name : "<unnamed>");
+	return static_cast<uint16_t>(m_sourceNames.size() - 1);
+}
+
+const eastl::vector<AllocationTraceEvent> &AllocationTrace::getEvents() const noexcept
+{
+	return m_events;
+}
+
+const eastl::vector<eastl::string> &AllocationTrace::getSourceNames() const noexcept
+{
+	return m_sourceNames;
+}
+
+uint32_t AllocationTrace::getThreadCount() const noexcept
+{
+	uint32_t threadCount = 0;
+	for (const auto &event : m_events)
+	{
+		threadCount = event.m_threadIndex + 1u > threadCount ? event.m_threadIndex + 1u : threadCount;
+	}
+	return threadCount;
+}
+
+namespace
+{
+	struct RecorderData
+	{
+		SpinLock m_mutex;
+		eastl::atomic<bool> m_recording = false;
+		eastl::atomic<uint32_t> m_nextThreadIndex = 0;
+		AllocationTrace m_trace;
+		eastl::hash_map<uint64_t, uint32_t> m_liveAllocations; // keyed by getAllocationKey()
+		eastl::hash_map<const char *, uint16_t> m_sources; // allocator names are expected to be string literals
+		uint32_t m_nextAllocationID = 0;
+
+		static RecorderData &get() noexcept
+		{
+			// intentionally never destroyed, since allocators with static storage duration may still free memory during static destruction
+			alignas(RecorderData) static char s_memory[sizeof(RecorderData)];
+			static RecorderData *s_instance = PLACEMENT_NEW(s_memory) RecorderData();
+			return *s_instance;
+		}
+
+		// allocators wrapping each other return the same pointer, so the source is part of the key. user space addresses
+		// fit into 48 bits
+		static uint64_t getAllocationKey(const void *ptr, uint16_t sourceIndex) noexcept
+		{
+			return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ptr)) ^ (static_cast<uint64_t>(sourceIndex) << 48);
+		}
+
+		// requires m_mutex to be held
+		uint16_t getSourceIndex(const char *source) noexcept
+		{
+			auto it = m_sources.find(source);
+			if (it != m_sources.end())
+			{
+				return it->second;
+			}
+			const uint16_t index = m_trace.addSource(source);
+			m_sources[source] = index;
+			return index;
+		}
+	};
+
+	uint8_t getThreadIndex() noexcept
+	{
+		thread_local uint32_t t_threadIndex = RecorderData::get().m_nextThreadIndex.fetch_add(1, eastl::memory_order_relaxed);
+		return static_cast<uint8_t>(t_threadIndex < k_maxThreadIndex ? t_threadIndex : k_maxThreadIndex);
+	}
+}
+
+void AllocationTraceRecorder::begin() noexcept
+{
+	RecorderData &data = RecorderData::get();
+	LOCK_HOLDER(data.m_mutex);
+
+	data.m_trace.clear();
+	data.m_liveAllocations.clear();
+	data.m_sources.clear();
+	data.m_nextAllocationID = 0;
+	data.m_recording.store(true, eastl::memory_order_relaxed);
+
+	Log::info("Started recording allocation trace");
+}
+
+bool AllocationTraceRecorder::end(const char *path) noexcept
+{
+	RecorderData &data = RecorderData::get();
+	AllocationTrace trace;
+
+	{
+		LOCK_HOLDER(data.m_mutex);
+
+		if (!data.m_recording.load(eastl::memory_order_relaxed))
+		{
+			return false;
+		}
+
+		data.m_recording.store(false, eastl::memory_order_relaxed);
+		trace = eastl::move(data.m_trace);
+		data.m_trace.clear();
+		data.m_liveAllocations.clear();
+		data.m_sources.clear();
+	}
+
+	Log::info("Writing allocation trace with %llu events to \"%s\"", (unsigned long long)trace.getEvents().size(), path);
+
+	return trace.saveToFile(path);
+}
+
+bool AllocationTraceRecorder::isRecording() noexcept
+{
+	return RecorderData::get().m_recording.load(eastl::memory_order_relaxed);
+}
+
+void AllocationTraceRecorder::recordAllocate(const char *source, const void *ptr, size_t size, size_t alignment) noexcept
+{
+	if (!ptr || !isRecording())
+	{
+		return;
+	}
+
+	const uint8_t threadIndex = getThreadIndex();
+
+	RecorderData &data = RecorderData::get();
+	LOCK_HOLDER(data.m_mutex);
+
+	if (!data.m_recording.load(eastl::memory_order_relaxed))
+	{
+		return;
+	}
+
+	AllocationTraceEvent event{};
+	event.m_size = size;
+	event.m_allocationID = data.m_nextAllocationID++;
+	event.m_sourceIndex = data.getSourceIndex(source);
+	event.m_threadIndex = threadIndex;
+	event.m_alignmentLog2 = static_cast<uint8_t>(util::findLastSetBit(static_cast<uint32_t>(alignment ? alignment : 1)));
+	event.m_type = AllocationTraceEvent::ALLOCATE;
+
+	data.m_trace.addEvent(event);
+	data.m_liveAllocations[RecorderData::getAllocationKey(ptr, event.m_sourceIndex)] = event.m_allocationID;
+}
+
+void AllocationTraceRecorder::recordDeallocate(const char *source, const void *ptr) noexcept
+{
+	if (!ptr || !isRecording())
+	{
+		return;
+	}
+
+	const uint8_t threadIndex = getThreadIndex();
+
+	RecorderData &data = RecorderData::get();
+	LOCK_HOLDER(data.m_mutex);
+
+	if (!data.m_recording.load(eastl::memory_order_relaxed))
+	{
+		return;
+	}
+
+	const uint16_t sourceIndex = data.getSourceIndex(source);
+	auto it = data.m_liveAllocations.find(RecorderData::getAllocationKey(ptr, sourceIndex));
+	if (it == data.m_liveAllocations.end())
+	{
+		return;
+	}
+
+	AllocationTraceEvent event{};
+	event.m_allocationID = it->second;
+	event.m_sourceIndex = sourceIndex;
+	event.m_threadIndex = threadIndex;
+	event.m_type = AllocationTraceEvent::DEALLOCATE;
+
+	data.m_trace.addEvent(event);
+	data.m_liveAllocations.erase(it);
+}
+
+void AllocationTraceRecorder::markFrame() noexcept
+{
+	if (!isRecording())
+	{
+		return;
+	}
+
+	RecorderData &data = RecorderData::get();
+	LOCK_HOLDER(data.m_mutex);
+
+	AllocationTraceEvent event{};
+	event.m_type = AllocationTraceEvent::FRAME;
+	data.m_trace.addEvent(event);
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <stdint.h>
+#include <EASTL/vector.h>
+#include <EASTL/string.h>
+
+struct AllocationTraceEvent
+{
+	enum Type : uint8_t
+	{
+		ALLOCATE, DEALLOCATE, FRAME
+	};
+
+	uint64_t m_size; // only valid for ALLOCATE
+	uint32_t m_allocationID; // identifies the allocation across ALLOCATE and DEALLOCATE events
+	uint16_t m_sourceIndex; // index into the source names of the trace
+	uint8_t m_threadIndex;
+	uint8_t m_alignmentLog2; // 0 if the allocation did not request a specific alignment
+	Type m_type;
+};
+
+/// <summary>
+/// A recorded sequence of allocation events of one or more allocators. Traces are captured from a running engine
+/// with AllocationTraceRecorder and replayed by the allocator benchmark.
+/// </summary>
+class AllocationTrace
+{
+public:
+	bool loadFromFile(const char *path) noexcept;
+	bool saveToFile(const char *path) const noexcept;
+	void clear() noexcept;
+	void addEvent(const AllocationTraceEvent &event) noexcept;
+	// Returns the index of the new source.
+	uint16_t addSource(const char *name) noexcept;
+	const eastl::vector<AllocationTraceEvent> &getEvents() const noexcept;
+	const eastl::vector<eastl::string> &getSourceNames() const noexcept;
+	// Returns the number of distinct threads that recorded events.
+	uint32_t getThreadCount() const noexcept;
+
+private:
+	eastl::vector<AllocationTraceEvent> m_events;
+	eastl::vector<eastl::string> m_sourceNames;
+};
+
+/// <summary>
+/// Records allocations of instrumented allocators (TrackingAllocator, TLSFHeapAllocator) into an AllocationTrace.
+/// Allocators are identified by their name. Recording is thread-safe and costs a single atomic load while inactive.
+/// </summary>
+namespace AllocationTraceRecorder
+{
+	void begin() noexcept;
+	// Stops recording and writes the trace to path. Returns false if no trace was being recorded or writing failed.
+	bool end(const char *path) noexcept;
+	bool isRecording() noexcept;
+	// Pass an alignment of 0 for allocations without a specific alignment.
+	void recordAllocate(const char *source, const void *ptr, size_t size, size_t alignment) noexcept;
+	// Deallocations of memory that was allocated before recording began are ignored.
+	void recordDeallocate(const char *source, const void *ptr) noexcept;
+	// Separates the frames of the trace. Meant to be called once per frame.
+	void markFrame() noexcept;
+}
@@ -0,0 +1,322 @@
+#include "AllocatorRegistry.h"
+#include <string.h>
+#include <assert.h>
+#include "IAllocator.h"
+#include "utility/SpinLock.h"
+#include "Log.h"
+
+static constexpr size_t k_maxBudgets = 64;
+
+struct AllocatorRegistryData
+{
+	struct Budget
+	{
+		const char *m_subsystem;
+		size_t m_budgetBytes;
+		bool m_exceeded;
+	};
+
+	SpinLock m_mutex;
+	AllocatorStats *m_allocators = nullptr;
+	size_t m_allocatorCount = 0;
+	Budget m_budgets[k_maxBudgets] = {};
+	size_t m_budgetCount = 0;
+
+	static AllocatorRegistryData &get() noexcept
+	{
+		// intentionally never destroyed, since allocators with static storage duration may unregister during static destruction
+		alignas(AllocatorRegistryData) static char s_memory[sizeof(AllocatorRegistryData)];
+		static AllocatorRegistryData *s_instance = PLACEMENT_NEW(s_memory) AllocatorRegistryData();
+		return *s_instance;
+	}
+
+	void add(AllocatorStats *stats) noexcept
+	{
+		LOCK_HOLDER(m_mutex);
+		stats->m_prev = nullptr;
+		stats->m_next = m_allocators;
+		if (m_allocators)
+		{
+			m_allocators->m_prev = stats;
+		}
+		m_allocators = stats;
+		++m_allocatorCount;
+	}
+
+	void remove(AllocatorStats *stats) noexcept
+	{
+		LOCK_HOLDER(m_mutex);
+		if (stats->m_prev)
+		{
+			stats->m_prev->m_next = stats->m_next;
+		}
+		else
+		{
+			assert(m_allocators == stats);
+			m_allocators = stats->m_next;
+		}
+		if (stats->m_next)
+		{
+			stats->m_next->m_prev = stats->m_prev;
+		}
+		--m_allocatorCount;
+	}
+
+	// requires m_mutex to be held
+	Budget *findBudget(const char *subsystem) noexcept
+	{
+		for (size_t i = 0; i < m_budgetCount; ++i)
+		{
+			if (strcmp(m_budgets[i].m_subsystem, subsystem) == 0)
+			{
+				return &m_budgets[i];
+			}
+		}
+		return nullptr;
+	}
+
+	// requires m_mutex to be held
+	size_t getSubsystemLiveBytes(const char *subsystem) const noexcept
+	{
+		size_t liveBytes = 0;
+		for (const AllocatorStats *stats = m_allocators; stats; stats = stats->m_next)
+		{
+			if (stats->m_subsystem && strcmp(stats->m_subsystem, subsystem) == 0)
+			{
+				liveBytes += stats->getLiveBytes();
+			}
+		}
+		return liveBytes;
+	}
+
+	// requires m_mutex to be held
+	void updateAllocationRates(float timeDelta) noexcept
+	{
+		for (AllocatorStats *stats = m_allocators; stats; stats = stats->m_next)
+		{
+			const uint64_t totalAllocationCount = stats->getTotalAllocationCount();
+			stats->m_allocationsPerSecond = timeDelta > 0.0f ? (totalAllocationCount - stats->m_lastTotalAllocationCount) / timeDelta : 0.0f;
+			stats->m_lastTotalAllocationCount = totalAllocationCount;
+		}
+	}
+
+	// requires m_mutex to be held
+	void getSnapshots(size_t maxCount, AllocatorStatsSnapshot *snapshots) const noexcept
+	{
+		size_t i = 0;
+		for (const AllocatorStats *stats = m_allocators; stats && i < maxCount; stats = stats->m_next, ++i)
+		{
+			auto &snapshot = snapshots[i];
+			snapshot.m_name = stats->getName();
+			snapshot.m_subsystem = stats->getSubsystem();
+			snapshot.m_liveBytes = stats->getLiveBytes();
+			snapshot.m_peakBytes = stats->getPeakBytes();
+			snapshot.m_liveAllocationCount = stats->getLiveAllocationCount();
+			snapshot.m_totalAllocationCount = stats->getTotalAllocationCount();
+			snapshot.m_allocationsPerSecond = stats->m_allocationsPerSecond;
+		}
+	}
+};
+
+AllocatorStats::AllocatorStats(const char *name, const char *subsystem) noexcept
+	:m_name(name),
+	m_subsystem(subsystem)
+{
+	AllocatorRegistryData::get().add(this);
+}
+
+AllocatorStats::AllocatorStats(AllocatorStats &&other) noexcept
+	:m_liveBytes(other.m_liveBytes.exchange(0, eastl::memory_order_relaxed)),
+	m_peakBytes(other.m_peakBytes.exchange(0, eastl::memory_order_relaxed)),
+	m_liveAllocationCount(other.m_liveAllocationCount.exchange(0, eastl::memory_order_relaxed)),
+	m_totalAllocationCount(other.m_totalAllocationCount.exchange(0, eastl::memory_order_relaxed)),
+	m_name(other.m_name),
+	m_subsystem(other.m_subsystem)
+{
+	AllocatorRegistryData::get().add(this);
+}
+
+AllocatorStats::~AllocatorStats() noexcept
+{
+	AllocatorRegistryData::get().remove(this);
+}
+
+void AllocatorStats::onAllocate(size_t size) noexcept
+{
+	update(static_cast<int64_t>(size), 1, 1);
+}
+
+void AllocatorStats::onDeallocate(size_t size) noexcept
+{
+	update(-static_cast<int64_t>(size), -1, 0);
+}
+
+void AllocatorStats::onReset() noexcept
+{
+	m_liveBytes.store(0, eastl::memory_order_relaxed);
+	m_liveAllocationCount.store(0, eastl::memory_order_relaxed);
+}
+
+void AllocatorStats::update(int64_t byteDelta, int64_t allocationCountDelta, uint64_t newAllocationCount) noexcept
+{
+	const int64_t liveBytes = m_liveBytes.fetch_add(byteDelta, eastl::memory_order_relaxed) + byteDelta;
+
+	if (allocationCountDelta != 0)
+	{
+		m_liveAllocationCount.fetch_add(allocationCountDelta, eastl::memory_order_relaxed);
+	}
+
+	if (newAllocationCount != 0)
+	{
+		m_totalAllocationCount.fetch_add(newAllocationCount, eastl::memory_order_relaxed);
+	}
+
+	if (byteDelta > 0)
+	{
+		int64_t peakBytes = m_peakBytes.load(eastl::memory_order_relaxed);
+		while (liveBytes > peakBytes && !m_peakBytes.compare_exchange_weak(peakBytes, liveBytes, eastl::memory_order_relaxed))
+		{
+		}
+	}
+}
+
+void AllocatorStats::setName(const char *name) noexcept
+{
+	m_name = name;
+}
+
+void AllocatorStats::setSubsystem(const char *subsystem) noexcept
+{
+	AllocatorRegistryData &registry = AllocatorRegistryData::get();
+	LOCK_HOLDER(registry.m_mutex);
+	m_subsystem = subsystem;
+}
+
+const char *AllocatorStats::getName() const noexcept
+{
+	return m_name;
+}
+
+const char *AllocatorStats::getSubsystem() const noexcept
+{
+	return m_subsystem;
+}
+
+size_t AllocatorStats::getLiveBytes() const noexcept
+{
+	const int64_t liveBytes = m_liveBytes.load(eastl::memory_order_relaxed);
+	return liveBytes > 0 ? static_cast<size_t>(liveBytes) : 0;
+}
+
+size_t AllocatorStats::getPeakBytes() const noexcept
+{
+	return static_cast<size_t>(m_peakBytes.load(eastl::memory_order_relaxed));
+}
+
+size_t AllocatorStats::getLiveAllocationCount() const noexcept
+{
+	const int64_t liveAllocationCount = m_liveAllocationCount.load(eastl::memory_order_relaxed);
+	return liveAllocationCount > 0 ? static_cast<size_t>(liveAllocationCount) : 0;
+}
+
+uint64_t AllocatorStats::getTotalAllocationCount() const noexcept
+{
+	return m_totalAllocationCount.load(eastl::memory_order_relaxed);
+}
+
+void AllocatorRegistry::update(float timeDelta) noexcept
+{
+	AllocatorRegistryData &registry = AllocatorRegistryData::get();
+
+	// Log::warn is called after releasing the lock, so collect the subsystems first
+	const char *exceededSubsystems[k_maxBudgets];
+	size_t exceededLiveBytes[k_maxBudgets];
+	size_t exceededBudgetBytes[k_maxBudgets];
+	size_t exceededCount = 0;
+
+	{
+		LOCK_HOLDER(registry.m_mutex);
+
+		registry.updateAllocationRates(timeDelta);
+
+		for (size_t i = 0; i < registry.m_budgetCount; ++i)
+		{
+			auto &budget = registry.m_budgets[i];
+			const size_t liveBytes = registry.getSubsystemLiveBytes(budget.m_subsystem);
+			const bool exceeded = liveBytes > budget.m_budgetBytes;
+
+			// only warn once until usage drops below the budget again
+			if (exceeded && !budget.m_exceeded)
+			{
+				exceededSubsystems[exceededCount] = budget.m_subsystem;
+				exceededLiveBytes[exceededCount] = liveBytes;
+				exceededBudgetBytes[exceededCount] = budget.m_budgetBytes;
+				++exceededCount;
+			}
+			budget.m_exceeded = exceeded;
+		}
+	}
+
+	for (size_t i = 0; i < exceededCount; ++i)
+	{
+		Log::warn("Memory budget of subsystem \"%s\" exceeded: %llu / %llu bytes!", exceededSubsystems[i], (unsigned long long)exceededLiveBytes[i], (unsigned long long)exceededBudgetBytes[i]);
+	}
+}
+
+void AllocatorRegistry::setBudget(const char *subsystem, size_t budgetBytes) noexcept
+{
+	assert(subsystem);
+	AllocatorRegistryData &registry = AllocatorRegistryData::get();
+	LOCK_HOLDER(registry.m_mutex);
+
+	auto *budget = registry.findBudget(subsystem);
+
+	if (budgetBytes == 0)
+	{
+		// remove by swapping with the last budget
+		if (budget)
+		{
+			*budget = registry.m_budgets[registry.m_budgetCount - 1];
+			--registry.m_budgetCount;
+		}
+		return;
+	}
+
+	if (!budget)
+	{
+		if (registry.m_budgetCount == k_maxBudgets)
+		{
+			assert(false);
+			return;
+		}
+		budget = &registry.m_budgets[registry.m_budgetCount++];
+		budget->m_subsystem = subsystem;
+		budget->m_exceeded = false;
+	}
+
+	budget->m_budgetBytes = budgetBytes;
+}
+
+size_t AllocatorRegistry::getBudget(const char *subsystem) noexcept
+{
+	AllocatorRegistryData &registry = AllocatorRegistryData::get();
+	LOCK_HOLDER(registry.m_mutex);
+	const auto *budget = registry.findBudget(subsystem);
+	return budget ? budget->m_budgetBytes : 0;
+}
+
+size_t AllocatorRegistry::getSubsystemLiveBytes(const char *subsystem) noexcept
+{
+	AllocatorRegistryData &registry = AllocatorRegistryData::get();
+	LOCK_HOLDER(registry.m_mutex);
+	return registry.getSubsystemLiveBytes(subsystem);
+}
+
+size_t AllocatorRegistry::getSnapshots(size_t maxCount, AllocatorStatsSnapshot *snapshots) noexcept
+{
+	AllocatorRegistryData &registry = AllocatorRegistryData::get();
+	LOCK_HOLDER(registry.m_mutex);
+
+	registry.getSnapshots(maxCount, snapshots);
+	return registry.m_allocatorCount;
+}
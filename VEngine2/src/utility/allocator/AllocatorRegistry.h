@@ -0,0 +1,82 @@
+#pragma once
+#include <stdint.h>
+#include <EASTL/atomic.h>
+
+/// <summary>
+/// Usage statistics of a single allocator. Allocators own an instance of this class and report their allocations to it.
+/// Every instance is registered in the AllocatorRegistry for the duration of its lifetime. Updating is thread-safe.
+/// </summary>
+class AllocatorStats
+{
+	friend struct AllocatorRegistryData;
+public:
+	explicit AllocatorStats(const char *name, const char *subsystem = nullptr) noexcept;
+	AllocatorStats(AllocatorStats &&other) noexcept;
+
+	AllocatorStats(const AllocatorStats &) noexcept = delete;
+	AllocatorStats &operator=(const AllocatorStats &) noexcept = delete;
+	AllocatorStats &operator=(AllocatorStats &&other) noexcept = delete;
+
+	~AllocatorStats() noexcept;
+
+	void onAllocate(size_t size) noexcept;
+	void onDeallocate(size_t size) noexcept;
+	// Used by allocators that release all their allocations at once.
+	void onReset() noexcept;
+	// Applies a batch of changes. Allowing temporarily negative values lets thread-local counters be flushed in any order.
+	void update(int64_t byteDelta, int64_t allocationCountDelta, uint64_t newAllocationCount) noexcept;
+
+	void setName(const char *name) noexcept;
+	// Assigns the allocator to a subsystem, whose combined usage is checked against the budget of the subsystem.
+	void setSubsystem(const char *subsystem) noexcept;
+	const char *getName() const noexcept;
+	const char *getSubsystem() const noexcept;
+	size_t getLiveBytes() const noexcept;
+	size_t getPeakBytes() const noexcept;
+	size_t getLiveAllocationCount() const noexcept;
+	uint64_t getTotalAllocationCount() const noexcept;
+
+private:
+	eastl::atomic<int64_t> m_liveBytes = 0;
+	eastl::atomic<int64_t> m_peakBytes = 0;
+	eastl::atomic<int64_t> m_liveAllocationCount = 0;
+	eastl::atomic<uint64_t> m_totalAllocationCount = 0;
+	const char *m_name = nullptr;
+	const char *m_subsystem = nullptr;
+
+	// owned by the registry
+	AllocatorStats *m_prev = nullptr;
+	AllocatorStats *m_next = nullptr;
+	uint64_t m_lastTotalAllocationCount = 0;
+	float m_allocationsPerSecond = 0.0f;
+};
+
+struct AllocatorStatsSnapshot
+{
+	const char *m_name;
+	const char *m_subsystem;
+	size_t m_liveBytes;
+	size_t m_peakBytes;
+	size_t m_liveAllocationCount;
+	uint64_t m_totalAllocationCount;
+	float m_allocationsPerSecond;
+};
+
+/// <summary>
+/// Global list of all allocators and their usage statistics. Allocators can be grouped into subsystems, which can be
+/// assigned a budget. A warning is logged whenever the combined live bytes of a subsystem exceed its budget.
+/// Works independently of the profiler.
+/// </summary>
+namespace AllocatorRegistry
+{
+	// Updates allocation rates and checks budgets. Meant to be called once per frame.
+	void update(float timeDelta) noexcept;
+
+	// Sets the budget of a subsystem in bytes. A budget of 0 removes it.
+	void setBudget(const char *subsystem, size_t budgetBytes) noexcept;
+	size_t getBudget(const char *subsystem) noexcept;
+	size_t getSubsystemLiveBytes(const char *subsystem) noexcept;
+
+	// Writes up to maxCount snapshots and returns the number of registered allocators.
+	size_t getSnapshots(size_t maxCount, AllocatorStatsSnapshot *snapshots) noexcept;
+}
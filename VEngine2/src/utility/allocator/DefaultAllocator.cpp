@@ -1,5 +1,5 @@
 #include "DefaultAllocator.h"
-#include <stdlib.h>
+#include "SmallObjectAllocator.h"
 #include "profiling/Profiling.h"
 
 DefaultAllocator *DefaultAllocator::get() noexcept
@@ -10,14 +10,14 @@ DefaultAllocator *DefaultAllocator::get() noexcept
 
 void *DefaultAllocator::allocate(size_t n, int flags) noexcept
 {
-	void *ptr = malloc(n);
+	void *ptr = SmallObjectAllocator::get()->allocate(n, flags);
 	PROFILING_MEM_ALLOC(ptr, n);
 	return ptr;
 }
 
 void *DefaultAllocator::allocate(size_t n, size_t alignment, size_t offset, int flags) noexcept
 {
-	void *ptr = malloc(n);
+	void *ptr = SmallObjectAllocator::get()->allocate(n, alignment, offset, flags);
 	PROFILING_MEM_ALLOC(ptr, n);
 	return ptr;
 }
@@ -25,7 +25,7 @@ void *DefaultAllocator::allocate(size_t n, size_t alignment, size_t offset, int
 void DefaultAllocator::deallocate(void *p, size_t n) noexcept
 {
 	PROFILING_MEM_FREE(p);
-	free(p);
+	SmallObjectAllocator::get()->deallocate(p, n);
 }
 
 const char *DefaultAllocator::get_name() const noexcept
@@ -38,6 +38,11 @@ void DefaultAllocator::set_name(const char *pName) noexcept
 	m_name = pName;
 }
 
+AllocatorStats *DefaultAllocator::getStats() noexcept
+{
+	return SmallObjectAllocator::get()->getStats();
+}
+
 void *operator new(std::size_t count)
 {
 	return DefaultAllocator::get()->allocate(count);
@@ -50,12 +55,12 @@ void *operator new[](std::size_t count)
 
 void *operator new(std::size_t count, std::align_val_t al)
 {
-	return DefaultAllocator::get()->allocate(count);
+	return DefaultAllocator::get()->allocate(count, static_cast<size_t>(al), 0);
 }
 
 void *operator new[](std::size_t count, std::align_val_t al)
 {
-	return DefaultAllocator::get()->allocate(count);
+	return DefaultAllocator::get()->allocate(count, static_cast<size_t>(al), 0);
 }
 
 void *operator new(std::size_t count, const std::nothrow_t &) noexcept
@@ -70,12 +75,12 @@ void *operator new[](std::size_t count, const std::nothrow_t &) noexcept
 
 void *operator new(std::size_t count, std::align_val_t al, const std::nothrow_t &) noexcept
 {
-	return DefaultAllocator::get()->allocate(count);
+	return DefaultAllocator::get()->allocate(count, static_cast<size_t>(al), 0);
 }
 
 void *operator new[](std::size_t count, std::align_val_t al, const std::nothrow_t &) noexcept
 {
-	return DefaultAllocator::get()->allocate(count);
+	return DefaultAllocator::get()->allocate(count, static_cast<size_t>(al), 0);
 }
 
 void operator delete(void *ptr) noexcept
@@ -11,6 +11,7 @@ public:
 	void  deallocate(void *p, size_t n) noexcept override;
 	const char *get_name() const noexcept override;
 	void set_name(const char *pName) noexcept override;
+	AllocatorStats *getStats() noexcept override;
 
 private:
 	const char *m_name = "Default Allocator";
@@ -1,5 +1,6 @@
 #include "IAllocator.h"
 #include <new>
+#include "DefaultAllocator.h"
 
 void *operator new(size_t size, void *pObjMem, PlacementNewDummy dummy) noexcept
 {
@@ -12,6 +13,11 @@ void operator delete(void *pObj, void *pObjMem, PlacementNewDummy dummy) noexcep
 	assert(false);
 }
 
+ProxyAllocator::ProxyAllocator(const char *pName) noexcept
+	:m_allocator(DefaultAllocator::get())
+{
+}
+
 void *operator new(std::size_t count, IAllocator *allocator) noexcept
 {
 	return allocator->allocate(count);
@@ -4,6 +4,8 @@
 #include "utility/DeletedCopyMove.h"
 #include <assert.h>
 
+class AllocatorStats;
+
 struct PlacementNewDummy 
 {
 	explicit PlacementNewDummy() {};
@@ -35,6 +37,9 @@ public:
 	virtual void set_name(const char *pName) noexcept = 0;
 	virtual ~IAllocator() noexcept = default;
 
+	// Usage statistics of this allocator. Returns nullptr if the allocator does not track its usage.
+	virtual AllocatorStats *getStats() noexcept { return nullptr; }
+
 	template<typename T>
 	T *allocateArray(size_t count) noexcept
 	{
@@ -52,13 +57,19 @@ public:
 	}
 };
 
+/// <summary>
+/// EASTL container allocator forwarding to an IAllocator. Default constructed instances (as created by EASTL
+/// containers without an explicit allocator) forward to the DefaultAllocator.
+/// </summary>
 class ProxyAllocator
 {
 public:
-	explicit ProxyAllocator(IAllocator *allocator)
+	explicit ProxyAllocator(const char *pName = nullptr) noexcept;
+
+	explicit ProxyAllocator(IAllocator *allocator) noexcept
 		:m_allocator(allocator)
 	{
-
+		assert(m_allocator);
 	}
 
 	void *allocate(size_t n, int flags = 0) noexcept
@@ -86,11 +97,21 @@ public:
 		m_allocator->set_name(pName);
 	}
 
-	bool operator==(const ProxyAllocator &other)
+	IAllocator *getAllocator() const noexcept
+	{
+		return m_allocator;
+	}
+
+	bool operator==(const ProxyAllocator &other) const noexcept
 	{
 		return other.m_allocator == m_allocator;
 	}
 
+	bool operator!=(const ProxyAllocator &other) const noexcept
+	{
+		return other.m_allocator != m_allocator;
+	}
+
 private:
 	IAllocator *m_allocator;
 };
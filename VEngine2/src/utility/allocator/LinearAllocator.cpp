@@ -1,9 +1,13 @@
 #include "LinearAllocator.h"
 #include <stdlib.h>
+#include <EASTL/utility.h>
 #include "utility/Utility.h"
+#include "utility/VirtualMemory.h"
+
+static constexpr size_t k_commitGranularity = 1024 * 64;
 
 LinearAllocator::LinearAllocator(char *memory, size_t stackSizeBytes, const char *name) noexcept
-	:m_name(name),
+	:m_stats(name),
 	m_stackSizeBytes(stackSizeBytes),
 	m_memory(memory),
 	m_ownsMemory(false)
@@ -11,7 +15,7 @@ LinearAllocator::LinearAllocator(char *memory, size_t stackSizeBytes, const char
 }
 
 LinearAllocator::LinearAllocator(size_t stackSizeBytes, const char *name) noexcept
-	:m_name(name),
+	:m_stats(name),
 	m_stackSizeBytes(stackSizeBytes),
 	m_memory((char *)malloc(stackSizeBytes)),
 	m_ownsMemory(true)
@@ -19,7 +23,7 @@ LinearAllocator::LinearAllocator(size_t stackSizeBytes, const char *name) noexce
 }
 
 LinearAllocator::LinearAllocator(LinearAllocator &&other) noexcept
-	:m_name(other.m_name),
+	:m_stats(eastl::move(other.m_stats)),
 	m_stackSizeBytes(other.m_stackSizeBytes),
 	m_memory(other.m_memory),
 	m_currentOffset(other.m_currentOffset),
@@ -44,6 +48,7 @@ void *LinearAllocator::allocate(size_t n, int flags) noexcept
 	if (newOffset <= m_stackSizeBytes)
 	{
 		char *resultPtr = m_memory + m_currentOffset;
+		m_stats.update(static_cast<int64_t>(newOffset - m_currentOffset), 0, 1);
 		m_currentOffset = newOffset;
 
 		return resultPtr;
@@ -53,12 +58,16 @@ void *LinearAllocator::allocate(size_t n, int flags) noexcept
 
 void *LinearAllocator::allocate(size_t n, size_t alignment, size_t offset, int flags) noexcept
 {
-	size_t curAlignedOffset = util::alignPow2Up(m_currentOffset, alignment);
+	// align the actual address (offset bytes into the allocation), the backing memory itself may be less aligned
+	const size_t baseAddress = reinterpret_cast<size_t>(m_memory);
+	size_t curAlignedOffset = util::alignPow2Up(baseAddress + m_currentOffset + offset, alignment) - offset - baseAddress;
 	size_t newOffset = curAlignedOffset + n;
 
 	if (newOffset <= m_stackSizeBytes)
 	{
-		char *resultPtr = m_memory + curAlignedOffset + offset;
+		char *resultPtr = m_memory + curAlignedOffset;
+		// alignment padding counts as used memory
+		m_stats.update(static_cast<int64_t>(newOffset - m_currentOffset), 0, 1);
 		m_currentOffset = newOffset;
 
 		return resultPtr;
@@ -73,12 +82,17 @@ void LinearAllocator::deallocate(void *p, size_t n) noexcept
 
 const char *LinearAllocator::get_name() const noexcept
 {
-	return m_name;
+	return m_stats.getName();
 }
 
 void LinearAllocator::set_name(const char *pName) noexcept
 {
-	m_name = pName;
+	m_stats.setName(pName);
+}
+
+AllocatorStats *LinearAllocator::getStats() noexcept
+{
+	return &m_stats;
 }
 
 LinearAllocator::Marker LinearAllocator::getMarker() noexcept
@@ -89,14 +103,26 @@ LinearAllocator::Marker LinearAllocator::getMarker() noexcept
 void LinearAllocator::freeToMarker(Marker marker) noexcept
 {
 	assert(marker <= m_currentOffset);
+	m_stats.update(-static_cast<int64_t>(m_currentOffset - marker), 0, 0);
 	m_currentOffset = marker;
 }
 
 void LinearAllocator::reset() noexcept
 {
+	m_stats.onReset();
 	m_currentOffset = 0;
 }
 
+bool LinearAllocator::owns(const void *ptr) const noexcept
+{
+	return ptr >= m_memory && ptr < (m_memory + m_stackSizeBytes);
+}
+
+size_t LinearAllocator::getCapacity() const noexcept
+{
+	return m_stackSizeBytes;
+}
+
 LinearAllocatorFrame::LinearAllocatorFrame(LinearAllocator *allocator, const char *name) noexcept
 	:m_allocator(allocator),
 	m_name(name),
@@ -133,3 +159,147 @@ void LinearAllocatorFrame::set_name(const char *pName) noexcept
 {
 	m_name = pName;
 }
+
+VirtualLinearAllocator::VirtualLinearAllocator(size_t reservedSizeBytes, const char *name) noexcept
+	:m_stats(name),
+	m_reservedSizeBytes(reservedSizeBytes),
+	m_memory(reinterpret_cast<char *>(VirtualMemory::reserve(util::alignUp(reservedSizeBytes, k_commitGranularity))))
+{
+	assert(m_memory);
+	m_reservedSizeBytes = m_memory ? m_reservedSizeBytes : 0;
+}
+
+VirtualLinearAllocator::VirtualLinearAllocator(VirtualLinearAllocator &&other) noexcept
+	:m_stats(eastl::move(other.m_stats)),
+	m_reservedSizeBytes(other.m_reservedSizeBytes),
+	m_memory(other.m_memory),
+	m_currentOffset(other.m_currentOffset),
+	m_committedSizeBytes(other.m_committedSizeBytes)
+{
+	other.m_reservedSizeBytes = 0;
+	other.m_memory = nullptr;
+	other.m_currentOffset = 0;
+	other.m_committedSizeBytes = 0;
+}
+
+VirtualLinearAllocator::~VirtualLinearAllocator()
+{
+	if (m_memory)
+	{
+		VirtualMemory::release(m_memory, util::alignUp(m_reservedSizeBytes, k_commitGranularity));
+	}
+}
+
+void *VirtualLinearAllocator::allocate(size_t n, int flags) noexcept
+{
+	size_t newOffset = m_currentOffset + n;
+	if (newOffset <= m_reservedSizeBytes && ensureCommitted(newOffset))
+	{
+		char *resultPtr = m_memory + m_currentOffset;
+		m_stats.update(static_cast<int64_t>(newOffset - m_currentOffset), 0, 1);
+		m_currentOffset = newOffset;
+
+		return resultPtr;
+	}
+	return nullptr;
+}
+
+void *VirtualLinearAllocator::allocate(size_t n, size_t alignment, size_t offset, int flags) noexcept
+{
+	// the reserved range is page aligned, so aligning the offset is sufficient for alignments up to the page size
+	const size_t baseAddress = reinterpret_cast<size_t>(m_memory);
+	size_t curAlignedOffset = util::alignPow2Up(baseAddress + m_currentOffset + offset, alignment) - offset - baseAddress;
+	size_t newOffset = curAlignedOffset + n;
+
+	if (newOffset <= m_reservedSizeBytes && ensureCommitted(newOffset))
+	{
+		char *resultPtr = m_memory + curAlignedOffset;
+		m_stats.update(static_cast<int64_t>(newOffset - m_currentOffset), 0, 1);
+		m_currentOffset = newOffset;
+
+		return resultPtr;
+	}
+	return nullptr;
+}
+
+void VirtualLinearAllocator::deallocate(void *p, size_t n) noexcept
+{
+	// freeing individual allocations is not supported
+}
+
+const char *VirtualLinearAllocator::get_name() const noexcept
+{
+	return m_stats.getName();
+}
+
+void VirtualLinearAllocator::set_name(const char *pName) noexcept
+{
+	m_stats.setName(pName);
+}
+
+AllocatorStats *VirtualLinearAllocator::getStats() noexcept
+{
+	return &m_stats;
+}
+
+VirtualLinearAllocator::Marker VirtualLinearAllocator::getMarker() noexcept
+{
+	return m_currentOffset;
+}
+
+void VirtualLinearAllocator::freeToMarker(Marker marker) noexcept
+{
+	assert(marker <= m_currentOffset);
+	m_stats.update(-static_cast<int64_t>(m_currentOffset - marker), 0, 0);
+	m_currentOffset = marker;
+}
+
+void VirtualLinearAllocator::reset() noexcept
+{
+	m_stats.onReset();
+	m_currentOffset = 0;
+}
+
+void VirtualLinearAllocator::trim() noexcept
+{
+	const size_t requiredCommitSize = util::alignUp(m_currentOffset, k_commitGranularity);
+	if (requiredCommitSize < m_committedSizeBytes)
+	{
+		VirtualMemory::decommit(m_memory + requiredCommitSize, m_committedSizeBytes - requiredCommitSize);
+		m_committedSizeBytes = requiredCommitSize;
+	}
+}
+
+bool VirtualLinearAllocator::owns(const void *ptr) const noexcept
+{
+	return ptr >= m_memory && ptr < (m_memory + m_reservedSizeBytes);
+}
+
+size_t VirtualLinearAllocator::getCapacity() const noexcept
+{
+	return m_reservedSizeBytes;
+}
+
+size_t VirtualLinearAllocator::getCommittedSize() const noexcept
+{
+	return m_committedSizeBytes;
+}
+
+bool VirtualLinearAllocator::ensureCommitted(size_t size) noexcept
+{
+	if (size <= m_committedSizeBytes)
+	{
+		return true;
+	}
+
+	// the reservation is rounded up to the commit granularity, so this never exceeds it
+	const size_t newCommittedSize = util::alignUp(size, k_commitGranularity);
+
+	if (!VirtualMemory::commit(m_memory + m_committedSizeBytes, newCommittedSize - m_committedSizeBytes))
+	{
+		return false;
+	}
+
+	m_committedSizeBytes = newCommittedSize;
+	return true;
+}
@@ -2,6 +2,7 @@
 #include <stdint.h>
 #include "utility/DeletedCopyMove.h"
 #include "IAllocator.h"
+#include "AllocatorRegistry.h"
 
 class LinearAllocator : public IAllocator
 {
@@ -25,14 +26,16 @@ public:
 	void  deallocate(void *p, size_t n) noexcept override;
 	const char *get_name() const noexcept override;
 	void set_name(const char *pName) noexcept override;
-
+	AllocatorStats *getStats() noexcept override;
 
 	Marker getMarker() noexcept;
 	void freeToMarker(Marker marker) noexcept;
 	void reset() noexcept;
+	bool owns(const void *ptr) const noexcept;
+	size_t getCapacity() const noexcept;
 
 private:
-	const char *m_name = nullptr;
+	AllocatorStats m_stats;
 	const size_t m_stackSizeBytes = 0;
 	char *m_memory = nullptr;
 	size_t m_currentOffset = 0;
@@ -56,4 +59,51 @@ private:
 	LinearAllocator *m_allocator;
 	const char *m_name;
 	LinearAllocator::Marker m_startMarker;
-};
\ No newline at end of file
+};
+
+/// <summary>
+/// Linear allocator that reserves its full capacity as virtual address space up front and commits pages on demand.
+/// Capacity can therefore be sized for the worst case while only paying for the memory actually used.
+/// Committed pages are kept across reset() until trim() is called.
+/// </summary>
+class VirtualLinearAllocator : public IAllocator
+{
+public:
+	typedef size_t Marker;
+
+	explicit VirtualLinearAllocator(size_t reservedSizeBytes, const char *name = nullptr) noexcept;
+	VirtualLinearAllocator(VirtualLinearAllocator &&other) noexcept;
+
+	VirtualLinearAllocator(const VirtualLinearAllocator &) noexcept = delete;
+	VirtualLinearAllocator &operator=(const VirtualLinearAllocator &) noexcept = delete;
+	VirtualLinearAllocator &operator=(VirtualLinearAllocator &&other) noexcept = delete;
+
+	~VirtualLinearAllocator();
+
+	// EASTL allocator interface:
+
+	void *allocate(size_t n, int flags = 0) noexcept override;
+	void *allocate(size_t n, size_t alignment, size_t offset, int flags = 0) noexcept override;
+	void  deallocate(void *p, size_t n) noexcept override;
+	const char *get_name() const noexcept override;
+	void set_name(const char *pName) noexcept override;
+	AllocatorStats *getStats() noexcept override;
+
+	Marker getMarker() noexcept;
+	void freeToMarker(Marker marker) noexcept;
+	void reset() noexcept;
+	// Decommits all pages past the current offset.
+	void trim() noexcept;
+	bool owns(const void *ptr) const noexcept;
+	size_t getCapacity() const noexcept;
+	size_t getCommittedSize() const noexcept;
+
+private:
+	AllocatorStats m_stats;
+	size_t m_reservedSizeBytes = 0;
+	char *m_memory = nullptr;
+	size_t m_currentOffset = 0;
+	size_t m_committedSizeBytes = 0;
+
+	bool ensureCommitted(size_t size) noexcept;
+};
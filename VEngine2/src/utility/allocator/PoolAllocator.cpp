@@ -1,9 +1,12 @@
 #include "PoolAllocator.h"
 #include <stdlib.h>
 #include <assert.h>
+#include <EASTL/utility.h>
 #include "utility/Utility.h"
+#include "utility/VirtualMemory.h"
 
 static constexpr uint32_t k_invalidIndex = 0xFFFFFFFF;
+static constexpr size_t k_commitGranularity = 1024 * 64;
 
 static uint32_t initializeLinkedList(char *memory, size_t elementSize, size_t elementCount) noexcept
 {
@@ -21,7 +24,7 @@ static uint32_t initializeLinkedList(char *memory, size_t elementSize, size_t el
 }
 
 FixedPoolAllocator::FixedPoolAllocator(char *memory, size_t elementSize, size_t elementCount, const char *name) noexcept
-	:m_name(name),
+	:m_stats(name),
 	m_elementSize(elementSize),
 	m_elementCount(elementCount),
 	m_memory(memory),
@@ -31,7 +34,7 @@ FixedPoolAllocator::FixedPoolAllocator(char *memory, size_t elementSize, size_t
 }
 
 FixedPoolAllocator::FixedPoolAllocator(size_t elementSize, size_t elementCount, const char *name) noexcept
-	:m_name(name),
+	:m_stats(name),
 	m_elementSize(elementSize),
 	m_elementCount(elementCount),
 	m_memory((char *)malloc(elementSize * elementCount)),
@@ -41,7 +44,7 @@ FixedPoolAllocator::FixedPoolAllocator(size_t elementSize, size_t elementCount,
 }
 
 FixedPoolAllocator::FixedPoolAllocator(FixedPoolAllocator &&other) noexcept
-	:m_name(other.m_name),
+	:m_stats(eastl::move(other.m_stats)),
 	m_elementSize(other.m_elementSize),
 	m_elementCount(other.m_elementCount),
 	m_memory(other.m_memory),
@@ -75,6 +78,7 @@ void *FixedPoolAllocator::allocate(size_t n, int flags) noexcept
 		char *resultPtr = m_memory + m_elementSize * m_freeListHeadIndex;
 		m_freeListHeadIndex = *(uint32_t *)resultPtr;
 		--m_freeElementCount;
+		m_stats.onAllocate(m_elementSize);
 		return resultPtr;
 	}
 
@@ -102,16 +106,22 @@ void FixedPoolAllocator::deallocate(void *p, size_t n) noexcept
 	// ... and set our newly freed slot as head of the free list
 	m_freeListHeadIndex = (uint32_t)elementIndex;
 	++m_freeElementCount;
+	m_stats.onDeallocate(m_elementSize);
 }
 
 const char *FixedPoolAllocator::get_name() const noexcept
 {
-	return m_name;
+	return m_stats.getName();
 }
 
 void FixedPoolAllocator::set_name(const char *pName) noexcept
 {
-	m_name = pName;
+	m_stats.setName(pName);
+}
+
+AllocatorStats *FixedPoolAllocator::getStats() noexcept
+{
+	return &m_stats;
 }
 
 size_t FixedPoolAllocator::getFreeElementCount() const noexcept
@@ -120,14 +130,14 @@ size_t FixedPoolAllocator::getFreeElementCount() const noexcept
 }
 
 DynamicPoolAllocator::DynamicPoolAllocator(size_t elementSize, size_t initialElementCount, const char *name) noexcept
-	:m_name(name),
+	:m_stats(name),
 	m_elementSize(elementSize),
 	m_nextPoolCapacity(initialElementCount)
 {
 }
 
 DynamicPoolAllocator::DynamicPoolAllocator(DynamicPoolAllocator &&other) noexcept
-	:m_name(other.m_name),
+	:m_stats(eastl::move(other.m_stats)),
 	m_elementSize(other.m_elementSize),
 	m_freeElementCount(other.m_freeElementCount),
 	m_nextPoolCapacity(other.m_nextPoolCapacity),
@@ -166,6 +176,7 @@ void *DynamicPoolAllocator::allocate(size_t n, int flags) noexcept
 			pool->m_freeListHeadIndex = *(uint32_t *)resultPtr;
 			--(pool->m_freeElementCount);
 			--m_freeElementCount;
+			m_stats.onAllocate(m_elementSize);
 			return resultPtr;
 		}
 
@@ -202,6 +213,7 @@ void *DynamicPoolAllocator::allocate(size_t n, int flags) noexcept
 		newPool->m_freeListHeadIndex = *(uint32_t *)resultPtr;
 		--(newPool->m_freeElementCount);
 		--m_freeElementCount;
+		m_stats.onAllocate(m_elementSize);
 		return resultPtr;
 	}
 }
@@ -238,6 +250,7 @@ void DynamicPoolAllocator::deallocate(void *p, size_t n) noexcept
 
 			++(pool->m_freeElementCount);
 			++m_freeElementCount;
+			m_stats.onDeallocate(m_elementSize);
 
 			return;
 		}
@@ -249,12 +262,17 @@ void DynamicPoolAllocator::deallocate(void *p, size_t n) noexcept
 
 const char *DynamicPoolAllocator::get_name() const noexcept
 {
-	return m_name;
+	return m_stats.getName();
 }
 
 void DynamicPoolAllocator::set_name(const char *pName) noexcept
 {
-	m_name = pName;
+	m_stats.setName(pName);
+}
+
+AllocatorStats *DynamicPoolAllocator::getStats() noexcept
+{
+	return &m_stats;
 }
 
 size_t DynamicPoolAllocator::getFreeElementCount() const noexcept
@@ -288,3 +306,136 @@ void DynamicPoolAllocator::clearEmptyPools() noexcept
 		pool = nextPool;
 	}
 }
+
+VirtualPoolAllocator::VirtualPoolAllocator(size_t elementSize, size_t maxElementCount, const char *name) noexcept
+	:m_stats(name),
+	m_elementSize(elementSize),
+	m_maxElementCount(maxElementCount),
+	m_reservedSizeBytes(util::alignUp(elementSize * maxElementCount, k_commitGranularity))
+{
+	assert(elementSize >= sizeof(void *));
+	m_memory = reinterpret_cast<char *>(VirtualMemory::reserve(m_reservedSizeBytes));
+	assert(m_memory);
+	m_maxElementCount = m_memory ? m_maxElementCount : 0;
+}
+
+VirtualPoolAllocator::VirtualPoolAllocator(VirtualPoolAllocator &&other) noexcept
+	:m_stats(eastl::move(other.m_stats)),
+	m_elementSize(other.m_elementSize),
+	m_maxElementCount(other.m_maxElementCount),
+	m_memory(other.m_memory),
+	m_committedSizeBytes(other.m_committedSizeBytes),
+	m_reservedSizeBytes(other.m_reservedSizeBytes),
+	m_unusedElementIndex(other.m_unusedElementIndex),
+	m_freeElementCount(other.m_freeElementCount),
+	m_freeListHead(other.m_freeListHead)
+{
+	other.m_maxElementCount = 0;
+	other.m_memory = nullptr;
+	other.m_committedSizeBytes = 0;
+	other.m_reservedSizeBytes = 0;
+	other.m_unusedElementIndex = 0;
+	other.m_freeElementCount = 0;
+	other.m_freeListHead = nullptr;
+}
+
+VirtualPoolAllocator::~VirtualPoolAllocator()
+{
+	if (m_memory)
+	{
+		VirtualMemory::release(m_memory, m_reservedSizeBytes);
+	}
+}
+
+void *VirtualPoolAllocator::allocate(size_t n, int flags) noexcept
+{
+	if (n > m_elementSize)
+	{
+		return nullptr;
+	}
+
+	// reuse freed elements first
+	if (m_freeListHead)
+	{
+		void *resultPtr = m_freeListHead;
+		m_freeListHead = *reinterpret_cast<void **>(resultPtr);
+		--m_freeElementCount;
+		m_stats.onAllocate(m_elementSize);
+		return resultPtr;
+	}
+
+	if (m_unusedElementIndex == m_maxElementCount)
+	{
+		return nullptr;
+	}
+
+	// commit more memory if the next element is not fully committed yet
+	const size_t requiredSize = (m_unusedElementIndex + 1) * m_elementSize;
+	if (requiredSize > m_committedSizeBytes)
+	{
+		const size_t newCommittedSize = util::alignUp(requiredSize, k_commitGranularity);
+		if (!VirtualMemory::commit(m_memory + m_committedSizeBytes, newCommittedSize - m_committedSizeBytes))
+		{
+			return nullptr;
+		}
+
+		// only count elements that lie entirely inside the newly committed memory
+		const size_t newMaxCommittedElementIndex = newCommittedSize / m_elementSize < m_maxElementCount ? newCommittedSize / m_elementSize : m_maxElementCount;
+		const size_t oldMaxCommittedElementIndex = m_committedSizeBytes / m_elementSize;
+		m_freeElementCount += newMaxCommittedElementIndex - oldMaxCommittedElementIndex;
+		m_committedSizeBytes = newCommittedSize;
+	}
+
+	char *resultPtr = m_memory + m_unusedElementIndex * m_elementSize;
+	++m_unusedElementIndex;
+	--m_freeElementCount;
+	m_stats.onAllocate(m_elementSize);
+	return resultPtr;
+}
+
+void *VirtualPoolAllocator::allocate(size_t n, size_t alignment, size_t offset, int flags) noexcept
+{
+	assert((m_elementSize % alignment) == 0);
+	return allocate(n, flags);
+}
+
+void VirtualPoolAllocator::deallocate(void *p, size_t n) noexcept
+{
+	assert(owns(p));
+	assert(((reinterpret_cast<char *>(p) - m_memory) % m_elementSize) == 0);
+
+	*reinterpret_cast<void **>(p) = m_freeListHead;
+	m_freeListHead = p;
+	++m_freeElementCount;
+	m_stats.onDeallocate(m_elementSize);
+}
+
+const char *VirtualPoolAllocator::get_name() const noexcept
+{
+	return m_stats.getName();
+}
+
+void VirtualPoolAllocator::set_name(const char *pName) noexcept
+{
+	m_stats.setName(pName);
+}
+
+AllocatorStats *VirtualPoolAllocator::getStats() noexcept
+{
+	return &m_stats;
+}
+
+size_t VirtualPoolAllocator::getFreeElementCount() const noexcept
+{
+	return m_freeElementCount;
+}
+
+size_t VirtualPoolAllocator::getCommittedSize() const noexcept
+{
+	return m_committedSizeBytes;
+}
+
+bool VirtualPoolAllocator::owns(const void *ptr) const noexcept
+{
+	return ptr >= m_memory && ptr < (m_memory + m_unusedElementIndex * m_elementSize);
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include <stdint.h>
 #include "IAllocator.h"
+#include "AllocatorRegistry.h"
 
 class FixedPoolAllocator : public IAllocator
 {
@@ -22,11 +23,12 @@ public:
 	void  deallocate(void *p, size_t n) noexcept override;
 	const char *get_name() const noexcept override;
 	void set_name(const char *pName) noexcept override;
+	AllocatorStats *getStats() noexcept override;
 
 	size_t getFreeElementCount() const noexcept;
 
 private:
-	const char *m_name = nullptr;
+	AllocatorStats m_stats;
 	const size_t m_elementSize = 0;
 	const size_t m_elementCount = 0;
 	char *m_memory = nullptr;
@@ -54,6 +56,7 @@ public:
 	void  deallocate(void *p, size_t n) noexcept override;
 	const char *get_name() const noexcept override;
 	void set_name(const char *pName) noexcept override;
+	AllocatorStats *getStats() noexcept override;
 
 	size_t getFreeElementCount() const noexcept;
 	void clearEmptyPools() noexcept;
@@ -68,9 +71,52 @@ private:
 		uint32_t m_freeListHeadIndex = 0xFFFFFFFF;
 	};
 
-	const char *m_name;
+	AllocatorStats m_stats;
 	size_t m_elementSize;
 	size_t m_freeElementCount = 0;
 	size_t m_nextPoolCapacity = 0;
 	Pool *m_pools = nullptr;
-};
\ No newline at end of file
+};
+
+/// <summary>
+/// Pool allocator that reserves address space for maxElementCount elements up front and commits pages on demand.
+/// Unlike DynamicPoolAllocator, all elements live in a single contiguous range, so growing never adds pools that need
+/// to be searched on deallocation.
+/// </summary>
+class VirtualPoolAllocator : public IAllocator
+{
+public:
+	explicit VirtualPoolAllocator(size_t elementSize, size_t maxElementCount, const char *name = nullptr) noexcept;
+	VirtualPoolAllocator(VirtualPoolAllocator &&other) noexcept;
+
+	VirtualPoolAllocator(const VirtualPoolAllocator &) noexcept = delete;
+	VirtualPoolAllocator &operator=(const VirtualPoolAllocator &) noexcept = delete;
+	VirtualPoolAllocator &operator=(VirtualPoolAllocator &&other) noexcept = delete;
+
+	~VirtualPoolAllocator();
+
+	// EASTL allocator interface:
+
+	void *allocate(size_t n, int flags = 0) noexcept override;
+	void *allocate(size_t n, size_t alignment, size_t offset, int flags = 0) noexcept override;
+	void  deallocate(void *p, size_t n) noexcept override;
+	const char *get_name() const noexcept override;
+	void set_name(const char *pName) noexcept override;
+	AllocatorStats *getStats() noexcept override;
+
+	// Number of elements that can be allocated without committing more memory.
+	size_t getFreeElementCount() const noexcept;
+	size_t getCommittedSize() const noexcept;
+	bool owns(const void *ptr) const noexcept;
+
+private:
+	AllocatorStats m_stats;
+	size_t m_elementSize = 0;
+	size_t m_maxElementCount = 0;
+	char *m_memory = nullptr;
+	size_t m_committedSizeBytes = 0;
+	size_t m_reservedSizeBytes = 0;
+	size_t m_unusedElementIndex = 0; // elements starting at this index were never handed out
+	size_t m_freeElementCount = 0;
+	void *m_freeListHead = nullptr;
+};
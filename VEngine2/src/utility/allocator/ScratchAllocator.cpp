@@ -0,0 +1,182 @@
+#include "ScratchAllocator.h"
+#include "DefaultAllocator.h"
+#include "job/JobSystem.h"
+#include "Log.h"
+
+static constexpr size_t k_minAlignment = 16; // matches EASTL_ALLOCATOR_MIN_ALIGNMENT
+static constexpr size_t k_maxThreadAllocators = 64;
+
+namespace
+{
+	struct ScratchData
+	{
+		ScratchAllocator *m_threadAllocators[k_maxThreadAllocators] = {};
+		ScratchAllocator *m_frameAllocators[2] = {};
+		size_t m_threadAllocatorCount = 0;
+		size_t m_frameIndex = 0;
+	};
+}
+
+static ScratchData *s_scratchData = nullptr;
+
+ScratchAllocator::ScratchAllocator(size_t capacityBytes, bool threadSafe, const char *name) noexcept
+	:m_linearAllocator(capacityBytes, name),
+	m_overflowAllocator(DefaultAllocator::get()),
+	m_threadSafe(threadSafe)
+{
+}
+
+void *ScratchAllocator::allocate(size_t n, int flags) noexcept
+{
+	return allocate(n, k_minAlignment, 0, flags);
+}
+
+void *ScratchAllocator::allocate(size_t n, size_t alignment, size_t offset, int flags) noexcept
+{
+	alignment = alignment < k_minAlignment ? k_minAlignment : alignment;
+
+	void *result = nullptr;
+	{
+		if (m_threadSafe)
+		{
+			m_mutex.lock();
+		}
+
+		result = m_linearAllocator.allocate(n, alignment, offset, flags);
+
+		if (!result)
+		{
+			++m_overflowAllocationCount;
+
+			if (!m_overflowWarningIssued)
+			{
+				m_overflowWarningIssued = true;
+				Log::warn("ScratchAllocator \"%s\" exceeded its capacity of %u bytes! Falling back to the default allocator.", get_name() ? get_name() : "", (unsigned int)m_linearAllocator.getCapacity());
+			}
+		}
+
+		if (m_threadSafe)
+		{
+			m_mutex.unlock();
+		}
+	}
+
+	return result ? result : m_overflowAllocator->allocate(n, alignment, offset, flags);
+}
+
+void ScratchAllocator::deallocate(void *p, size_t n) noexcept
+{
+	// linear allocations are freed in bulk by reset(), only overflow allocations need to be freed individually
+	if (p && !m_linearAllocator.owns(p))
+	{
+		m_overflowAllocator->deallocate(p, n);
+	}
+}
+
+const char *ScratchAllocator::get_name() const noexcept
+{
+	return m_linearAllocator.get_name();
+}
+
+void ScratchAllocator::set_name(const char *pName) noexcept
+{
+	m_linearAllocator.set_name(pName);
+}
+
+AllocatorStats *ScratchAllocator::getStats() noexcept
+{
+	// overflow allocations are tracked by the overflow allocator
+	return m_linearAllocator.getStats();
+}
+
+void ScratchAllocator::reset() noexcept
+{
+	if (m_threadSafe)
+	{
+		m_mutex.lock();
+	}
+
+	m_linearAllocator.reset();
+	m_overflowAllocationCount = 0;
+
+	if (m_threadSafe)
+	{
+		m_mutex.unlock();
+	}
+}
+
+size_t ScratchAllocator::getOverflowAllocationCount() const noexcept
+{
+	return m_overflowAllocationCount;
+}
+
+void scratch::init(size_t threadAllocatorCapacity, size_t frameAllocatorCapacity) noexcept
+{
+	assert(!s_scratchData);
+	assert(job::isManagedThread());
+
+	s_scratchData = new ScratchData();
+
+	s_scratchData->m_threadAllocatorCount = job::getThreadCount();
+	assert(s_scratchData->m_threadAllocatorCount <= k_maxThreadAllocators);
+
+	for (size_t i = 0; i < s_scratchData->m_threadAllocatorCount; ++i)
+	{
+		s_scratchData->m_threadAllocators[i] = new ScratchAllocator(threadAllocatorCapacity, false, "Thread Scratch Allocator");
+	}
+
+	s_scratchData->m_frameAllocators[0] = new ScratchAllocator(frameAllocatorCapacity, true, "Frame Scratch Allocator 0");
+	s_scratchData->m_frameAllocators[1] = new ScratchAllocator(frameAllocatorCapacity, true, "Frame Scratch Allocator 1");
+}
+
+void scratch::shutdown() noexcept
+{
+	assert(s_scratchData);
+
+	for (size_t i = 0; i < s_scratchData->m_threadAllocatorCount; ++i)
+	{
+		delete s_scratchData->m_threadAllocators[i];
+	}
+
+	delete s_scratchData->m_frameAllocators[0];
+	delete s_scratchData->m_frameAllocators[1];
+
+	delete s_scratchData;
+	s_scratchData = nullptr;
+}
+
+void scratch::beginFrame() noexcept
+{
+	assert(s_scratchData);
+
+	for (size_t i = 0; i < s_scratchData->m_threadAllocatorCount; ++i)
+	{
+		s_scratchData->m_threadAllocators[i]->reset();
+	}
+
+	// the frame allocator of the previous frame stays valid until the end of this frame
+	s_scratchData->m_frameIndex = (s_scratchData->m_frameIndex + 1) & 1;
+	s_scratchData->m_frameAllocators[s_scratchData->m_frameIndex]->reset();
+}
+
+IAllocator *scratch::getThreadAllocator() noexcept
+{
+	if (!s_scratchData || !job::isManagedThread())
+	{
+		return DefaultAllocator::get();
+	}
+
+	const size_t threadIndex = job::getThreadIndex();
+	assert(threadIndex < s_scratchData->m_threadAllocatorCount);
+	return s_scratchData->m_threadAllocators[threadIndex];
+}
+
+IAllocator *scratch::getFrameAllocator() noexcept
+{
+	if (!s_scratchData)
+	{
+		return DefaultAllocator::get();
+	}
+
+	return s_scratchData->m_frameAllocators[s_scratchData->m_frameIndex];
+}
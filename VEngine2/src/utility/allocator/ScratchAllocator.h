@@ -0,0 +1,62 @@
+#pragma once
+#include <EASTL/vector.h>
+#include "IAllocator.h"
+#include "LinearAllocator.h"
+#include "utility/SpinLock.h"
+
+/// <summary>
+/// Linear allocator for transient data that is released in bulk by calling reset(). Deallocating individual allocations
+/// is a no-op. The capacity is only reserved as address space and committed as it is used. Once it is exhausted,
+/// allocations are served by the overflow allocator instead of failing.
+/// </summary>
+class ScratchAllocator : public IAllocator
+{
+public:
+	explicit ScratchAllocator(size_t capacityBytes, bool threadSafe, const char *name = nullptr) noexcept;
+	DELETED_COPY_MOVE(ScratchAllocator);
+	~ScratchAllocator() noexcept = default;
+
+	// EASTL allocator interface:
+
+	void *allocate(size_t n, int flags = 0) noexcept override;
+	void *allocate(size_t n, size_t alignment, size_t offset, int flags = 0) noexcept override;
+	void  deallocate(void *p, size_t n) noexcept override;
+	const char *get_name() const noexcept override;
+	void set_name(const char *pName) noexcept override;
+	AllocatorStats *getStats() noexcept override;
+
+	void reset() noexcept;
+	size_t getOverflowAllocationCount() const noexcept;
+
+private:
+	VirtualLinearAllocator m_linearAllocator;
+	IAllocator *m_overflowAllocator;
+	SpinLock m_mutex;
+	size_t m_overflowAllocationCount = 0;
+	bool m_threadSafe;
+	bool m_overflowWarningIssued = false;
+};
+
+/// <summary>
+/// Frame scoped scratch memory. Every job system thread owns a ScratchAllocator that must only be used from that thread.
+/// Additionally there is a double-buffered, thread-safe frame allocator whose allocations stay valid until the end of
+/// the following frame, which makes it suitable for data captured by render graph passes.
+/// All scratch memory is reclaimed by beginFrame(), so it must not be referenced past the frame boundary.
+/// </summary>
+namespace scratch
+{
+	void init(size_t threadAllocatorCapacity, size_t frameAllocatorCapacity) noexcept;
+	void shutdown() noexcept;
+	void beginFrame() noexcept;
+
+	// Allocator of the calling thread. Containers using it must not be resized after waiting on a job::Counter
+	// with stayOnThread == false, since the calling fiber may have been resumed on a different thread.
+	// Returns the DefaultAllocator on threads not managed by the job system.
+	IAllocator *getThreadAllocator() noexcept;
+
+	// Double-buffered frame allocator. Safe to use from any thread.
+	IAllocator *getFrameAllocator() noexcept;
+}
+
+template<typename T>
+using ScratchVector = eastl::vector<T, ProxyAllocator>;
@@ -0,0 +1,581 @@
+#include "SmallObjectAllocator.h"
+#include <stdlib.h>
+#include <malloc.h>
+#include <EASTL/atomic.h>
+#include "utility/VirtualMemory.h"
+#include "utility/Utility.h"
+
+static constexpr size_t k_spanHeaderSize = 128;
+static constexpr size_t k_minAlignment = 16; // matches EASTL_ALLOCATOR_MIN_ALIGNMENT
+static constexpr size_t k_maxCommittedFreeSpans = 32;
+static constexpr size_t k_largeAllocationHeaderSize = 16; // stores the size of large allocations
+static constexpr uint32_t k_usageFlushInterval = 64;
+
+struct SmallObjectAllocator::Span
+{
+	// written by threads freeing memory they do not own, so it gets its own cache line
+	alignas(64) eastl::atomic<void *> m_remoteFreeList = nullptr;
+	alignas(64) eastl::atomic<ThreadCache *> m_owner = nullptr;
+	Span *m_prev = nullptr;
+	Span *m_next = nullptr;
+	void *m_freeList = nullptr;
+	uint32_t m_sizeClass = 0;
+	uint32_t m_objectSize = 0;
+	uint32_t m_capacity = 0;
+	uint32_t m_usedCount = 0;
+	uint32_t m_unusedIndex = 0; // objects starting at this index were never handed out, so they are not in any free list
+	bool m_full = false; // span is in the full list of its owner
+};
+
+static_assert(sizeof(SmallObjectAllocator::Span) <= k_spanHeaderSize);
+
+struct SmallObjectAllocator::ThreadCache
+{
+	Span *m_partialSpans[k_sizeClassCount] = {}; // spans with free objects. the head is allocated from
+	Span *m_fullSpans[k_sizeClassCount] = {};
+
+	// usage statistics are accumulated per thread and periodically flushed to avoid contention
+	int64_t m_pendingBytes = 0;
+	int64_t m_pendingAllocationCount = 0;
+	uint64_t m_pendingNewAllocationCount = 0;
+	uint32_t m_pendingUpdateCount = 0;
+};
+
+namespace
+{
+	struct ThreadCacheReleaser
+	{
+		~ThreadCacheReleaser() noexcept
+		{
+			SmallObjectAllocator::get()->releaseThreadCache();
+		}
+	};
+}
+
+static thread_local SmallObjectAllocator::ThreadCache *s_threadCache = nullptr;
+static thread_local bool s_threadCacheReleased = false;
+static thread_local ThreadCacheReleaser s_threadCacheReleaser;
+
+// size classes are 16 byte steps up to 128 bytes and 4 steps per power of two above that
+static uint32_t getSizeClass(size_t size) noexcept
+{
+	assert(size <= SmallObjectAllocator::k_maxSmallObjectSize);
+
+	if (size <= 128)
+	{
+		return size == 0 ? 0 : static_cast<uint32_t>((size + 15) / 16 - 1);
+	}
+
+	const uint32_t log2 = util::findLastSetBit(static_cast<uint32_t>(size - 1));
+	const uint32_t step = static_cast<uint32_t>((size - 1 - (size_t(1) << log2)) >> (log2 - 2));
+	return 8 + (log2 - 7) * 4 + step;
+}
+
+static uint32_t getSizeClassObjectSize(uint32_t sizeClass) noexcept
+{
+	assert(sizeClass < SmallObjectAllocator::k_sizeClassCount);
+
+	if (sizeClass < 8)
+	{
+		return (sizeClass + 1) * 16;
+	}
+
+	const uint32_t log2 = 7 + (sizeClass - 8) / 4;
+	const uint32_t step = (sizeClass - 8) % 4;
+	return (1u << log2) + (step + 1) * (1u << (log2 - 2));
+}
+
+static char *getSpanData(SmallObjectAllocator::Span *span) noexcept
+{
+	return reinterpret_cast<char *>(span) + k_spanHeaderSize;
+}
+
+static void pushSpan(SmallObjectAllocator::Span **list, SmallObjectAllocator::Span *span) noexcept
+{
+	span->m_prev = nullptr;
+	span->m_next = *list;
+	if (*list)
+	{
+		(*list)->m_prev = span;
+	}
+	*list = span;
+}
+
+static void removeSpan(SmallObjectAllocator::Span **list, SmallObjectAllocator::Span *span) noexcept
+{
+	if (span->m_prev)
+	{
+		span->m_prev->m_next = span->m_next;
+	}
+	else
+	{
+		assert(*list == span);
+		*list = span->m_next;
+	}
+
+	if (span->m_next)
+	{
+		span->m_next->m_prev = span->m_prev;
+	}
+
+	span->m_prev = nullptr;
+	span->m_next = nullptr;
+}
+
+// moves memory freed by other threads into the local free list. must only be called by the owner.
+static bool collectRemoteFrees(SmallObjectAllocator::Span *span) noexcept
+{
+	void *list = span->m_remoteFreeList.exchange(nullptr, eastl::memory_order_acquire);
+	const bool collected = list != nullptr;
+
+	while (list)
+	{
+		void *next = *reinterpret_cast<void **>(list);
+		*reinterpret_cast<void **>(list) = span->m_freeList;
+		span->m_freeList = list;
+		assert(span->m_usedCount > 0);
+		--span->m_usedCount;
+		list = next;
+	}
+
+	return collected;
+}
+
+static void *popObject(SmallObjectAllocator::Span *span) noexcept
+{
+	if (!span->m_freeList && span->m_unusedIndex == span->m_capacity && span->m_remoteFreeList.load(eastl::memory_order_relaxed))
+	{
+		collectRemoteFrees(span);
+	}
+
+	void *result = nullptr;
+
+	if (span->m_freeList)
+	{
+		result = span->m_freeList;
+		span->m_freeList = *reinterpret_cast<void **>(result);
+	}
+	else if (span->m_unusedIndex < span->m_capacity)
+	{
+		result = getSpanData(span) + static_cast<size_t>(span->m_unusedIndex) * span->m_objectSize;
+		++span->m_unusedIndex;
+	}
+
+	if (result)
+	{
+		++span->m_usedCount;
+	}
+
+	return result;
+}
+
+SmallObjectAllocator *SmallObjectAllocator::get() noexcept
+{
+	// the instance is intentionally never destroyed: memory may still be freed during static destruction
+	alignas(SmallObjectAllocator) static char s_instanceMemory[sizeof(SmallObjectAllocator)];
+	static SmallObjectAllocator *s_instance = PLACEMENT_NEW(s_instanceMemory) SmallObjectAllocator();
+	return s_instance;
+}
+
+SmallObjectAllocator::SmallObjectAllocator() noexcept
+	:m_stats("Small Object Allocator")
+{
+	// if reserving fails, all allocations are forwarded to the CRT heap
+	m_reservedMemory = reinterpret_cast<char *>(VirtualMemory::reserve(k_reservedAddressSpaceSize));
+	m_reservedSpanCount = m_reservedMemory ? k_reservedAddressSpaceSize / k_spanSize : 0;
+}
+
+void *SmallObjectAllocator::allocate(size_t n, int flags) noexcept
+{
+	return allocate(n, k_minAlignment, 0, flags);
+}
+
+void *SmallObjectAllocator::allocate(size_t n, size_t alignment, size_t offset, int flags) noexcept
+{
+	alignment = alignment < k_minAlignment ? k_minAlignment : alignment;
+
+	// objects are always aligned to k_minAlignment. larger alignments are handled by over-allocating and
+	// returning an interior pointer. deallocate() maps it back to the start of the object.
+	const bool adjustPointer = alignment > k_minAlignment || (offset % k_minAlignment) != 0;
+	const size_t requiredSize = adjustPointer ? n + alignment - 1 : n;
+
+	ThreadCache *cache = getThreadCache();
+
+	if (requiredSize <= k_maxSmallObjectSize && cache)
+	{
+		const uint32_t sizeClass = getSizeClass(requiredSize);
+		char *result = reinterpret_cast<char *>(allocateSmall(cache, sizeClass));
+
+		if (result)
+		{
+			recordUsage(cache, getSizeClassObjectSize(sizeClass), 1);
+
+			if (adjustPointer)
+			{
+				result = reinterpret_cast<char *>(util::alignPow2Up(reinterpret_cast<size_t>(result) + offset, alignment) - offset);
+			}
+			return result;
+		}
+	}
+
+	// the header is placed in front of the allocation, so offset the alignment accordingly
+	n = n > offset ? n : offset + 1;
+	char *memory = reinterpret_cast<char *>(_aligned_offset_malloc(n + k_largeAllocationHeaderSize, alignment, offset + k_largeAllocationHeaderSize));
+	if (!memory)
+	{
+		return nullptr;
+	}
+
+	*reinterpret_cast<size_t *>(memory) = n;
+	recordUsage(cache, static_cast<int64_t>(n), 1);
+
+	return memory + k_largeAllocationHeaderSize;
+}
+
+void SmallObjectAllocator::deallocate(void *p, size_t n) noexcept
+{
+	if (!p)
+	{
+		return;
+	}
+
+	if (owns(p))
+	{
+		deallocateSmall(p);
+	}
+	else
+	{
+		char *memory = reinterpret_cast<char *>(p) - k_largeAllocationHeaderSize;
+		recordUsage(s_threadCache, -static_cast<int64_t>(*reinterpret_cast<size_t *>(memory)), -1);
+		_aligned_free(memory);
+	}
+}
+
+const char *SmallObjectAllocator::get_name() const noexcept
+{
+	return m_stats.getName();
+}
+
+void SmallObjectAllocator::set_name(const char *pName) noexcept
+{
+	m_stats.setName(pName);
+}
+
+AllocatorStats *SmallObjectAllocator::getStats() noexcept
+{
+	return &m_stats;
+}
+
+bool SmallObjectAllocator::owns(const void *ptr) const noexcept
+{
+	return ptr >= m_reservedMemory && ptr < (m_reservedMemory + m_reservedSpanCount * k_spanSize);
+}
+
+void SmallObjectAllocator::releaseThreadCache() noexcept
+{
+	ThreadCache *cache = s_threadCache;
+	s_threadCache = nullptr;
+	s_threadCacheReleased = true;
+
+	if (!cache)
+	{
+		return;
+	}
+
+	flushUsage(cache);
+
+	// hand all spans still in use over to other threads
+	for (uint32_t sizeClass = 0; sizeClass < k_sizeClassCount; ++sizeClass)
+	{
+		Span **lists[] = { &cache->m_partialSpans[sizeClass], &cache->m_fullSpans[sizeClass] };
+		for (Span **list : lists)
+		{
+			while (Span *span = *list)
+			{
+				removeSpan(list, span);
+				collectRemoteFrees(span);
+				span->m_full = false;
+
+				if (span->m_usedCount == 0)
+				{
+					releaseSpan(span);
+				}
+				else
+				{
+					LOCK_HOLDER(m_spanMutex);
+					span->m_owner.store(nullptr, eastl::memory_order_relaxed);
+					pushSpan(&m_abandonedSpans[sizeClass], span);
+				}
+			}
+		}
+	}
+
+	cache->~ThreadCache();
+	free(cache);
+}
+
+SmallObjectAllocator::ThreadCache *SmallObjectAllocator::getThreadCache() noexcept
+{
+	ThreadCache *cache = s_threadCache;
+
+	// lazily create the cache, unless this thread is already shutting down
+	if (!cache && !s_threadCacheReleased)
+	{
+		void *cacheMemory = malloc(sizeof(ThreadCache));
+		if (cacheMemory)
+		{
+			cache = PLACEMENT_NEW(cacheMemory) ThreadCache();
+			s_threadCache = cache;
+
+			// odr-use the releaser to ensure it is constructed on this thread and hands back the cache on thread exit
+			(void)&s_threadCacheReleaser;
+		}
+	}
+
+	return cache;
+}
+
+void *SmallObjectAllocator::allocateSmall(ThreadCache *cache, uint32_t sizeClass) noexcept
+{
+	Span **partialSpans = &cache->m_partialSpans[sizeClass];
+	Span **fullSpans = &cache->m_fullSpans[sizeClass];
+
+	while (Span *span = *partialSpans)
+	{
+		if (void *result = popObject(span))
+		{
+			return result;
+		}
+
+		// span is exhausted -> move it to the full list
+		removeSpan(partialSpans, span);
+		pushSpan(fullSpans, span);
+		span->m_full = true;
+	}
+
+	// all spans are exhausted -> check if other threads freed memory in any of them
+	Span *span = *fullSpans;
+	while (span)
+	{
+		Span *nextSpan = span->m_next;
+
+		if (span->m_remoteFreeList.load(eastl::memory_order_relaxed))
+		{
+			removeSpan(fullSpans, span);
+			pushSpan(partialSpans, span);
+			span->m_full = false;
+		}
+
+		span = nextSpan;
+	}
+
+	if (*partialSpans)
+	{
+		return popObject(*partialSpans);
+	}
+
+	// still no free memory -> get a new span
+	span = acquireSpan(cache, sizeClass);
+	if (!span)
+	{
+		return nullptr;
+	}
+
+	pushSpan(partialSpans, span);
+	return popObject(span);
+}
+
+void SmallObjectAllocator::deallocateSmall(void *p) noexcept
+{
+	Span *span = getSpan(p);
+
+	// p may be an interior pointer of an over-aligned allocation, so get the actual start of the object
+	char *spanData = getSpanData(span);
+	const size_t objectIndex = static_cast<size_t>(reinterpret_cast<char *>(p) - spanData) / span->m_objectSize;
+	assert(objectIndex < span->m_capacity);
+	void *object = spanData + objectIndex * span->m_objectSize;
+
+	ThreadCache *cache = s_threadCache;
+
+	recordUsage(cache, -static_cast<int64_t>(span->m_objectSize), -1);
+
+	// we own the span -> free into the local free list
+	if (cache && span->m_owner.load(eastl::memory_order_relaxed) == cache)
+	{
+		*reinterpret_cast<void **>(object) = span->m_freeList;
+		span->m_freeList = object;
+		assert(span->m_usedCount > 0);
+		--span->m_usedCount;
+
+		const uint32_t sizeClass = span->m_sizeClass;
+
+		if (span->m_full)
+		{
+			removeSpan(&cache->m_fullSpans[sizeClass], span);
+			pushSpan(&cache->m_partialSpans[sizeClass], span);
+			span->m_full = false;
+		}
+		// return empty spans, but keep the one we are currently allocating from to avoid thrashing
+		else if (span->m_usedCount == 0 && cache->m_partialSpans[sizeClass] != span)
+		{
+			removeSpan(&cache->m_partialSpans[sizeClass], span);
+			releaseSpan(span);
+		}
+	}
+	// span is owned by another thread -> push onto its remote free list
+	else
+	{
+		void *head = span->m_remoteFreeList.load(eastl::memory_order_relaxed);
+		do
+		{
+			*reinterpret_cast<void **>(object) = head;
+		} while (!span->m_remoteFreeList.compare_exchange_weak(head, object, eastl::memory_order_release, eastl::memory_order_relaxed));
+	}
+}
+
+SmallObjectAllocator::Span *SmallObjectAllocator::acquireSpan(ThreadCache *cache, uint32_t sizeClass) noexcept
+{
+	// try to adopt spans of exited threads first
+	while (true)
+	{
+		Span *span = nullptr;
+		{
+			LOCK_HOLDER(m_spanMutex);
+			span = m_abandonedSpans[sizeClass];
+			if (span)
+			{
+				removeSpan(&m_abandonedSpans[sizeClass], span);
+			}
+		}
+
+		if (!span)
+		{
+			break;
+		}
+
+		span->m_owner.store(cache, eastl::memory_order_relaxed);
+		collectRemoteFrees(span);
+
+		if (span->m_freeList || span->m_unusedIndex < span->m_capacity)
+		{
+			return span;
+		}
+
+		// adopted span has no free memory either
+		pushSpan(&cache->m_fullSpans[sizeClass], span);
+		span->m_full = true;
+	}
+
+	// get a span from the free lists or carve out a new one from the reserved address range
+	char *spanMemory = nullptr;
+	bool committed = false;
+	bool headerPageCommitted = false;
+	{
+		LOCK_HOLDER(m_spanMutex);
+
+		if (m_committedFreeSpans)
+		{
+			Span *span = m_committedFreeSpans;
+			removeSpan(&m_committedFreeSpans, span);
+			--m_committedFreeSpanCount;
+			spanMemory = reinterpret_cast<char *>(span);
+			committed = true;
+		}
+		else if (m_decommittedFreeSpans)
+		{
+			Span *span = m_decommittedFreeSpans;
+			removeSpan(&m_decommittedFreeSpans, span);
+			spanMemory = reinterpret_cast<char *>(span);
+			headerPageCommitted = true;
+		}
+		else if (m_nextUnusedSpanIndex < m_reservedSpanCount)
+		{
+			spanMemory = m_reservedMemory + m_nextUnusedSpanIndex * k_spanSize;
+			++m_nextUnusedSpanIndex;
+		}
+	}
+
+	if (!spanMemory)
+	{
+		return nullptr;
+	}
+
+	if (!committed)
+	{
+		const size_t pageSize = VirtualMemory::getPageSize();
+		const bool success = headerPageCommitted ?
+			VirtualMemory::commit(spanMemory + pageSize, k_spanSize - pageSize) :
+			VirtualMemory::commit(spanMemory, k_spanSize);
+
+		if (!success)
+		{
+			return nullptr;
+		}
+	}
+
+	Span *span = PLACEMENT_NEW(spanMemory) Span();
+	span->m_owner.store(cache, eastl::memory_order_relaxed);
+	span->m_sizeClass = sizeClass;
+	span->m_objectSize = getSizeClassObjectSize(sizeClass);
+	span->m_capacity = static_cast<uint32_t>((k_spanSize - k_spanHeaderSize) / span->m_objectSize);
+
+	return span;
+}
+
+void SmallObjectAllocator::releaseSpan(Span *span) noexcept
+{
+	assert(span->m_usedCount == 0);
+
+	{
+		LOCK_HOLDER(m_spanMutex);
+		if (m_committedFreeSpanCount < k_maxCommittedFreeSpans)
+		{
+			pushSpan(&m_committedFreeSpans, span);
+			++m_committedFreeSpanCount;
+			return;
+		}
+	}
+
+	// keep the first page committed: it holds the span header, which links the span into the free list
+	const size_t pageSize = VirtualMemory::getPageSize();
+	VirtualMemory::decommit(reinterpret_cast<char *>(span) + pageSize, k_spanSize - pageSize);
+
+	LOCK_HOLDER(m_spanMutex);
+	pushSpan(&m_decommittedFreeSpans, span);
+}
+
+SmallObjectAllocator::Span *SmallObjectAllocator::getSpan(const void *ptr) const noexcept
+{
+	assert(owns(ptr));
+	const size_t spanOffset = static_cast<size_t>(reinterpret_cast<const char *>(ptr) - m_reservedMemory) & ~(k_spanSize - 1);
+	return reinterpret_cast<Span *>(m_reservedMemory + spanOffset);
+}
+
+void SmallObjectAllocator::recordUsage(ThreadCache *cache, int64_t byteDelta, int64_t allocationCountDelta) noexcept
+{
+	const uint64_t newAllocationCount = allocationCountDelta > 0 ? 1 : 0;
+
+	if (!cache)
+	{
+		m_stats.update(byteDelta, allocationCountDelta, newAllocationCount);
+		return;
+	}
+
+	cache->m_pendingBytes += byteDelta;
+	cache->m_pendingAllocationCount += allocationCountDelta;
+	cache->m_pendingNewAllocationCount += newAllocationCount;
+
+	if (++cache->m_pendingUpdateCount >= k_usageFlushInterval)
+	{
+		flushUsage(cache);
+	}
+}
+
+void SmallObjectAllocator::flushUsage(ThreadCache *cache) noexcept
+{
+	m_stats.update(cache->m_pendingBytes, cache->m_pendingAllocationCount, cache->m_pendingNewAllocationCount);
+	cache->m_pendingBytes = 0;
+	cache->m_pendingAllocationCount = 0;
+	cache->m_pendingNewAllocationCount = 0;
+	cache->m_pendingUpdateCount = 0;
+}
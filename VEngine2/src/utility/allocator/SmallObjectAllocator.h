@@ -0,0 +1,63 @@
+#pragma once
+#include <stdint.h>
+#include "IAllocator.h"
+#include "AllocatorRegistry.h"
+#include "utility/SpinLock.h"
+
+/// <summary>
+/// Thread-safe size class allocator for allocations of up to k_maxSmallObjectSize bytes. Larger allocations are
+/// forwarded to the CRT heap.
+/// Memory is carved out of fixed size spans inside a single virtual address range reserved up front, so ownership
+/// of a pointer can be determined with a range check. Every thread owns a cache of spans per size class and allocates
+/// from these without any synchronization. Freeing memory owned by another thread pushes it onto a lock-free list in
+/// the owning span, which is collected by the owner once it runs out of free memory in its spans.
+/// Spans of exited threads are handed over to the next thread allocating from the same size class.
+/// </summary>
+class SmallObjectAllocator : public IAllocator
+{
+public:
+	static constexpr size_t k_maxSmallObjectSize = 1024 * 16;
+	static constexpr size_t k_sizeClassCount = 36;
+	static constexpr size_t k_spanSize = 1024 * 128;
+	static constexpr size_t k_reservedAddressSpaceSize = 1024ull * 1024ull * 1024ull * 64ull;
+
+	struct Span;
+	struct ThreadCache;
+
+	static SmallObjectAllocator *get() noexcept;
+
+	DELETED_COPY_MOVE(SmallObjectAllocator);
+
+	// EASTL allocator interface:
+
+	void *allocate(size_t n, int flags = 0) noexcept override;
+	void *allocate(size_t n, size_t alignment, size_t offset, int flags = 0) noexcept override;
+	void  deallocate(void *p, size_t n) noexcept override;
+	const char *get_name() const noexcept override;
+	void set_name(const char *pName) noexcept override;
+	AllocatorStats *getStats() noexcept override;
+
+	bool owns(const void *ptr) const noexcept;
+	void releaseThreadCache() noexcept;
+
+private:
+	AllocatorStats m_stats;
+	char *m_reservedMemory = nullptr;
+	size_t m_reservedSpanCount = 0;
+	size_t m_nextUnusedSpanIndex = 0;
+	size_t m_committedFreeSpanCount = 0;
+	SpinLock m_spanMutex;
+	Span *m_committedFreeSpans = nullptr;
+	Span *m_decommittedFreeSpans = nullptr;
+	Span *m_abandonedSpans[k_sizeClassCount] = {};
+
+	explicit SmallObjectAllocator() noexcept;
+	ThreadCache *getThreadCache() noexcept;
+	void *allocateSmall(ThreadCache *cache, uint32_t sizeClass) noexcept;
+	void deallocateSmall(void *p) noexcept;
+	Span *acquireSpan(ThreadCache *cache, uint32_t sizeClass) noexcept;
+	void releaseSpan(Span *span) noexcept;
+	Span *getSpan(const void *ptr) const noexcept;
+	void recordUsage(ThreadCache *cache, int64_t byteDelta, int64_t allocationCountDelta) noexcept;
+	void flushUsage(ThreadCache *cache) noexcept;
+};
@@ -0,0 +1,555 @@
+#include "TLSFHeapAllocator.h"
+#include <stddef.h>
+#include <assert.h>
+#include "utility/Utility.h"
+#include "utility/VirtualMemory.h"
+#include "AllocationTrace.h"
+
+static constexpr size_t k_alignment = 16;
+static constexpr size_t k_blockFreeBit = 1;
+static constexpr size_t k_prevBlockFreeBit = 2;
+static constexpr size_t k_blockFlagsMask = k_blockFreeBit | k_prevBlockFreeBit;
+
+struct TLSFHeapBlockHeader
+{
+	TLSFHeapBlockHeader *m_prevPhysical; // only valid if the previous block is free
+	size_t m_size; // size of the payload. the lowest two bits store whether this block and the previous block are free
+
+	// only valid if this block is free. these overlap the payload.
+	TLSFHeapBlockHeader *m_nextFree;
+	TLSFHeapBlockHeader *m_prevFree;
+};
+
+struct TLSFHeapPool
+{
+	TLSFHeapPool *m_next;
+	size_t m_size;
+};
+
+using BlockHeader = TLSFHeapBlockHeader;
+
+static constexpr size_t k_blockHeaderSize = offsetof(BlockHeader, m_nextFree);
+static constexpr size_t k_minBlockSize = sizeof(BlockHeader) - k_blockHeaderSize; // large enough for the free list links
+static constexpr size_t k_poolHeaderSize = 16;
+
+static_assert(k_blockHeaderSize == k_alignment);
+static_assert(sizeof(TLSFHeapPool) <= k_poolHeaderSize);
+
+static uint32_t findLastSetBit64(size_t value) noexcept
+{
+	const uint32_t high = static_cast<uint32_t>(static_cast<uint64_t>(value) >> 32);
+	return high ? 32 + util::findLastSetBit(high) : util::findLastSetBit(static_cast<uint32_t>(value));
+}
+
+static size_t getBlockSize(const BlockHeader *block) noexcept
+{
+	return block->m_size & ~k_blockFlagsMask;
+}
+
+static void setBlockSize(BlockHeader *block, size_t size) noexcept
+{
+	block->m_size = size | (block->m_size & k_blockFlagsMask);
+}
+
+static bool isBlockFree(const BlockHeader *block) noexcept
+{
+	return (block->m_size & k_blockFreeBit) != 0;
+}
+
+static void setBlockFree(BlockHeader *block, bool free) noexcept
+{
+	block->m_size = free ? (block->m_size | k_blockFreeBit) : (block->m_size & ~k_blockFreeBit);
+}
+
+static bool isPrevBlockFree(const BlockHeader *block) noexcept
+{
+	return (block->m_size & k_prevBlockFreeBit) != 0;
+}
+
+static void setPrevBlockFree(BlockHeader *block, bool free) noexcept
+{
+	block->m_size = free ? (block->m_size | k_prevBlockFreeBit) : (block->m_size & ~k_prevBlockFreeBit);
+}
+
+static char *getPayload(const BlockHeader *block) noexcept
+{
+	return reinterpret_cast<char *>(const_cast<BlockHeader *>(block)) + k_blockHeaderSize;
+}
+
+static BlockHeader *getBlockHeader(const void *ptr) noexcept
+{
+	// ptr may point a few bytes into the payload to satisfy an alignment offset
+	const size_t payload = util::alignDown(reinterpret_cast<size_t>(ptr), k_alignment);
+	return reinterpret_cast<BlockHeader *>(payload - k_blockHeaderSize);
+}
+
+static BlockHeader *getNextBlock(const BlockHeader *block) noexcept
+{
+	return reinterpret_cast<BlockHeader *>(getPayload(block) + getBlockSize(block));
+}
+
+static BlockHeader *linkNextBlock(BlockHeader *block) noexcept
+{
+	BlockHeader *next = getNextBlock(block);
+	next->m_prevPhysical = block;
+	return next;
+}
+
+static void markBlockFree(BlockHeader *block) noexcept
+{
+	BlockHeader *next = linkNextBlock(block);
+	setPrevBlockFree(next, true);
+	setBlockFree(block, true);
+}
+
+static void markBlockUsed(BlockHeader *block) noexcept
+{
+	BlockHeader *next = getNextBlock(block);
+	setPrevBlockFree(next, false);
+	setBlockFree(block, false);
+}
+
+// splits off everything past size bytes of the payload into a new free block, which is returned
+static BlockHeader *splitBlock(BlockHeader *block, size_t size) noexcept
+{
+	assert(getBlockSize(block) >= size + k_blockHeaderSize + k_minBlockSize);
+
+	BlockHeader *remaining = reinterpret_cast<BlockHeader *>(getPayload(block) + size);
+	remaining->m_prevPhysical = block;
+	remaining->m_size = getBlockSize(block) - size - k_blockHeaderSize;
+	setBlockSize(block, size);
+	markBlockFree(remaining);
+
+	return remaining;
+}
+
+// merges block into the physically preceding block
+static BlockHeader *absorbBlock(BlockHeader *prev, BlockHeader *block) noexcept
+{
+	setBlockSize(prev, getBlockSize(prev) + getBlockSize(block) + k_blockHeaderSize);
+	linkNextBlock(prev);
+	return prev;
+}
+
+void TLSFHeapAllocator::mappingInsert(size_t size, uint32_t &fl, uint32_t &sl) noexcept
+{
+	if (size < k_smallBlockSize)
+	{
+		// small blocks are stored in the first list, linearly subdivided
+		fl = 0;
+		sl = static_cast<uint32_t>(size / (k_smallBlockSize / k_slIndexCount));
+	}
+	else
+	{
+		const uint32_t log2 = findLastSetBit64(size);
+		sl = static_cast<uint32_t>(size >> (log2 - k_slIndexCountLog2)) ^ k_slIndexCount;
+		fl = log2 - (k_flIndexShift - 1);
+	}
+}
+
+void TLSFHeapAllocator::mappingSearch(size_t size, uint32_t &fl, uint32_t &sl) noexcept
+{
+	mappingInsert(roundUpToSizeClass(size), fl, sl);
+}
+
+size_t TLSFHeapAllocator::roundUpToSizeClass(size_t size) noexcept
+{
+	if (size >= k_smallBlockSize)
+	{
+		const size_t round = size_t(1) << (findLastSetBit64(size) - k_slIndexCountLog2);
+		size = (size + round - 1) & ~(round - 1);
+	}
+	return size;
+}
+
+TLSFHeapAllocator::TLSFHeapAllocator(size_t poolSize, bool growable, bool threadSafe, const char *name) noexcept
+	:m_stats(name),
+	m_poolSize(poolSize),
+	m_growable(growable),
+	m_threadSafe(threadSafe)
+{
+	addPool(0);
+}
+
+TLSFHeapAllocator::~TLSFHeapAllocator() noexcept
+{
+	TLSFHeapPool *pool = m_pools;
+	while (pool)
+	{
+		TLSFHeapPool *next = pool->m_next;
+		VirtualMemory::release(pool, pool->m_size);
+		pool = next;
+	}
+}
+
+void *TLSFHeapAllocator::allocate(size_t n, int flags) noexcept
+{
+	if (m_threadSafe)
+	{
+		m_mutex.lock();
+	}
+
+	void *result = allocateInternal(n, k_alignment, 0);
+
+	if (m_threadSafe)
+	{
+		m_mutex.unlock();
+	}
+
+	AllocationTraceRecorder::recordAllocate(m_stats.getName(), result, n, 0);
+
+	return result;
+}
+
+void *TLSFHeapAllocator::allocate(size_t n, size_t alignment, size_t offset, int flags) noexcept
+{
+	if (m_threadSafe)
+	{
+		m_mutex.lock();
+	}
+
+	void *result = allocateInternal(n, alignment, offset);
+
+	if (m_threadSafe)
+	{
+		m_mutex.unlock();
+	}
+
+	AllocationTraceRecorder::recordAllocate(m_stats.getName(), result, n, alignment);
+
+	return result;
+}
+
+void TLSFHeapAllocator::deallocate(void *p, size_t n) noexcept
+{
+	if (!p)
+	{
+		return;
+	}
+
+	// record before the memory can be reused by another thread, so that the trace stays consistent
+	AllocationTraceRecorder::recordDeallocate(m_stats.getName(), p);
+
+	if (m_threadSafe)
+	{
+		m_mutex.lock();
+	}
+
+	deallocateInternal(p);
+
+	if (m_threadSafe)
+	{
+		m_mutex.unlock();
+	}
+}
+
+const char *TLSFHeapAllocator::get_name() const noexcept
+{
+	return m_stats.getName();
+}
+
+void TLSFHeapAllocator::set_name(const char *pName) noexcept
+{
+	m_stats.setName(pName);
+}
+
+AllocatorStats *TLSFHeapAllocator::getStats() noexcept
+{
+	return &m_stats;
+}
+
+size_t TLSFHeapAllocator::getAllocationSize(const void *ptr) const noexcept
+{
+	const BlockHeader *block = getBlockHeader(ptr);
+	assert(!isBlockFree(block));
+	return getBlockSize(block) - (reinterpret_cast<const char *>(ptr) - getPayload(block));
+}
+
+size_t TLSFHeapAllocator::getFreeSize() const noexcept
+{
+	return m_freeSize;
+}
+
+size_t TLSFHeapAllocator::getPoolCount() const noexcept
+{
+	return m_poolCount;
+}
+
+size_t TLSFHeapAllocator::getCommittedSize() const noexcept
+{
+	return m_committedSize;
+}
+
+bool TLSFHeapAllocator::checkIntegrity() const noexcept
+{
+	size_t freeSize = 0;
+
+	for (const TLSFHeapPool *pool = m_pools; pool; pool = pool->m_next)
+	{
+		const BlockHeader *block = reinterpret_cast<const BlockHeader *>(reinterpret_cast<const char *>(pool) + k_poolHeaderSize);
+		bool prevFree = false;
+
+		// the sentinel block at the end of each pool has a size of 0
+		while (getBlockSize(block) != 0)
+		{
+			const BlockHeader *next = getNextBlock(block);
+
+			if (isPrevBlockFree(block) != prevFree)
+			{
+				return false;
+			}
+
+			if (isBlockFree(block))
+			{
+				// free blocks are always coalesced
+				if (prevFree || isBlockFree(next) || next->m_prevPhysical != block)
+				{
+					return false;
+				}
+
+				uint32_t fl, sl;
+				mappingInsert(getBlockSize(block), fl, sl);
+				if ((m_flBitmap & (1u << fl)) == 0 || (m_slBitmaps[fl] & (1u << sl)) == 0)
+				{
+					return false;
+				}
+
+				freeSize += getBlockSize(block);
+			}
+
+			prevFree = isBlockFree(block);
+			block = next;
+		}
+
+		if (isPrevBlockFree(block) != prevFree)
+		{
+			return false;
+		}
+	}
+
+	return freeSize == m_freeSize;
+}
+
+void *TLSFHeapAllocator::allocateInternal(size_t n, size_t alignment, size_t offset) noexcept
+{
+	alignment = alignment < k_alignment ? k_alignment : alignment;
+
+	// blocks are always k_alignment aligned, so handle offsets that are not a multiple of it by returning a pointer
+	// a few bytes into the payload
+	const size_t misalignment = (k_alignment - offset % k_alignment) % k_alignment;
+	offset += misalignment;
+	n += misalignment;
+
+	size_t size = util::alignUp(n < k_minBlockSize ? k_minBlockSize : n, k_alignment);
+
+	// over-aligned allocations need room for a free block in front of the aligned payload
+	const bool needsPadding = alignment > k_alignment;
+	const size_t searchSize = needsPadding ? size + alignment + k_blockHeaderSize + k_minBlockSize : size;
+
+	if (searchSize >= (size_t(1) << k_flIndexMax))
+	{
+		return nullptr;
+	}
+
+	BlockHeader *block = findFreeBlock(searchSize);
+
+	// the new pool must hold a block of the size class searched by findFreeBlock(), which can be larger than searchSize
+	if (!block && m_growable && addPool(roundUpToSizeClass(searchSize)))
+	{
+		block = findFreeBlock(searchSize);
+	}
+
+	if (!block)
+	{
+		return nullptr;
+	}
+
+	assert(getBlockSize(block) >= searchSize);
+	removeFreeBlock(block);
+
+	if (needsPadding)
+	{
+		char *payload = getPayload(block);
+		size_t gap = util::alignPow2Up(reinterpret_cast<size_t>(payload) + offset, alignment) - offset - reinterpret_cast<size_t>(payload);
+
+		// the gap must be large enough to hold a free block
+		if (gap != 0 && gap < k_blockHeaderSize + k_minBlockSize)
+		{
+			gap = util::alignPow2Up(reinterpret_cast<size_t>(payload) + offset + k_blockHeaderSize + k_minBlockSize, alignment) - offset - reinterpret_cast<size_t>(payload);
+		}
+
+		if (gap != 0)
+		{
+			BlockHeader *alignedBlock = splitBlock(block, gap - k_blockHeaderSize);
+			setPrevBlockFree(alignedBlock, true);
+			insertFreeBlock(block);
+			block = alignedBlock;
+		}
+	}
+
+	// return the unused end of the block to the heap
+	if (getBlockSize(block) >= size + k_blockHeaderSize + k_minBlockSize)
+	{
+		BlockHeader *remaining = splitBlock(block, size);
+		setPrevBlockFree(remaining, true);
+		insertFreeBlock(remaining);
+	}
+
+	markBlockUsed(block);
+	m_stats.onAllocate(getBlockSize(block));
+
+	return getPayload(block) + misalignment;
+}
+
+void TLSFHeapAllocator::deallocateInternal(void *p) noexcept
+{
+	BlockHeader *block = getBlockHeader(p);
+	assert(!isBlockFree(block));
+
+	m_stats.onDeallocate(getBlockSize(block));
+
+	markBlockFree(block);
+
+	// coalesce with free neighbors
+	if (isPrevBlockFree(block))
+	{
+		BlockHeader *prev = block->m_prevPhysical;
+		assert(isBlockFree(prev));
+		removeFreeBlock(prev);
+		block = absorbBlock(prev, block);
+	}
+
+	BlockHeader *next = getNextBlock(block);
+	if (isBlockFree(next))
+	{
+		removeFreeBlock(next);
+		block = absorbBlock(block, next);
+	}
+
+	insertFreeBlock(block);
+}
+
+bool TLSFHeapAllocator::addPool(size_t minBlockSize) noexcept
+{
+	const size_t overhead = k_poolHeaderSize + 2 * k_blockHeaderSize; // pool header, first block header and sentinel
+	size_t poolSize = minBlockSize + overhead > m_poolSize ? minBlockSize + overhead : m_poolSize;
+	poolSize = util::alignUp(poolSize, VirtualMemory::getAllocationGranularity());
+
+	// the largest block must fit into the mapping
+	const size_t maxPoolSize = (size_t(1) << k_flIndexMax) - 1;
+	if (poolSize - overhead > maxPoolSize)
+	{
+		return false;
+	}
+
+	char *memory = reinterpret_cast<char *>(VirtualMemory::reserve(poolSize));
+	if (!memory)
+	{
+		return false;
+	}
+
+	if (!VirtualMemory::commit(memory, poolSize))
+	{
+		VirtualMemory::release(memory, poolSize);
+		return false;
+	}
+
+	TLSFHeapPool *pool = reinterpret_cast<TLSFHeapPool *>(memory);
+	pool->m_next = m_pools;
+	pool->m_size = poolSize;
+	m_pools = pool;
+	++m_poolCount;
+	m_committedSize += poolSize;
+
+	// a single free block spanning the whole pool, followed by a used sentinel block of size 0
+	BlockHeader *block = reinterpret_cast<BlockHeader *>(memory + k_poolHeaderSize);
+	block->m_prevPhysical = nullptr;
+	block->m_size = poolSize - overhead;
+	markBlockFree(block);
+
+	BlockHeader *sentinel = getNextBlock(block);
+	sentinel->m_size = 0;
+	setPrevBlockFree(sentinel, true);
+
+	insertFreeBlock(block);
+
+	return true;
+}
+
+BlockHeader *TLSFHeapAllocator::findFreeBlock(size_t size) noexcept
+{
+	uint32_t fl, sl;
+	mappingSearch(size, fl, sl);
+
+	if (fl >= k_flIndexCount)
+	{
+		return nullptr;
+	}
+
+	// look for a non-empty list in the same first level, then in any larger first level
+	uint32_t slBitmap = m_slBitmaps[fl] & (~0u << sl);
+	if (!slBitmap)
+	{
+		const uint32_t flBitmap = (fl + 1) < 32 ? (m_flBitmap & (~0u << (fl + 1))) : 0;
+		if (!flBitmap)
+		{
+			return nullptr;
+		}
+
+		fl = util::findFirstSetBit(flBitmap);
+		slBitmap = m_slBitmaps[fl];
+	}
+
+	sl = util::findFirstSetBit(slBitmap);
+	return m_freeBlocks[fl][sl];
+}
+
+void TLSFHeapAllocator::insertFreeBlock(BlockHeader *block) noexcept
+{
+	uint32_t fl, sl;
+	mappingInsert(getBlockSize(block), fl, sl);
+
+	BlockHeader *head = m_freeBlocks[fl][sl];
+	block->m_nextFree = head;
+	block->m_prevFree = nullptr;
+	if (head)
+	{
+		head->m_prevFree = block;
+	}
+
+	m_freeBlocks[fl][sl] = block;
+	m_flBitmap |= 1u << fl;
+	m_slBitmaps[fl] |= 1u << sl;
+	m_freeSize += getBlockSize(block);
+}
+
+void TLSFHeapAllocator::removeFreeBlock(BlockHeader *block) noexcept
+{
+	uint32_t fl, sl;
+	mappingInsert(getBlockSize(block), fl, sl);
+
+	if (block->m_prevFree)
+	{
+		block->m_prevFree->m_nextFree = block->m_nextFree;
+	}
+	if (block->m_nextFree)
+	{
+		block->m_nextFree->m_prevFree = block->m_prevFree;
+	}
+
+	if (m_freeBlocks[fl][sl] == block)
+	{
+		m_freeBlocks[fl][sl] = block->m_nextFree;
+
+		if (!block->m_nextFree)
+		{
+			m_slBitmaps[fl] &= ~(1u << sl);
+			if (!m_slBitmaps[fl])
+			{
+				m_flBitmap &= ~(1u << fl);
+			}
+		}
+	}
+
+	m_freeSize -= getBlockSize(block);
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <stdint.h>
+#include "IAllocator.h"
+#include "AllocatorRegistry.h"
+#include "utility/SpinLock.h"
+
+struct TLSFHeapBlockHeader;
+struct TLSFHeapPool;
+
+/// <summary>
+/// General purpose heap based on the two-level segregated fit algorithm. Allocating and freeing run in constant time
+/// and fragmentation is bounded, which makes it suitable for variable sized allocations with deterministic latency.
+/// Unlike TLSFAllocator, all bookkeeping data lives in block headers inside the managed memory.
+/// Memory is requested from the OS in pools of at least poolSize bytes. A growable heap adds another pool once it runs
+/// out of memory, otherwise allocations fail.
+/// </summary>
+class TLSFHeapAllocator : public IAllocator
+{
+public:
+	explicit TLSFHeapAllocator(size_t poolSize, bool growable, bool threadSafe, const char *name = nullptr) noexcept;
+	DELETED_COPY_MOVE(TLSFHeapAllocator);
+	~TLSFHeapAllocator() noexcept;
+
+	// EASTL allocator interface:
+
+	void *allocate(size_t n, int flags = 0) noexcept override;
+	void *allocate(size_t n, size_t alignment, size_t offset, int flags = 0) noexcept override;
+	void  deallocate(void *p, size_t n) noexcept override;
+	const char *get_name() const noexcept override;
+	void set_name(const char *pName) noexcept override;
+	AllocatorStats *getStats() noexcept override;
+
+	// Returns the number of bytes usable through ptr, which may be more than were requested.
+	size_t getAllocationSize(const void *ptr) const noexcept;
+	size_t getFreeSize() const noexcept;
+	size_t getPoolCount() const noexcept;
+	size_t getCommittedSize() const noexcept;
+	// Walks all blocks and validates the heap. Only meant for debugging.
+	bool checkIntegrity() const noexcept;
+
+private:
+	static constexpr uint32_t k_slIndexCountLog2 = 5;
+	static constexpr uint32_t k_slIndexCount = 1u << k_slIndexCountLog2;
+	static constexpr uint32_t k_alignmentLog2 = 4;
+	static constexpr uint32_t k_flIndexShift = k_slIndexCountLog2 + k_alignmentLog2;
+	static constexpr uint32_t k_flIndexMax = 40;
+	static constexpr uint32_t k_flIndexCount = k_flIndexMax - k_flIndexShift + 1;
+	static constexpr size_t k_smallBlockSize = size_t(1) << k_flIndexShift;
+
+	AllocatorStats m_stats;
+	SpinLock m_mutex;
+	size_t m_poolSize;
+	size_t m_freeSize = 0;
+	size_t m_poolCount = 0;
+	size_t m_committedSize = 0;
+	TLSFHeapPool *m_pools = nullptr;
+	uint32_t m_flBitmap = 0;
+	uint32_t m_slBitmaps[k_flIndexCount] = {};
+	TLSFHeapBlockHeader *m_freeBlocks[k_flIndexCount][k_slIndexCount] = {};
+	bool m_growable;
+	bool m_threadSafe;
+
+	// returns indices of the list holding free blocks in the same size class as size. used for inserting free blocks
+	static void mappingInsert(size_t size, uint32_t &fl, uint32_t &sl) noexcept;
+	// returns indices of the list one size class above size, so that any block in it is large enough. used for allocating
+	static void mappingSearch(size_t size, uint32_t &fl, uint32_t &sl) noexcept;
+	// rounds size up to the smallest block size that is found by mappingSearch(size)
+	static size_t roundUpToSizeClass(size_t size) noexcept;
+	void *allocateInternal(size_t n, size_t alignment, size_t offset) noexcept;
+	void deallocateInternal(void *p) noexcept;
+	bool addPool(size_t minBlockSize) noexcept;
+	TLSFHeapBlockHeader *findFreeBlock(size_t size) noexcept;
+	void insertFreeBlock(TLSFHeapBlockHeader *block) noexcept;
+	void removeFreeBlock(TLSFHeapBlockHeader *block) noexcept;
+};
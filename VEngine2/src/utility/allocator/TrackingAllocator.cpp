@@ -0,0 +1,57 @@
+#include "TrackingAllocator.h"
+#include "AllocationTrace.h"
+
+TrackingAllocator::TrackingAllocator(IAllocator *allocator, const char *name, const char *subsystem) noexcept
+	:m_allocator(allocator),
+	m_stats(name, subsystem)
+{
+	assert(m_allocator);
+}
+
+void *TrackingAllocator::allocate(size_t n, int flags) noexcept
+{
+	void *result = m_allocator->allocate(n, flags);
+	if (result)
+	{
+		m_stats.onAllocate(n);
+		AllocationTraceRecorder::recordAllocate(m_stats.getName(), result, n, 0);
+	}
+	return result;
+}
+
+void *TrackingAllocator::allocate(size_t n, size_t alignment, size_t offset, int flags) noexcept
+{
+	void *result = m_allocator->allocate(n, alignment, offset, flags);
+	if (result)
+	{
+		m_stats.onAllocate(n);
+		AllocationTraceRecorder::recordAllocate(m_stats.getName(), result, n, alignment);
+	}
+	return result;
+}
+
+void TrackingAllocator::deallocate(void *p, size_t n) noexcept
+{
+	if (p)
+	{
+		// record before the memory can be reused by another thread, so that the trace stays consistent
+		AllocationTraceRecorder::recordDeallocate(m_stats.getName(), p);
+		m_stats.onDeallocate(n);
+		m_allocator->deallocate(p, n);
+	}
+}
+
+const char *TrackingAllocator::get_name() const noexcept
+{
+	return m_stats.getName();
+}
+
+void TrackingAllocator::set_name(const char *pName) noexcept
+{
+	m_stats.setName(pName);
+}
+
+AllocatorStats *TrackingAllocator::getStats() noexcept
+{
+	return &m_stats;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include "IAllocator.h"
+#include "AllocatorRegistry.h"
+
+/// <summary>
+/// Forwards to another allocator while tracking the usage under its own name and subsystem. Allows attributing memory
+/// of a shared allocator to the subsystem using it. Requires callers to pass the allocation size to deallocate().
+/// </summary>
+class TrackingAllocator : public IAllocator
+{
+public:
+	explicit TrackingAllocator(IAllocator *allocator, const char *name, const char *subsystem = nullptr) noexcept;
+	DELETED_COPY_MOVE(TrackingAllocator);
+	~TrackingAllocator() noexcept = default;
+
+	// EASTL allocator interface:
+
+	void *allocate(size_t n, int flags = 0) noexcept override;
+	void *allocate(size_t n, size_t alignment, size_t offset, int flags = 0) noexcept override;
+	void  deallocate(void *p, size_t n) noexcept override;
+	const char *get_name() const noexcept override;
+	void set_name(const char *pName) noexcept override;
+	AllocatorStats *getStats() noexcept override;
+
+private:
+	IAllocator *m_allocator;
+	AllocatorStats m_stats;
+};
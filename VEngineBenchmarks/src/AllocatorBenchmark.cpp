@@ -0,0 +1,1029 @@
+#include "AllocatorBenchmark.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <malloc.h>
+#include <chrono>
+#include <thread>
+#include <EASTL/unique_ptr.h>
+#include <EASTL/sort.h>
+#include <EASTL/atomic.h>
+#include "utility/allocator/AllocationTrace.h"
+#include "utility/allocator/SmallObjectAllocator.h"
+#include "utility/allocator/TLSFHeapAllocator.h"
+#include "utility/allocator/PoolAllocator.h"
+#include "utility/allocator/LinearAllocator.h"
+#include "utility/TLSFAllocator.h"
+#include "utility/SpinLock.h"
+#include "utility/Utility.h"
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr uint32_t k_maxThreads = 64;
+static constexpr double k_percentiles[] = { 0.5, 0.9, 0.99, 0.999, 1.0 };
+
+namespace
+{
+	class Random
+	{
+	public:
+		explicit Random(uint64_t seed) noexcept : m_state(seed * 0x9E3779B97F4A7C15ull + 1) {}
+
+		uint32_t next() noexcept
+		{
+			// xorshift64*
+			m_state ^= m_state >> 12;
+			m_state ^= m_state << 25;
+			m_state ^= m_state >> 27;
+			return static_cast<uint32_t>((m_state * 0x2545F4914F6CDD1Dull) >> 32);
+		}
+
+		uint32_t range(uint32_t minValue, uint32_t maxValue) noexcept
+		{
+			return minValue + next() % (maxValue - minValue + 1);
+		}
+
+	private:
+		uint64_t m_state;
+	};
+
+	// Generates the ops of a single thread. Slots are allocated from the shared slot count of the workload.
+	class ThreadOpBuilder
+	{
+	public:
+		explicit ThreadOpBuilder(AllocatorBenchmarkWorkload &workload, eastl::vector<AllocatorBenchmarkOp> &ops) noexcept
+			:m_workload(workload),
+			m_ops(ops)
+		{
+		}
+
+		uint32_t allocate(uint32_t size, uint32_t alignmentLog2 = 0) noexcept
+		{
+			uint32_t slot;
+			if (!m_freeSlots.empty())
+			{
+				slot = m_freeSlots.back();
+				m_freeSlots.pop_back();
+			}
+			else
+			{
+				slot = m_workload.m_slotCount++;
+			}
+
+			m_ops.push_back({ size, slot, static_cast<uint8_t>(alignmentLog2), AllocatorBenchmarkOp::ALLOCATE });
+			m_liveSlots.push_back(slot);
+			m_liveSizes.push_back(size);
+			return slot;
+		}
+
+		// frees the live allocation at the given index of the live list
+		void deallocate(size_t liveIndex) noexcept
+		{
+			const uint32_t slot = m_liveSlots[liveIndex];
+			m_ops.push_back({ m_liveSizes[liveIndex], slot, 0, AllocatorBenchmarkOp::DEALLOCATE });
+			m_freeSlots.push_back(slot);
+
+			m_liveSlots[liveIndex] = m_liveSlots.back();
+			m_liveSlots.pop_back();
+			m_liveSizes[liveIndex] = m_liveSizes.back();
+			m_liveSizes.pop_back();
+		}
+
+		void deallocateAll() noexcept
+		{
+			while (!m_liveSlots.empty())
+			{
+				deallocate(m_liveSlots.size() - 1);
+			}
+		}
+
+		void endFrame() noexcept
+		{
+			m_ops.push_back({ 0, 0, 0, AllocatorBenchmarkOp::FRAME });
+		}
+
+		size_t getLiveCount() const noexcept
+		{
+			return m_liveSlots.size();
+		}
+
+		// moves the live allocations out of the builder, so that another thread can free them
+		void takeLiveAllocations(eastl::vector<uint32_t> &slots, eastl::vector<uint32_t> &sizes) noexcept
+		{
+			slots = eastl::move(m_liveSlots);
+			sizes = eastl::move(m_liveSizes);
+			m_liveSlots.clear();
+			m_liveSizes.clear();
+		}
+
+	private:
+		AllocatorBenchmarkWorkload &m_workload;
+		eastl::vector<AllocatorBenchmarkOp> &m_ops;
+		eastl::vector<uint32_t> m_freeSlots;
+		eastl::vector<uint32_t> m_liveSlots;
+		eastl::vector<uint32_t> m_liveSizes;
+	};
+
+	// Common interface for all benchmarked allocators. Allocators that are not thread-safe are protected by a lock when
+	// the workload uses multiple threads.
+	class BenchmarkAllocator
+	{
+	public:
+		explicit BenchmarkAllocator(bool threadSafe) noexcept
+			:m_threadSafe(threadSafe)
+		{
+		}
+
+		virtual ~BenchmarkAllocator() noexcept = default;
+
+		void setMultiThreaded(bool multiThreaded) noexcept
+		{
+			m_needsLock = multiThreaded && !m_threadSafe;
+		}
+
+		void *allocate(uint32_t threadIndex, size_t size, size_t alignment) noexcept
+		{
+			if (m_needsLock)
+			{
+				m_mutex.lock();
+			}
+			void *result = allocateImpl(threadIndex, size, alignment);
+			if (m_needsLock)
+			{
+				m_mutex.unlock();
+			}
+			return result;
+		}
+
+		void deallocate(uint32_t threadIndex, void *ptr, size_t size) noexcept
+		{
+			if (m_needsLock)
+			{
+				m_mutex.lock();
+			}
+			deallocateImpl(threadIndex, ptr, size);
+			if (m_needsLock)
+			{
+				m_mutex.unlock();
+			}
+		}
+
+		virtual void endFrame(uint32_t threadIndex) noexcept {}
+		// Returns the number of bytes the allocator occupies or 0 if it can not be determined.
+		virtual size_t getFootprint() const noexcept { return 0; }
+
+	protected:
+		virtual void *allocateImpl(uint32_t threadIndex, size_t size, size_t alignment) noexcept = 0;
+		virtual void deallocateImpl(uint32_t threadIndex, void *ptr, size_t size) noexcept = 0;
+
+	private:
+		SpinLock m_mutex;
+		bool m_threadSafe;
+		bool m_needsLock = false;
+	};
+
+	class SystemHeapBenchmarkAllocator : public BenchmarkAllocator
+	{
+	public:
+		explicit SystemHeapBenchmarkAllocator() noexcept : BenchmarkAllocator(true) {}
+
+	protected:
+		void *allocateImpl(uint32_t threadIndex, size_t size, size_t alignment) noexcept override
+		{
+			return _aligned_malloc(size ? size : 1, alignment < 16 ? 16 : alignment);
+		}
+
+		void deallocateImpl(uint32_t threadIndex, void *ptr, size_t size) noexcept override
+		{
+			_aligned_free(ptr);
+		}
+	};
+
+	class SmallObjectBenchmarkAllocator : public BenchmarkAllocator
+	{
+	public:
+		explicit SmallObjectBenchmarkAllocator() noexcept : BenchmarkAllocator(true) {}
+
+	protected:
+		void *allocateImpl(uint32_t threadIndex, size_t size, size_t alignment) noexcept override
+		{
+			return alignment ? SmallObjectAllocator::get()->allocate(size, alignment, 0) : SmallObjectAllocator::get()->allocate(size);
+		}
+
+		void deallocateImpl(uint32_t threadIndex, void *ptr, size_t size) noexcept override
+		{
+			SmallObjectAllocator::get()->deallocate(ptr, size);
+		}
+	};
+
+	class TLSFHeapBenchmarkAllocator : public BenchmarkAllocator
+	{
+	public:
+		explicit TLSFHeapBenchmarkAllocator(bool threadSafe) noexcept
+			:BenchmarkAllocator(true),
+			m_allocator(4 * 1024 * 1024, true, threadSafe, "Benchmark TLSFHeapAllocator")
+		{
+		}
+
+		size_t getFootprint() const noexcept override
+		{
+			return m_allocator.getCommittedSize();
+		}
+
+	protected:
+		void *allocateImpl(uint32_t threadIndex, size_t size, size_t alignment) noexcept override
+		{
+			return alignment ? m_allocator.allocate(size, alignment, 0) : m_allocator.allocate(size);
+		}
+
+		void deallocateImpl(uint32_t threadIndex, void *ptr, size_t size) noexcept override
+		{
+			m_allocator.deallocate(ptr, size);
+		}
+
+	private:
+		TLSFHeapAllocator m_allocator;
+	};
+
+	// TLSFAllocator manages offsets instead of memory, so the returned handle is its span and the footprint is the
+	// highest offset ever used.
+	class TLSFOffsetBenchmarkAllocator : public BenchmarkAllocator
+	{
+	public:
+		static constexpr uint32_t k_memorySize = 0xC0000000u;
+
+		explicit TLSFOffsetBenchmarkAllocator() noexcept
+			:BenchmarkAllocator(false),
+			m_allocator(k_memorySize, 1, "Benchmark TLSFAllocator")
+		{
+		}
+
+		size_t getFootprint() const noexcept override
+		{
+			return m_highWaterMark;
+		}
+
+	protected:
+		void *allocateImpl(uint32_t threadIndex, size_t size, size_t alignment) noexcept override
+		{
+			uint32_t offset = 0;
+			void *span = nullptr;
+			if (!m_allocator.alloc(static_cast<uint32_t>(size ? size : 1), static_cast<uint32_t>(alignment ? alignment : 16), offset, span))
+			{
+				return nullptr;
+			}
+			m_highWaterMark = offset + size > m_highWaterMark ? offset + size : m_highWaterMark;
+			return span;
+		}
+
+		void deallocateImpl(uint32_t threadIndex, void *ptr, size_t size) noexcept override
+		{
+			m_allocator.free(ptr);
+		}
+
+	private:
+		TLSFAllocator m_allocator;
+		size_t m_highWaterMark = 0;
+	};
+
+	class FixedPoolBenchmarkAllocator : public BenchmarkAllocator
+	{
+	public:
+		explicit FixedPoolBenchmarkAllocator(size_t elementSize, size_t elementCount) noexcept
+			:BenchmarkAllocator(false),
+			m_allocator(elementSize, elementCount, "Benchmark FixedPoolAllocator"),
+			m_footprint(elementSize * elementCount)
+		{
+		}
+
+		size_t getFootprint() const noexcept override
+		{
+			return m_footprint;
+		}
+
+	protected:
+		void *allocateImpl(uint32_t threadIndex, size_t size, size_t alignment) noexcept override
+		{
+			return m_allocator.allocate(size);
+		}
+
+		void deallocateImpl(uint32_t threadIndex, void *ptr, size_t size) noexcept override
+		{
+			m_allocator.deallocate(ptr, size);
+		}
+
+	private:
+		FixedPoolAllocator m_allocator;
+		size_t m_footprint;
+	};
+
+	class DynamicPoolBenchmarkAllocator : public BenchmarkAllocator
+	{
+	public:
+		explicit DynamicPoolBenchmarkAllocator(size_t elementSize) noexcept
+			:BenchmarkAllocator(false),
+			m_allocator(elementSize, 1024, "Benchmark DynamicPoolAllocator")
+		{
+		}
+
+	protected:
+		void *allocateImpl(uint32_t threadIndex, size_t size, size_t alignment) noexcept override
+		{
+			return m_allocator.allocate(size);
+		}
+
+		void deallocateImpl(uint32_t threadIndex, void *ptr, size_t size) noexcept override
+		{
+			m_allocator.deallocate(ptr, size);
+		}
+
+	private:
+		DynamicPoolAllocator m_allocator;
+	};
+
+	// One linear allocator per thread, which is reset at the end of every frame. Frees are ignored.
+	class LinearBenchmarkAllocator : public BenchmarkAllocator
+	{
+	public:
+		static constexpr size_t k_capacityPerThread = 1024ull * 1024ull * 1024ull;
+
+		explicit LinearBenchmarkAllocator(uint32_t threadCount) noexcept
+			:BenchmarkAllocator(true)
+		{
+			for (uint32_t i = 0; i < threadCount; ++i)
+			{
+				m_allocators.push_back(eastl::make_unique<VirtualLinearAllocator>(k_capacityPerThread, "Benchmark VirtualLinearAllocator"));
+			}
+		}
+
+		void endFrame(uint32_t threadIndex) noexcept override
+		{
+			m_allocators[threadIndex]->reset();
+		}
+
+		size_t getFootprint() const noexcept override
+		{
+			size_t footprint = 0;
+			for (const auto &allocator : m_allocators)
+			{
+				footprint += allocator->getCommittedSize();
+			}
+			return footprint;
+		}
+
+	protected:
+		void *allocateImpl(uint32_t threadIndex, size_t size, size_t alignment) noexcept override
+		{
+			return m_allocators[threadIndex]->allocate(size, alignment ? alignment : 16, 0);
+		}
+
+		void deallocateImpl(uint32_t threadIndex, void *ptr, size_t size) noexcept override
+		{
+		}
+
+	private:
+		eastl::vector<eastl::unique_ptr<VirtualLinearAllocator>> m_allocators;
+	};
+
+	// Pools serve every request with the same element size, so they are limited to workloads with small sizes.
+	static size_t getPoolElementSize(const AllocatorBenchmarkWorkload &workload) noexcept
+	{
+		if (workload.m_maxSize > 16 * 1024 || workload.m_maxAlignment > 16)
+		{
+			return 0;
+		}
+		return util::alignUp<size_t>(workload.m_maxSize < 8 ? 8 : workload.m_maxSize, 16);
+	}
+
+	static const char *const k_allocatorNames[] = { "System Heap", "SmallObjectAllocator", "TLSFHeapAllocator", "TLSFAllocator", "FixedPoolAllocator", "DynamicPoolAllocator", "VirtualLinearAllocator" };
+	static constexpr size_t k_allocatorCount = sizeof(k_allocatorNames) / sizeof(k_allocatorNames[0]);
+
+	// Returns nullptr if the allocator can not serve the workload.
+	static eastl::unique_ptr<BenchmarkAllocator> createAllocator(size_t index, const AllocatorBenchmarkWorkload &workload) noexcept
+	{
+		const bool multiThreaded = workload.m_threadCount > 1;
+		const size_t poolElementSize = getPoolElementSize(workload);
+
+		eastl::unique_ptr<BenchmarkAllocator> allocator;
+
+		switch (index)
+		{
+		case 0:
+			allocator = eastl::make_unique<SystemHeapBenchmarkAllocator>();
+			break;
+		case 1:
+			allocator = eastl::make_unique<SmallObjectBenchmarkAllocator>();
+			break;
+		case 2:
+			allocator = eastl::make_unique<TLSFHeapBenchmarkAllocator>(multiThreaded);
+			break;
+		case 3:
+			if (workload.m_maxSize < TLSFOffsetBenchmarkAllocator::k_memorySize / 4)
+			{
+				allocator = eastl::make_unique<TLSFOffsetBenchmarkAllocator>();
+			}
+			break;
+		case 4:
+			if (poolElementSize)
+			{
+				allocator = eastl::make_unique<FixedPoolBenchmarkAllocator>(poolElementSize, workload.m_peakLiveCount);
+			}
+			break;
+		case 5:
+			if (poolElementSize)
+			{
+				allocator = eastl::make_unique<DynamicPoolBenchmarkAllocator>(poolElementSize);
+			}
+			break;
+		case 6:
+			if (workload.m_frameScoped)
+			{
+				allocator = eastl::make_unique<LinearBenchmarkAllocator>(workload.m_threadCount);
+			}
+			break;
+		default:
+			assert(false);
+			break;
+		}
+
+		if (allocator)
+		{
+			allocator->setMultiThreaded(multiThreaded);
+		}
+
+		return allocator;
+	}
+
+	struct ThreadResult
+	{
+		uint64_t m_failedAllocationCount = 0;
+		eastl::vector<uint32_t> m_latenciesNs;
+	};
+
+	template<bool MEASURE_LATENCY>
+	static void runOps(BenchmarkAllocator *allocator, uint32_t threadIndex, const eastl::vector<AllocatorBenchmarkOp> &ops, void **slots, ThreadResult &result) noexcept
+	{
+		for (const auto &op : ops)
+		{
+			Clock::time_point start;
+			if (MEASURE_LATENCY)
+			{
+				start = Clock::now();
+			}
+
+			switch (op.m_type)
+			{
+			case AllocatorBenchmarkOp::ALLOCATE:
+			{
+				void *ptr = allocator->allocate(threadIndex, op.m_size, op.m_alignmentLog2 ? (size_t(1) << op.m_alignmentLog2) : 0);
+				slots[op.m_slot] = ptr;
+				result.m_failedAllocationCount += ptr ? 0 : 1;
+				break;
+			}
+			case AllocatorBenchmarkOp::DEALLOCATE:
+				if (slots[op.m_slot])
+				{
+					allocator->deallocate(threadIndex, slots[op.m_slot], op.m_size);
+					slots[op.m_slot] = nullptr;
+				}
+				break;
+			case AllocatorBenchmarkOp::FRAME:
+				allocator->endFrame(threadIndex);
+				continue;
+			default:
+				break;
+			}
+
+			if (MEASURE_LATENCY)
+			{
+				const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+				result.m_latenciesNs.push_back(static_cast<uint32_t>(ns < UINT32_MAX ? ns : UINT32_MAX));
+			}
+		}
+	}
+
+	// Runs all phases of the workload and returns the wall clock time spent in the phases.
+	template<bool MEASURE_LATENCY>
+	static double runWorkload(const AllocatorBenchmarkWorkload &workload, BenchmarkAllocator *allocator, eastl::vector<void *> &slots, eastl::vector<ThreadResult> &threadResults) noexcept
+	{
+		slots.clear();
+		slots.resize(workload.m_slotCount, nullptr);
+		threadResults.clear();
+		threadResults.resize(workload.m_threadCount);
+
+		double seconds = 0.0;
+
+		for (const auto &phase : workload.m_phases)
+		{
+			eastl::atomic<bool> go = false;
+			eastl::vector<std::thread> threads;
+
+			for (size_t t = 0; t < phase.size(); ++t)
+			{
+				if (MEASURE_LATENCY)
+				{
+					threadResults[t].m_latenciesNs.reserve(threadResults[t].m_latenciesNs.size() + phase[t].size());
+				}
+
+				threads.push_back(std::thread([&, t]()
+					{
+						while (!go.load(eastl::memory_order_acquire))
+						{
+							std::this_thread::yield();
+						}
+						runOps<MEASURE_LATENCY>(allocator, static_cast<uint32_t>(t), phase[t], slots.data(), threadResults[t]);
+					}));
+			}
+
+			const auto start = Clock::now();
+			go.store(true, eastl::memory_order_release);
+			for (auto &thread : threads)
+			{
+				thread.join();
+			}
+			seconds += std::chrono::duration<double>(Clock::now() - start).count();
+		}
+
+		return seconds;
+	}
+
+	// Frees whatever the workload left allocated, so that allocators can be destroyed safely.
+	static void freeRemainingAllocations(const AllocatorBenchmarkWorkload &workload, BenchmarkAllocator *allocator, eastl::vector<void *> &slots) noexcept
+	{
+		eastl::vector<uint32_t> slotSizes(workload.m_slotCount, 0);
+		for (const auto &phase : workload.m_phases)
+		{
+			for (const auto &ops : phase)
+			{
+				for (const auto &op : ops)
+				{
+					if (op.m_type == AllocatorBenchmarkOp::ALLOCATE)
+					{
+						slotSizes[op.m_slot] = op.m_size;
+					}
+				}
+			}
+		}
+
+		for (size_t i = 0; i < slots.size(); ++i)
+		{
+			if (slots[i])
+			{
+				allocator->deallocate(0, slots[i], slotSizes[i]);
+				slots[i] = nullptr;
+			}
+		}
+	}
+}
+
+void AllocatorBenchmarkWorkload::finalize() noexcept
+{
+	m_operationCount = 0;
+	m_threadCount = 0;
+	m_maxSize = 0;
+	m_maxAlignment = 0;
+	m_peakLiveBytes = 0;
+	m_peakLiveCount = 0;
+	m_frameScoped = true;
+	bool hasFrames = false;
+
+	constexpr uint32_t k_noOwner = UINT32_MAX;
+	eastl::vector<uint32_t> slotOwners(m_slotCount, k_noOwner);
+	size_t liveBytes = 0;
+	size_t liveCount = 0;
+
+	for (const auto &phase : m_phases)
+	{
+		assert(phase.size() <= k_maxThreads);
+		m_threadCount = phase.size() > m_threadCount ? static_cast<uint32_t>(phase.size()) : m_threadCount;
+
+		// threads may run in any order, so the peak of a phase is bounded by the sum of the peaks of its threads
+		size_t phasePeakBytes = liveBytes;
+		size_t phasePeakCount = liveCount;
+
+		for (size_t t = 0; t < phase.size(); ++t)
+		{
+			int64_t threadBytes = 0;
+			int64_t threadCount = 0;
+			int64_t threadPeakBytes = 0;
+			int64_t threadPeakCount = 0;
+			size_t liveInFrame = 0;
+
+			for (const auto &op : phase[t])
+			{
+				switch (op.m_type)
+				{
+				case AllocatorBenchmarkOp::ALLOCATE:
+					++m_operationCount;
+					m_maxSize = op.m_size > m_maxSize ? op.m_size : m_maxSize;
+					m_maxAlignment = (size_t(1) << op.m_alignmentLog2) > m_maxAlignment ? (size_t(1) << op.m_alignmentLog2) : m_maxAlignment;
+					threadBytes += op.m_size;
+					++threadCount;
+					slotOwners[op.m_slot] = static_cast<uint32_t>(t);
+					++liveInFrame;
+					break;
+				case AllocatorBenchmarkOp::DEALLOCATE:
+					++m_operationCount;
+					threadBytes -= op.m_size;
+					--threadCount;
+					// memory of a linear allocator may only be freed by the allocating thread in the same frame
+					if (slotOwners[op.m_slot] != t || liveInFrame == 0)
+					{
+						m_frameScoped = false;
+					}
+					else
+					{
+						--liveInFrame;
+					}
+					slotOwners[op.m_slot] = k_noOwner;
+					break;
+				case AllocatorBenchmarkOp::FRAME:
+					m_frameScoped = m_frameScoped && liveInFrame == 0;
+					hasFrames = true;
+					break;
+				default:
+					break;
+				}
+
+				threadPeakBytes = threadBytes > threadPeakBytes ? threadBytes : threadPeakBytes;
+				threadPeakCount = threadCount > threadPeakCount ? threadCount : threadPeakCount;
+			}
+
+			m_frameScoped = m_frameScoped && liveInFrame == 0;
+
+			phasePeakBytes += static_cast<size_t>(threadPeakBytes);
+			phasePeakCount += static_cast<size_t>(threadPeakCount);
+			liveBytes += threadBytes;
+			liveCount += threadCount;
+		}
+
+		m_peakLiveBytes = phasePeakBytes > m_peakLiveBytes ? phasePeakBytes : m_peakLiveBytes;
+		m_peakLiveCount = phasePeakCount > m_peakLiveCount ? phasePeakCount : m_peakLiveCount;
+	}
+
+	// without frames, a linear allocator would never be reset
+	m_frameScoped = m_frameScoped && hasFrames;
+}
+
+AllocatorBenchmarkWorkload AllocatorBenchmark::createSmallObjectChurnWorkload(uint32_t threadCount, uint32_t operationsPerThread) noexcept
+{
+	constexpr size_t k_targetLiveCount = 4096;
+
+	AllocatorBenchmarkWorkload workload;
+	workload.m_name = "small-object-churn";
+	workload.m_phases.resize(1);
+	workload.m_phases[0].resize(threadCount);
+
+	for (uint32_t t = 0; t < threadCount; ++t)
+	{
+		Random random(t + 1);
+		ThreadOpBuilder builder(workload, workload.m_phases[0][t]);
+
+		for (uint32_t i = 0; i < operationsPerThread; ++i)
+		{
+			const size_t liveCount = builder.getLiveCount();
+			if (liveCount < k_targetLiveCount / 2 || (liveCount < k_targetLiveCount && (random.next() & 1)))
+			{
+				builder.allocate(random.range(8, 256));
+			}
+			else
+			{
+				builder.deallocate(random.next() % liveCount);
+			}
+		}
+
+		builder.deallocateAll();
+	}
+
+	workload.finalize();
+	return workload;
+}
+
+AllocatorBenchmarkWorkload AllocatorBenchmark::createMixedSizeWorkload(uint32_t threadCount, uint32_t operationsPerThread) noexcept
+{
+	constexpr size_t k_targetLiveCount = 1024;
+
+	AllocatorBenchmarkWorkload workload;
+	workload.m_name = "mixed-sizes";
+	workload.m_phases.resize(1);
+	workload.m_phases[0].resize(threadCount);
+
+	for (uint32_t t = 0; t < threadCount; ++t)
+	{
+		Random random(t + 1001);
+		ThreadOpBuilder builder(workload, workload.m_phases[0][t]);
+
+		for (uint32_t i = 0; i < operationsPerThread; ++i)
+		{
+			const size_t liveCount = builder.getLiveCount();
+			if (liveCount < k_targetLiveCount / 2 || (liveCount < k_targetLiveCount && (random.next() & 1)))
+			{
+				// log-uniform sizes between 16 bytes and 256 KiB with occasional over-aligned requests
+				const uint32_t sizeClass = 16u << random.range(0, 14);
+				const uint32_t size = sizeClass + random.next() % sizeClass;
+				const uint32_t alignmentSelector = random.next() % 32;
+				builder.allocate(size, alignmentSelector == 0 ? 8 : alignmentSelector < 4 ? 6 : 0);
+			}
+			else
+			{
+				builder.deallocate(random.next() % liveCount);
+			}
+		}
+
+		builder.deallocateAll();
+	}
+
+	workload.finalize();
+	return workload;
+}
+
+AllocatorBenchmarkWorkload AllocatorBenchmark::createFrameWorkload(uint32_t threadCount, uint32_t frameCount) noexcept
+{
+	AllocatorBenchmarkWorkload workload;
+	workload.m_name = "frame-scoped";
+	workload.m_phases.resize(1);
+	workload.m_phases[0].resize(threadCount);
+
+	for (uint32_t t = 0; t < threadCount; ++t)
+	{
+		Random random(t + 2001);
+		ThreadOpBuilder builder(workload, workload.m_phases[0][t]);
+
+		for (uint32_t frame = 0; frame < frameCount; ++frame)
+		{
+			const uint32_t allocationCount = random.range(500, 1500);
+			for (uint32_t i = 0; i < allocationCount; ++i)
+			{
+				builder.allocate(random.range(16, 4096));
+			}
+
+			// temporary memory is mostly released in random order at the end of the frame
+			while (builder.getLiveCount() > 0)
+			{
+				builder.deallocate(random.next() % builder.getLiveCount());
+			}
+
+			builder.endFrame();
+		}
+	}
+
+	workload.finalize();
+	return workload;
+}
+
+AllocatorBenchmarkWorkload AllocatorBenchmark::createCrossThreadWorkload(uint32_t threadCount, uint32_t allocationsPerThread) noexcept
+{
+	AllocatorBenchmarkWorkload workload;
+	workload.m_name = "cross-thread-free";
+	workload.m_phases.resize(2);
+	workload.m_phases[0].resize(threadCount);
+	workload.m_phases[1].resize(threadCount);
+
+	// every thread allocates in the first phase and frees the allocations of its neighbor in the second
+	eastl::vector<eastl::vector<uint32_t>> slots(threadCount);
+	eastl::vector<eastl::vector<uint32_t>> sizes(threadCount);
+
+	for (uint32_t t = 0; t < threadCount; ++t)
+	{
+		Random random(t + 3001);
+		ThreadOpBuilder builder(workload, workload.m_phases[0][t]);
+
+		for (uint32_t i = 0; i < allocationsPerThread; ++i)
+		{
+			builder.allocate(random.range(16, 1024));
+		}
+
+		builder.takeLiveAllocations(slots[t], sizes[t]);
+	}
+
+	for (uint32_t t = 0; t < threadCount; ++t)
+	{
+		const uint32_t owner = (t + 1) % threadCount;
+		auto &ops = workload.m_phases[1][t];
+		for (size_t i = 0; i < slots[owner].size(); ++i)
+		{
+			ops.push_back({ sizes[owner][i], slots[owner][i], 0, AllocatorBenchmarkOp::DEALLOCATE });
+		}
+	}
+
+	workload.finalize();
+	return workload;
+}
+
+AllocatorBenchmarkWorkload AllocatorBenchmark::createTraceWorkload(const AllocationTrace &trace, const char *name, const char *source) noexcept
+{
+	AllocatorBenchmarkWorkload workload;
+	workload.m_name = name;
+	workload.m_phases.resize(1);
+	workload.m_phases[0].resize(1);
+
+	// events of all threads are replayed on a single thread, since cross-thread frees are only ordered in the recorded sequence
+	auto &ops = workload.m_phases[0][0];
+
+	uint32_t sourceIndex = UINT32_MAX;
+	if (source)
+	{
+		const auto &sourceNames = trace.getSourceNames();
+		for (size_t i = 0; i < sourceNames.size(); ++i)
+		{
+			if (sourceNames[i] == source)
+			{
+				sourceIndex = static_cast<uint32_t>(i);
+			}
+		}
+	}
+
+	eastl::vector<uint32_t> sizes;
+
+	for (const auto &event : trace.getEvents())
+	{
+		if (event.m_type != AllocationTraceEvent::FRAME && source && event.m_sourceIndex != sourceIndex)
+		{
+			continue;
+		}
+
+		switch (event.m_type)
+		{
+		case AllocationTraceEvent::ALLOCATE:
+		{
+			const uint32_t size = static_cast<uint32_t>(event.m_size < UINT32_MAX ? event.m_size : UINT32_MAX);
+			if (event.m_allocationID >= sizes.size())
+			{
+				sizes.resize(event.m_allocationID + 1, 0);
+			}
+			sizes[event.m_allocationID] = size;
+			ops.push_back({ size, event.m_allocationID, event.m_alignmentLog2, AllocatorBenchmarkOp::ALLOCATE });
+			break;
+		}
+		case AllocationTraceEvent::DEALLOCATE:
+			ops.push_back({ sizes[event.m_allocationID], event.m_allocationID, 0, AllocatorBenchmarkOp::DEALLOCATE });
+			break;
+		case AllocationTraceEvent::FRAME:
+			ops.push_back({ 0, 0, 0, AllocatorBenchmarkOp::FRAME });
+			break;
+		default:
+			break;
+		}
+	}
+
+	workload.m_slotCount = static_cast<uint32_t>(sizes.size());
+	workload.finalize();
+	return workload;
+}
+
+eastl::vector<AllocatorBenchmarkResult> AllocatorBenchmark::run(const AllocatorBenchmarkWorkload &workload, uint32_t repetitions) noexcept
+{
+	eastl::vector<AllocatorBenchmarkResult> results;
+	eastl::vector<void *> slots;
+	eastl::vector<ThreadResult> threadResults;
+
+	for (size_t i = 0; i < k_allocatorCount; ++i)
+	{
+		AllocatorBenchmarkResult result{};
+		result.m_allocatorName = k_allocatorNames[i];
+		result.m_supported = createAllocator(i, workload) != nullptr;
+		result.m_fragmentation = -1.0f;
+
+		if (!result.m_supported)
+		{
+			results.push_back(result);
+			continue;
+		}
+
+		// throughput is measured without per-operation timing. every repetition starts with a fresh allocator
+		double bestSeconds = 0.0;
+		for (uint32_t r = 0; r < repetitions; ++r)
+		{
+			auto allocator = createAllocator(i, workload);
+
+			const double seconds = runWorkload<false>(workload, allocator.get(), slots, threadResults);
+			bestSeconds = (r == 0 || seconds < bestSeconds) ? seconds : bestSeconds;
+
+			result.m_failedAllocationCount = 0;
+			for (const auto &threadResult : threadResults)
+			{
+				result.m_failedAllocationCount += threadResult.m_failedAllocationCount;
+			}
+
+			// allocators never return memory to the OS during a run, so the final footprint is the peak footprint
+			result.m_footprintBytes = allocator->getFootprint();
+			freeRemainingAllocations(workload, allocator.get(), slots);
+		}
+		result.m_operationsPerSecond = bestSeconds > 0.0 ? workload.m_operationCount / bestSeconds : 0.0;
+
+		if (result.m_footprintBytes != 0)
+		{
+			const float fragmentation = 1.0f - static_cast<float>(static_cast<double>(workload.m_peakLiveBytes) / result.m_footprintBytes);
+			result.m_fragmentation = fragmentation > 0.0f ? fragmentation : 0.0f;
+		}
+
+		// latency pass
+		{
+			auto allocator = createAllocator(i, workload);
+
+			runWorkload<true>(workload, allocator.get(), slots, threadResults);
+			freeRemainingAllocations(workload, allocator.get(), slots);
+
+			eastl::vector<uint32_t> latencies;
+			for (const auto &threadResult : threadResults)
+			{
+				latencies.insert(latencies.end(), threadResult.m_latenciesNs.begin(), threadResult.m_latenciesNs.end());
+			}
+
+			if (!latencies.empty())
+			{
+				eastl::sort(latencies.begin(), latencies.end());
+				for (size_t p = 0; p < sizeof(k_percentiles) / sizeof(k_percentiles[0]); ++p)
+				{
+					const size_t index = static_cast<size_t>(k_percentiles[p] * (latencies.size() - 1));
+					result.m_latencyPercentilesNs[p] = latencies[index];
+				}
+			}
+		}
+
+		results.push_back(result);
+	}
+
+	return results;
+}
+
+void AllocatorBenchmark::printResults(const AllocatorBenchmarkWorkload &workload, const eastl::vector<AllocatorBenchmarkResult> &results) noexcept
+{
+	printf("\n%s: %u thread(s), %llu operations, peak live %.2f MiB in %llu allocations, max size %llu bytes\n",
+		workload.m_name.c_str(),
+		workload.m_threadCount,
+		(unsigned long long)workload.m_operationCount,
+		workload.m_peakLiveBytes / (1024.0 * 1024.0),
+		(unsigned long long)workload.m_peakLiveCount,
+		(unsigned long long)workload.m_maxSize);
+
+	printf("%-24s %10s %9s %9s %9s %9s %11s %9s %14s %14s\n", "Allocator", "Mops/s", "p50 ns", "p90 ns", "p99 ns", "p99.9 ns", "max ns", "failed", "footprint MiB", "fragmentation");
+
+	for (const auto &result : results)
+	{
+		if (!result.m_supported)
+		{
+			printf("%-24s %10s\n", result.m_allocatorName.c_str(), "unsupported");
+			continue;
+		}
+
+		char footprint[32] = "n/a";
+		char fragmentation[32] = "n/a";
+		if (result.m_footprintBytes != 0)
+		{
+			snprintf(footprint, sizeof(footprint), "%.2f", result.m_footprintBytes / (1024.0 * 1024.0));
+			snprintf(fragmentation, sizeof(fragmentation), "%.1f%%", result.m_fragmentation * 100.0f);
+		}
+
+		printf("%-24s %10.2f %9.0f %9.0f %9.0f %9.0f %11.0f %9llu %14s %14s\n",
+			result.m_allocatorName.c_str(),
+			result.m_operationsPerSecond / 1e6,
+			result.m_latencyPercentilesNs[0],
+			result.m_latencyPercentilesNs[1],
+			result.m_latencyPercentilesNs[2],
+			result.m_latencyPercentilesNs[3],
+			result.m_latencyPercentilesNs[4],
+			(unsigned long long)result.m_failedAllocationCount,
+			footprint,
+			fragmentation);
+	}
+}
+
+bool AllocatorBenchmark::writeResultsCSV(const char *path, const eastl::vector<AllocatorBenchmarkWorkload> &workloads, const eastl::vector<eastl::vector<AllocatorBenchmarkResult>> &results) noexcept
+{
+	FILE *file = nullptr;
+	if (fopen_s(&file, path, "w") != 0 || !file)
+	{
+		printf("Failed to open \"%s\" for writing!\n", path);
+		return false;
+	}
+
+	fprintf(file, "workload,threads,operations,peak_live_bytes,allocator,supported,ops_per_second,p50_ns,p90_ns,p99_ns,p999_ns,max_ns,failed_allocations,footprint_bytes,fragmentation\n");
+
+	for (size_t w = 0; w < workloads.size(); ++w)
+	{
+		const auto &workload = workloads[w];
+		for (const auto &result : results[w])
+		{
+			fprintf(file, "%s,%u,%llu,%llu,%s,%d,%.0f,%.0f,%.0f,%.0f,%.0f,%.0f,%llu,%llu,%.4f\n",
+				workload.m_name.c_str(),
+				workload.m_threadCount,
+				(unsigned long long)workload.m_operationCount,
+				(unsigned long long)workload.m_peakLiveBytes,
+				result.m_allocatorName.c_str(),
+				result.m_supported ? 1 : 0,
+				result.m_operationsPerSecond,
+				result.m_latencyPercentilesNs[0],
+				result.m_latencyPercentilesNs[1],
+				result.m_latencyPercentilesNs[2],
+				result.m_latencyPercentilesNs[3],
+				result.m_latencyPercentilesNs[4],
+				(unsigned long long)result.m_failedAllocationCount,
+				(unsigned long long)result.m_footprintBytes,
+				result.m_fragmentation);
+		}
+	}
+
+	fclose(file);
+	return true;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <stdint.h>
+#include <EASTL/vector.h>
+#include <EASTL/string.h>
+
+class AllocationTrace;
+
+struct AllocatorBenchmarkOp
+{
+	enum Type : uint8_t
+	{
+		ALLOCATE, DEALLOCATE, FRAME
+	};
+
+	uint32_t m_size;
+	uint32_t m_slot; // index into the table of live allocations of the workload
+	uint8_t m_alignmentLog2; // 0 if the allocation did not request a specific alignment
+	Type m_type;
+};
+
+/// <summary>
+/// A sequence of allocator operations. Phases run one after another, while the threads of a phase run concurrently.
+/// Allocations may be freed by a different thread in a later phase.
+/// </summary>
+struct AllocatorBenchmarkWorkload
+{
+	eastl::string m_name;
+	uint32_t m_slotCount = 0;
+	eastl::vector<eastl::vector<eastl::vector<AllocatorBenchmarkOp>>> m_phases; // phase -> thread -> ops
+
+	// derived by finalize()
+	uint64_t m_operationCount = 0;
+	uint32_t m_threadCount = 0;
+	size_t m_maxSize = 0;
+	size_t m_maxAlignment = 0;
+	size_t m_peakLiveBytes = 0; // upper bound when threads run concurrently
+	size_t m_peakLiveCount = 0; // upper bound when threads run concurrently
+	bool m_frameScoped = true; // there are FRAME ops and all allocations are freed before the next FRAME op of the allocating thread
+
+	void finalize() noexcept;
+};
+
+struct AllocatorBenchmarkResult
+{
+	eastl::string m_allocatorName;
+	bool m_supported;
+	uint64_t m_failedAllocationCount;
+	double m_operationsPerSecond;
+	double m_latencyPercentilesNs[5]; // 50, 90, 99, 99.9, 100
+	size_t m_footprintBytes; // 0 if the allocator can not report it
+	float m_fragmentation; // 1 - peak live bytes / footprint. -1 if the footprint is unknown
+};
+
+namespace AllocatorBenchmark
+{
+	// Synthetic workloads. Every thread runs its own deterministic sequence.
+	AllocatorBenchmarkWorkload createSmallObjectChurnWorkload(uint32_t threadCount, uint32_t operationsPerThread) noexcept;
+	AllocatorBenchmarkWorkload createMixedSizeWorkload(uint32_t threadCount, uint32_t operationsPerThread) noexcept;
+	AllocatorBenchmarkWorkload createFrameWorkload(uint32_t threadCount, uint32_t frameCount) noexcept;
+	AllocatorBenchmarkWorkload createCrossThreadWorkload(uint32_t threadCount, uint32_t allocationsPerThread) noexcept;
+
+	// Converts a recorded trace into a single threaded workload that preserves the recorded order.
+	// Only events of the given source are used, unless source is null.
+	AllocatorBenchmarkWorkload createTraceWorkload(const AllocationTrace &trace, const char *name, const char *source) noexcept;
+
+	// Runs the workload once against every allocator. Allocators that can not serve the workload are reported as unsupported.
+	eastl::vector<AllocatorBenchmarkResult> run(const AllocatorBenchmarkWorkload &workload, uint32_t repetitions) noexcept;
+
+	void printResults(const AllocatorBenchmarkWorkload &workload, const eastl::vector<AllocatorBenchmarkResult> &results) noexcept;
+	bool writeResultsCSV(const char *path, const eastl::vector<AllocatorBenchmarkWorkload> &workloads, const eastl::vector<eastl::vector<AllocatorBenchmarkResult>> &results) noexcept;
+}
@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include "AllocatorBenchmark.h"
+#include "utility/allocator/AllocationTrace.h"
+
+static void printUsage() noexcept
+{
+	printf("Usage: VEngineBenchmarks [options] [trace files...]\n");
+	printf("Replays allocation traces recorded in the engine (Debug > Memory > Record Allocation Trace) and synthetic\n");
+	printf("workloads against all allocators and reports throughput, latency percentiles and fragmentation.\n\n");
+	printf("  --threads <count>      Threads used by the synthetic workloads. Defaults to the hardware thread count.\n");
+	printf("  --repetitions <count>  Throughput runs per allocator; the fastest run is reported. Defaults to 3.\n");
+	printf("  --source <name>        Only replay events of the allocator with this name from the traces.\n");
+	printf("  --no-synthetic         Only run the given traces.\n");
+	printf("  --csv <path>           Additionally write all results to a CSV file.\n");
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t threadCount = std::thread::hardware_concurrency();
+	uint32_t repetitions = 3;
+	const char *source = nullptr;
+	const char *csvPath = nullptr;
+	bool synthetic = true;
+	eastl::vector<const char *> tracePaths;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const bool hasValue = i + 1 < argc;
+
+		if (strcmp(argv[i], "--threads") == 0 && hasValue)
+		{
+			threadCount = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "--repetitions") == 0 && hasValue)
+		{
+			repetitions = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "--source") == 0 && hasValue)
+		{
+			source = argv[++i];
+		}
+		else if (strcmp(argv[i], "--csv") == 0 && hasValue)
+		{
+			csvPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--no-synthetic") == 0)
+		{
+			synthetic = false;
+		}
+		else if (argv[i][0] == '-')
+		{
+			printUsage();
+			return EXIT_FAILURE;
+		}
+		else
+		{
+			tracePaths.push_back(argv[i]);
+		}
+	}
+
+	threadCount = threadCount < 1 ? 1 : threadCount > 64 ? 64 : threadCount;
+	repetitions = repetitions < 1 ? 1 : repetitions;
+
+	eastl::vector<AllocatorBenchmarkWorkload> workloads;
+
+	if (synthetic)
+	{
+		workloads.push_back(AllocatorBenchmark::createSmallObjectChurnWorkload(1, 1000000));
+		workloads.push_back(AllocatorBenchmark::createSmallObjectChurnWorkload(threadCount, 1000000));
+		workloads.push_back(AllocatorBenchmark::createMixedSizeWorkload(1, 200000));
+		workloads.push_back(AllocatorBenchmark::createMixedSizeWorkload(threadCount, 200000));
+		workloads.push_back(AllocatorBenchmark::createFrameWorkload(threadCount, 200));
+		workloads.push_back(AllocatorBenchmark::createCrossThreadWorkload(threadCount, 100000));
+	}
+
+	for (const char *path : tracePaths)
+	{
+		AllocationTrace trace;
+		if (!trace.loadFromFile(path))
+		{
+			return EXIT_FAILURE;
+		}
+
+		printf("Loaded trace \"%s\": %llu events from %u thread(s) and %u allocator(s)\n", path, (unsigned long long)trace.getEvents().size(), trace.getThreadCount(), (unsigned)trace.getSourceNames().size());
+		for (const auto &name : trace.getSourceNames())
+		{
+			printf("    %s\n", name.c_str());
+		}
+
+		workloads.push_back(AllocatorBenchmark::createTraceWorkload(trace, path, source));
+	}
+
+	if (workloads.empty())
+	{
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	eastl::vector<eastl::vector<AllocatorBenchmarkResult>> results;
+	for (const auto &workload : workloads)
+	{
+		results.push_back(AllocatorBenchmark::run(workload, repetitions));
+		AllocatorBenchmark::printResults(workload, results.back());
+	}
+
+	if (csvPath && !AllocatorBenchmark::writeResultsCSV(csvPath, workloads, results))
+	{
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
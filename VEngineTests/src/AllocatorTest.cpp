@@ -0,0 +1,417 @@
+#include "gtest/gtest.h"
+#include <thread>
+#include <EASTL/vector.h>
+#include "utility/allocator/ScratchAllocator.h"
+#include "utility/allocator/SmallObjectAllocator.h"
+#include "utility/allocator/PoolAllocator.h"
+#include "utility/allocator/LinearAllocator.h"
+#include "utility/allocator/TrackingAllocator.h"
+#include "utility/allocator/AllocatorRegistry.h"
+#include "utility/allocator/TLSFHeapAllocator.h"
+#include "utility/TLSFAllocator.h"
+
+TEST(ScratchAllocator, testAlignmentAndReset)
+{
+	ScratchAllocator allocator(1024, false, "Test Scratch Allocator");
+
+	void *a = allocator.allocate(3);
+	void *b = allocator.allocate(5, 64, 0);
+
+	ASSERT_NE(a, nullptr);
+	ASSERT_NE(b, nullptr);
+	ASSERT_EQ((size_t)a % 16, 0);
+	ASSERT_EQ((size_t)b % 64, 0);
+
+	allocator.reset();
+
+	// memory is reused after reset
+	ASSERT_EQ(allocator.allocate(3), a);
+}
+
+TEST(ScratchAllocator, testOverflow)
+{
+	ScratchAllocator allocator(256, false, "Test Scratch Allocator");
+
+	void *a = allocator.allocate(200);
+	void *b = allocator.allocate(200);
+
+	ASSERT_NE(a, nullptr);
+	ASSERT_NE(b, nullptr);
+	ASSERT_EQ(allocator.getOverflowAllocationCount(), 1);
+
+	allocator.deallocate(b, 200);
+	allocator.deallocate(a, 200);
+}
+
+TEST(ScratchAllocator, testVector)
+{
+	ScratchAllocator allocator(1024, false, "Test Scratch Allocator");
+
+	ScratchVector<uint32_t> v{ ProxyAllocator(&allocator) };
+	for (uint32_t i = 0; i < 1000; ++i)
+	{
+		v.push_back(i);
+	}
+
+	for (uint32_t i = 0; i < 1000; ++i)
+	{
+		ASSERT_EQ(v[i], i);
+	}
+	ASSERT_GT(allocator.getOverflowAllocationCount(), 0);
+}
+
+TEST(SmallObjectAllocator, testAlignment)
+{
+	SmallObjectAllocator *allocator = SmallObjectAllocator::get();
+
+	for (size_t size = 1; size <= SmallObjectAllocator::k_maxSmallObjectSize; size = size * 3 / 2 + 1)
+	{
+		void *a = allocator->allocate(size);
+		void *b = allocator->allocate(size, 256, 0);
+
+		ASSERT_TRUE(allocator->owns(a));
+		ASSERT_TRUE(allocator->owns(b));
+		ASSERT_EQ((size_t)a % 16, 0);
+		ASSERT_EQ((size_t)b % 256, 0);
+
+		memset(a, 0xFF, size);
+		memset(b, 0xFF, size);
+
+		allocator->deallocate(a, size);
+		allocator->deallocate(b, size);
+	}
+
+	// large allocations are served by the CRT heap
+	void *large = allocator->allocate(SmallObjectAllocator::k_maxSmallObjectSize + 1);
+	ASSERT_NE(large, nullptr);
+	ASSERT_FALSE(allocator->owns(large));
+	allocator->deallocate(large, SmallObjectAllocator::k_maxSmallObjectSize + 1);
+}
+
+TEST(SmallObjectAllocator, testReuse)
+{
+	SmallObjectAllocator *allocator = SmallObjectAllocator::get();
+
+	void *a = allocator->allocate(48);
+	allocator->deallocate(a, 48);
+
+	// freed memory is handed out again by the thread cache
+	ASSERT_EQ(allocator->allocate(48), a);
+	allocator->deallocate(a, 48);
+}
+
+TEST(SmallObjectAllocator, testCrossThreadFree)
+{
+	SmallObjectAllocator *allocator = SmallObjectAllocator::get();
+
+	constexpr size_t k_allocationCount = 100000;
+	eastl::vector<uint32_t *> allocations(k_allocationCount);
+
+	std::thread producer([&]()
+		{
+			for (size_t i = 0; i < k_allocationCount; ++i)
+			{
+				allocations[i] = (uint32_t *)allocator->allocate(sizeof(uint32_t) * (1 + i % 64));
+				allocations[i][0] = (uint32_t)i;
+			}
+		});
+	producer.join();
+
+	// memory is freed on a different thread than it was allocated on, after the allocating thread exited
+	std::thread consumer([&]()
+		{
+			for (size_t i = 0; i < k_allocationCount; ++i)
+			{
+				ASSERT_EQ(allocations[i][0], (uint32_t)i);
+				allocator->deallocate(allocations[i], sizeof(uint32_t) * (1 + i % 64));
+			}
+		});
+	consumer.join();
+
+	// spans of the exited threads are adopted and can be allocated from again
+	void *a = allocator->allocate(sizeof(uint32_t));
+	ASSERT_TRUE(allocator->owns(a));
+	allocator->deallocate(a, sizeof(uint32_t));
+}
+
+TEST(AllocatorRegistry, testPoolStats)
+{
+	DynamicPoolAllocator allocator(64, 16, "Test Pool Allocator");
+
+	void *a = allocator.allocate(64);
+	void *b = allocator.allocate(64);
+	void *c = allocator.allocate(64);
+	allocator.deallocate(b, 64);
+
+	const AllocatorStats *stats = allocator.getStats();
+	ASSERT_EQ(stats->getLiveBytes(), 128);
+	ASSERT_EQ(stats->getPeakBytes(), 192);
+	ASSERT_EQ(stats->getLiveAllocationCount(), 2);
+	ASSERT_EQ(stats->getTotalAllocationCount(), 3);
+
+	// the allocator is visible in the registry
+	AllocatorStatsSnapshot snapshots[256];
+	const size_t snapshotCount = AllocatorRegistry::getSnapshots(256, snapshots);
+	bool found = false;
+	for (size_t i = 0; i < snapshotCount && i < 256; ++i)
+	{
+		found = found || (snapshots[i].m_name == allocator.get_name() && snapshots[i].m_liveBytes == 128);
+	}
+	ASSERT_TRUE(found);
+
+	allocator.deallocate(a, 64);
+	allocator.deallocate(c, 64);
+	ASSERT_EQ(stats->getLiveBytes(), 0);
+}
+
+TEST(AllocatorRegistry, testSubsystemBudget)
+{
+	TrackingAllocator allocatorA(SmallObjectAllocator::get(), "Test Tracking Allocator A", "Test Subsystem");
+	TrackingAllocator allocatorB(SmallObjectAllocator::get(), "Test Tracking Allocator B", "Test Subsystem");
+
+	AllocatorRegistry::setBudget("Test Subsystem", 1024);
+	ASSERT_EQ(AllocatorRegistry::getBudget("Test Subsystem"), 1024);
+
+	void *a = allocatorA.allocate(1000);
+	void *b = allocatorB.allocate(1000);
+	ASSERT_EQ(AllocatorRegistry::getSubsystemLiveBytes("Test Subsystem"), 2000);
+
+	// logs a warning
+	AllocatorRegistry::update(1.0f);
+
+	allocatorA.deallocate(a, 1000);
+	allocatorB.deallocate(b, 1000);
+	ASSERT_EQ(AllocatorRegistry::getSubsystemLiveBytes("Test Subsystem"), 0);
+
+	AllocatorRegistry::setBudget("Test Subsystem", 0);
+	ASSERT_EQ(AllocatorRegistry::getBudget("Test Subsystem"), 0);
+}
+
+TEST(VirtualLinearAllocator, testGrowth)
+{
+	VirtualLinearAllocator allocator(1024 * 1024 * 64, "Test Virtual Linear Allocator");
+
+	ASSERT_EQ(allocator.getCommittedSize(), 0);
+
+	char *a = (char *)allocator.allocate(100);
+	ASSERT_NE(a, nullptr);
+	const size_t initialCommittedSize = allocator.getCommittedSize();
+	ASSERT_GE(initialCommittedSize, 100);
+	ASSERT_LT(initialCommittedSize, allocator.getCapacity());
+
+	// memory is committed on demand and stays contiguous
+	char *b = (char *)allocator.allocate(1024 * 1024 * 4, 256, 0);
+	ASSERT_EQ((size_t)b % 256, 0);
+	ASSERT_GT(allocator.getCommittedSize(), initialCommittedSize);
+	memset(b, 0xFF, 1024 * 1024 * 4);
+
+	// exceeding the reservation fails
+	ASSERT_EQ(allocator.allocate(allocator.getCapacity()), nullptr);
+
+	allocator.reset();
+	ASSERT_EQ(allocator.allocate(100), a);
+
+	allocator.trim();
+	ASSERT_EQ(allocator.getCommittedSize(), initialCommittedSize);
+}
+
+TEST(VirtualPoolAllocator, testAllocateAndFree)
+{
+	constexpr size_t k_elementCount = 100000;
+	VirtualPoolAllocator allocator(48, k_elementCount, "Test Virtual Pool Allocator");
+
+	eastl::vector<void *> allocations;
+	for (size_t i = 0; i < k_elementCount; ++i)
+	{
+		void *p = allocator.allocate(48);
+		ASSERT_NE(p, nullptr);
+		memset(p, 0xFF, 48);
+		allocations.push_back(p);
+	}
+
+	// pool is exhausted
+	ASSERT_EQ(allocator.allocate(48), nullptr);
+	ASSERT_EQ(allocator.getFreeElementCount(), 0);
+
+	allocator.deallocate(allocations[42], 48);
+	ASSERT_EQ(allocator.getFreeElementCount(), 1);
+	ASSERT_EQ(allocator.allocate(48), allocations[42]);
+
+	for (void *p : allocations)
+	{
+		allocator.deallocate(p, 48);
+	}
+	ASSERT_EQ(allocator.getStats()->getLiveAllocationCount(), 0);
+}
+
+TEST(TLSFHeapAllocator, testAlignmentAndOffset)
+{
+	TLSFHeapAllocator allocator(1024 * 1024, false, false, "Test TLSF Heap Allocator");
+
+	void *a = allocator.allocate(3);
+	void *b = allocator.allocate(100, 256, 0);
+	void *c = allocator.allocate(100, 64, 8);
+	void *d = allocator.allocate(7, 4096, 20);
+
+	ASSERT_NE(a, nullptr);
+	ASSERT_NE(b, nullptr);
+	ASSERT_NE(c, nullptr);
+	ASSERT_NE(d, nullptr);
+	ASSERT_EQ((size_t)a % 16, 0);
+	ASSERT_EQ((size_t)b % 256, 0);
+	ASSERT_EQ(((size_t)c + 8) % 64, 0);
+	ASSERT_EQ(((size_t)d + 20) % 4096, 0);
+	ASSERT_GE(allocator.getAllocationSize(b), 100);
+	ASSERT_GE(allocator.getAllocationSize(d), 7);
+	ASSERT_TRUE(allocator.checkIntegrity());
+
+	allocator.deallocate(c, 100);
+	allocator.deallocate(a, 3);
+	allocator.deallocate(d, 7);
+	allocator.deallocate(b, 100);
+	ASSERT_TRUE(allocator.checkIntegrity());
+	ASSERT_EQ(allocator.getStats()->getLiveBytes(), 0);
+}
+
+TEST(TLSFHeapAllocator, testCoalescing)
+{
+	TLSFHeapAllocator allocator(1024 * 1024, false, false, "Test TLSF Heap Allocator");
+	const size_t initialFreeSize = allocator.getFreeSize();
+
+	void *allocations[64];
+	for (auto &p : allocations)
+	{
+		p = allocator.allocate(1000);
+		ASSERT_NE(p, nullptr);
+	}
+
+	// free every other block first, so that the remaining frees have to merge with both neighbors
+	for (size_t i = 0; i < 64; i += 2)
+	{
+		allocator.deallocate(allocations[i], 1000);
+	}
+	ASSERT_TRUE(allocator.checkIntegrity());
+	for (size_t i = 1; i < 64; i += 2)
+	{
+		allocator.deallocate(allocations[i], 1000);
+	}
+	ASSERT_TRUE(allocator.checkIntegrity());
+
+	// everything merged back into a single block. the size is rounded up to the next size class when searching
+	ASSERT_EQ(allocator.getFreeSize(), initialFreeSize);
+	void *p = allocator.allocate(initialFreeSize - 64 * 1024);
+	ASSERT_NE(p, nullptr);
+	allocator.deallocate(p, initialFreeSize - 64 * 1024);
+}
+
+TEST(TLSFHeapAllocator, testGrowth)
+{
+	TLSFHeapAllocator fixedAllocator(256 * 1024, false, false, "Test TLSF Heap Allocator");
+	ASSERT_EQ(fixedAllocator.allocate(1024 * 1024), nullptr);
+
+	TLSFHeapAllocator allocator(256 * 1024, true, false, "Test TLSF Heap Allocator");
+	ASSERT_EQ(allocator.getPoolCount(), 1);
+
+	void *a = allocator.allocate(200 * 1024);
+	void *b = allocator.allocate(200 * 1024);
+	void *c = allocator.allocate(1024 * 1024);
+	ASSERT_NE(a, nullptr);
+	ASSERT_NE(b, nullptr);
+	ASSERT_NE(c, nullptr);
+	ASSERT_EQ(allocator.getPoolCount(), 3);
+	memset(c, 0xFF, 1024 * 1024);
+	ASSERT_TRUE(allocator.checkIntegrity());
+
+	allocator.deallocate(a, 200 * 1024);
+	allocator.deallocate(b, 200 * 1024);
+	allocator.deallocate(c, 1024 * 1024);
+	ASSERT_TRUE(allocator.checkIntegrity());
+
+	// the new pool must be large enough for the rounded up size class of the allocation
+	const size_t largeSize = 5 * 1024 * 1024 + 100;
+	void *d = allocator.allocate(largeSize);
+	ASSERT_NE(d, nullptr);
+	memset(d, 0xFF, largeSize);
+	ASSERT_TRUE(allocator.checkIntegrity());
+
+	allocator.deallocate(d, largeSize);
+	ASSERT_TRUE(allocator.checkIntegrity());
+}
+
+TEST(TLSFHeapAllocator, testRandomAllocations)
+{
+	TLSFHeapAllocator allocator(4 * 1024 * 1024, true, false, "Test TLSF Heap Allocator");
+
+	struct Allocation
+	{
+		uint8_t *m_ptr;
+		size_t m_size;
+	};
+	eastl::vector<Allocation> allocations;
+
+	uint32_t seed = 12345;
+	auto random = [&]()
+	{
+		seed = seed * 1664525u + 1013904223u;
+		return seed >> 8;
+	};
+
+	for (size_t i = 0; i < 20000; ++i)
+	{
+		if (allocations.empty() || (random() % 3) != 0)
+		{
+			const size_t size = 1 + random() % ((random() % 8) == 0 ? 64 * 1024 : 512);
+			const size_t alignment = size_t(1) << (random() % 8);
+			uint8_t *p = (uint8_t *)allocator.allocate(size, alignment, 0);
+			ASSERT_NE(p, nullptr);
+			ASSERT_EQ((size_t)p % alignment, 0);
+			memset(p, (int)(size & 0xFF), size);
+			allocations.push_back({ p, size });
+		}
+		else
+		{
+			const size_t index = random() % allocations.size();
+			const Allocation allocation = allocations[index];
+			for (size_t j = 0; j < allocation.m_size; ++j)
+			{
+				ASSERT_EQ(allocation.m_ptr[j], (uint8_t)(allocation.m_size & 0xFF));
+			}
+			allocator.deallocate(allocation.m_ptr, allocation.m_size);
+			allocations[index] = allocations.back();
+			allocations.pop_back();
+		}
+	}
+	ASSERT_TRUE(allocator.checkIntegrity());
+
+	for (const auto &allocation : allocations)
+	{
+		allocator.deallocate(allocation.m_ptr, allocation.m_size);
+	}
+	ASSERT_TRUE(allocator.checkIntegrity());
+	ASSERT_EQ(allocator.getStats()->getLiveAllocationCount(), 0);
+}
+
+TEST(TLSFAllocator, testSmallSpanFallback)
+{
+	TLSFAllocator allocator(1024, 1, "Test TLSF Allocator");
+
+	uint32_t offsetA = 0;
+	uint32_t offsetB = 0;
+	void *spanA = nullptr;
+	void *spanB = nullptr;
+	ASSERT_TRUE(allocator.alloc(8, 1, offsetA, spanA));
+	ASSERT_TRUE(allocator.alloc(8, 1, offsetB, spanB));
+
+	// leaves a free span smaller than the next request in the small free lists
+	allocator.free(spanA);
+
+	// must fall back to the regular free lists, which still hold almost all of the memory
+	uint32_t offsetC = 0;
+	void *spanC = nullptr;
+	ASSERT_TRUE(allocator.alloc(16, 1, offsetC, spanC));
+	ASSERT_GE(offsetC, offsetB + 8);
+
+	allocator.free(spanB);
+	allocator.free(spanC);
+	ASSERT_EQ(allocator.getAllocationCount(), 0);
+}
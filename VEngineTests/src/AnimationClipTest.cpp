@@ -0,0 +1,270 @@
+#include "gtest/gtest.h"
+#include "animation/AnimationClip.h"
+#include "animation/AnimationClipCompressor.h"
+#include <math.h>
+#include <string.h>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+// joints 0-2 have keys on all tracks at different rates, joint 3 has a single key and joint 4 has no keys at all
+static constexpr uint32_t k_jointCount = 5;
+static constexpr uint32_t k_frameCounts[k_jointCount] = { 8, 13, 5, 1, 0 };
+static constexpr float k_duration = 2.0f;
+
+struct SourceClip
+{
+	eastl::vector<float> m_timeKeys;
+	eastl::vector<float> m_translations;
+	eastl::vector<float> m_rotations;
+	eastl::vector<float> m_scales;
+	AnimationClipSourceJoint m_joints[k_jointCount];
+};
+
+// the source keys of the test clip. the scale track of joint 0 is linear and the scale track of joint 2 is constant
+static void createSourceClip(SourceClip *clip) noexcept
+{
+	for (uint32_t j = 0; j < k_jointCount; ++j)
+	{
+		const uint32_t frameCount = k_frameCounts[j];
+		for (uint32_t i = 0; i < frameCount; ++i)
+		{
+			const float t = frameCount > 1 ? k_duration * i / (frameCount - 1) : 0.0f;
+			clip->m_timeKeys.push_back(t);
+			clip->m_translations.push_back(sinf(t + j));
+			clip->m_translations.push_back(t * 0.5f);
+			clip->m_translations.push_back(-cosf(t * 2.0f));
+
+			const glm::quat q = glm::angleAxis(t * 0.5f + j, glm::normalize(glm::vec3(1.0f, 2.0f, 0.5f + j)));
+			clip->m_rotations.push_back(q.x);
+			clip->m_rotations.push_back(q.y);
+			clip->m_rotations.push_back(q.z);
+			clip->m_rotations.push_back(q.w);
+
+			clip->m_scales.push_back(j == 2 ? 1.0f : 1.0f + t * 0.25f);
+		}
+	}
+
+	// all tracks of a joint share the same time keys
+	uint32_t offset = 0;
+	for (uint32_t j = 0; j < k_jointCount; ++j)
+	{
+		const uint32_t frameCount = k_frameCounts[j];
+		auto &joint = clip->m_joints[j];
+		joint.m_translationKeyCount = frameCount;
+		joint.m_rotationKeyCount = frameCount;
+		joint.m_scaleKeyCount = frameCount;
+		joint.m_translationTimeKeys = clip->m_timeKeys.data() + offset;
+		joint.m_rotationTimeKeys = clip->m_timeKeys.data() + offset;
+		joint.m_scaleTimeKeys = clip->m_timeKeys.data() + offset;
+		joint.m_translations = clip->m_translations.data() + offset * 3;
+		joint.m_rotations = clip->m_rotations.data() + offset * 4;
+		joint.m_scales = clip->m_scales.data() + offset;
+
+		offset += frameCount;
+	}
+}
+
+static AnimationClip createTestClip() noexcept
+{
+	SourceClip sourceClip;
+	createSourceClip(&sourceClip);
+
+	AnimationClipLayout layout{};
+	eastl::vector<char> data;
+	AnimationClipCompressor::compress(k_jointCount, sourceClip.m_joints, k_duration, AnimationClipCompressionSettings{}, &layout, &data);
+
+	// the clip takes ownership of its memory
+	char *memory = new char[data.size()];
+	memcpy(memory, data.data(), data.size());
+
+	AnimationClipCreateInfo createInfo{};
+	createInfo.m_jointCount = k_jointCount;
+	createInfo.m_duration = k_duration;
+	createInfo.m_memory = memory;
+	createInfo.setArrays(layout, memory);
+
+	return AnimationClip(createInfo);
+}
+
+// samples the uncompressed keys of a joint
+static JointPose sampleSourceJoint(const AnimationClipSourceJoint &joint, float time) noexcept
+{
+	JointPose result{};
+	result.m_rot[3] = 1.0f;
+	result.m_scale = 1.0f;
+
+	const uint32_t count = joint.m_translationKeyCount;
+	if (count == 0)
+	{
+		return result;
+	}
+
+	uint32_t key1 = 0;
+	while (key1 < count && joint.m_translationTimeKeys[key1] <= time)
+	{
+		++key1;
+	}
+	const uint32_t key0 = key1 > 0 ? key1 - 1 : 0;
+	key1 = key1 < count ? key1 : count - 1;
+	const float timeDiff = joint.m_translationTimeKeys[key1] - joint.m_translationTimeKeys[key0];
+	const float alpha = timeDiff > 0.0f ? (time - joint.m_translationTimeKeys[key0]) / timeDiff : 0.0f;
+
+	for (size_t i = 0; i < 3; ++i)
+	{
+		result.m_trans[i] = glm::mix(joint.m_translations[key0 * 3 + i], joint.m_translations[key1 * 3 + i], alpha);
+	}
+
+	const glm::quat rot = glm::slerp(glm::make_quat(joint.m_rotations + key0 * 4), glm::make_quat(joint.m_rotations + key1 * 4), alpha);
+	memcpy(result.m_rot, &rot[0], sizeof(result.m_rot));
+
+	result.m_scale = glm::mix(joint.m_scales[key0], joint.m_scales[key1], alpha);
+
+	return result;
+}
+
+static void expectPosesNear(const JointPose &expected, const JointPose &actual, float tolerance = 1e-5f) noexcept
+{
+	for (size_t i = 0; i < 3; ++i)
+	{
+		EXPECT_NEAR(expected.m_trans[i], actual.m_trans[i], tolerance);
+	}
+	EXPECT_NEAR(expected.m_scale, actual.m_scale, tolerance);
+
+	// nlerp instead of slerp
+	const float dot = fabsf(glm::dot(glm::make_quat(expected.m_rot), glm::make_quat(actual.m_rot)));
+	EXPECT_NEAR(dot, 1.0f, 1e-4f);
+}
+
+TEST(AnimationClip, testSampleAllJoints)
+{
+	AnimationClip clip = createTestClip();
+	AnimationClipCursor cursor;
+	JointPoses poses;
+	poses.reset(k_jointCount);
+
+	// forward playback with a loop and a jump back to the start
+	const float times[] = { 0.0f, 0.01f, 0.2f, 0.21f, 0.5f, 1.3f, 1.99f, 2.0f, 2.05f, 0.1f, 0.7f };
+	for (bool loop : { false, true })
+	{
+		for (float time : times)
+		{
+			clip.sampleAllJoints(time, loop, false, &cursor, &poses);
+
+			for (uint32_t j = 0; j < k_jointCount; ++j)
+			{
+				expectPosesNear(clip.getJointPose(j, time, loop, false), poses.getJointPose(j));
+			}
+		}
+	}
+
+	// root motion extraction samples the root translation at the start
+	clip.sampleAllJoints(1.5f, true, true, &cursor, &poses);
+	expectPosesNear(clip.getJointPose(0, 1.5f, true, true), poses.getJointPose(0));
+}
+
+TEST(AnimationClip, testCursorMatchesSearch)
+{
+	AnimationClip clip = createTestClip();
+
+	// the results must not depend on the previous sampling time
+	AnimationClipCursor cursor;
+	JointPoses poses;
+	poses.reset(k_jointCount);
+	for (float time = 1.9f; time > 0.0f; time -= 0.37f)
+	{
+		clip.sampleAllJoints(time * 0.5f, false, false, &cursor, &poses);
+		clip.sampleAllJoints(time, false, false, &cursor, &poses);
+
+		AnimationClipCursor freshCursor;
+		JointPoses freshPoses;
+		freshPoses.reset(k_jointCount);
+		clip.sampleAllJoints(time, false, false, &freshCursor, &freshPoses);
+
+		EXPECT_EQ(poses.m_data, freshPoses.m_data);
+	}
+}
+
+TEST(AnimationClip, testCompressionError)
+{
+	SourceClip sourceClip;
+	createSourceClip(&sourceClip);
+	AnimationClip clip = createTestClip();
+
+	// the error between keys is bounded by the error at the removed keys plus the time quantization
+	for (float time = 0.0f; time <= k_duration; time += 0.0137f)
+	{
+		for (uint32_t j = 0; j < k_jointCount; ++j)
+		{
+			expectPosesNear(sampleSourceJoint(sourceClip.m_joints[j], time), clip.getJointPose(j, time, false, false), 5e-4f);
+		}
+	}
+}
+
+TEST(AnimationClip, testCompressionReducesKeys)
+{
+	SourceClip sourceClip;
+	createSourceClip(&sourceClip);
+
+	AnimationClipLayout layout{};
+	eastl::vector<char> data;
+	AnimationClipCompressor::compress(k_jointCount, sourceClip.m_joints, k_duration, AnimationClipCompressionSettings{}, &layout, &data);
+
+	ASSERT_EQ(data.size(), layout.getMemorySize());
+	EXPECT_TRUE(layout.isValid(data.data()));
+
+	const AnimationClipJointInfo *jointInfo = reinterpret_cast<const AnimationClipJointInfo *>(data.data());
+
+	// linear tracks keep only the first and the last key
+	EXPECT_EQ(jointInfo[0].m_scaleFrameCount, 2u);
+	EXPECT_EQ(jointInfo[0].m_flags & ANIMATION_CLIP_TRACK_FLAG_CONSTANT_SCALE, 0u);
+
+	// constant tracks
+	EXPECT_EQ(jointInfo[2].m_scaleFrameCount, 1u);
+	EXPECT_NE(jointInfo[2].m_flags & ANIMATION_CLIP_TRACK_FLAG_CONSTANT_SCALE, 0u);
+	EXPECT_EQ(jointInfo[3].m_flags, ANIMATION_CLIP_TRACK_FLAG_CONSTANT_TRANSLATION | ANIMATION_CLIP_TRACK_FLAG_CONSTANT_ROTATION | ANIMATION_CLIP_TRACK_FLAG_CONSTANT_SCALE);
+
+	// joints without keys
+	EXPECT_EQ(jointInfo[4].m_translationFrameCount, 0u);
+	EXPECT_EQ(jointInfo[4].m_rotationFrameCount, 0u);
+	EXPECT_EQ(jointInfo[4].m_scaleFrameCount, 0u);
+	EXPECT_EQ(jointInfo[4].m_flags, 0u);
+
+	const size_t uncompressedSize = sourceClip.m_timeKeys.size() * sizeof(float) * (3 + 1 + 3 + 4 + 1);
+	EXPECT_LT(data.size() - k_jointCount * sizeof(AnimationClipJointInfo), uncompressedSize / 2);
+}
+
+TEST(AnimationClip, testJointPosesLerp)
+{
+	JointPoses x;
+	JointPoses y;
+	x.reset(3);
+	y.reset(3);
+
+	JointPose a{};
+	a.m_trans[0] = 1.0f;
+	a.m_scale = 2.0f;
+	const glm::quat qa = glm::angleAxis(0.5f, glm::vec3(0.0f, 1.0f, 0.0f));
+	memcpy(a.m_rot, &qa[0], sizeof(a.m_rot));
+
+	// same rotation with flipped sign, which must not change the interpolated rotation
+	JointPose b{};
+	b.m_trans[0] = 3.0f;
+	b.m_scale = 4.0f;
+	const glm::quat qb = -qa;
+	memcpy(b.m_rot, &qb[0], sizeof(b.m_rot));
+
+	x.setJointPose(1, a);
+	y.setJointPose(1, b);
+
+	JointPoses::lerp(x, y, 0.25f, &x);
+
+	const JointPose result = x.getJointPose(1);
+	EXPECT_FLOAT_EQ(result.m_trans[0], 1.5f);
+	EXPECT_FLOAT_EQ(result.m_scale, 2.5f);
+	EXPECT_NEAR(fabsf(glm::dot(glm::make_quat(result.m_rot), qa)), 1.0f, 1e-5f);
+
+	// identity joints stay identity
+	const JointPose identity = x.getJointPose(0);
+	EXPECT_FLOAT_EQ(identity.m_rot[3], 1.0f);
+	EXPECT_FLOAT_EQ(identity.m_scale, 1.0f);
+}
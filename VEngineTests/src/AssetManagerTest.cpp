@@ -0,0 +1,393 @@
+#include "gtest/gtest.h"
+#include "asset/AssetManager.h"
+#include "asset/AssetLoadTelemetry.h"
+#include "asset/handler/AssetHandler.h"
+#include "job/JobSystem.h"
+#include "utility/Thread.h"
+#include <EASTL/atomic.h>
+#include <string.h>
+
+namespace
+{
+	class TestAsset : public AssetData
+	{
+	public:
+		static constexpr AssetType k_assetType = "6C0F5D1A-3E1B-4C4B-9B0E-2A7D5F8E1C33"_uuid;
+
+		explicit TestAsset(const AssetID &assetID) noexcept : AssetData(assetID, k_assetType) {}
+
+		Asset<TestAsset> m_dependencies[4];
+		uint32_t m_value = 0;
+	};
+
+	// "fail" can not be loaded. "parent" depends on "child0" to "child3" and "grandparent" depends on "parent".
+	// all assets starting with "user" depend on "shared" and "user0" waits on "user1" while loading.
+	// "cycle0" and "cycle1" depend on each other, as do "cycle2" and "cycle3".
+	class TestAssetHandler : public AssetHandler
+	{
+	public:
+		eastl::atomic<uint32_t> m_loadCount = 0;
+
+		AssetData *createEmptyAssetData(const AssetID &assetID, const AssetType &assetType) noexcept override
+		{
+			return new TestAsset(assetID);
+		}
+
+		bool loadAssetData(AssetData *assetData, const char *path) noexcept override
+		{
+			++m_loadCount;
+
+			AssetLoadTelemetry::StageTimer stageTimer(AssetLoadStage::IO);
+			AssetLoadTelemetry::addBytesRead(10);
+			stageTimer.setStage(AssetLoadStage::DECODE);
+
+			auto *testAsset = static_cast<TestAsset *>(assetData);
+
+			if (strcmp(path, "/assets/fail") == 0)
+			{
+				return false;
+			}
+
+			// gives the jobs waiting on the assets depending on "shared" time to occupy all worker threads
+			if (strcmp(path, "/assets/shared") == 0)
+			{
+				Thread::sleep(50);
+			}
+
+			// waits on an asset it does not declare as a dependency
+			if (strcmp(path, "/assets/user0") == 0)
+			{
+				Asset<TestAsset> user1 = AssetManager::get()->getAsset<TestAsset>(AssetID("user1"));
+				if (!user1.waitUntilLoaded())
+				{
+					return false;
+				}
+			}
+
+			// the dependency closing the cycle is dropped, so one of the two assets is loaded before its dependency
+			const bool cyclic = strncmp(path, "/assets/cycle", 13) == 0;
+
+			eastl::vector<AssetDependency> dependencies;
+			if (!cyclic)
+			{
+				getAssetDependencies(path, dependencies);
+			}
+			for (size_t i = 0; i < dependencies.size(); ++i)
+			{
+				// dependencies are loaded before the asset itself
+				testAsset->m_dependencies[i] = AssetManager::get()->getAsset<TestAsset>(dependencies[i].m_assetID);
+				if (!testAsset->m_dependencies[i].isLoaded())
+				{
+					return false;
+				}
+			}
+
+			testAsset->m_value = 42;
+			testAsset->setMemorySize(100);
+			return true;
+		}
+
+		void getAssetDependencies(const char *path, eastl::vector<AssetDependency> &dependencies) noexcept override
+		{
+			if (strcmp(path, "/assets/parent") == 0)
+			{
+				const char *children[] = { "child0", "child1", "child2", "child3" };
+				for (const char *child : children)
+				{
+					dependencies.push_back({ AssetID(child), TestAsset::k_assetType });
+				}
+			}
+			else if (strcmp(path, "/assets/grandparent") == 0)
+			{
+				dependencies.push_back({ AssetID("parent"), TestAsset::k_assetType });
+			}
+			else if (strncmp(path, "/assets/user", 12) == 0)
+			{
+				dependencies.push_back({ AssetID("shared"), TestAsset::k_assetType });
+			}
+			else if (strncmp(path, "/assets/cycle", 13) == 0)
+			{
+				char other[] = "cycle0";
+				other[5] = static_cast<char>('0' + ((path[13] - '0') ^ 1));
+				dependencies.push_back({ AssetID(other), TestAsset::k_assetType });
+			}
+		}
+
+		void destroyAssetData(AssetData *assetData) noexcept override
+		{
+			delete assetData;
+		}
+	};
+}
+
+TEST(AssetManager, testAsyncLoad)
+{
+	job::init();
+	AssetManager::init();
+
+	TestAssetHandler handler;
+	AssetManager::get()->registerAssetHandler(TestAsset::k_assetType, &handler);
+
+	{
+		job::Counter *counter = nullptr;
+		Asset<TestAsset> a = AssetManager::get()->getAsset<TestAsset>(AssetID("a"), &counter);
+		Asset<TestAsset> b = AssetManager::get()->getAsset<TestAsset>(AssetID("b"), &counter);
+		Asset<TestAsset> failed = AssetManager::get()->getAsset<TestAsset>(AssetID("fail"), &counter);
+		Asset<TestAsset> a2 = AssetManager::get()->getAsset<TestAsset>(AssetID("a"), &counter);
+
+		ASSERT_TRUE(a);
+		EXPECT_EQ(a.get(), a2.get());
+
+		job::waitForCounter(counter);
+		job::freeCounter(counter);
+
+		EXPECT_TRUE(a.isLoaded());
+		EXPECT_TRUE(b.isLoaded());
+		EXPECT_EQ(a->m_value, 42);
+		EXPECT_FALSE(failed.isLoaded());
+		EXPECT_EQ(failed->getAssetStatus(), AssetStatus::ERROR);
+		EXPECT_EQ(handler.m_loadCount, 3);
+	}
+
+	{
+		// dependencies are queued before the parent is loaded, so they finish bottom-up
+		job::Counter *counter = nullptr;
+		Asset<TestAsset> grandparent = AssetManager::get()->getAsset<TestAsset>(AssetID("grandparent"), &counter);
+		job::waitForCounter(counter);
+		job::freeCounter(counter);
+
+		ASSERT_TRUE(grandparent.isLoaded());
+		ASSERT_TRUE(grandparent->m_dependencies[0].isLoaded());
+		const Asset<TestAsset> &parent = grandparent->m_dependencies[0];
+		for (const auto &child : parent->m_dependencies)
+		{
+			EXPECT_TRUE(child.isLoaded());
+			EXPECT_EQ(child->m_value, 42);
+		}
+	}
+
+	{
+		// waiting on a queued asset loads it and helps with its dependencies on the calling thread
+		Asset<TestAsset> parent = AssetManager::get()->getAsset<TestAsset>(AssetID("parent"));
+		EXPECT_TRUE(parent.waitUntilLoaded());
+		EXPECT_TRUE(parent->m_dependencies[3].isLoaded());
+	}
+
+	// waits for the remaining load jobs, which still need the handler
+	AssetManager::shutdown();
+	job::shutdown();
+}
+
+TEST(AssetManager, testWaitForQueuedFinish)
+{
+	job::init();
+	AssetManager::init();
+
+	TestAssetHandler handler;
+	AssetManager::get()->registerAssetHandler(TestAsset::k_assetType, &handler);
+
+	{
+		// every worker thread ends up waiting on a dependent of "shared" whose finish is queued as a job behind the remaining
+		// waiting jobs. the waiting threads need to run the queued finishes themselves, otherwise no thread is left to run them.
+		const char *users[] = { "user0", "user1", "user2", "user3", "user4", "user5", "user6", "user7" };
+		Asset<TestAsset> assets[8];
+
+		job::Counter *counter = nullptr;
+		for (size_t i = 0; i < 8; ++i)
+		{
+			assets[i] = AssetManager::get()->getAsset<TestAsset>(AssetID(users[i]), &counter);
+		}
+		job::waitForCounter(counter);
+		job::freeCounter(counter);
+
+		for (const auto &asset : assets)
+		{
+			EXPECT_TRUE(asset.isLoaded());
+		}
+		EXPECT_EQ(handler.m_loadCount, 9);
+	}
+
+	AssetManager::shutdown();
+	job::shutdown();
+}
+
+TEST(AssetManager, testCyclicDependencies)
+{
+	job::init();
+	AssetManager::init();
+
+	TestAssetHandler handler;
+	AssetManager::get()->registerAssetHandler(TestAsset::k_assetType, &handler);
+
+	{
+		// without dropping one of the dependencies, neither asset would finish and waiting would recurse endlessly
+		Asset<TestAsset> cycle0 = AssetManager::get()->getAsset<TestAsset>(AssetID("cycle0"));
+		Asset<TestAsset> cycle1 = AssetManager::get()->getAsset<TestAsset>(AssetID("cycle1"));
+		EXPECT_TRUE(cycle0.waitUntilLoaded());
+		EXPECT_TRUE(cycle1.waitUntilLoaded());
+		EXPECT_EQ(handler.m_loadCount, 2);
+	}
+
+	{
+		// same through load jobs
+		job::Counter *counter = nullptr;
+		Asset<TestAsset> cycle2 = AssetManager::get()->getAsset<TestAsset>(AssetID("cycle2"), &counter);
+		Asset<TestAsset> cycle3 = AssetManager::get()->getAsset<TestAsset>(AssetID("cycle3"), &counter);
+		job::waitForCounter(counter);
+		job::freeCounter(counter);
+
+		EXPECT_TRUE(cycle2.isLoaded());
+		EXPECT_TRUE(cycle3.isLoaded());
+		EXPECT_EQ(handler.m_loadCount, 4);
+	}
+
+	AssetManager::shutdown();
+	job::shutdown();
+}
+
+TEST(AssetManager, testCache)
+{
+	job::init();
+	AssetManager::init();
+
+	TestAssetHandler handler;
+	AssetManager::get()->registerAssetHandler(TestAsset::k_assetType, &handler);
+	AssetManager::get()->setCacheBudget(TestAsset::k_assetType, 250);
+
+	// the counter also waits for the load job to release its reference
+	auto loadAndRelease = [](const char *assetID)
+	{
+		job::Counter *counter = nullptr;
+		Asset<TestAsset> asset = AssetManager::get()->getAsset<TestAsset>(AssetID(assetID), &counter);
+		if (counter)
+		{
+			job::waitForCounter(counter);
+			job::freeCounter(counter);
+		}
+		EXPECT_TRUE(asset.isLoaded());
+	};
+
+	loadAndRelease("a");
+	loadAndRelease("b");
+	EXPECT_EQ(AssetManager::get()->getCacheSize(TestAsset::k_assetType), 200);
+
+	// "a" was released least recently, so it is evicted first
+	loadAndRelease("c");
+	EXPECT_EQ(AssetManager::get()->getCacheSize(TestAsset::k_assetType), 200);
+	EXPECT_EQ(handler.m_loadCount, 3);
+
+	loadAndRelease("b");
+	EXPECT_EQ(handler.m_loadCount, 3);
+	loadAndRelease("a");
+	EXPECT_EQ(handler.m_loadCount, 4);
+
+	{
+		// referenced assets do not count towards the budget
+		Asset<TestAsset> b = AssetManager::get()->getAsset<TestAsset>(AssetID("b"));
+		EXPECT_TRUE(b.isLoaded());
+		EXPECT_EQ(AssetManager::get()->getCacheSize(TestAsset::k_assetType), 100);
+	}
+
+	AssetManager::get()->setCacheBudget(TestAsset::k_assetType, 0);
+	EXPECT_EQ(AssetManager::get()->getCacheSize(TestAsset::k_assetType), 0);
+
+	AssetManager::shutdown();
+	job::shutdown();
+}
+
+TEST(AssetManager, testLoadTelemetry)
+{
+	job::init();
+	AssetManager::init();
+
+	TestAssetHandler handler;
+	AssetManager::get()->registerAssetHandler(TestAsset::k_assetType, &handler);
+
+	{
+		Asset<TestAsset> parent = AssetManager::get()->getAsset<TestAsset>(AssetID("parent"));
+		EXPECT_TRUE(parent.waitUntilLoaded());
+		Asset<TestAsset> failed = AssetManager::get()->getAsset<TestAsset>(AssetID("fail"));
+		EXPECT_FALSE(failed.waitUntilLoaded());
+	}
+
+	AssetLoadTelemetry *telemetry = AssetManager::get()->getLoadTelemetry();
+
+	AssetTypeLoadStats typeStats;
+	ASSERT_TRUE(telemetry->getTypeStats(TestAsset::k_assetType, &typeStats));
+	EXPECT_EQ(typeStats.m_loadCount, 6);
+	EXPECT_EQ(typeStats.m_failedCount, 1);
+	EXPECT_EQ(typeStats.m_bytesRead, 60);
+
+	eastl::vector<AssetLoadRecord> records;
+	telemetry->getRecords(records);
+	ASSERT_EQ(records.size(), 6);
+
+	// the children finish before their parent
+	EXPECT_EQ(records[4].m_assetID, AssetID("parent"));
+	EXPECT_EQ(records[5].m_assetID, AssetID("fail"));
+	EXPECT_FALSE(records[5].m_success);
+
+	for (const auto &record : records)
+	{
+		const uint64_t stageTime = record.m_stageTimes[static_cast<size_t>(AssetLoadStage::IO)] + record.m_stageTimes[static_cast<size_t>(AssetLoadStage::DECODE)];
+		EXPECT_GE(record.m_handlerTime, stageTime);
+		EXPECT_GE(record.m_latency, record.m_handlerTime);
+		EXPECT_EQ(record.m_bytesRead, 10);
+	}
+
+	telemetry->clear();
+	telemetry->getRecords(records);
+	EXPECT_TRUE(records.empty());
+	EXPECT_FALSE(telemetry->getTypeStats(TestAsset::k_assetType, &typeStats));
+
+	AssetManager::shutdown();
+	job::shutdown();
+}
+
+TEST(AssetManager, testDebouncedReload)
+{
+	job::init();
+	AssetManager::init();
+
+	TestAssetHandler handler;
+	AssetManager::get()->registerAssetHandler(TestAsset::k_assetType, &handler);
+
+	{
+		Asset<TestAsset> grandparent = AssetManager::get()->getAsset<TestAsset>(AssetID("grandparent"));
+		ASSERT_TRUE(grandparent.waitUntilLoaded());
+		Asset<TestAsset> child0 = grandparent->m_dependencies[0]->m_dependencies[0];
+		EXPECT_EQ(handler.m_loadCount, 6);
+
+		// repeated changes of the same file are reloaded once the delay expired
+		AssetManager::get()->queueReload(AssetID("child0"), TestAsset::k_assetType);
+		AssetManager::get()->queueReload(AssetID("child0"), TestAsset::k_assetType);
+		AssetManager::get()->update();
+		EXPECT_TRUE(AssetManager::get()->isReloadPending());
+		EXPECT_EQ(handler.m_loadCount, 6);
+
+		AssetManager::get()->setReloadDelay(0);
+		AssetManager::get()->update();
+		while (AssetManager::get()->isReloadPending())
+		{
+			Thread::yield();
+		}
+
+		// the assets depending on "child0" are reloaded after it
+		EXPECT_EQ(handler.m_loadCount, 9);
+		EXPECT_TRUE(child0->isReloadedAssetAvailable());
+		EXPECT_TRUE(grandparent->isReloadedAssetAvailable());
+
+		Asset<TestAsset> newGrandparent = AssetManager::get()->getAsset<TestAsset>(AssetID("grandparent"));
+		Asset<TestAsset> newParent = AssetManager::get()->getAsset<TestAsset>(AssetID("parent"));
+		Asset<TestAsset> newChild0 = AssetManager::get()->getAsset<TestAsset>(AssetID("child0"));
+		Asset<TestAsset> child1 = AssetManager::get()->getAsset<TestAsset>(AssetID("child1"));
+		EXPECT_NE(newChild0.get(), child0.get());
+		EXPECT_EQ(newGrandparent->m_dependencies[0].get(), newParent.get());
+		EXPECT_EQ(newParent->m_dependencies[0].get(), newChild0.get());
+		EXPECT_EQ(newParent->m_dependencies[1].get(), child1.get());
+		EXPECT_FALSE(child1->isReloadedAssetAvailable());
+	}
+
+	AssetManager::shutdown();
+	job::shutdown();
+}
@@ -0,0 +1,101 @@
+#include "gtest/gtest.h"
+#include <random>
+#include <string.h>
+#include <EASTL/vector.h>
+#include "utility/Compression.h"
+
+static void testRoundTrip(const eastl::vector<char> &data, size_t *compressedSize = nullptr)
+{
+	eastl::vector<char> compressed(Compression::getMaxCompressedSize(data.size()));
+	const size_t size = Compression::compress(data.size(), data.data(), compressed.size(), compressed.data());
+	ASSERT_NE(size, 0);
+
+	eastl::vector<char> decompressed(data.size() + 1, 'x');
+	ASSERT_TRUE(Compression::decompress(size, compressed.data(), data.size(), decompressed.data()));
+	ASSERT_EQ(memcmp(data.data(), decompressed.data(), data.size()), 0);
+	ASSERT_EQ(decompressed[data.size()], 'x');
+
+	if (compressedSize)
+	{
+		*compressedSize = size;
+	}
+}
+
+TEST(Compression, testRoundTrip)
+{
+	std::default_random_engine e;
+	std::uniform_int_distribution<int> d(0, 255);
+
+	// empty and tiny blocks are stored as literals
+	testRoundTrip({});
+	testRoundTrip({ 'a' });
+	testRoundTrip(eastl::vector<char>(12, 'b'));
+
+	// incompressible data
+	eastl::vector<char> random(100000);
+	for (auto &c : random)
+	{
+		c = static_cast<char>(d(e));
+	}
+	testRoundTrip(random);
+
+	// long runs produce overlapping matches and long length extensions
+	size_t compressedSize = 0;
+	eastl::vector<char> run(100000, 'c');
+	testRoundTrip(run, &compressedSize);
+	EXPECT_LT(compressedSize, 1000);
+
+	// repeated phrases with random noise in between
+	eastl::vector<char> text;
+	const char *phrases[] = { "vertex", "index", "material", "texture", "skeleton" };
+	for (size_t i = 0; i < 20000; ++i)
+	{
+		const char *phrase = phrases[d(e) % 5];
+		text.insert(text.end(), phrase, phrase + strlen(phrase));
+		if (d(e) < 32)
+		{
+			text.push_back(static_cast<char>(d(e)));
+		}
+	}
+	testRoundTrip(text, &compressedSize);
+	EXPECT_LT(compressedSize, text.size() / 2);
+}
+
+TEST(Compression, testInsufficientSpace)
+{
+	eastl::vector<char> data(1000);
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		data[i] = static_cast<char>(i * 7919);
+	}
+
+	char compressed[100];
+	EXPECT_EQ(Compression::compress(data.size(), data.data(), sizeof(compressed), compressed), 0);
+}
+
+TEST(Compression, testMalformedInput)
+{
+	eastl::vector<char> data(4096);
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		data[i] = static_cast<char>("abcabcabd"[i % 9]);
+	}
+
+	eastl::vector<char> compressed(Compression::getMaxCompressedSize(data.size()));
+	const size_t size = Compression::compress(data.size(), data.data(), compressed.size(), compressed.data());
+	ASSERT_NE(size, 0);
+
+	eastl::vector<char> decompressed(data.size());
+
+	// wrong uncompressed size
+	EXPECT_FALSE(Compression::decompress(size, compressed.data(), data.size() - 1, decompressed.data()));
+	EXPECT_FALSE(Compression::decompress(size, compressed.data(), data.size() + 1, decompressed.data()));
+
+	// truncated input
+	EXPECT_FALSE(Compression::decompress(size / 2, compressed.data(), data.size(), decompressed.data()));
+	EXPECT_FALSE(Compression::decompress(0, compressed.data(), data.size(), decompressed.data()));
+
+	// offset pointing before the start of the output
+	const unsigned char invalidOffset[] = { 0x10, 'a', 0x05, 0x00, 0x00 };
+	EXPECT_FALSE(Compression::decompress(sizeof(invalidOffset), invalidOffset, 5, decompressed.data()));
+}
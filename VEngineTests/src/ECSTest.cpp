@@ -708,6 +708,29 @@ TEST(ECSTestSuite, DestructorCallDestroyEntityMultipleComponents)
 	EXPECT_EQ(counter1, 1);
 }
 
+TEST(ECSTestSuite, DestroyEntityReuseID)
+{
+	ECS ecs;
+	ecs.registerComponent<CompA>();
+	ecs.registerComponent<CompB>();
+
+	auto entity = ecs.createEntity<CompA>();
+	ecs.destroyEntity(entity);
+	EXPECT_FALSE(ecs.isValid(entity));
+
+	// the index of the destroyed entity is reused with a new generation
+	auto reused = ecs.createEntity<CompA>();
+	EXPECT_NE(reused, entity);
+	EXPECT_TRUE(ecs.isValid(reused));
+	EXPECT_FALSE(ecs.isValid(entity));
+	EXPECT_NE(ecs.getComponent<CompA>(reused), nullptr);
+
+	// migrating to a different archetype keeps the generation
+	ecs.addComponent<CompB>(reused);
+	EXPECT_TRUE(ecs.isValid(reused));
+	EXPECT_TRUE(ecs.hasComponent<CompB>(reused));
+}
+
 TEST(ECSTestSuite, EmptyEntityCreate)
 {
 	ECS ecs;
@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+#include "filesystem/PathCache.h"
+#include "filesystem/IFileSystem.h"
+
+static IFileSystem *const s_fileSystem = reinterpret_cast<IFileSystem *>(static_cast<uintptr_t>(16));
+
+TEST(PathCache, testLookup)
+{
+	PathCache cache;
+	char resolvedPath[IFileSystem::k_maxPathLength];
+	PathCache::Info info{};
+
+	EXPECT_FALSE(cache.lookup("/assets/a.txt", resolvedPath, &info));
+
+	info.m_fileSystem = s_fileSystem;
+	info.m_flags = PathCache::FLAG_EXISTS;
+	cache.insert("/assets/a.txt", "C:/game/assets/a.txt", info);
+
+	PathCache::Info cachedInfo{};
+	ASSERT_TRUE(cache.lookup("/assets/a.txt", resolvedPath, &cachedInfo));
+	EXPECT_STREQ(resolvedPath, "C:/game/assets/a.txt");
+	EXPECT_EQ(cachedInfo.m_fileSystem, s_fileSystem);
+	EXPECT_EQ(cachedInfo.m_flags, PathCache::FLAG_EXISTS);
+
+	cache.update("/assets/a.txt", cachedInfo.m_generation, PathCache::FLAG_SIZE_VALID, 42);
+	ASSERT_TRUE(cache.lookup("/assets/a.txt", resolvedPath, &cachedInfo));
+	EXPECT_EQ(cachedInfo.m_flags, PathCache::FLAG_EXISTS | PathCache::FLAG_SIZE_VALID);
+	EXPECT_EQ(cachedInfo.m_size, 42);
+}
+
+TEST(PathCache, testInvalidate)
+{
+	PathCache cache;
+	char resolvedPath[IFileSystem::k_maxPathLength];
+	PathCache::Info info{};
+	info.m_fileSystem = s_fileSystem;
+
+	const char *paths[] = { "/assets/textures", "/assets/textures/a.dds", "/assets/textures/b/c.dds", "/assets/textures2", "/assets/mesh" };
+	for (const char *path : paths)
+	{
+		cache.lookup(path, resolvedPath, &info);
+		cache.insert(path, path, info);
+	}
+
+	cache.invalidate("/assets/mesh");
+	EXPECT_FALSE(cache.lookup("/assets/mesh", resolvedPath, &info));
+	EXPECT_TRUE(cache.lookup("/assets/textures", resolvedPath, &info));
+
+	cache.invalidateRecursive("/assets/textures");
+	EXPECT_FALSE(cache.lookup("/assets/textures", resolvedPath, &info));
+	EXPECT_FALSE(cache.lookup("/assets/textures/a.dds", resolvedPath, &info));
+	EXPECT_FALSE(cache.lookup("/assets/textures/b/c.dds", resolvedPath, &info));
+	EXPECT_TRUE(cache.lookup("/assets/textures2", resolvedPath, &info));
+
+	cache.clear();
+	EXPECT_FALSE(cache.lookup("/assets/textures2", resolvedPath, &info));
+}
+
+TEST(PathCache, testStaleResultsAreDiscarded)
+{
+	PathCache cache;
+	char resolvedPath[IFileSystem::k_maxPathLength];
+	PathCache::Info info{};
+	info.m_fileSystem = s_fileSystem;
+
+	// a result computed before an invalidation must not be inserted
+	EXPECT_FALSE(cache.lookup("/assets/a.txt", resolvedPath, &info));
+	cache.invalidate("/assets/a.txt");
+	cache.insert("/assets/a.txt", "C:/game/assets/a.txt", info);
+	EXPECT_FALSE(cache.lookup("/assets/a.txt", resolvedPath, &info));
+
+	// nor may it update an entry
+	cache.insert("/assets/a.txt", "C:/game/assets/a.txt", info);
+	PathCache::Info staleInfo{};
+	ASSERT_TRUE(cache.lookup("/assets/a.txt", resolvedPath, &staleInfo));
+	cache.invalidate("/assets/b.txt");
+	cache.update("/assets/a.txt", staleInfo.m_generation, PathCache::FLAG_SIZE_VALID, 42);
+	ASSERT_TRUE(cache.lookup("/assets/a.txt", resolvedPath, &info));
+	EXPECT_EQ(info.m_flags & PathCache::FLAG_SIZE_VALID, 0);
+}
@@ -0,0 +1,130 @@
+#include "gtest/gtest.h"
+#include <stdint.h>
+#include <string.h>
+#include "utility/Serialization.h"
+
+namespace
+{
+	struct TestData
+	{
+		float m_values[3] = {};
+		uint32_t m_ids[4] = {};
+		uint32_t m_nameLength = 0;
+		const char *m_name = nullptr;
+	};
+
+	template<typename Stream>
+	static bool serialize(TestData &d, Stream &stream) noexcept
+	{
+		serializeArray(stream, 3, d.m_values);
+		serializeArray(stream, 4, d.m_ids);
+		serializeUInt32(stream, d.m_nameLength);
+		serializeBytesView(stream, d.m_nameLength, d.m_name);
+
+		return true;
+	}
+}
+
+TEST(Serialization, testRoundTrip)
+{
+	TestData src;
+	src.m_values[0] = 1.0f;
+	src.m_values[1] = -2.5f;
+	src.m_values[2] = 1e10f;
+	for (uint32_t i = 0; i < 4; ++i)
+	{
+		src.m_ids[i] = 0xDEADBEEF + i;
+	}
+	src.m_name = "name";
+	src.m_nameLength = 5;
+
+	SerializationWriteStream writeStream(1);
+	ASSERT_TRUE(serialize(src, writeStream));
+
+	// the bulk paths write the same bytes as the single value ones
+	const auto &data = writeStream.getData();
+	ASSERT_EQ(data.size(), 3 * 4 + 4 * 4 + 4 + 5);
+	EXPECT_EQ(memcmp(data.data(), src.m_values, sizeof(src.m_values)), 0);
+	EXPECT_EQ(memcmp(data.data() + 12, src.m_ids, sizeof(src.m_ids)), 0);
+
+	TestData dst;
+	SerializationReadStream readStream(data.size(), data.data());
+	ASSERT_TRUE(serialize(dst, readStream));
+	EXPECT_EQ(readStream.getReadOffset(), data.size());
+
+	EXPECT_EQ(memcmp(dst.m_values, src.m_values, sizeof(src.m_values)), 0);
+	EXPECT_EQ(memcmp(dst.m_ids, src.m_ids, sizeof(src.m_ids)), 0);
+	EXPECT_EQ(dst.m_nameLength, 5);
+
+	// the view points into the source buffer instead of a copy
+	EXPECT_EQ(dst.m_name, data.data() + 32);
+	EXPECT_STREQ(dst.m_name, "name");
+}
+
+TEST(Serialization, testShortBuffer)
+{
+	const char buffer[16] = {};
+
+	{
+		// a failed read does not consume anything
+		float values[4];
+		SerializationReadStream stream(15, buffer);
+		EXPECT_FALSE(stream.serialize(4, values));
+		EXPECT_EQ(stream.getReadOffset(), 0);
+		EXPECT_TRUE(stream.serialize(3, values));
+		EXPECT_FALSE(stream.serialize(1, values));
+		EXPECT_EQ(stream.getReadOffset(), 12);
+	}
+
+	{
+		const char *view = nullptr;
+		SerializationReadStream stream(16, buffer);
+		EXPECT_TRUE(stream.serializeView(10, view));
+		EXPECT_EQ(view, buffer);
+		EXPECT_FALSE(stream.serializeView(7, view));
+		EXPECT_EQ(view, buffer);
+		EXPECT_TRUE(stream.serializeView(6, view));
+		EXPECT_EQ(view, buffer + 10);
+		EXPECT_EQ(stream.getReadOffset(), 16);
+
+		// empty reads at the end still succeed
+		EXPECT_TRUE(stream.serializeView(0, view));
+	}
+
+	{
+		// the name length claims more bytes than are left
+		TestData src;
+		src.m_name = "name";
+		src.m_nameLength = 5;
+
+		SerializationWriteStream writeStream;
+		ASSERT_TRUE(serialize(src, writeStream));
+
+		TestData dst;
+		SerializationReadStream readStream(writeStream.getData().size() - 1, writeStream.getData().data());
+		EXPECT_FALSE(serialize(dst, readStream));
+		EXPECT_EQ(dst.m_name, nullptr);
+	}
+}
+
+TEST(Serialization, testOverflowingCount)
+{
+	const char buffer[16] = {};
+	uint32_t values[4];
+	const char *view = nullptr;
+
+	SerializationReadStream stream(16, buffer);
+	ASSERT_TRUE(stream.serialize(1, values));
+
+	// count * sizeof(T) and offset + length wrap around to small values
+	EXPECT_FALSE(stream.serialize(SIZE_MAX / 4 + 2, values));
+	EXPECT_FALSE(stream.serialize(SIZE_MAX, values));
+	EXPECT_FALSE(stream.serializeView(SIZE_MAX - 1, view));
+	EXPECT_FALSE(stream.serializeView(SIZE_MAX, view));
+	EXPECT_EQ(view, nullptr);
+	EXPECT_EQ(stream.getReadOffset(), 4);
+
+	// the stream is still usable afterwards
+	EXPECT_TRUE(stream.serialize(3, values));
+	EXPECT_EQ(stream.getReadOffset(), 16);
+}
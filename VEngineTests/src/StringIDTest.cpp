@@ -0,0 +1,94 @@
+#include "gtest/gtest.h"
+#include "utility/StringID.h"
+#include "job/JobSystem.h"
+#include <stdio.h>
+
+TEST(StringID, testIntern)
+{
+	char str[] = "stringid/test/a";
+	StringID a("stringid/test/a");
+	StringID a2(str);
+	StringID b(SID("stringid/test/b"));
+
+	// equal strings share the pooled copy, which is also used for hashing StringIDs
+	EXPECT_EQ(a, a2);
+	EXPECT_EQ(a.m_string, a2.m_string);
+	EXPECT_NE(a.m_string, str);
+	EXPECT_STREQ(a.m_string, "stringid/test/a");
+	EXPECT_NE(a, b);
+	EXPECT_EQ(b.m_hash, "stringid/test/b"_hash);
+
+	StringID found;
+	ASSERT_TRUE(StringID::tryGet("stringid/test/b", &found));
+	EXPECT_EQ(found, b);
+	EXPECT_EQ(found.m_string, b.m_string);
+	EXPECT_FALSE(StringID::tryGet("stringid/test/not_interned", &found));
+}
+
+TEST(StringID, testLiteral)
+{
+	// literals do not touch the pool, so they can be created at compile time
+	static constexpr StringID k_literal = SID("stringid/test/literal");
+	static_assert(k_literal.m_hash == "stringid/test/literal"_hash);
+
+	StringID found;
+	EXPECT_FALSE(StringID::tryGet("stringid/test/literal", &found));
+	EXPECT_STREQ(k_literal.m_string, "stringid/test/literal");
+
+	StringID pooled("stringid/test/literal");
+	EXPECT_EQ(pooled, k_literal);
+	EXPECT_EQ(StringIDHash()(pooled), StringIDHash()(k_literal));
+
+	StringID hashOnly = StringID::hashOnly("stringid/test/literal");
+	EXPECT_EQ(hashOnly, k_literal);
+	EXPECT_EQ(hashOnly.m_string, nullptr);
+	EXPECT_STREQ(StringID::getDebugName(hashOnly), "stringid/test/literal");
+}
+
+TEST(StringID, testParallelIntern)
+{
+	job::init();
+
+	constexpr uint32_t k_jobCount = 16;
+	constexpr uint32_t k_stringCount = 4096;
+
+	// all jobs intern the same strings, so every pooled string needs to be unique
+	static const char *s_pooledStrings[k_jobCount][k_stringCount];
+
+	job::Job jobs[k_jobCount];
+	for (uint32_t i = 0; i < k_jobCount; ++i)
+	{
+		jobs[i] = job::Job([](void *param)
+			{
+				const size_t jobIdx = reinterpret_cast<size_t>(param);
+				for (uint32_t j = 0; j < k_stringCount; ++j)
+				{
+					char str[64];
+					snprintf(str, sizeof(str), "stringid/parallel/%u", j);
+					s_pooledStrings[jobIdx][j] = StringID(str).m_string;
+				}
+			}, reinterpret_cast<void *>(static_cast<size_t>(i)));
+	}
+
+	job::Counter *counter = nullptr;
+	job::run(k_jobCount, jobs, &counter);
+	job::waitForCounter(counter);
+	job::freeCounter(counter);
+
+	for (uint32_t j = 0; j < k_stringCount; ++j)
+	{
+		char str[64];
+		snprintf(str, sizeof(str), "stringid/parallel/%u", j);
+
+		StringID found;
+		ASSERT_TRUE(StringID::tryGet(str, &found));
+		EXPECT_STREQ(found.m_string, str);
+
+		for (uint32_t i = 0; i < k_jobCount; ++i)
+		{
+			EXPECT_EQ(s_pooledStrings[i][j], found.m_string);
+		}
+	}
+
+	job::shutdown();
+}
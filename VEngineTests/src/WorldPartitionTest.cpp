@@ -0,0 +1,143 @@
+#include "gtest/gtest.h"
+#include "WorldPartition.h"
+#include "TransformHierarchy.h"
+#include "component/TransformComponent.h"
+#include "ecs/ECS.h"
+#include "ecs/ECSComponentInfoTable.h"
+#include "filesystem/RawFileSystem.h"
+#include "filesystem/VirtualFileSystem.h"
+#include "job/JobSystem.h"
+#include "utility/Thread.h"
+
+static constexpr const char *k_nativeTestDirectory = "WorldPartitionTest";
+
+static Transform createTransform(float x, float z) noexcept
+{
+	Transform transform;
+	transform.m_translation = glm::vec3(x, 0.0f, z);
+	return transform;
+}
+
+// updates until the given number of cells is loaded. the cell files are read in load jobs, so this takes multiple updates
+static void updateUntilLoaded(WorldPartition &worldPartition, float x, float z, size_t loadedCellCount) noexcept
+{
+	for (size_t i = 0; i < 1000; ++i)
+	{
+		worldPartition.update(glm::vec3(x, 0.0f, z));
+		if (worldPartition.getLoadedCellCount() == loadedCellCount)
+		{
+			return;
+		}
+		Thread::sleep(1);
+	}
+}
+
+static size_t getEntityCount(ECS &ecs) noexcept
+{
+	size_t entityCount = 0;
+	ecs.iterate<TransformComponent>([&](size_t count, const EntityID *entities, TransformComponent *transC)
+		{
+			entityCount += count;
+		});
+	return entityCount;
+}
+
+// finds the entity whose global translation is at the given x coordinate
+static EntityID findEntity(ECS &ecs, float x) noexcept
+{
+	EntityID result = k_nullEntity;
+	ecs.iterate<TransformComponent>([&](size_t count, const EntityID *entities, TransformComponent *transC)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (transC[i].m_globalTransform.m_translation.x == x)
+				{
+					result = entities[i];
+				}
+			}
+		});
+	return result;
+}
+
+TEST(WorldPartition, testStreaming)
+{
+	job::init();
+	ECS::registerComponent<TransformComponent>();
+	ECSComponentInfoTable::registerType<TransformComponent>();
+
+	RawFileSystem::get().createDirectoryHierarchy(k_nativeTestDirectory);
+	ASSERT_TRUE(VirtualFileSystem::get().mount(k_nativeTestDirectory, "test"));
+
+	// the parent is in cell (0, 0) and its child in cell (1, 0)
+	ECS srcECS;
+	const EntityID parent = srcECS.createEntity(TransformComponent(createTransform(5.0f, 5.0f)));
+	const EntityID child = srcECS.createEntity(TransformComponent(createTransform(10.0f, 0.0f)));
+	ASSERT_TRUE(TransformHierarchy::attach(&srcECS, child, parent, true));
+	ASSERT_TRUE(WorldPartition::build(&srcECS, "/test/level", 10.0f));
+
+	ECS ecs;
+	{
+		WorldPartition worldPartition(&ecs);
+		worldPartition.setRadii(1.0f, 2.0f);
+		worldPartition.setFrameBudget(1000);
+		ASSERT_TRUE(worldPartition.open("/test/level"));
+
+		// the global cell is always loaded
+		updateUntilLoaded(worldPartition, 5.0f, 5.0f, 2);
+		EXPECT_EQ(worldPartition.getLoadedCellCount(), 2);
+		EXPECT_EQ(getEntityCount(ecs), 1);
+		EXPECT_NE(findEntity(ecs, 5.0f), k_nullEntity);
+
+		// crossing into cell (1, 0) unloads the parent. the child is created as a root at its global transform
+		updateUntilLoaded(worldPartition, 15.0f, 5.0f, 2);
+		EXPECT_EQ(worldPartition.getLoadedCellCount(), 2);
+		EXPECT_EQ(getEntityCount(ecs), 1);
+		EntityID loadedChild = findEntity(ecs, 15.0f);
+		ASSERT_NE(loadedChild, k_nullEntity);
+		EXPECT_EQ(ecs.getComponent<TransformComponent>(loadedChild)->m_parentEntity, k_nullEntity);
+
+		// on the border both cells are loaded and the child is attached to its parent again
+		updateUntilLoaded(worldPartition, 10.0f, 5.0f, 3);
+		EXPECT_EQ(worldPartition.getLoadedCellCount(), 3);
+		EXPECT_EQ(getEntityCount(ecs), 2);
+		const EntityID loadedParent = findEntity(ecs, 5.0f);
+		ASSERT_NE(loadedParent, k_nullEntity);
+		EXPECT_EQ(ecs.getComponent<TransformComponent>(loadedChild)->m_parentEntity, loadedParent);
+		EXPECT_EQ(findEntity(ecs, 15.0f), loadedChild);
+
+		// moving the parent across the cell boundary moves it into cell (1, 0) and its child into cell (2, 0)
+		TransformHierarchy::setLocalTransform(&srcECS, parent, createTransform(15.0f, 5.0f));
+		ASSERT_TRUE(WorldPartition::build(&srcECS, "/test/level", 10.0f));
+		ASSERT_TRUE(worldPartition.open("/test/level"));
+		EXPECT_EQ(getEntityCount(ecs), 0);
+
+		updateUntilLoaded(worldPartition, 15.0f, 5.0f, 2);
+		EXPECT_EQ(worldPartition.getLoadedCellCount(), 2);
+		EXPECT_EQ(getEntityCount(ecs), 1);
+		EXPECT_NE(findEntity(ecs, 15.0f), k_nullEntity);
+
+		updateUntilLoaded(worldPartition, 25.0f, 5.0f, 2);
+		EXPECT_EQ(worldPartition.getLoadedCellCount(), 2);
+		EXPECT_EQ(getEntityCount(ecs), 1);
+		loadedChild = findEntity(ecs, 25.0f);
+		ASSERT_NE(loadedChild, k_nullEntity);
+		EXPECT_EQ(ecs.getComponent<TransformComponent>(loadedChild)->m_parentEntity, k_nullEntity);
+	}
+
+	// closing the world partition destroyed all streamed entities
+	EXPECT_EQ(getEntityCount(ecs), 0);
+
+	auto &vfs = VirtualFileSystem::get();
+	const char *files[] = { "level.idx", "global.cell", "cell_0_0.cell", "cell_1_0.cell", "cell_2_0.cell" };
+	for (const char *file : files)
+	{
+		eastl::string path = "/test/level/";
+		path += file;
+		vfs.remove(path.c_str());
+	}
+	vfs.remove("/test/level");
+	vfs.unmount("test");
+	RawFileSystem::get().remove(k_nativeTestDirectory);
+
+	job::shutdown();
+}